@@ -0,0 +1,107 @@
+#ifndef UNICODE
+#define UNICODE
+#define _UNICODE
+#endif
+
+#include "alloc_guard.hpp"
+
+#include <atomic>
+
+#ifdef _DEBUG
+#include <crtdbg.h>
+#endif
+
+namespace
+{
+
+struct ThreadState
+{
+    bool active = false;          // inside a ScopedNoAlloc
+    bool assert_on_alloc = false; // that scope is armed
+    int allowed = 0;              // ScopedAllowAlloc nesting depth
+    bool reporting = false;       // inside our own assert; its allocations are not ours
+    size_t count = 0;             // monotonic; scopes remember their start
+};
+
+thread_local ThreadState t_state;
+std::atomic<uint64_t> g_total{0};
+std::atomic<bool> g_enabled{false};
+
+#ifdef _DEBUG
+_CRT_ALLOC_HOOK g_previous_hook = nullptr;
+
+int __cdecl AllocHook(int alloc_type, void* user_data, size_t size, int block_type, long request,
+                      const unsigned char* file, int line)
+{
+    // _CRT_BLOCK: the CRT's own bookkeeping, including what _CrtDbgReport
+    // allocates while showing the assert below.
+    ThreadState& state = t_state;
+    if ((alloc_type == _HOOK_ALLOC || alloc_type == _HOOK_REALLOC) && block_type != _CRT_BLOCK && state.active &&
+        state.allowed == 0 && !state.reporting)
+    {
+        ++state.count;
+        g_total.fetch_add(1, std::memory_order_relaxed);
+        if (state.assert_on_alloc)
+        {
+            state.reporting = true;
+            _ASSERT_EXPR(false, L"heap allocation in a steady-state frame (see alloc_guard.hpp)");
+            state.reporting = false;
+        }
+    }
+    return g_previous_hook ? g_previous_hook(alloc_type, user_data, size, block_type, request, file, line) : TRUE;
+}
+#endif
+
+} // namespace
+
+namespace alloc_guard
+{
+
+void Install()
+{
+#ifdef _DEBUG
+    if (g_enabled.exchange(true))
+        return;
+    g_previous_hook = _CrtSetAllocHook(AllocHook);
+#endif
+}
+
+bool Enabled()
+{
+    return g_enabled.load();
+}
+
+ScopedNoAlloc::ScopedNoAlloc(bool assert_on_alloc)
+    : start_(t_state.count), previous_active_(t_state.active), previous_assert_(t_state.assert_on_alloc)
+{
+    t_state.active = true;
+    t_state.assert_on_alloc = assert_on_alloc;
+}
+
+ScopedNoAlloc::~ScopedNoAlloc()
+{
+    t_state.active = previous_active_;
+    t_state.assert_on_alloc = previous_assert_;
+}
+
+size_t ScopedNoAlloc::Count() const
+{
+    return t_state.count - start_;
+}
+
+ScopedAllowAlloc::ScopedAllowAlloc()
+{
+    ++t_state.allowed;
+}
+
+ScopedAllowAlloc::~ScopedAllowAlloc()
+{
+    --t_state.allowed;
+}
+
+uint64_t TotalCount()
+{
+    return g_total.load(std::memory_order_relaxed);
+}
+
+} // namespace alloc_guard
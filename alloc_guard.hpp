@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Debug-build check that steady-state frames make no CRT heap allocations.
+// Per-frame allocations contend for the heap lock with the capture thread
+// and fragment the heap over multi-day soaks, so a regression should trip
+// where it is introduced rather than show up days into a soak.
+//
+//   Install()         - wWinMain, once: chains a _CrtSetAllocHook hook.
+//   ScopedNoAlloc     - around RenderFrame: allocations on this thread are
+//                       counted and, once armed, asserted on at the
+//                       allocation itself (Retry breaks with its call stack).
+//   ScopedAllowAlloc  - inside it, for work that runs only because an input
+//                       changed: a text layout rebuilt for new text,
+//                       device-lost recovery, the periodic FPS log line.
+//
+// In release builds there is no hook: scopes only set a thread_local and
+// Count() stays zero.
+namespace alloc_guard
+{
+
+void Install();
+
+// True once Install() has hooked the debug CRT.
+bool Enabled();
+
+class ScopedNoAlloc
+{
+  public:
+    // `assert_on_alloc` is false during warm-up, when allocations are only
+    // counted.
+    explicit ScopedNoAlloc(bool assert_on_alloc);
+    ~ScopedNoAlloc();
+
+    ScopedNoAlloc(const ScopedNoAlloc&) = delete;
+    ScopedNoAlloc& operator=(const ScopedNoAlloc&) = delete;
+
+    // Allocations on this thread since construction, outside any
+    // ScopedAllowAlloc.
+    size_t Count() const;
+
+  private:
+    size_t start_;
+    bool previous_active_;
+    bool previous_assert_;
+};
+
+class ScopedAllowAlloc
+{
+  public:
+    ScopedAllowAlloc();
+    ~ScopedAllowAlloc();
+
+    ScopedAllowAlloc(const ScopedAllowAlloc&) = delete;
+    ScopedAllowAlloc& operator=(const ScopedAllowAlloc&) = delete;
+};
+
+// Allocations caught by any ScopedNoAlloc since startup, all threads.
+uint64_t TotalCount();
+
+} // namespace alloc_guard
@@ -0,0 +1,171 @@
+#ifndef UNICODE
+#define UNICODE
+#define _UNICODE
+#endif
+
+#include "app_options.hpp"
+
+#include <cwchar>
+
+namespace
+{
+
+bool IsSwitch(const std::wstring& arg, const wchar_t* name)
+{
+    return _wcsicmp(arg.c_str(), name) == 0;
+}
+
+// Matches "--name=value" (name compared case-insensitively, including the
+// trailing '='); on success `value` receives everything after the '='.
+bool MatchValue(const std::wstring& arg, const wchar_t* prefix, std::wstring& value)
+{
+    const size_t prefix_len = wcslen(prefix);
+    if (arg.size() < prefix_len || _wcsnicmp(arg.c_str(), prefix, prefix_len) != 0)
+        return false;
+    value = arg.substr(prefix_len);
+    return true;
+}
+
+// Strict decimal parse: the whole string must be digits and fit `max_value`.
+bool ParseUnsigned(const std::wstring& text, unsigned max_value, unsigned& out)
+{
+    if (text.empty() || text.size() > 9)
+        return false;
+    unsigned value = 0;
+    for (wchar_t ch : text)
+    {
+        if (ch < L'0' || ch > L'9')
+            return false;
+        value = value * 10 + static_cast<unsigned>(ch - L'0');
+    }
+    if (value > max_value)
+        return false;
+    out = value;
+    return true;
+}
+
+} // namespace
+
+AppOptions ParseAppOptions(const std::vector<std::wstring>& args)
+{
+    AppOptions options;
+    std::wstring value;
+    for (const auto& arg : args)
+    {
+        if (IsSwitch(arg, L"--async-log"))
+        {
+            options.async_log = true;
+        }
+        else if (MatchValue(arg, L"--log-format=", value))
+        {
+            if (_wcsicmp(value.c_str(), L"utf8") == 0)
+                options.log_utf8 = true;
+            else if (_wcsicmp(value.c_str(), L"utf16") == 0)
+                options.log_utf8 = false;
+        }
+        else if (MatchValue(arg, L"--log-rotate-mb=", value))
+        {
+            unsigned mb = 0;
+            if (ParseUnsigned(value, 1024 * 1024, mb))
+                options.log_rotate_mb = mb;
+        }
+        else if (MatchValue(arg, L"--log-rotate-minutes=", value))
+        {
+            unsigned minutes = 0;
+            if (ParseUnsigned(value, 7 * 24 * 60, minutes))
+                options.log_rotate_minutes = minutes;
+        }
+        else if (MatchValue(arg, L"--log-keep=", value))
+        {
+            unsigned keep = 0;
+            if (ParseUnsigned(value, 100, keep))
+                options.log_keep_files = keep;
+        }
+        else if (MatchValue(arg, L"--fps=", value))
+        {
+            // Malformed values keep the default rather than failing startup.
+            unsigned fps = 0;
+            if (_wcsicmp(value.c_str(), L"unlimited") == 0)
+                options.target_fps = 0;
+            else if (ParseUnsigned(value, 1000, fps))
+                options.target_fps = fps;
+        }
+        else if (MatchValue(arg, L"--present=", value))
+        {
+            if (_wcsicmp(value.c_str(), L"flip") == 0)
+                options.present_model = PresentModel::Flip;
+            else if (_wcsicmp(value.c_str(), L"blt") == 0)
+                options.present_model = PresentModel::Blt;
+        }
+        else if (MatchValue(arg, L"--render-mode=", value))
+        {
+            if (_wcsicmp(value.c_str(), L"low-power") == 0)
+                options.render_mode = RenderMode::LowPower;
+            else if (_wcsicmp(value.c_str(), L"full") == 0)
+                options.render_mode = RenderMode::Full;
+        }
+        else if (MatchValue(arg, L"--cube-fps=", value))
+        {
+            unsigned fps = 0;
+            if (ParseUnsigned(value, 1000, fps))
+                options.cube_fps = fps;
+        }
+        else if (MatchValue(arg, L"--qr-interval=", value))
+        {
+            unsigned interval_ms = 0;
+            if (ParseUnsigned(value, 3600000, interval_ms))
+                options.qr_interval_ms = interval_ms;
+        }
+        else if (MatchValue(arg, L"--record-interval=", value))
+        {
+            unsigned interval_ms = 0;
+            if (ParseUnsigned(value, 3600000, interval_ms))
+                options.record_interval_ms = interval_ms;
+        }
+        else if (MatchValue(arg, L"--audio-engine=", value))
+        {
+            if (_wcsicmp(value.c_str(), L"legacy") == 0)
+                options.audio_engine = AudioEngine::Legacy;
+            else if (_wcsicmp(value.c_str(), L"event") == 0)
+                options.audio_engine = AudioEngine::Event;
+            else if (_wcsicmp(value.c_str(), L"low-latency") == 0)
+                options.audio_engine = AudioEngine::LowLatency;
+        }
+        else if (MatchValue(arg, L"--hud=", value))
+        {
+            if (_wcsicmp(value.c_str(), L"d2d") == 0)
+                options.hud_backend = HudBackend::D2D;
+            else if (_wcsicmp(value.c_str(), L"gpu") == 0)
+                options.hud_backend = HudBackend::Gpu;
+            else if (_wcsicmp(value.c_str(), L"auto") == 0)
+                options.hud_backend = HudBackend::Auto;
+        }
+        else if (IsSwitch(arg, L"--latency-probe"))
+        {
+            options.latency_probe = true;
+        }
+        else if (IsSwitch(arg, L"--headless"))
+        {
+            options.headless = true;
+        }
+        else if (MatchValue(arg, L"--headless-out=", value))
+        {
+            // An empty path would silently fall back to stdout; ignore it.
+            if (!value.empty())
+            {
+                options.headless = true;
+                options.headless_output = value;
+            }
+        }
+        else if (IsSwitch(arg, L"--no-metrics"))
+        {
+            options.metrics_shm = false;
+        }
+        else if (MatchValue(arg, L"--metrics-name=", value))
+        {
+            if (!value.empty())
+                options.metrics_name = value;
+        }
+    }
+    return options;
+}
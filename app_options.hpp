@@ -0,0 +1,120 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Switches that change how the debugger itself behaves. Every argument is
+// still shown in the HUD and QR payload unchanged — this tool exists to
+// display exactly what the launcher delivered, so recognised switches are
+// read, never consumed. Unknown arguments are ignored.
+enum class PresentModel
+{
+    // Legacy blt model: one buffer, DXGI_SWAP_EFFECT_DISCARD, DWM copies it.
+    Blt,
+    // FLIP_DISCARD with a frame-latency waitable (max latency 1) and
+    // DXGI_PRESENT_ALLOW_TEARING when the system supports it.
+    Flip,
+};
+
+enum class RenderMode
+{
+    // Render and present every paced frame.
+    Full,
+    // Render only when something visible changed: typed input, status text,
+    // a new QR payload, a mic level change, or a (rate-limited) cube frame.
+    LowPower,
+};
+
+enum class AudioEngine
+{
+    // Original capture loop: 200 ms wait timeout, GetNextPacketSize polling,
+    // and a log line on every wakeup.
+    Legacy,
+    // Block on the WASAPI event and drain every packet per wakeup; logs only
+    // on stream state changes.
+    Event,
+    // Event, plus IAudioClient3 with the smallest shared-mode engine period.
+    LowLatency,
+};
+
+enum class HudBackend
+{
+    // Every overlay element through Direct2D.
+    D2D,
+    // Meter bars, waveform, frame-time graph and QR modules as one instanced
+    // D3D11 draw; Direct2D only for text. Needs feature level 11_0, else
+    // falls back to D2D.
+    Gpu,
+    // Gpu on software adapters (WARP, Microsoft Basic Render Driver), where
+    // Direct2D's many small draws dominate the frame; D2D elsewhere.
+    Auto,
+};
+
+struct AppOptions
+{
+    // --async-log: queue log records and let a writer thread batch them to
+    // disk instead of fflush()ing on every Log() call.
+    bool async_log = false;
+
+    // --log-format=utf16|utf8: utf8 writes compact "<unix ms> text" records
+    // instead of UTF-16LE with formatted local timestamps.
+    bool log_utf8 = false;
+
+    // --log-rotate-mb=<N>, --log-rotate-minutes=<N>: rotate the log once it
+    // reaches N MiB / has been open N minutes (0 = never, the default).
+    unsigned log_rotate_mb = 0;
+    unsigned log_rotate_minutes = 0;
+
+    // --log-keep=<N>: rotated files kept (debug.1.log .. debug.N.log).
+    unsigned log_keep_files = 3;
+
+    // --fps=<N>|unlimited: frame-pacing target for the render loop. 0 means
+    // unlimited (render as fast as Present allows).
+    unsigned target_fps = 60;
+
+    // --present=flip|blt: swap-chain presentation model. Flip falls back to
+    // blt at runtime when the OS or driver rejects it.
+    PresentModel present_model = PresentModel::Blt;
+
+    // --render-mode=full|low-power: see RenderMode.
+    RenderMode render_mode = RenderMode::Full;
+
+    // --cube-fps=<N>: cube animation rate in low-power mode; 0 keeps the cube
+    // static. Ignored in full mode, where the cube moves every frame.
+    unsigned cube_fps = 10;
+
+    // --qr-interval=<ms>: how often the QR payload is refreshed. 0 refreshes
+    // it on every rendered frame (for latency measurement from the stream).
+    unsigned qr_interval_ms = 5000;
+
+    // --record-interval=<ms>: append a sample to the session record this
+    // often (see session_record.hpp). 0, the default, records only on "save".
+    unsigned record_interval_ms = 0;
+
+    // --audio-engine=legacy|event|low-latency: microphone capture loop.
+    AudioEngine audio_engine = AudioEngine::Legacy;
+
+    // --hud=d2d|gpu|auto: see HudBackend.
+    HudBackend hud_backend = HudBackend::D2D;
+
+    // --latency-probe: time every typed character from WM_CHAR to the
+    // refresh that shows it (see input_latency.hpp) and report it in the QR
+    // payload, the metrics segment and the `memory` panel.
+    bool latency_probe = false;
+
+    // --headless: print the argument/path/QR report as JSON and exit without
+    // creating a window, graphics device or audio client.
+    bool headless = false;
+
+    // --headless-out=<path>: write the headless report to a file instead of
+    // stdout. Implies --headless.
+    std::wstring headless_output;
+
+    // Live metrics in shared memory (see metrics_export.hpp). On by default;
+    // --no-metrics turns it off, --metrics-name=<name> replaces the default
+    // "Local\CloudStreamingArgsDebugger.Metrics.<pid>" segment name.
+    bool metrics_shm = true;
+    std::wstring metrics_name;
+};
+
+AppOptions ParseAppOptions(const std::vector<std::wstring>& args);
@@ -0,0 +1,154 @@
+#ifndef UNICODE
+#define UNICODE
+#define _UNICODE
+#endif
+
+#include "arg_list_view.hpp"
+
+#include <algorithm>
+#include <cwctype>
+
+#include "cli_args_display.hpp"
+
+namespace arg_list_view::detail
+{
+
+std::wstring FormatRow(size_t index, const std::wstring& arg, size_t max_chars)
+{
+    std::wstring row = std::to_wstring(index + 1) + L": " + FormatCliArg(arg);
+    if (max_chars > 0 && row.size() > max_chars)
+    {
+        row.resize(max_chars - 1);
+        row.push_back(L'\u2026'); // horizontal ellipsis
+    }
+    return row;
+}
+
+std::wstring Fold(const std::wstring& text)
+{
+    std::wstring folded(text);
+    std::transform(folded.begin(), folded.end(), folded.begin(),
+                   [](wchar_t ch) { return static_cast<wchar_t>(std::towlower(ch)); });
+    return folded;
+}
+
+} // namespace arg_list_view::detail
+
+void ArgListView::SetArgs(const std::vector<std::wstring>& args)
+{
+    rows_.clear();
+    folded_args_.clear();
+    rows_.reserve(args.size());
+    folded_args_.reserve(args.size());
+    for (size_t i = 0; i < args.size(); ++i)
+    {
+        rows_.push_back(arg_list_view::detail::FormatRow(i, args[i], kMaxRowChars));
+        folded_args_.push_back(arg_list_view::detail::Fold(args[i]));
+    }
+    first_row_ = 0;
+    ClearSearch();
+}
+
+bool ArgListView::SetPageRows(size_t rows)
+{
+    page_rows_ = (std::max)(rows, size_t{1});
+    return ScrollTo(first_row_);
+}
+
+size_t ArgListView::EndRow() const
+{
+    return (std::min)(first_row_ + page_rows_, rows_.size());
+}
+
+size_t ArgListView::MaxFirstRow() const
+{
+    return rows_.size() > page_rows_ ? rows_.size() - page_rows_ : 0;
+}
+
+bool ArgListView::ScrollTo(size_t first_row)
+{
+    const size_t clamped = (std::min)(first_row, MaxFirstRow());
+    if (clamped == first_row_)
+        return false;
+    first_row_ = clamped;
+    return true;
+}
+
+bool ArgListView::ScrollBy(long long rows)
+{
+    if (rows < 0)
+    {
+        const size_t up = static_cast<size_t>(-rows);
+        return ScrollTo(up >= first_row_ ? 0 : first_row_ - up);
+    }
+    return ScrollTo(first_row_ + (std::min)(static_cast<size_t>(rows), rows_.size()));
+}
+
+bool ArgListView::PageUp()
+{
+    return ScrollBy(-static_cast<long long>(page_rows_));
+}
+
+bool ArgListView::PageDown()
+{
+    return ScrollBy(static_cast<long long>(page_rows_));
+}
+
+bool ArgListView::Home()
+{
+    return ScrollTo(0);
+}
+
+bool ArgListView::End()
+{
+    return ScrollTo(MaxFirstRow());
+}
+
+void ArgListView::Reveal(size_t row)
+{
+    if (row < first_row_)
+        ScrollTo(row);
+    else if (row >= first_row_ + page_rows_)
+        ScrollTo(row + 1 - page_rows_);
+}
+
+size_t ArgListView::Find(const std::wstring& needle)
+{
+    ClearSearch();
+    if (needle.empty())
+        return 0;
+
+    needle_ = needle;
+    const std::wstring folded = arg_list_view::detail::Fold(needle);
+    for (size_t i = 0; i < folded_args_.size(); ++i)
+    {
+        if (folded_args_[i].find(folded) != std::wstring::npos)
+            matches_.push_back(i);
+    }
+    if (matches_.empty())
+        return 0;
+
+    const auto first_visible = std::lower_bound(matches_.begin(), matches_.end(), first_row_);
+    current_match_ = first_visible == matches_.end() ? 0 : static_cast<size_t>(first_visible - matches_.begin());
+    Reveal(matches_[current_match_]);
+    return matches_.size();
+}
+
+bool ArgListView::FindNext(bool forward)
+{
+    if (matches_.empty())
+        return false;
+    if (forward)
+        current_match_ = current_match_ + 1 >= matches_.size() ? 0 : current_match_ + 1;
+    else
+        current_match_ = current_match_ == 0 ? matches_.size() - 1 : current_match_ - 1;
+    Reveal(matches_[current_match_]);
+    return true;
+}
+
+void ArgListView::ClearSearch()
+{
+    needle_.clear();
+    matches_.clear();
+    current_match_ = static_cast<size_t>(-1);
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Scrollable, searchable one-row-per-argument view of argv for the HUD.
+// Launchers can pass 32 KB command lines with hundreds of tokens (JSON blobs,
+// long URLs); laid out as one wrapped block, that text dominated every frame.
+// Rows are formatted once in SetArgs() and only the window
+// [FirstRow(), EndRow()) is drawn, each row from its own cached layout, so
+// per-frame cost follows the window height rather than argv.
+//
+// Pure model: no Direct2D. Render-thread only.
+class ArgListView
+{
+  public:
+    // Longest row text; longer arguments are cut and end in an ellipsis. The
+    // full argument is still searched and still goes into the QR payload.
+    static constexpr size_t kMaxRowChars = 256;
+
+    void SetArgs(const std::vector<std::wstring>& args);
+
+    size_t RowCount() const
+    {
+        return rows_.size();
+    }
+    // "<n>: <FormatCliArg(arg)>", 1-based n, at most kMaxRowChars.
+    const std::wstring& Row(size_t row) const
+    {
+        return rows_[row];
+    }
+
+    // Rows that fit the box the HUD draws into; clamps the scroll position.
+    // Returns true if the visible window moved.
+    bool SetPageRows(size_t rows);
+    size_t PageRows() const
+    {
+        return page_rows_;
+    }
+    size_t FirstRow() const
+    {
+        return first_row_;
+    }
+    // One past the last visible row.
+    size_t EndRow() const;
+    bool Overflows() const
+    {
+        return rows_.size() > page_rows_;
+    }
+
+    // Scrolling; each returns true if the visible window moved.
+    bool ScrollBy(long long rows);
+    bool ScrollTo(size_t first_row);
+    bool PageUp();
+    bool PageDown();
+    bool Home();
+    bool End();
+
+    // Case-insensitive substring search over the full arguments. Selects the
+    // first match at or below the first visible row (wrapping around) and
+    // scrolls it into view. An empty needle clears the search. Returns the
+    // number of matching rows.
+    size_t Find(const std::wstring& needle);
+    // Moves to the next (or previous) match, wrapping around; false without
+    // an active search or matches.
+    bool FindNext(bool forward);
+    void ClearSearch();
+
+    const std::wstring& Needle() const
+    {
+        return needle_;
+    }
+    // Matching rows, ascending.
+    const std::vector<size_t>& Matches() const
+    {
+        return matches_;
+    }
+    // Index into Matches() of the selected match; npos if none.
+    size_t CurrentMatch() const
+    {
+        return current_match_;
+    }
+    bool IsCurrentMatch(size_t row) const
+    {
+        return current_match_ < matches_.size() && matches_[current_match_] == row;
+    }
+
+  private:
+    size_t MaxFirstRow() const;
+    // Scrolls the least distance that makes `row` visible.
+    void Reveal(size_t row);
+
+    std::vector<std::wstring> rows_;
+    std::vector<std::wstring> folded_args_; // lower-cased full arguments, for Find()
+    size_t page_rows_ = 1;
+    size_t first_row_ = 0;
+
+    std::wstring needle_;
+    std::vector<size_t> matches_;
+    size_t current_match_ = static_cast<size_t>(-1);
+};
+
+namespace arg_list_view::detail
+{
+
+// "<index + 1>: <FormatCliArg(arg)>", cut to `max_chars` with a trailing
+// ellipsis when longer.
+std::wstring FormatRow(size_t index, const std::wstring& arg, size_t max_chars);
+
+// Lower-cases `text` for case-insensitive matching.
+std::wstring Fold(const std::wstring& text);
+
+} // namespace arg_list_view::detail
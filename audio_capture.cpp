@@ -19,6 +19,10 @@
 #include <stdexcept>
 
 #include "log_manager.hpp"
+#include "metrics_export.hpp"
+#include "trace_events.hpp"
+
+static_assert(kMetricsMaxChannels == kMeterMaxChannels, "metrics export mirrors the meter's channel count");
 
 #pragma comment(lib, "ole32")
 #pragma comment(lib, "avrt")
@@ -141,75 +145,189 @@ float PeakPcm32(const BYTE* data, UINT32 total_samples)
     return peak;
 }
 
+PeakFn SelectPeakKernel(const SampleFormat& sf)
+{
+    return SelectPeakKernel(sf, DetectPeakIsa());
+}
+
 float PeakForFormat(const SampleFormat& sf, const BYTE* data, UINT32 total_samples)
 {
-    if (sf.tag == WAVE_FORMAT_IEEE_FLOAT && sf.bps == 32)
-        return PeakFloat32(data, total_samples);
-    if (sf.tag == WAVE_FORMAT_PCM && sf.bps == 16)
-        return PeakPcm16(data, total_samples);
-    if (sf.tag == WAVE_FORMAT_PCM && sf.bps == 24)
-        return PeakPcm24(data, total_samples);
-    if (sf.tag == WAVE_FORMAT_PCM && sf.bps == 32)
-        return PeakPcm32(data, total_samples);
+    if (PeakFn kernel = SelectPeakKernel(sf))
+        return kernel(data, total_samples);
 
     Log(L"Unsupported audio format: tag=" + std::to_wstring(sf.tag) + L", bps=" + std::to_wstring(sf.bps));
     return 0.f;
 }
 
+bool NeedsRebuild(const DeviceNotification& notification, bool have_stream)
+{
+    switch (notification.change)
+    {
+    case DeviceChange::DefaultChanged:
+        // Capture always opens the console default; the communications and
+        // multimedia roles and the render defaults do not affect it.
+        return notification.flow == eCapture && notification.role == eConsole;
+    case DeviceChange::StateChanged:
+        if (notification.is_current)
+            return notification.state != DEVICE_STATE_ACTIVE;
+        // Some endpoint came back while there is nothing to capture from; a
+        // rebuild that finds no default capture device is only a lookup.
+        return !have_stream && notification.state == DEVICE_STATE_ACTIVE;
+    case DeviceChange::Removed:
+        return notification.is_current;
+    }
+    return false;
+}
+
 } // namespace audio_capture::detail
 
+namespace
+{
+
+std::wstring HrToHex(HRESULT hr)
+{
+    wchar_t buf[16];
+    swprintf_s(buf, L"0x%08lX", static_cast<unsigned long>(hr));
+    return buf;
+}
+
+// Retry interval after a rebuild found the default endpoint but could not
+// open it (a virtual device still being set up, or one that is in use).
+constexpr DWORD kRebuildRetryMs = 500;
+
+} // namespace
+
+// Forwards endpoint notifications to the owning AudioCapture. The callbacks
+// arrive on an MMDevice thread and must not block, so they only compare the
+// endpoint id and wake the capture thread, which does the actual rebuild.
+class AudioCapture::DeviceListener final : public IMMNotificationClient
+{
+  public:
+    explicit DeviceListener(AudioCapture* owner) : owner_(owner)
+    {
+    }
+
+    ULONG STDMETHODCALLTYPE AddRef() override
+    {
+        return refs_.fetch_add(1) + 1;
+    }
+
+    ULONG STDMETHODCALLTYPE Release() override
+    {
+        const ULONG refs = refs_.fetch_sub(1) - 1;
+        if (refs == 0)
+            delete this;
+        return refs;
+    }
+
+    HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** object) override
+    {
+        if (!object)
+            return E_POINTER;
+        if (riid == __uuidof(IUnknown) || riid == __uuidof(IMMNotificationClient))
+        {
+            *object = static_cast<IMMNotificationClient*>(this);
+            AddRef();
+            return S_OK;
+        }
+        *object = nullptr;
+        return E_NOINTERFACE;
+    }
+
+    HRESULT STDMETHODCALLTYPE OnDefaultDeviceChanged(EDataFlow flow, ERole role, LPCWSTR) override
+    {
+        audio_capture::detail::DeviceNotification notification;
+        notification.change = audio_capture::detail::DeviceChange::DefaultChanged;
+        notification.flow = flow;
+        notification.role = role;
+        owner_->OnDeviceNotification(notification);
+        return S_OK;
+    }
+
+    HRESULT STDMETHODCALLTYPE OnDeviceStateChanged(LPCWSTR device_id, DWORD state) override
+    {
+        audio_capture::detail::DeviceNotification notification;
+        notification.change = audio_capture::detail::DeviceChange::StateChanged;
+        notification.state = state;
+        notification.is_current = owner_->IsCurrentDevice(device_id);
+        owner_->OnDeviceNotification(notification);
+        return S_OK;
+    }
+
+    HRESULT STDMETHODCALLTYPE OnDeviceRemoved(LPCWSTR device_id) override
+    {
+        audio_capture::detail::DeviceNotification notification;
+        notification.change = audio_capture::detail::DeviceChange::Removed;
+        notification.is_current = owner_->IsCurrentDevice(device_id);
+        owner_->OnDeviceNotification(notification);
+        return S_OK;
+    }
+
+    // A new endpoint is not the default yet; OnDefaultDeviceChanged follows
+    // if it becomes one.
+    HRESULT STDMETHODCALLTYPE OnDeviceAdded(LPCWSTR) override
+    {
+        return S_OK;
+    }
+
+    HRESULT STDMETHODCALLTYPE OnPropertyValueChanged(LPCWSTR, const PROPERTYKEY) override
+    {
+        return S_OK;
+    }
+
+  private:
+    std::atomic<ULONG> refs_{1};
+    AudioCapture* owner_;
+};
+
 AudioCapture::~AudioCapture()
 {
     Stop();
 
-    capture_client_.Reset();
-    audio_client_.Reset();
-    capture_device_.Reset();
+    ReleaseStream();
     device_enumerator_.Reset();
+}
 
-    if (mix_format_)
-    {
-        CoTaskMemFree(mix_format_);
-        mix_format_ = nullptr;
-    }
+std::wstring AudioCapture::Name() const
+{
+    AcquireSRWLockShared(&device_lock_);
+    std::wstring name = mic_name_;
+    ReleaseSRWLockShared(&device_lock_);
+    return name;
 }
 
 bool AudioCapture::Initialize()
 {
+    return Initialize(AudioCaptureOptions{});
+}
+
+bool AudioCapture::Initialize(const AudioCaptureOptions& options)
+{
+    options_ = options;
     try
     {
         AC_CALL(CoCreateInstance(__uuidof(MMDeviceEnumerator), nullptr, CLSCTX_ALL, IID_PPV_ARGS(&device_enumerator_)),
                 "IMMDeviceEnumerator failed");
-        AC_CALL(device_enumerator_->GetDefaultAudioEndpoint(eCapture, eConsole, capture_device_.GetAddressOf()),
-                "No default capture device");
 
-        ComPtr<IPropertyStore> store;
-        AC_CALL(capture_device_->OpenPropertyStore(STGM_READ, &store), "OpenPropertyStore failed");
-        PROPVARIANT pv;
-        PropVariantInit(&pv);
-        AC_CALL(store->GetValue(PKEY_Device_FriendlyName, &pv), "GetValue(FriendlyName) failed");
-        mic_name_ = pv.vt == VT_LPWSTR ? pv.pwszVal : L"Unknown microphone";
-        PropVariantClear(&pv);
+        audio_event_ = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+        stop_event_ = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+        device_event_ = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+        if (!audio_event_ || !stop_event_ || !device_event_)
+            throw std::runtime_error("Failed to create audio events");
 
+        OpenDefaultDevice();
         mic_available_ = true;
+        OpenStream();
 
-        AC_CALL(capture_device_->Activate(__uuidof(IAudioClient), CLSCTX_ALL, nullptr,
-                                          reinterpret_cast<void**>(audio_client_.GetAddressOf())),
-                "IAudioClient activate failed");
-
-        AC_CALL(audio_client_->GetMixFormat(&mix_format_), "GetMixFormat failed");
-
-        // 100ms buffer for smoother level visualisation.
-        REFERENCE_TIME buf_dur = 100 * 10000;
-        AC_CALL(audio_client_->Initialize(AUDCLNT_SHAREMODE_SHARED, AUDCLNT_STREAMFLAGS_EVENTCALLBACK, buf_dur, 0,
-                                          mix_format_, nullptr),
-                "AudioClient init failed");
-        AC_CALL(audio_client_->GetService(IID_PPV_ARGS(&capture_client_)), "GetService(IAudioCaptureClient)");
-
-        audio_event_ = CreateEventW(nullptr, FALSE, FALSE, nullptr);
-        if (!audio_event_)
-            throw std::runtime_error("Failed to create audio event");
-        audio_client_->SetEventHandle(audio_event_);
+        // Without notifications the stream still works; it just cannot
+        // follow the default device.
+        device_listener_.Attach(new DeviceListener(this));
+        const HRESULT notify_hr = device_enumerator_->RegisterEndpointNotificationCallback(device_listener_.Get());
+        if (FAILED(notify_hr))
+        {
+            Log(L"Audio: device change notifications unavailable, hr=" + HrToHex(notify_hr));
+            device_listener_.Reset();
+        }
 
         thread_running_.store(true);
         audio_thread_ = CreateThread(nullptr, 0, RawAudioThreadWithSEH, this, 0, nullptr);
@@ -230,14 +348,222 @@ bool AudioCapture::Initialize()
     }
 }
 
+// Opens the default console capture endpoint and records its name and id.
+// Throws when there is none.
+void AudioCapture::OpenDefaultDevice()
+{
+    AC_CALL(device_enumerator_->GetDefaultAudioEndpoint(eCapture, eConsole, capture_device_.ReleaseAndGetAddressOf()),
+            "No default capture device");
+
+    ComPtr<IPropertyStore> store;
+    AC_CALL(capture_device_->OpenPropertyStore(STGM_READ, &store), "OpenPropertyStore failed");
+    PROPVARIANT pv;
+    PropVariantInit(&pv);
+    AC_CALL(store->GetValue(PKEY_Device_FriendlyName, &pv), "GetValue(FriendlyName) failed");
+    std::wstring name = pv.vt == VT_LPWSTR ? pv.pwszVal : L"Unknown microphone";
+    PropVariantClear(&pv);
+
+    std::wstring id;
+    LPWSTR raw_id = nullptr;
+    if (SUCCEEDED(capture_device_->GetId(&raw_id)) && raw_id)
+    {
+        id = raw_id;
+        CoTaskMemFree(raw_id);
+    }
+
+    AcquireSRWLockExclusive(&device_lock_);
+    mic_name_ = std::move(name);
+    device_id_ = std::move(id);
+    ReleaseSRWLockExclusive(&device_lock_);
+}
+
+// Activates an audio client on capture_device_ and resolves everything that
+// depends on its mix format. Leaves the stream initialised but not started.
+void AudioCapture::OpenStream()
+{
+    AC_CALL(capture_device_->Activate(__uuidof(IAudioClient), CLSCTX_ALL, nullptr,
+                                      reinterpret_cast<void**>(audio_client_.ReleaseAndGetAddressOf())),
+            "IAudioClient activate failed");
+
+    AC_CALL(audio_client_->GetMixFormat(&mix_format_), "GetMixFormat failed");
+
+    // Parse the (possibly extensible) format and pick the peak kernel once
+    // per stream; the capture thread then never looks at the GUIDs again.
+    format_ = audio_capture::detail::ResolveFormat(mix_format_);
+    peak_fn_ = audio_capture::detail::SelectPeakKernel(format_);
+    if (!peak_fn_)
+        Log(L"Unsupported audio format: tag=" + std::to_wstring(format_.tag) +
+            L", bps=" + std::to_wstring(format_.bps) + L" (level meter will stay at 0)");
+    else
+        Log(std::wstring(L"Audio: peak kernel ") +
+            audio_capture::detail::PeakIsaName(audio_capture::detail::DetectPeakIsa()));
+
+    // Writer-side state only: the render thread keeps whatever snapshot was
+    // published last until the first packet of this stream.
+    meter_.Configure(format_, mix_format_->nSamplesPerSec);
+
+    InitializeClient();
+    AC_CALL(audio_client_->GetService(IID_PPV_ARGS(&capture_client_)), "GetService(IAudioCaptureClient)");
+    AC_CALL(audio_client_->SetEventHandle(audio_event_), "SetEventHandle failed");
+}
+
+void AudioCapture::ReleaseStream()
+{
+    if (audio_client_)
+        audio_client_->Stop();
+    capture_client_.Reset();
+    audio_client_.Reset();
+    capture_device_.Reset();
+    if (mix_format_)
+    {
+        CoTaskMemFree(mix_format_);
+        mix_format_ = nullptr;
+    }
+    peak_fn_ = nullptr;
+}
+
+// Capture thread only. Moves the stream to the current default capture
+// device, after a notification or an AUDCLNT_E_DEVICE_INVALIDATED. It runs
+// between two waits, so it never races the packet loop. IsAvailable() stays
+// true while a working device is swapped for another; the UI only sees the
+// generation bump and the new name.
+void AudioCapture::RebuildStream()
+{
+    const LONGLONG start_ms = static_cast<LONGLONG>(GetTickCount64());
+    const bool was_retrying = retry_rebuild_;
+    retry_rebuild_ = false;
+    ReleaseStream();
+
+    try
+    {
+        OpenDefaultDevice();
+    }
+    catch (const std::exception&)
+    {
+        // Nothing to capture from; the next notification tries again.
+        AcquireSRWLockExclusive(&device_lock_);
+        device_id_.clear();
+        ReleaseSRWLockExclusive(&device_lock_);
+        mic_available_ = false;
+        device_generation_.fetch_add(1, std::memory_order_release);
+        Log(L"Audio: no capture device; waiting for one to appear");
+        return;
+    }
+
+    try
+    {
+        OpenStream();
+        AC_CALL(audio_client_->Start(), "IAudioClient start failed");
+    }
+    catch (const std::exception& ex)
+    {
+        ReleaseStream();
+        retry_rebuild_ = true;
+        if (mic_available_.exchange(false))
+            device_generation_.fetch_add(1, std::memory_order_release);
+        if (!was_retrying)
+            Log(L"Audio: could not open " + Name() + L": " + std::wstring(ex.what(), ex.what() + strlen(ex.what())) +
+                L"; retrying every " + std::to_wstring(kRebuildRetryMs) + L" ms");
+        return;
+    }
+
+    stream_state_ = StreamState::Running;
+    mic_available_ = true;
+    device_generation_.fetch_add(1, std::memory_order_release);
+    Log(L"Audio: capturing from " + Name() + L" (rebuilt in " +
+        std::to_wstring(static_cast<LONGLONG>(GetTickCount64()) - start_ms) + L" ms)");
+}
+
+void AudioCapture::RequestRebuild()
+{
+    if (device_event_)
+        SetEvent(device_event_);
+}
+
+bool AudioCapture::IsCurrentDevice(LPCWSTR device_id) const
+{
+    if (!device_id)
+        return false;
+    AcquireSRWLockShared(&device_lock_);
+    const bool current = device_id_ == device_id;
+    ReleaseSRWLockShared(&device_lock_);
+    return current;
+}
+
+// Notification thread: decide, log, and hand the work to the capture thread.
+void AudioCapture::OnDeviceNotification(const audio_capture::detail::DeviceNotification& notification)
+{
+    if (!audio_capture::detail::NeedsRebuild(notification, mic_available_.load()))
+        return;
+    switch (notification.change)
+    {
+    case audio_capture::detail::DeviceChange::DefaultChanged:
+        Log(L"Audio: default capture device changed");
+        break;
+    case audio_capture::detail::DeviceChange::StateChanged:
+        Log(L"Audio: capture device state changed to " + std::to_wstring(notification.state));
+        break;
+    case audio_capture::detail::DeviceChange::Removed:
+        Log(L"Audio: capture device removed");
+        break;
+    }
+    RequestRebuild();
+}
+
+void AudioCapture::InitializeClient()
+{
+    if (options_.event_driven && options_.low_latency_period)
+    {
+        // Windows 10+: the shared-mode engine may offer periods below the
+        // default 10 ms. Use the smallest one it advertises for this format.
+        ComPtr<IAudioClient3> client3;
+        if (SUCCEEDED(audio_client_.As(&client3)))
+        {
+            UINT32 default_period = 0, fundamental = 0, min_period = 0, max_period = 0;
+            HRESULT hr =
+                client3->GetSharedModeEnginePeriod(mix_format_, &default_period, &fundamental, &min_period, &max_period);
+            if (SUCCEEDED(hr))
+                hr = client3->InitializeSharedAudioStream(AUDCLNT_STREAMFLAGS_EVENTCALLBACK, min_period, mix_format_,
+                                                          nullptr);
+            if (SUCCEEDED(hr))
+            {
+                Log(L"Audio: IAudioClient3 shared period " + std::to_wstring(min_period) + L" frames (default " +
+                    std::to_wstring(default_period) + L")");
+                return;
+            }
+            Log(L"Audio: IAudioClient3 low-latency init failed, hr=" + HrToHex(hr) + L"; using default period");
+        }
+        else
+        {
+            Log(L"Audio: IAudioClient3 unavailable; using default period");
+        }
+    }
+
+    // 100ms buffer for smoother level visualisation.
+    REFERENCE_TIME buf_dur = 100 * 10000;
+    AC_CALL(audio_client_->Initialize(AUDCLNT_SHAREMODE_SHARED, AUDCLNT_STREAMFLAGS_EVENTCALLBACK, buf_dur, 0,
+                                      mix_format_, nullptr),
+            "AudioClient init failed");
+}
+
 void AudioCapture::Stop(DWORD timeout_ms)
 {
+    // First, so no callback can signal an event that is about to close.
+    if (device_listener_)
+    {
+        device_enumerator_->UnregisterEndpointNotificationCallback(device_listener_.Get());
+        device_listener_.Reset();
+    }
+
     thread_running_.store(false);
-    if (audio_event_)
-        SetEvent(audio_event_);
+    if (stop_event_)
+        SetEvent(stop_event_);
 
     if (audio_thread_)
     {
+        // The thread waits on stop_event_ in both loops and a lost device is
+        // rebuilt rather than polled, so this returns within one wakeup.
+        // Termination is left for a driver call that never returns.
         DWORD wait_result = WaitForSingleObject(audio_thread_, timeout_ms);
         if (wait_result == WAIT_TIMEOUT)
         {
@@ -248,10 +574,13 @@ void AudioCapture::Stop(DWORD timeout_ms)
         audio_thread_ = nullptr;
     }
 
-    if (audio_event_)
+    for (HANDLE* event : {&audio_event_, &stop_event_, &device_event_})
     {
-        CloseHandle(audio_event_);
-        audio_event_ = nullptr;
+        if (*event)
+        {
+            CloseHandle(*event);
+            *event = nullptr;
+        }
     }
 
     if (audio_client_)
@@ -286,15 +615,55 @@ DWORD AudioCapture::ThreadMain()
         audio_client_->Start();
         Log(L"Audio capture thread started");
 
-        while (thread_running_.load())
+        // In priority order: Stop() wins over a pending rebuild, and a
+        // rebuild over the packets of a stream that is going away.
+        const HANDLE events[] = {stop_event_, device_event_, audio_event_};
+        constexpr DWORD kStopSignaled = WAIT_OBJECT_0;
+        constexpr DWORD kDeviceChanged = WAIT_OBJECT_0 + 1;
+        constexpr DWORD kAudioReady = WAIT_OBJECT_0 + 2;
+
+        // Event-driven engine: the WASAPI event fires once per engine period,
+        // so there is nothing to time out for (except a pending rebuild
+        // retry) and no per-wakeup logging.
+        while (options_.event_driven && thread_running_.load(std::memory_order_relaxed))
         {
-            DWORD wait = WaitForSingleObject(audio_event_, 200);
-            if (wait == WAIT_OBJECT_0)
+            const DWORD wait = WaitForMultipleObjects(3, events, FALSE, retry_rebuild_ ? kRebuildRetryMs : INFINITE);
+            if (wait == kStopSignaled)
+                break;
+            if (wait == kDeviceChanged || wait == WAIT_TIMEOUT)
+            {
+                RebuildStream();
+                continue;
+            }
+            if (wait != kAudioReady)
+            {
+                Log(L"Audio thread: wait failed, code=" + std::to_wstring(wait));
+                break;
+            }
+            DrainPackets();
+        }
+
+        while (!options_.event_driven && thread_running_.load())
+        {
+            DWORD wait = WaitForMultipleObjects(3, events, FALSE, retry_rebuild_ ? kRebuildRetryMs : 200);
+            if (wait == kStopSignaled)
+                break;
+            if (wait == kDeviceChanged)
+            {
+                RebuildStream();
+                continue;
+            }
+            if (wait == kAudioReady)
             {
                 Log(L"Audio thread: signal received");
             }
             else if (wait == WAIT_TIMEOUT)
             {
+                if (retry_rebuild_)
+                {
+                    RebuildStream();
+                    continue;
+                }
                 static ULONGLONG last_timeout_log = 0;
                 ULONGLONG now = GetTickCount64();
                 if (now - last_timeout_log > 30000)
@@ -311,7 +680,8 @@ DWORD AudioCapture::ThreadMain()
             PollOnce();
         }
 
-        audio_client_->Stop();
+        if (audio_client_)
+            audio_client_->Stop();
         Log(L"Audio capture thread stopped");
     }
     catch (const std::exception& ex)
@@ -341,6 +711,8 @@ void AudioCapture::PollOnce()
         if (FAILED(hr))
         {
             Log(L"PollMicrophone: Initial GetNextPacketSize failed, hr=0x" + std::to_wstring(hr));
+            if (hr == AUDCLNT_E_DEVICE_INVALIDATED)
+                RequestRebuild();
             return;
         }
         if (pkt_len == 0)
@@ -352,9 +724,12 @@ void AudioCapture::PollOnce()
             UINT32 frames = 0;
             DWORD flags = 0;
             hr = capture_client_->GetBuffer(&data, &frames, &flags, nullptr, nullptr);
+            trace_events::AudioGetBuffer(frames, flags, hr);
             if (FAILED(hr))
             {
                 Log(L"PollMicrophone: GetBuffer failed, hr=0x" + std::to_wstring(hr));
+                if (hr == AUDCLNT_E_DEVICE_INVALIDATED)
+                    RequestRebuild();
                 break;
             }
 
@@ -366,9 +741,7 @@ void AudioCapture::PollOnce()
                 break;
             }
 
-            float peak = ComputePeak(data, frames, flags);
-            float current_level = mic_level_.load();
-            mic_level_.store(current_level * 0.5f + peak * 0.5f);
+            ProcessPacket(data, frames, flags);
 
             if (!thread_running_.load())
             {
@@ -378,6 +751,7 @@ void AudioCapture::PollOnce()
             }
 
             hr = capture_client_->ReleaseBuffer(frames);
+            trace_events::AudioReleaseBuffer(frames, hr);
             if (FAILED(hr))
             {
                 Log(L"PollMicrophone: ReleaseBuffer failed, hr=0x" + std::to_wstring(hr));
@@ -408,21 +782,110 @@ void AudioCapture::PollOnce()
     }
 }
 
+void AudioCapture::SetStreamState(StreamState state, const wchar_t* what, HRESULT hr)
+{
+    if (state == stream_state_)
+        return;
+    stream_state_ = state;
+    if (state == StreamState::Failing)
+        Log(std::wstring(L"Audio capture: ") + what + L" failed, hr=" + HrToHex(hr));
+    else
+        Log(L"Audio capture: recovered");
+}
+
+void AudioCapture::DrainPackets()
+{
+    if (!capture_client_)
+        return;
+
+    // GetBuffer reports AUDCLNT_S_BUFFER_EMPTY once the queue is drained, so
+    // no separate GetNextPacketSize round trip is needed per packet.
+    while (thread_running_.load(std::memory_order_relaxed))
+    {
+        BYTE* data = nullptr;
+        UINT32 frames = 0;
+        DWORD flags = 0;
+        HRESULT hr = capture_client_->GetBuffer(&data, &frames, &flags, nullptr, nullptr);
+        if (hr == AUDCLNT_S_BUFFER_EMPTY)
+            break;
+        trace_events::AudioGetBuffer(frames, flags, hr);
+        if (FAILED(hr))
+        {
+            // Typically AUDCLNT_E_DEVICE_INVALIDATED; logged once, not per
+            // event, and the stream is rebuilt on the next wakeup.
+            SetStreamState(StreamState::Failing, L"GetBuffer", hr);
+            if (hr == AUDCLNT_E_DEVICE_INVALIDATED)
+                RequestRebuild();
+            return;
+        }
+
+        if (data && frames > 0)
+            ProcessPacket(data, frames, flags);
+
+        hr = capture_client_->ReleaseBuffer(frames);
+        trace_events::AudioReleaseBuffer(frames, hr);
+        if (FAILED(hr))
+        {
+            SetStreamState(StreamState::Failing, L"ReleaseBuffer", hr);
+            if (hr == AUDCLNT_E_DEVICE_INVALIDATED)
+                RequestRebuild();
+            return;
+        }
+    }
+    SetStreamState(StreamState::Running, nullptr, S_OK);
+}
+
+void AudioCapture::ProcessPacket(const BYTE* data, UINT32 frames, DWORD flags)
+{
+    const float peak = ComputePeak(data, frames, flags);
+    mic_level_.store(mic_level_.load(std::memory_order_relaxed) * 0.5f + peak * 0.5f, std::memory_order_relaxed);
+    meter_.Process(data, frames, (flags & AUDCLNT_BUFFERFLAGS_SILENT) != 0);
+    if (metrics_)
+        PublishMetrics();
+}
+
+void AudioCapture::PublishMetrics()
+{
+    MetricsAudioSection audio{};
+    LARGE_INTEGER now{};
+    QueryPerformanceCounter(&now);
+    audio.packets = meter_.Packets();
+    audio.qpc = now.QuadPart;
+    audio.channels = meter_.Channels();
+    audio.level = mic_level_.load(std::memory_order_relaxed);
+    const ChannelLevel* levels = meter_.Levels();
+    for (UINT32 c = 0; c < kMeterMaxChannels; ++c)
+    {
+        audio.peak[c] = levels[c].peak;
+        audio.rms[c] = levels[c].rms;
+    }
+    // Once a second is plenty for a CPU-time counter, and keeps the syscall
+    // off the per-packet path.
+    const LONGLONG frequency = metrics_->Block() ? metrics_->Block()->qpc_frequency : 0;
+    if (frequency > 0 && now.QuadPart - metrics_cpu_qpc_ >= frequency)
+    {
+        FILETIME created{}, exited{}, kernel{}, user{};
+        if (GetThreadTimes(GetCurrentThread(), &created, &exited, &kernel, &user))
+        {
+            const auto ticks = [](const FILETIME& t) { return (uint64_t{t.dwHighDateTime} << 32) | t.dwLowDateTime; };
+            thread_cpu_100ns_ = ticks(kernel) + ticks(user);
+        }
+        metrics_cpu_qpc_ = now.QuadPart;
+    }
+    audio.thread_cpu_100ns = thread_cpu_100ns_;
+    metrics_->PublishAudio(audio);
+}
+
 float AudioCapture::ComputePeak(const BYTE* data, UINT32 frames, DWORD flags) const
 {
-    if ((flags & AUDCLNT_BUFFERFLAGS_SILENT) || !data || !mix_format_)
+    if ((flags & AUDCLNT_BUFFERFLAGS_SILENT) || !data || !peak_fn_)
         return 0.f;
 
-    using namespace audio_capture::detail;
-    const SampleFormat sf = ResolveFormat(mix_format_);
-
-    UINT64 total64 = static_cast<UINT64>(frames) * static_cast<UINT64>(sf.channels);
+    UINT64 total64 = static_cast<UINT64>(frames) * static_cast<UINT64>(format_.channels);
     if (total64 > UINT32_MAX)
     {
         Log(L"Sample count overflow: " + std::to_wstring(total64));
         return 0.f;
     }
-    const UINT32 total_samples = static_cast<UINT32>(total64);
-
-    return PeakForFormat(sf, data, total_samples);
+    return peak_fn_(data, static_cast<UINT32>(total64));
 }
@@ -7,17 +7,75 @@
 // clang-format on
 
 #include <atomic>
+#include <cstdint>
 #include <string>
 
 #include <wrl/client.h>
 
+#include "audio_meter.hpp"
+
+class MetricsExport;
+
+namespace audio_capture::detail
+{
+
+struct SampleFormat
+{
+    WORD tag;
+    WORD bps;
+    UINT32 channels;
+};
+
+// Peak of |sample| over `total_samples` interleaved samples, in [0, 1].
+using PeakFn = float (*)(const BYTE* data, UINT32 total_samples);
+
+// One IMMNotificationClient callback, reduced to what NeedsRebuild() needs.
+enum class DeviceChange
+{
+    DefaultChanged, // OnDefaultDeviceChanged
+    StateChanged,   // OnDeviceStateChanged
+    Removed,        // OnDeviceRemoved
+};
+
+struct DeviceNotification
+{
+    DeviceChange change = DeviceChange::DefaultChanged;
+    EDataFlow flow = eCapture; // DefaultChanged only
+    ERole role = eConsole;     // DefaultChanged only
+    DWORD state = 0;           // StateChanged only: DEVICE_STATE_*
+    bool is_current = false;   // the endpoint is the one being captured
+};
+
+} // namespace audio_capture::detail
+
+struct AudioCaptureOptions
+{
+    // false: the original loop (200 ms wait timeout, GetNextPacketSize
+    // polling, a log line per wakeup and per benign condition).
+    // true: block on the WASAPI event with no timeout, drain packets until
+    // AUDCLNT_S_BUFFER_EMPTY, and log only when the capture state changes.
+    bool event_driven = false;
+
+    // Event-driven only: initialise through IAudioClient3 with the engine's
+    // minimum shared-mode period when available (lower latency, more
+    // wakeups). Falls back to IAudioClient::Initialize otherwise.
+    bool low_latency_period = false;
+};
+
 // WASAPI microphone capture in shared mode with event-driven pumping on its
 // own background thread. The thread body is reached through seh_wrapper.cpp
 // so that SEH faults in the audio stack (e.g. device disconnect during
 // GetBuffer) can be turned into a logged termination instead of crashing
 // the process.
 //
-// Ownership: the object owns the thread, the event handle and all COM
+// Device changes: an IMMNotificationClient watches the default console
+// capture endpoint. When it changes, or the endpoint in use goes away, the
+// capture thread rebuilds the stream in place (re-activate, re-resolve the
+// format, swap the peak kernel) instead of failing every GetBuffer. The meter
+// publishes nothing meanwhile, so the render thread keeps drawing the last
+// snapshot until the new device delivers its first packet.
+//
+// Ownership: the object owns the thread, the event handles and all COM
 // interfaces. Destruction calls Stop() — callers usually prefer to call
 // Stop() explicitly on shutdown so they can observe any failure.
 class AudioCapture
@@ -33,10 +91,12 @@ class AudioCapture
     // returns false on failure instead of throwing — a missing microphone
     // must not take down the rest of the UI.
     bool Initialize();
+    bool Initialize(const AudioCaptureOptions& options);
 
-    // Cooperatively stop the capture thread. Signals the event, waits for
-    // the thread with the given timeout, and (as a last resort) terminates
-    // it. Safe to call multiple times and from the destructor.
+    // Cooperatively stop the capture thread. Signals a dedicated stop event,
+    // so the thread leaves its wait at once even with the device gone, waits
+    // for it with the given timeout, and (only if a driver call hangs)
+    // terminates it. Safe to call multiple times and from the destructor.
     void Stop(DWORD timeout_ms = 5000);
 
     bool IsAvailable() const
@@ -47,9 +107,28 @@ class AudioCapture
     {
         return mic_level_.load();
     }
-    const std::wstring& Name() const
+    // Friendly name of the device in use. A copy: the capture thread
+    // replaces it when it moves to another device.
+    std::wstring Name() const;
+    // Incremented by the capture thread whenever the device, and with it
+    // Name() or IsAvailable(), changes. Lets the UI refresh its title
+    // without polling the name.
+    uint32_t DeviceGeneration() const
     {
-        return mic_name_;
+        return device_generation_.load(std::memory_order_acquire);
+    }
+    // Per-channel levels and waveform history. Render thread only (the
+    // meter has a single reader); never blocks the capture thread.
+    const MeterSnapshot& Meter()
+    {
+        return meter_.Latest();
+    }
+
+    // Publish levels into `metrics` from the capture thread after every
+    // packet. Call before Initialize(); `metrics` must outlive Stop().
+    void SetMetricsExport(MetricsExport* metrics)
+    {
+        metrics_ = metrics;
     }
 
     // Entry point invoked by the SEH wrapper in seh_wrapper.cpp.
@@ -57,20 +136,64 @@ class AudioCapture
     DWORD ThreadMain();
 
   private:
+    // Capture health as seen by the event-driven loop; a log line is written
+    // only when this changes.
+    enum class StreamState
+    {
+        Running,
+        Failing,
+    };
+
+    class DeviceListener;
+
+    void OpenDefaultDevice();
+    void OpenStream();
+    void InitializeClient();
+    void ReleaseStream();
+    void RebuildStream();
+    void RequestRebuild();
+    bool IsCurrentDevice(LPCWSTR device_id) const;
+    void OnDeviceNotification(const audio_capture::detail::DeviceNotification& notification);
     void PollOnce();
+    void DrainPackets();
+    void SetStreamState(StreamState state, const wchar_t* what, HRESULT hr);
     float ComputePeak(const BYTE* data, UINT32 frames, DWORD flags) const;
+    void ProcessPacket(const BYTE* data, UINT32 frames, DWORD flags);
+    void PublishMetrics();
 
     Microsoft::WRL::ComPtr<IMMDeviceEnumerator> device_enumerator_;
     Microsoft::WRL::ComPtr<IMMDevice> capture_device_;
     Microsoft::WRL::ComPtr<IAudioClient> audio_client_;
     Microsoft::WRL::ComPtr<IAudioCaptureClient> capture_client_;
+    Microsoft::WRL::ComPtr<IMMNotificationClient> device_listener_;
     WAVEFORMATEX* mix_format_ = nullptr;
+    AudioCaptureOptions options_;
+    // Resolved in Initialize() and again on every rebuild; peak_fn_ is null
+    // for unsupported formats.
+    audio_capture::detail::SampleFormat format_{};
+    audio_capture::detail::PeakFn peak_fn_ = nullptr;
+    StreamState stream_state_ = StreamState::Running;
     HANDLE audio_event_ = nullptr;
+    HANDLE stop_event_ = nullptr;   // manual reset, set by Stop()
+    HANDLE device_event_ = nullptr; // auto reset, set by RequestRebuild()
     HANDLE audio_thread_ = nullptr;
+    // Capture thread only: the last rebuild failed with a device present, so
+    // the loop retries on a timer instead of waiting for a notification.
+    bool retry_rebuild_ = false;
     std::atomic<float> mic_level_{0.f};
+    AudioMeter meter_;
+    MetricsExport* metrics_ = nullptr;
+    // Capture thread only: last GetThreadTimes sample for metrics_.
+    LONGLONG metrics_cpu_qpc_ = 0;
+    uint64_t thread_cpu_100ns_ = 0;
     std::atomic<bool> mic_available_{false};
     std::atomic<bool> thread_running_{false};
+    std::atomic<uint32_t> device_generation_{0};
+    // Guards mic_name_ and device_id_, written by whichever thread opens the
+    // device and read by the UI and by the notification callbacks.
+    mutable SRWLOCK device_lock_ = SRWLOCK_INIT;
     std::wstring mic_name_;
+    std::wstring device_id_;
 };
 
 // Pure DSP helpers. Deliberately exposed so unit tests can exercise them
@@ -78,13 +201,6 @@ class AudioCapture
 namespace audio_capture::detail
 {
 
-struct SampleFormat
-{
-    WORD tag;
-    WORD bps;
-    UINT32 channels;
-};
-
 SampleFormat ResolveFormat(const WAVEFORMATEX* mix);
 
 float PeakFloat32(const BYTE* data, UINT32 total_samples);
@@ -93,4 +209,31 @@ float PeakPcm24(const BYTE* data, UINT32 total_samples);
 float PeakPcm32(const BYTE* data, UINT32 total_samples);
 float PeakForFormat(const SampleFormat& sf, const BYTE* data, UINT32 total_samples);
 
+// Kernel for `sf`, or nullptr when the format is not supported. Resolved once
+// per stream so the capture thread does not re-dispatch on every packet.
+// Uses the best instruction set DetectPeakIsa() reports.
+PeakFn SelectPeakKernel(const SampleFormat& sf);
+
+// Vectorised kernels (audio_peak_kernels.cpp). Each one returns exactly what
+// the scalar Peak* reference above returns for the same samples.
+enum class PeakIsa
+{
+    Scalar,
+    Sse2,
+    Avx2,
+    Neon,
+};
+
+PeakIsa DetectPeakIsa();
+bool IsPeakIsaAvailable(PeakIsa isa);
+const wchar_t* PeakIsaName(PeakIsa isa);
+// nullptr when the format is unsupported or `isa` is not available here.
+PeakFn SelectPeakKernel(const SampleFormat& sf, PeakIsa isa);
+
+// Whether a device notification means the stream must be rebuilt: the
+// default console capture endpoint moved, the endpoint in use was disabled,
+// unplugged or removed, or an endpoint became active while there is no
+// stream at all. `have_stream` is false after the device was lost.
+bool NeedsRebuild(const DeviceNotification& notification, bool have_stream);
+
 } // namespace audio_capture::detail
@@ -0,0 +1,196 @@
+#ifndef UNICODE
+#define UNICODE
+#define _UNICODE
+#endif
+
+#include "audio_meter.hpp"
+
+#include <mmreg.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "audio_capture.hpp"
+
+namespace
+{
+
+// Conversions match the scalar peak kernels in audio_capture.cpp, so the
+// meter's peak is the same number Level() is derived from.
+float LoadFloat32(const BYTE* p)
+{
+    float v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+float LoadPcm16(const BYTE* p)
+{
+    int16_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v / 32768.0f;
+}
+
+float LoadPcm24(const BYTE* p)
+{
+    int32_t sample = (p[0] << 8) | (p[1] << 16) | (p[2] << 24);
+    sample >>= 8;
+    return sample / 8388608.0f;
+}
+
+float LoadPcm32(const BYTE* p)
+{
+    int32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v / 2147483648.0f;
+}
+
+float ClampLevel(float v)
+{
+    // Also maps NaN (from a float stream) to the clamp value rather than
+    // letting it poison the smoothed level forever.
+    return v < AudioMeter::kMaxLevel ? v : AudioMeter::kMaxLevel;
+}
+
+} // namespace
+
+void AudioMeter::Configure(const audio_capture::detail::SampleFormat& format, UINT32 sample_rate)
+{
+    if (format.tag == WAVE_FORMAT_IEEE_FLOAT && format.bps == 32)
+        encoding_ = Encoding::Float32;
+    else if (format.tag == WAVE_FORMAT_PCM && format.bps == 16)
+        encoding_ = Encoding::Pcm16;
+    else if (format.tag == WAVE_FORMAT_PCM && format.bps == 24)
+        encoding_ = Encoding::Pcm24;
+    else if (format.tag == WAVE_FORMAT_PCM && format.bps == 32)
+        encoding_ = Encoding::Pcm32;
+    else
+        encoding_ = Encoding::Unsupported;
+
+    channels_ = format.channels ? format.channels : 1;
+    tracked_channels_ = (std::min)(channels_, kMeterMaxChannels);
+    frames_per_point_ = sample_rate / (1000 / kMeterHistoryPointMs);
+    if (frames_per_point_ == 0)
+        frames_per_point_ = 1;
+
+    for (ChannelLevel& level : levels_)
+        level = ChannelLevel{};
+    for (WaveformPoint& point : block_)
+        point = WaveformPoint{};
+    block_frames_ = 0;
+    history_head_ = 0;
+    history_length_ = 0;
+    packets_ = 0;
+}
+
+template <typename Load>
+void AudioMeter::Accumulate(const BYTE* data, UINT32 frames, UINT32 bytes_per_sample, Load load)
+{
+    const size_t frame_bytes = static_cast<size_t>(channels_) * bytes_per_sample;
+    const UINT32 waveform_channels = (std::min)(tracked_channels_, kMeterWaveformChannels);
+
+    for (UINT32 f = 0; f < frames; ++f)
+    {
+        const BYTE* frame = data + f * frame_bytes;
+        for (UINT32 c = 0; c < tracked_channels_; ++c)
+        {
+            const float v = load(frame + c * bytes_per_sample);
+            const float a = v < 0 ? -v : v;
+            if (a > packet_peak_[c])
+                packet_peak_[c] = a;
+            // NaN and infinities stay out of the sums (NaN compares false).
+            if (a <= kMaxLevel)
+                packet_sum_squares_[c] += static_cast<double>(v) * v;
+            if (c < waveform_channels)
+            {
+                if (v < block_[c].min)
+                    block_[c].min = v;
+                if (v > block_[c].max)
+                    block_[c].max = v;
+            }
+        }
+        if (++block_frames_ == frames_per_point_)
+            PushHistoryPoint();
+    }
+}
+
+void AudioMeter::AccumulateSilence(UINT32 frames)
+{
+    // Zeros do not move peak, sums or the block envelope; only the block
+    // clock advances.
+    while (frames > 0)
+    {
+        const UINT32 step = (std::min)(frames, frames_per_point_ - block_frames_);
+        block_frames_ += step;
+        frames -= step;
+        if (block_frames_ == frames_per_point_)
+            PushHistoryPoint();
+    }
+}
+
+void AudioMeter::PushHistoryPoint()
+{
+    for (UINT32 c = 0; c < kMeterWaveformChannels; ++c)
+    {
+        history_[c][history_head_] = block_[c];
+        block_[c] = WaveformPoint{};
+    }
+    history_head_ = (history_head_ + 1) % kMeterHistoryLength;
+    if (history_length_ < kMeterHistoryLength)
+        ++history_length_;
+    block_frames_ = 0;
+}
+
+void AudioMeter::Process(const BYTE* data, UINT32 frames, bool silent)
+{
+    if (encoding_ == Encoding::Unsupported || frames == 0)
+        return;
+
+    for (UINT32 c = 0; c < tracked_channels_; ++c)
+    {
+        packet_peak_[c] = 0.f;
+        packet_sum_squares_[c] = 0.0;
+    }
+
+    if (silent || !data)
+        AccumulateSilence(frames);
+    else if (encoding_ == Encoding::Float32)
+        Accumulate(data, frames, 4, LoadFloat32);
+    else if (encoding_ == Encoding::Pcm16)
+        Accumulate(data, frames, 2, LoadPcm16);
+    else if (encoding_ == Encoding::Pcm24)
+        Accumulate(data, frames, 3, LoadPcm24);
+    else
+        Accumulate(data, frames, 4, LoadPcm32);
+
+    // Same per-packet smoothing as AudioCapture::Level().
+    for (UINT32 c = 0; c < tracked_channels_; ++c)
+    {
+        const float peak = ClampLevel(packet_peak_[c]);
+        const float rms = ClampLevel(static_cast<float>(std::sqrt(packet_sum_squares_[c] / frames)));
+        levels_[c].peak = levels_[c].peak * 0.5f + peak * 0.5f;
+        levels_[c].rms = levels_[c].rms * 0.5f + rms * 0.5f;
+    }
+    ++packets_;
+    PublishSnapshot();
+}
+
+void AudioMeter::PublishSnapshot()
+{
+    MeterSnapshot& out = snapshots_.Back();
+    out.channels = channels_;
+    for (UINT32 c = 0; c < kMeterMaxChannels; ++c)
+        out.levels[c] = levels_[c];
+
+    // Linearise the ring so the reader can walk it oldest-first.
+    out.history_length = history_length_;
+    const UINT32 first = (history_head_ + kMeterHistoryLength - history_length_) % kMeterHistoryLength;
+    for (UINT32 c = 0; c < kMeterWaveformChannels; ++c)
+    {
+        for (UINT32 i = 0; i < history_length_; ++i)
+            out.history[c][i] = history_[c][(first + i) % kMeterHistoryLength];
+    }
+    out.packets = packets_;
+    snapshots_.Publish();
+}
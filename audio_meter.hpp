@@ -0,0 +1,157 @@
+#pragma once
+
+#include <windows.h>
+
+#include <atomic>
+#include <cstdint>
+
+// Per-channel level metering for the capture stream. The capture thread runs
+// one pass over each interleaved WASAPI packet, computing peak and RMS for
+// every tracked channel plus a decimated min/max envelope of the first two
+// channels. The render thread reads the result through a triple buffer, so
+// neither side ever blocks or retries and a snapshot is never torn.
+//
+//   AudioMeter::Configure() - once per stream, before the capture thread runs.
+//   AudioMeter::Process()   - capture thread, once per packet; publishes.
+//   AudioMeter::Latest()    - render thread (single reader).
+
+namespace audio_capture::detail
+{
+struct SampleFormat;
+}
+
+// Single-writer / single-reader triple buffer. The writer fills Back() and
+// Publish()es it; the reader's Latest() swaps in the newest published slot
+// if there is one. Both sides are wait-free.
+template <typename T> class TripleBuffer
+{
+  public:
+    // Writer side. The slot holds whatever was there two publishes ago, so
+    // the writer must fill it completely.
+    T& Back()
+    {
+        return slots_[back_];
+    }
+    void Publish()
+    {
+        const uint8_t previous = middle_.exchange(static_cast<uint8_t>(back_ | kFresh), std::memory_order_acq_rel);
+        back_ = static_cast<uint8_t>(previous & kIndexMask);
+    }
+
+    // Reader side. The reference stays valid until the next Latest() call.
+    const T& Latest()
+    {
+        if (middle_.load(std::memory_order_relaxed) & kFresh)
+            front_ = static_cast<uint8_t>(middle_.exchange(front_, std::memory_order_acq_rel) & kIndexMask);
+        return slots_[front_];
+    }
+
+  private:
+    static constexpr uint8_t kIndexMask = 0x3;
+    static constexpr uint8_t kFresh = 0x4;
+
+    T slots_[3]{};
+    std::atomic<uint8_t> middle_{1};
+    uint8_t back_ = 0;  // writer only
+    uint8_t front_ = 2; // reader only
+};
+
+constexpr UINT32 kMeterMaxChannels = 8;
+constexpr UINT32 kMeterWaveformChannels = 2;
+constexpr UINT32 kMeterHistoryLength = 128;
+// Each history point covers this much audio (128 points ~ 1.3 s).
+constexpr UINT32 kMeterHistoryPointMs = 10;
+
+struct ChannelLevel
+{
+    float peak = 0.f; // smoothed max |sample|, 1.0 = full scale
+    float rms = 0.f;  // smoothed per-packet RMS
+};
+
+struct WaveformPoint
+{
+    float min = 0.f; // most negative sample in the block
+    float max = 0.f; // most positive sample in the block
+};
+
+struct MeterSnapshot
+{
+    // Channels in the stream; levels are tracked for the first
+    // kMeterMaxChannels of them. 0 until the first packet arrives.
+    UINT32 channels = 0;
+    ChannelLevel levels[kMeterMaxChannels]{};
+    // Oldest first; the newest point is at history_length - 1.
+    UINT32 history_length = 0;
+    WaveformPoint history[kMeterWaveformChannels][kMeterHistoryLength]{};
+    // Incremented per published packet.
+    UINT64 packets = 0;
+};
+
+class AudioMeter
+{
+  public:
+    // Levels beyond this (about +12 dBFS on float streams) are clamped so a
+    // burst of garbage samples cannot stick in the smoothed values.
+    static constexpr float kMaxLevel = 4.0f;
+
+    // Clears all levels and history. Unsupported formats leave the meter at 0.
+    void Configure(const audio_capture::detail::SampleFormat& format, UINT32 sample_rate);
+
+    // `silent` mirrors AUDCLNT_BUFFERFLAGS_SILENT: the packet counts as zeros.
+    void Process(const BYTE* data, UINT32 frames, bool silent);
+
+    const MeterSnapshot& Latest()
+    {
+        return snapshots_.Latest();
+    }
+
+    // Writer-side view of the current levels, for publishing from the
+    // capture thread itself. Capture thread only.
+    UINT32 Channels() const
+    {
+        return channels_;
+    }
+    const ChannelLevel* Levels() const
+    {
+        return levels_;
+    }
+    UINT64 Packets() const
+    {
+        return packets_;
+    }
+
+  private:
+    enum class Encoding
+    {
+        Unsupported,
+        Float32,
+        Pcm16,
+        Pcm24,
+        Pcm32,
+    };
+
+    template <typename Load> void Accumulate(const BYTE* data, UINT32 frames, UINT32 bytes_per_sample, Load load);
+    void AccumulateSilence(UINT32 frames);
+    void PushHistoryPoint();
+    void PublishSnapshot();
+
+    Encoding encoding_ = Encoding::Unsupported;
+    UINT32 channels_ = 0;
+    UINT32 tracked_channels_ = 0;
+    UINT32 frames_per_point_ = 1;
+
+    // Per-packet accumulators.
+    float packet_peak_[kMeterMaxChannels]{};
+    double packet_sum_squares_[kMeterMaxChannels]{};
+
+    // Running state.
+    ChannelLevel levels_[kMeterMaxChannels]{};
+    WaveformPoint block_[kMeterWaveformChannels]{};
+    UINT32 block_frames_ = 0;
+    WaveformPoint history_[kMeterWaveformChannels][kMeterHistoryLength]{};
+    UINT32 history_head_ = 0; // next slot to write
+    UINT32 history_length_ = 0;
+    UINT64 packets_ = 0;
+
+    TripleBuffer<MeterSnapshot> snapshots_;
+};
@@ -0,0 +1,484 @@
+#ifndef UNICODE
+#define UNICODE
+#define _UNICODE
+#endif
+
+// Vectorised peak kernels for audio_capture::detail. Every kernel returns
+// exactly what the scalar reference in audio_capture.cpp returns for the
+// same input (tests/audio_peak_tests.cpp checks this bit for bit):
+//
+//   - Integer formats track the largest and smallest raw sample and convert
+//     once at the end. The scalar loops divide by a power of two, which is
+//     exact, so max(|s|) / 2^N equals max(|s| / 2^N).
+//   - PCM32 converts to float first, as the scalar loop does, because
+//     int32 -> float rounds and the rounded value is what gets compared.
+//   - Float32 keeps the scalar NaN behaviour: a NaN sample never replaces the
+//     running peak (`v > peak` is false), which _mm_max_ps(v, peak) and a
+//     compare-and-select on NEON both reproduce.
+//
+// AVX2 is chosen at runtime (cpu_dispatch.hpp); SSE2 is the x86/x64 baseline
+// and NEON is mandatory on ARM64 and ARM64EC, so neither needs detection.
+
+#include "audio_capture.hpp"
+
+#include <mmreg.h>
+
+#include <cstdint>
+
+#include "cpu_dispatch.hpp"
+
+#if defined(CPU_DISPATCH_X86)
+#define PEAK_X86 1
+#include <immintrin.h>
+#elif defined(CPU_DISPATCH_NEON)
+#define PEAK_NEON 1
+#include <arm_neon.h>
+#endif
+
+#define PEAK_TARGET_AVX2 CPU_TARGET_AVX2
+
+namespace audio_capture::detail
+{
+namespace
+{
+
+// Largest |sample| of the 16/24-bit kernels, scaled like the reference.
+float AbsToPeak(int32_t max_value, int32_t min_value, float scale)
+{
+    const int64_t hi = max_value > 0 ? max_value : 0;
+    const int64_t lo = min_value < 0 ? -static_cast<int64_t>(min_value) : 0;
+    return static_cast<float>(hi > lo ? hi : lo) / scale;
+}
+
+// Shared scalar tails. These mirror the reference loops so the few samples
+// left over after the vector body cannot change the result.
+void TailFloat(const float* samples, UINT32 begin, UINT32 end, float& peak)
+{
+    for (UINT32 i = begin; i < end; ++i)
+    {
+        float v = samples[i];
+        if (v < 0)
+            v = -v;
+        if (v > peak)
+            peak = v;
+    }
+}
+
+void TailPcm16(const int16_t* samples, UINT32 begin, UINT32 end, int32_t& max_value, int32_t& min_value)
+{
+    for (UINT32 i = begin; i < end; ++i)
+    {
+        max_value = samples[i] > max_value ? samples[i] : max_value;
+        min_value = samples[i] < min_value ? samples[i] : min_value;
+    }
+}
+
+int32_t LoadPcm24(const uint8_t* p)
+{
+    int32_t sample = (p[0] << 8) | (p[1] << 16) | (p[2] << 24);
+    return sample >> 8;
+}
+
+void TailPcm24(const uint8_t* p, UINT32 begin, UINT32 end, int32_t& max_value, int32_t& min_value)
+{
+    for (UINT32 i = begin; i < end; ++i)
+    {
+        const int32_t sample = LoadPcm24(p + 3 * i);
+        max_value = sample > max_value ? sample : max_value;
+        min_value = sample < min_value ? sample : min_value;
+    }
+}
+
+void TailPcm32(const int32_t* samples, UINT32 begin, UINT32 end, float& peak)
+{
+    for (UINT32 i = begin; i < end; ++i)
+    {
+        float v = static_cast<float>(samples[i]);
+        if (v < 0)
+            v = -v;
+        if (v > peak)
+            peak = v;
+    }
+}
+
+#if defined(PEAK_X86)
+
+float HorizontalMax(__m128 v)
+{
+    v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+    v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtss_f32(v);
+}
+
+int32_t HorizontalMaxEpi16(__m128i v)
+{
+    v = _mm_max_epi16(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+    v = _mm_max_epi16(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+    v = _mm_max_epi16(v, _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1)));
+    return static_cast<int16_t>(_mm_cvtsi128_si32(v));
+}
+
+int32_t HorizontalMinEpi16(__m128i v)
+{
+    v = _mm_min_epi16(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+    v = _mm_min_epi16(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+    v = _mm_min_epi16(v, _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1)));
+    return static_cast<int16_t>(_mm_cvtsi128_si32(v));
+}
+
+// ---------------------------------------------------------------------------
+// SSE2
+// ---------------------------------------------------------------------------
+
+float PeakFloat32Sse2(const BYTE* data, UINT32 total_samples)
+{
+    const auto* samples = reinterpret_cast<const float*>(data);
+    const __m128 sign = _mm_set1_ps(-0.0f);
+    __m128 peak0 = _mm_setzero_ps();
+    __m128 peak1 = _mm_setzero_ps();
+    UINT32 i = 0;
+    for (; i + 8 <= total_samples; i += 8)
+    {
+        // Operand order matters: MAXPS returns the second operand when the
+        // first is NaN, which keeps the running peak like the scalar loop.
+        peak0 = _mm_max_ps(_mm_andnot_ps(sign, _mm_loadu_ps(samples + i)), peak0);
+        peak1 = _mm_max_ps(_mm_andnot_ps(sign, _mm_loadu_ps(samples + i + 4)), peak1);
+    }
+    float peak = HorizontalMax(_mm_max_ps(peak0, peak1));
+    TailFloat(samples, i, total_samples, peak);
+    return peak;
+}
+
+float PeakPcm16Sse2(const BYTE* data, UINT32 total_samples)
+{
+    const auto* samples = reinterpret_cast<const int16_t*>(data);
+    __m128i max_v = _mm_setzero_si128();
+    __m128i min_v = _mm_setzero_si128();
+    UINT32 i = 0;
+    for (; i + 8 <= total_samples; i += 8)
+    {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(samples + i));
+        max_v = _mm_max_epi16(max_v, v);
+        min_v = _mm_min_epi16(min_v, v);
+    }
+    int32_t max_value = HorizontalMaxEpi16(max_v);
+    int32_t min_value = HorizontalMinEpi16(min_v);
+    TailPcm16(samples, i, total_samples, max_value, min_value);
+    return AbsToPeak(max_value, min_value, 32768.0f);
+}
+
+float PeakPcm24Sse2(const BYTE* data, UINT32 total_samples)
+{
+    // Unpacking 3-byte samples needs PSHUFB (SSSE3). On plain SSE2 use the
+    // branch-free min/max loop, which still drops the per-sample float work.
+    int32_t max_value = 0;
+    int32_t min_value = 0;
+    TailPcm24(reinterpret_cast<const uint8_t*>(data), 0, total_samples, max_value, min_value);
+    return AbsToPeak(max_value, min_value, 8388608.0f);
+}
+
+float PeakPcm32Sse2(const BYTE* data, UINT32 total_samples)
+{
+    const auto* samples = reinterpret_cast<const int32_t*>(data);
+    const __m128 sign = _mm_set1_ps(-0.0f);
+    __m128 peak_v = _mm_setzero_ps();
+    UINT32 i = 0;
+    for (; i + 4 <= total_samples; i += 4)
+    {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(samples + i));
+        peak_v = _mm_max_ps(_mm_andnot_ps(sign, _mm_cvtepi32_ps(v)), peak_v);
+    }
+    float peak = HorizontalMax(peak_v);
+    TailPcm32(samples, i, total_samples, peak);
+    return peak / 2147483648.0f;
+}
+
+// ---------------------------------------------------------------------------
+// AVX2
+// ---------------------------------------------------------------------------
+
+PEAK_TARGET_AVX2 float PeakFloat32Avx2(const BYTE* data, UINT32 total_samples)
+{
+    const auto* samples = reinterpret_cast<const float*>(data);
+    const __m256 sign = _mm256_set1_ps(-0.0f);
+    __m256 peak0 = _mm256_setzero_ps();
+    __m256 peak1 = _mm256_setzero_ps();
+    UINT32 i = 0;
+    for (; i + 16 <= total_samples; i += 16)
+    {
+        peak0 = _mm256_max_ps(_mm256_andnot_ps(sign, _mm256_loadu_ps(samples + i)), peak0);
+        peak1 = _mm256_max_ps(_mm256_andnot_ps(sign, _mm256_loadu_ps(samples + i + 8)), peak1);
+    }
+    const __m256 peak_v = _mm256_max_ps(peak0, peak1);
+    float peak = HorizontalMax(_mm_max_ps(_mm256_castps256_ps128(peak_v), _mm256_extractf128_ps(peak_v, 1)));
+    TailFloat(samples, i, total_samples, peak);
+    return peak;
+}
+
+PEAK_TARGET_AVX2 float PeakPcm16Avx2(const BYTE* data, UINT32 total_samples)
+{
+    const auto* samples = reinterpret_cast<const int16_t*>(data);
+    __m256i max_v = _mm256_setzero_si256();
+    __m256i min_v = _mm256_setzero_si256();
+    UINT32 i = 0;
+    for (; i + 16 <= total_samples; i += 16)
+    {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(samples + i));
+        max_v = _mm256_max_epi16(max_v, v);
+        min_v = _mm256_min_epi16(min_v, v);
+    }
+    int32_t max_value =
+        HorizontalMaxEpi16(_mm_max_epi16(_mm256_castsi256_si128(max_v), _mm256_extracti128_si256(max_v, 1)));
+    int32_t min_value =
+        HorizontalMinEpi16(_mm_min_epi16(_mm256_castsi256_si128(min_v), _mm256_extracti128_si256(min_v, 1)));
+    TailPcm16(samples, i, total_samples, max_value, min_value);
+    return AbsToPeak(max_value, min_value, 32768.0f);
+}
+
+PEAK_TARGET_AVX2 float PeakPcm24Avx2(const BYTE* data, UINT32 total_samples)
+{
+    const auto* p = reinterpret_cast<const uint8_t*>(data);
+    // Eight samples (24 bytes) per iteration: move bytes 12..23 into the
+    // upper lane, then place each sample in the top three bytes of a dword
+    // and shift right arithmetically to sign-extend, as LoadPcm24 does.
+    const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 3, 4, 5, 6);
+    const __m256i spread = _mm256_setr_epi8(-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, //
+                                            -1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11);
+    __m256i max_v = _mm256_setzero_si256();
+    __m256i min_v = _mm256_setzero_si256();
+    UINT32 i = 0;
+    // The 32-byte load reads 8 bytes past the eight samples it uses, so keep
+    // at least three more samples in the buffer.
+    for (; i + 11 <= total_samples; i += 8)
+    {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 3 * i));
+        v = _mm256_permutevar8x32_epi32(v, lanes);
+        v = _mm256_srai_epi32(_mm256_shuffle_epi8(v, spread), 8);
+        max_v = _mm256_max_epi32(max_v, v);
+        min_v = _mm256_min_epi32(min_v, v);
+    }
+
+    int32_t max_lanes[8];
+    int32_t min_lanes[8];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(max_lanes), max_v);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(min_lanes), min_v);
+    int32_t max_value = 0;
+    int32_t min_value = 0;
+    for (int lane = 0; lane < 8; ++lane)
+    {
+        max_value = max_lanes[lane] > max_value ? max_lanes[lane] : max_value;
+        min_value = min_lanes[lane] < min_value ? min_lanes[lane] : min_value;
+    }
+    TailPcm24(p, i, total_samples, max_value, min_value);
+    return AbsToPeak(max_value, min_value, 8388608.0f);
+}
+
+PEAK_TARGET_AVX2 float PeakPcm32Avx2(const BYTE* data, UINT32 total_samples)
+{
+    const auto* samples = reinterpret_cast<const int32_t*>(data);
+    const __m256 sign = _mm256_set1_ps(-0.0f);
+    __m256 peak_v = _mm256_setzero_ps();
+    UINT32 i = 0;
+    for (; i + 8 <= total_samples; i += 8)
+    {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(samples + i));
+        peak_v = _mm256_max_ps(_mm256_andnot_ps(sign, _mm256_cvtepi32_ps(v)), peak_v);
+    }
+    float peak = HorizontalMax(_mm_max_ps(_mm256_castps256_ps128(peak_v), _mm256_extractf128_ps(peak_v, 1)));
+    TailPcm32(samples, i, total_samples, peak);
+    return peak / 2147483648.0f;
+}
+
+
+#elif defined(PEAK_NEON)
+
+// ---------------------------------------------------------------------------
+// NEON
+// ---------------------------------------------------------------------------
+
+float PeakFloat32Neon(const BYTE* data, UINT32 total_samples)
+{
+    const auto* samples = reinterpret_cast<const float*>(data);
+    float32x4_t peak0 = vdupq_n_f32(0.f);
+    float32x4_t peak1 = vdupq_n_f32(0.f);
+    UINT32 i = 0;
+    for (; i + 8 <= total_samples; i += 8)
+    {
+        // FMAX propagates NaN; compare-and-select keeps the scalar rule.
+        const float32x4_t v0 = vabsq_f32(vld1q_f32(samples + i));
+        const float32x4_t v1 = vabsq_f32(vld1q_f32(samples + i + 4));
+        peak0 = vbslq_f32(vcgtq_f32(v0, peak0), v0, peak0);
+        peak1 = vbslq_f32(vcgtq_f32(v1, peak1), v1, peak1);
+    }
+    float peak = vmaxvq_f32(vmaxq_f32(peak0, peak1));
+    TailFloat(samples, i, total_samples, peak);
+    return peak;
+}
+
+float PeakPcm16Neon(const BYTE* data, UINT32 total_samples)
+{
+    const auto* samples = reinterpret_cast<const int16_t*>(data);
+    int16x8_t max_v = vdupq_n_s16(0);
+    int16x8_t min_v = vdupq_n_s16(0);
+    UINT32 i = 0;
+    for (; i + 8 <= total_samples; i += 8)
+    {
+        const int16x8_t v = vld1q_s16(samples + i);
+        max_v = vmaxq_s16(max_v, v);
+        min_v = vminq_s16(min_v, v);
+    }
+    int32_t max_value = vmaxvq_s16(max_v);
+    int32_t min_value = vminvq_s16(min_v);
+    TailPcm16(samples, i, total_samples, max_value, min_value);
+    return AbsToPeak(max_value, min_value, 32768.0f);
+}
+
+int32x4_t MakePcm24(int16x4_t high, uint8x8_t low_bytes_half, bool upper)
+{
+    const uint16x8_t low16 = vmovl_u8(low_bytes_half);
+    const uint32x4_t low32 = upper ? vmovl_high_u16(low16) : vmovl_u16(vget_low_u16(low16));
+    return vorrq_s32(vshll_n_s16(high, 8), vreinterpretq_s32_u32(low32));
+}
+
+float PeakPcm24Neon(const BYTE* data, UINT32 total_samples)
+{
+    const auto* p = reinterpret_cast<const uint8_t*>(data);
+    int32x4_t max_v = vdupq_n_s32(0);
+    int32x4_t min_v = vdupq_n_s32(0);
+    UINT32 i = 0;
+    for (; i + 16 <= total_samples; i += 16)
+    {
+        // LD3 de-interleaves 16 samples into low, middle and high bytes.
+        const uint8x16x3_t v = vld3q_u8(p + 3 * i);
+        const int16x8_t high_lo = vreinterpretq_s16_u8(vzip1q_u8(v.val[1], v.val[2]));
+        const int16x8_t high_hi = vreinterpretq_s16_u8(vzip2q_u8(v.val[1], v.val[2]));
+        const int32x4_t s0 = MakePcm24(vget_low_s16(high_lo), vget_low_u8(v.val[0]), false);
+        const int32x4_t s1 = MakePcm24(vget_high_s16(high_lo), vget_low_u8(v.val[0]), true);
+        const int32x4_t s2 = MakePcm24(vget_low_s16(high_hi), vget_high_u8(v.val[0]), false);
+        const int32x4_t s3 = MakePcm24(vget_high_s16(high_hi), vget_high_u8(v.val[0]), true);
+        max_v = vmaxq_s32(vmaxq_s32(max_v, s0), vmaxq_s32(vmaxq_s32(s1, s2), s3));
+        min_v = vminq_s32(vminq_s32(min_v, s0), vminq_s32(vminq_s32(s1, s2), s3));
+    }
+    int32_t max_value = vmaxvq_s32(max_v);
+    int32_t min_value = vminvq_s32(min_v);
+    TailPcm24(p, i, total_samples, max_value, min_value);
+    return AbsToPeak(max_value, min_value, 8388608.0f);
+}
+
+float PeakPcm32Neon(const BYTE* data, UINT32 total_samples)
+{
+    const auto* samples = reinterpret_cast<const int32_t*>(data);
+    float32x4_t peak_v = vdupq_n_f32(0.f);
+    UINT32 i = 0;
+    for (; i + 4 <= total_samples; i += 4)
+    {
+        // Integer input cannot produce NaN, so a plain FMAX is exact here.
+        peak_v = vmaxq_f32(peak_v, vabsq_f32(vcvtq_f32_s32(vld1q_s32(samples + i))));
+    }
+    float peak = vmaxvq_f32(peak_v);
+    TailPcm32(samples, i, total_samples, peak);
+    return peak / 2147483648.0f;
+}
+
+#endif
+
+// Per-ISA tables, indexed by KernelSlot(): float32, pcm16, pcm24, pcm32.
+constexpr PeakFn kScalarKernels[] = {PeakFloat32, PeakPcm16, PeakPcm24, PeakPcm32};
+#if defined(PEAK_X86)
+constexpr PeakFn kSse2Kernels[] = {PeakFloat32Sse2, PeakPcm16Sse2, PeakPcm24Sse2, PeakPcm32Sse2};
+constexpr PeakFn kAvx2Kernels[] = {PeakFloat32Avx2, PeakPcm16Avx2, PeakPcm24Avx2, PeakPcm32Avx2};
+#elif defined(PEAK_NEON)
+constexpr PeakFn kNeonKernels[] = {PeakFloat32Neon, PeakPcm16Neon, PeakPcm24Neon, PeakPcm32Neon};
+#endif
+
+// Index into the kernel tables above, or -1 when unsupported.
+int KernelSlot(const SampleFormat& sf)
+{
+    if (sf.tag == WAVE_FORMAT_IEEE_FLOAT && sf.bps == 32)
+        return 0;
+    if (sf.tag == WAVE_FORMAT_PCM && sf.bps == 16)
+        return 1;
+    if (sf.tag == WAVE_FORMAT_PCM && sf.bps == 24)
+        return 2;
+    if (sf.tag == WAVE_FORMAT_PCM && sf.bps == 32)
+        return 3;
+    return -1;
+}
+
+PeakIsa DetectPeakIsaOnce()
+{
+#if defined(PEAK_X86)
+    return cpu_dispatch::HasAvx2() ? PeakIsa::Avx2 : PeakIsa::Sse2;
+#elif defined(PEAK_NEON)
+    return PeakIsa::Neon;
+#else
+    return PeakIsa::Scalar;
+#endif
+}
+
+} // namespace
+
+PeakIsa DetectPeakIsa()
+{
+    static const PeakIsa isa = DetectPeakIsaOnce();
+    return isa;
+}
+
+bool IsPeakIsaAvailable(PeakIsa isa)
+{
+    switch (isa)
+    {
+    case PeakIsa::Scalar:
+        return true;
+#if defined(PEAK_X86)
+    case PeakIsa::Sse2:
+        return true;
+    case PeakIsa::Avx2:
+        return DetectPeakIsa() == PeakIsa::Avx2;
+#elif defined(PEAK_NEON)
+    case PeakIsa::Neon:
+        return true;
+#endif
+    default:
+        return false;
+    }
+}
+
+const wchar_t* PeakIsaName(PeakIsa isa)
+{
+    switch (isa)
+    {
+    case PeakIsa::Sse2:
+        return L"SSE2";
+    case PeakIsa::Avx2:
+        return L"AVX2";
+    case PeakIsa::Neon:
+        return L"NEON";
+    default:
+        return L"scalar";
+    }
+}
+
+PeakFn SelectPeakKernel(const SampleFormat& sf, PeakIsa isa)
+{
+    const int kind = KernelSlot(sf);
+    if (kind < 0 || !IsPeakIsaAvailable(isa))
+        return nullptr;
+
+    switch (isa)
+    {
+#if defined(PEAK_X86)
+    case PeakIsa::Sse2:
+        return kSse2Kernels[kind];
+    case PeakIsa::Avx2:
+        return kAvx2Kernels[kind];
+#elif defined(PEAK_NEON)
+    case PeakIsa::Neon:
+        return kNeonKernels[kind];
+#endif
+    default:
+        return kScalarKernels[kind];
+    }
+}
+
+} // namespace audio_capture::detail
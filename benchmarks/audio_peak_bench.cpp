@@ -0,0 +1,152 @@
+// Peak detection over one WASAPI packet's worth of samples, per format and
+// kernel. Sizes cover a 10 ms stereo packet at 48 kHz (960 samples) up to a
+// 100 ms 8-channel virtual cable buffer (38400 samples).
+
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+// clang-format off
+#include <windows.h>
+#include <mmreg.h>
+// clang-format on
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../audio_capture.hpp"
+#include "../audio_meter.hpp"
+
+using audio_capture::detail::PeakFn;
+using audio_capture::detail::PeakForFormat;
+using audio_capture::detail::PeakIsa;
+using audio_capture::detail::SampleFormat;
+using audio_capture::detail::SelectPeakKernel;
+
+namespace
+{
+
+// Random bytes are valid samples for every integer format; float buffers get
+// proper values so NaN handling does not skew the numbers.
+std::vector<BYTE> MakeBuffer(const SampleFormat& sf, size_t samples)
+{
+    std::mt19937 rng(42);
+    std::vector<BYTE> bytes(samples * (sf.bps / 8));
+    if (sf.tag == WAVE_FORMAT_IEEE_FLOAT)
+    {
+        std::uniform_real_distribution<float> dist(-1.f, 1.f);
+        auto* f = reinterpret_cast<float*>(bytes.data());
+        for (size_t i = 0; i < samples; ++i)
+            f[i] = dist(rng);
+    }
+    else
+    {
+        std::uniform_int_distribution<int> dist(0, 255);
+        for (BYTE& b : bytes)
+            b = static_cast<BYTE>(dist(rng));
+    }
+    return bytes;
+}
+
+constexpr SampleFormat kFormats[] = {
+    {WAVE_FORMAT_IEEE_FLOAT, 32, 1},
+    {WAVE_FORMAT_PCM, 16, 1},
+    {WAVE_FORMAT_PCM, 24, 1},
+    {WAVE_FORMAT_PCM, 32, 1},
+};
+
+const char* FormatName(const SampleFormat& sf)
+{
+    if (sf.tag == WAVE_FORMAT_IEEE_FLOAT)
+        return "float32";
+    return sf.bps == 16 ? "pcm16" : sf.bps == 24 ? "pcm24" : "pcm32";
+}
+
+const char* IsaName(PeakIsa isa)
+{
+    switch (isa)
+    {
+    case PeakIsa::Sse2:
+        return "sse2";
+    case PeakIsa::Avx2:
+        return "avx2";
+    case PeakIsa::Neon:
+        return "neon";
+    default:
+        return "scalar";
+    }
+}
+
+// Labels end up in the JSON output, so results stay readable without
+// decoding the numeric arguments.
+void SetPeakLabel(benchmark::State& state, const SampleFormat& sf, PeakIsa isa)
+{
+    state.SetLabel(std::string(FormatName(sf)) + "/" + IsaName(isa));
+}
+
+// Arg 0: index into kFormats. Arg 1: samples per call.
+void BM_PeakForFormat(benchmark::State& state)
+{
+    const SampleFormat& sf = kFormats[state.range(0)];
+    const auto samples = static_cast<UINT32>(state.range(1));
+    const std::vector<BYTE> buf = MakeBuffer(sf, samples);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(PeakForFormat(sf, buf.data(), samples));
+    state.SetItemsProcessed(state.iterations() * samples);
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(buf.size()));
+    SetPeakLabel(state, sf, audio_capture::detail::DetectPeakIsa());
+}
+
+// Same, pinned to one instruction set.
+void BM_PeakKernel(benchmark::State& state, SampleFormat sf, PeakIsa isa)
+{
+    const auto samples = static_cast<UINT32>(state.range(0));
+    const PeakFn kernel = SelectPeakKernel(sf, isa);
+    const std::vector<BYTE> buf = MakeBuffer(sf, samples);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(kernel(buf.data(), samples));
+    state.SetItemsProcessed(state.iterations() * samples);
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(buf.size()));
+    SetPeakLabel(state, sf, isa);
+}
+
+// One BM_PeakKernel/<isa>/<format> per kernel this CPU can run, so the JSON
+// output carries no skipped entries and runs from different machines line
+// up by name.
+const bool kPeakKernelsRegistered = []
+{
+    for (PeakIsa isa : {PeakIsa::Scalar, PeakIsa::Sse2, PeakIsa::Avx2, PeakIsa::Neon})
+    {
+        if (!audio_capture::detail::IsPeakIsaAvailable(isa))
+            continue;
+        for (const SampleFormat& sf : kFormats)
+        {
+            const std::string name = std::string("BM_PeakKernel/") + IsaName(isa) + "/" + FormatName(sf);
+            benchmark::RegisterBenchmark(name.c_str(), BM_PeakKernel, sf, isa)->Arg(960)->Arg(38400);
+        }
+    }
+    return true;
+}();
+
+// Per-channel meter pass for an 8-channel float stream (the hot path on
+// virtual audio cables). Arg 0: frames per packet.
+void BM_AudioMeterProcess(benchmark::State& state)
+{
+    const SampleFormat sf{WAVE_FORMAT_IEEE_FLOAT, 32, 8};
+    const auto frames = static_cast<UINT32>(state.range(0));
+    const std::vector<BYTE> buf = MakeBuffer(sf, static_cast<size_t>(frames) * sf.channels);
+    AudioMeter meter;
+    meter.Configure(sf, 48000);
+    for (auto _ : state)
+        meter.Process(buf.data(), frames, false);
+    state.SetItemsProcessed(state.iterations() * frames * sf.channels);
+}
+
+} // namespace
+
+BENCHMARK(BM_PeakForFormat)->ArgsProduct({{0, 1, 2, 3}, {960, 3840, 38400}});
+BENCHMARK(BM_AudioMeterProcess)->Arg(480)->Arg(4800);
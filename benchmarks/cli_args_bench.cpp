@@ -0,0 +1,104 @@
+// Argument formatting and UTF-8 conversion, which run on startup and for
+// every QR payload. Launchers routinely pass hundreds of arguments, many of
+// them quoted paths.
+
+#include <windows.h>
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+#include "../arg_list_view.hpp"
+#include "../cli_args_display.hpp"
+#include "../utf8_convert.hpp"
+
+// Defined in cli_args_debugger.cpp.
+extern std::string wstring_to_string(const std::wstring& wstr);
+
+namespace
+{
+
+// Arg 0: number of arguments. Arg 1: 1 if every other one needs quoting.
+std::vector<std::wstring> MakeArgs(size_t count, bool quoted)
+{
+    std::vector<std::wstring> args;
+    args.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (quoted && i % 2)
+            args.push_back(L"--path=C:\\Program Files\\Game " + std::to_wstring(i) + L"\\bin");
+        else
+            args.push_back(L"--flag" + std::to_wstring(i) + L"=value");
+    }
+    return args;
+}
+
+void BM_BuildCliArgsText(benchmark::State& state)
+{
+    const std::vector<std::wstring> args = MakeArgs(static_cast<size_t>(state.range(0)), state.range(1) != 0);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(BuildCliArgsText(args));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Row formatting and search index for the HUD's argument list; runs once.
+void BM_ArgListViewSetArgs(benchmark::State& state)
+{
+    const std::vector<std::wstring> args = MakeArgs(static_cast<size_t>(state.range(0)), true);
+    ArgListView view;
+    for (auto _ : state)
+    {
+        view.SetArgs(args);
+        benchmark::DoNotOptimize(view.RowCount());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// "find": one pass over every argument.
+void BM_ArgListViewFind(benchmark::State& state)
+{
+    ArgListView view;
+    view.SetArgs(MakeArgs(static_cast<size_t>(state.range(0)), true));
+    view.SetPageRows(20);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(view.Find(L"GAME 1"));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Arg 0: characters. Arg 1: 1 for non-ASCII text (Cyrillic, multi-byte UTF-8).
+void BM_WstringToString(benchmark::State& state)
+{
+    const auto length = static_cast<size_t>(state.range(0));
+    const std::wstring text(length, state.range(1) ? L'\x0436' : L'a');
+    for (auto _ : state)
+        benchmark::DoNotOptimize(wstring_to_string(text));
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(length * sizeof(wchar_t)));
+}
+
+// The QR, log and headless path: appending into one reused buffer. Arg 0:
+// characters. Arg 1: 0 for ASCII, 1 for Cyrillic, 2 for ASCII with one
+// non-ASCII character every 32 (a localized path).
+void BM_Utf8Append(benchmark::State& state)
+{
+    const auto length = static_cast<size_t>(state.range(0));
+    std::wstring text(length, state.range(1) == 1 ? L'\x0436' : L'a');
+    if (state.range(1) == 2)
+        for (size_t i = 31; i < length; i += 32)
+            text[i] = L'\x00e9';
+    std::string out;
+    for (auto _ : state)
+    {
+        utf8_convert::Assign(text.data(), text.size(), out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(length * sizeof(wchar_t)));
+}
+
+} // namespace
+
+BENCHMARK(BM_BuildCliArgsText)->ArgsProduct({{8, 256, 4096}, {0, 1}});
+BENCHMARK(BM_ArgListViewSetArgs)->Arg(8)->Arg(256)->Arg(4096);
+BENCHMARK(BM_ArgListViewFind)->Arg(8)->Arg(256)->Arg(4096);
+BENCHMARK(BM_WstringToString)->ArgsProduct({{64, 4096, 65536}, {0, 1}});
+BENCHMARK(BM_Utf8Append)->ArgsProduct({{64, 4096, 65536}, {0, 1, 2}});
@@ -0,0 +1,50 @@
+// Log() throughput with 1..8 threads logging at once, for the synchronous
+// (fflush per line) and asynchronous (lock-free ring + writer thread) modes.
+// Writes to the real log file, like tests/logging_tests.cpp.
+
+#include <windows.h>
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+
+#include "../log_manager.hpp"
+
+namespace
+{
+
+// Arg 0: LogWriteMode. Thread 0 owns the logger's lifetime: Google Benchmark
+// holds every thread at a barrier before and after the timed loop, so no
+// thread logs before InitLogger() or after CloseLogger().
+void BM_LogContention(benchmark::State& state)
+{
+    if (state.thread_index() == 0)
+    {
+        LoggerOptions options;
+        options.mode = static_cast<LogWriteMode>(state.range(0));
+        InitLogger(options);
+    }
+
+    const std::wstring line = L"benchmark: thread " + std::to_wstring(state.thread_index()) +
+                              L" RenderFrame: Present FPS=60, frame p50=16.67ms p99=17.10ms";
+    for (auto _ : state)
+        Log(line);
+    state.SetItemsProcessed(state.iterations());
+
+    if (state.thread_index() == 0)
+    {
+        // Charge the final drain to the run so async mode cannot hide its
+        // backlog, then release the file for the next run.
+        FlushLogger();
+        CloseLogger();
+    }
+    state.SetLabel(state.range(0) == static_cast<int64_t>(LogWriteMode::Async) ? "async" : "sync");
+}
+
+} // namespace
+
+BENCHMARK(BM_LogContention)
+    ->Arg(static_cast<int64_t>(LogWriteMode::Sync))
+    ->Arg(static_cast<int64_t>(LogWriteMode::Async))
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
@@ -0,0 +1,114 @@
+// QR payload encoding and rasterisation as done by QrWorker, plus the plain
+// QrCode::encodeText baseline. Args payloads range from none to the largest
+// that still fits a version-40 symbol at ECC MEDIUM.
+
+#include <windows.h>
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../hud_batch.hpp"
+#include "../qr_worker.hpp"
+#include "qrcodegen.hpp"
+
+using qrcodegen::QrCode;
+
+namespace
+{
+
+std::string MakeArgsSuffix(size_t length)
+{
+    if (length == 0)
+        return std::string();
+    std::string suffix = ";args=";
+    while (suffix.size() < length)
+        suffix += "--flag" + std::to_string(suffix.size()) + " ";
+    suffix.resize(length);
+    return suffix;
+}
+
+QrStamp MakeStamp(unsigned long long frame)
+{
+    QrStamp stamp;
+    stamp.unix_time = 1760400000;
+    stamp.fps = 60;
+    stamp.frame = frame;
+    stamp.qpc = 123456789012LL + static_cast<long long>(frame) * 166667;
+    return stamp;
+}
+
+// Arg 0: args suffix length in bytes.
+void BM_QrEncodeText(benchmark::State& state)
+{
+    const std::string payload = qr_worker::detail::BuildStampPayload(MakeStamp(1)) +
+                                MakeArgsSuffix(static_cast<size_t>(state.range(0)));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(QrCode::encodeText(payload.c_str(), QrCode::Ecc::MEDIUM));
+}
+
+// The worker's per-update path: rebuild only the stamp segment.
+void BM_QrEncodePayload(benchmark::State& state)
+{
+    const auto args_segments =
+        qr_worker::detail::MakeByteSegments(MakeArgsSuffix(static_cast<size_t>(state.range(0))));
+    const int min_version = qr_worker::detail::StableMinVersion(args_segments);
+    unsigned long long frame = 0;
+    for (auto _ : state)
+        benchmark::DoNotOptimize(qr_worker::detail::EncodePayload(MakeStamp(++frame), args_segments, min_version));
+}
+
+// Start()'s split of an oversized args suffix into chunk payloads.
+void BM_QrSplitArgsPayload(benchmark::State& state)
+{
+    const std::string suffix = MakeArgsSuffix(static_cast<size_t>(state.range(0)));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(qr_worker::detail::SplitArgsPayload(suffix));
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void BM_QrRasterize(benchmark::State& state)
+{
+    const auto args_segments =
+        qr_worker::detail::MakeByteSegments(MakeArgsSuffix(static_cast<size_t>(state.range(0))));
+    const QrCode qr =
+        qr_worker::detail::EncodePayload(MakeStamp(1), args_segments, qr_worker::detail::StableMinVersion(args_segments));
+    std::vector<uint32_t> pixels;
+    for (auto _ : state)
+    {
+        qr_worker::detail::RasterizeQr(qr, QrWorker::kPixelSize, pixels);
+        benchmark::DoNotOptimize(pixels.data());
+    }
+    state.SetLabel("version " + std::to_string(qr.getVersion()));
+}
+
+// --hud=gpu: turning a freshly rasterised code into HUD quads, once per QR
+// update.
+void BM_QrImageQuads(benchmark::State& state)
+{
+    const auto args_segments =
+        qr_worker::detail::MakeByteSegments(MakeArgsSuffix(static_cast<size_t>(state.range(0))));
+    const QrCode qr =
+        qr_worker::detail::EncodePayload(MakeStamp(1), args_segments, qr_worker::detail::StableMinVersion(args_segments));
+    std::vector<uint32_t> pixels;
+    qr_worker::detail::RasterizeQr(qr, QrWorker::kPixelSize, pixels);
+    std::vector<HudQuad> quads(HudBatch::kDefaultCapacity);
+    size_t count = 0;
+    for (auto _ : state)
+    {
+        count = hud_batch::detail::BuildImageQuads(pixels.data(), QrWorker::kPixelSize, QrWorker::kPixelSize,
+                                                   {0.0f, 0.0f, 0.0f, 1.0f}, quads.data(), quads.size());
+        benchmark::DoNotOptimize(quads.data());
+    }
+    state.SetLabel("version " + std::to_string(qr.getVersion()) + ", " + std::to_string(count) + " quads");
+}
+
+} // namespace
+
+BENCHMARK(BM_QrEncodeText)->Arg(0)->Arg(256)->Arg(1024)->Arg(2048);
+BENCHMARK(BM_QrEncodePayload)->Arg(0)->Arg(256)->Arg(1024)->Arg(2048);
+BENCHMARK(BM_QrSplitArgsPayload)->Arg(2048)->Arg(8192)->Arg(32768);
+BENCHMARK(BM_QrRasterize)->Arg(0)->Arg(256)->Arg(2048);
+BENCHMARK(BM_QrImageQuads)->Arg(0)->Arg(256)->Arg(2048);
@@ -34,8 +34,8 @@
 #include <ctime>
 #include <d2d1.h>
 #include <d3d11.h>
-#include <d3dcompiler.h>
 #include <dwrite.h>
+#include <dxgi1_5.h> // IDXGIFactory5 (tearing), IDXGISwapChain2 (latency waitable)
 #include <excpt.h> // For SEH exception handling
 #include <fstream>
 #include <iomanip> // For setw/setfill
@@ -45,7 +45,6 @@
 #include <psapi.h>    // For GetProcessMemoryInfo
 #include <share.h>    // For _wfsopen share flags
 #include <shlobj.h>
-#include <sstream>
 #include <stdexcept>
 #include <string>
 #include <thread>
@@ -76,7 +75,7 @@
 #pragma comment(lib, "d2d1")
 #pragma comment(lib, "dwrite")
 #pragma comment(lib, "d3d11")
-#pragma comment(lib, "d3dcompiler")
+#pragma comment(lib, "dxgi")
 #pragma comment(lib, "ole32")
 #pragma comment(lib, "avrt")
 #pragma comment(lib, "user32")  // For window functions
@@ -85,6 +84,28 @@
 #pragma comment(lib, "winmm")   // For PlaySound
 #pragma comment(lib, "psapi")   // For GetProcessMemoryInfo
 
+// Shaders from shaders/cube.hlsl and shaders/hud.hlsl. Normally fxc compiles
+// them into bytecode headers at build time (g_cube_vs / g_cube_ps, g_hud_vs /
+// g_hud_ps), so neither startup nor device-lost recovery loads
+// d3dcompiler_47.dll. RUNTIME_SHADER_COMPILE instead compiles the .hlsl files
+// on every device creation: a debug fallback for editing shaders without
+// rebuilding, and for builds without fxc.
+#ifdef RUNTIME_SHADER_COMPILE
+#include <d3dcompiler.h>
+#pragma comment(lib, "d3dcompiler")
+#ifndef CUBE_SHADER_PATH
+#define CUBE_SHADER_PATH L"shaders\\cube.hlsl"
+#endif
+#ifndef HUD_SHADER_PATH
+#define HUD_SHADER_PATH L"shaders\\hud.hlsl"
+#endif
+#else
+#include "cube_ps.h"
+#include "cube_vs.h"
+#include "hud_ps.h"
+#include "hud_vs.h"
+#endif
+
 // Include QrCodeGen (ensure that qrcodegen.hpp and qrcodegen.cpp are in your project)
 #include "qrcodegen.hpp"
 using qrcodegen::QrCode;
@@ -93,13 +114,70 @@ using qrcodegen::QrCode;
 // seh_wrapper) can link against the same instance.
 #include "log_manager.hpp"
 
+// Debugger-specific command-line switches (--async-log, ...).
+#include "app_options.hpp"
+
+// QPC + waitable-timer frame pacing for the message loop.
+#include "frame_pacer.hpp"
+
+// Per-section frame timings and percentile summaries.
+#include "frame_stats.hpp"
+
+// Retained DirectWrite layouts for overlay text.
+#include "text_layout_cache.hpp"
+
+// Scrollable, searchable one-row-per-argument list for large command lines.
+#include "arg_list_view.hpp"
+
+// Low-power mode: skip frames when nothing visible changed.
+#include "idle_render.hpp"
+
+// QR encoding and rasterisation off the render thread.
+#include "qr_worker.hpp"
+
 // Path/env inspection (executable path, OS version, Wine/Proton, etc.)
 #include "path_info.hpp"
 
+// Background path_info collection, read by the render thread as snapshots.
+#include "path_info_cache.hpp"
+
+// --headless JSON report (no window, device or audio).
+#include "headless_report.hpp"
+
 // WASAPI microphone capture (owns its own thread, COM objects, and level
 // smoothing). See audio_capture.hpp for the public contract.
 #include "audio_capture.hpp"
 
+// Background threads for startup work that does not need the window.
+#include "startup_tasks.hpp"
+
+// Backward tail reader and live-follow for the "logs" panel.
+#include "log_tail.hpp"
+
+// Seqlock-published live metrics in shared memory for monitoring agents.
+#include "metrics_export.hpp"
+
+// TraceLogging (ETW) events for WPA/GPUView/PresentMon correlation.
+#include "trace_events.hpp"
+
+// Debug-build assert on heap allocations in steady-state frames.
+#include "alloc_guard.hpp"
+
+// Append-only binary session record behind "save" / "read"
+#include "session_record.hpp"
+
+// Quad batch for the --hud=gpu overlay backend
+#include "hud_batch.hpp"
+
+// Keystroke-to-display timing for --latency-probe
+#include "input_latency.hpp"
+
+// Build/host architecture and the shared AVX2 probe for the SIMD kernels
+#include "cpu_dispatch.hpp"
+
+// UTF-16 -> UTF-8 with a SIMD ASCII fast path
+#include "utf8_convert.hpp"
+
 // Use Microsoft::WRL::ComPtr for COM object management
 using Microsoft::WRL::ComPtr;
 
@@ -112,20 +190,12 @@ using Microsoft::WRL::ComPtr;
             throw std::runtime_error(msg);                                                                             \
     } while (0)
 
-// Helper function: robust conversion from std::wstring to std::string using WideCharToMultiByte (UTF-8)
+// Helper function: conversion from std::wstring to UTF-8 std::string. Uses the string length, so embedded null
+// characters are preserved. Hot paths append into a reused buffer with utf8_convert::Append instead.
 std::string wstring_to_string(const std::wstring& wstr)
 {
-    if (wstr.empty())
-        return std::string();
-
-    // Use the string length so embedded null characters are preserved
-    int size_needed =
-        WideCharToMultiByte(CP_UTF8, 0, wstr.c_str(), static_cast<int>(wstr.size()), nullptr, 0, nullptr, nullptr);
-
-    std::string strTo(size_needed, 0);
-    WideCharToMultiByte(CP_UTF8, 0, wstr.c_str(), static_cast<int>(wstr.size()), &strTo[0], size_needed, nullptr,
-                        nullptr);
-
+    std::string strTo;
+    utf8_convert::Append(wstr, strTo);
     return strTo;
 }
 
@@ -138,11 +208,20 @@ constexpr const wchar_t* kWindowCaption = L"Cloud Streaming Args Debugger";
 const std::vector<std::wstring> kDescriptionLines = {
     L"Cloud Streaming Args Debugger",
     L"This utility displays all command-line arguments for cloud streaming applications.",
-    L"Type 'exit', 'save', 'read', 'logs', 'path', 'sound' or 'memory' and press Enter to execute commands."};
+    L"Type 'exit', 'save', 'read', 'logs', 'path', 'sound', 'memory' or 'find <text>' and press Enter to execute "
+    L"commands."};
 
 constexpr float kMargin = 20.0f;
 constexpr float kLineHeight = 30.0f;
 
+// GPU HUD colours: the Direct2D brushes' D2D1::ColorF::White, Green (#008000)
+// and Yellow, indexed by HudInk, plus the QR modules' black.
+constexpr HudColor kHudInkColors[] = {
+    {1.0f, 1.0f, 1.0f, 1.0f}, {0.0f, 128.0f / 255.0f, 0.0f, 1.0f}, {1.0f, 1.0f, 0.0f, 1.0f}};
+constexpr HudColor kHudBlack = {0.0f, 0.0f, 0.0f, 1.0f};
+// Runs of dark modules in a version-40 code: at most 177 rows of 89.
+constexpr size_t kMaxQrQuads = 16384;
+
 // Structures for 3D rendering
 struct SimpleVertex
 {
@@ -155,6 +234,14 @@ struct ConstantBufferData
     DirectX::XMMATRIX world_view_projection;
 };
 
+// cbuffer HudConstants in shaders/hud.hlsl.
+struct HudConstantsData
+{
+    float inv_viewport_width;
+    float inv_viewport_height;
+    float unused[2];
+};
+
 class ArgumentDebuggerWindow;
 LRESULT CALLBACK WindowProc(HWND hwnd, UINT message, WPARAM wparam, LPARAM lparam);
 ArgumentDebuggerWindow* g_app_instance = nullptr;
@@ -167,6 +254,21 @@ LONG WINAPI AppUnhandledExceptionFilter(EXCEPTION_POINTERS* ep)
     return EXCEPTION_EXECUTE_HANDLER;
 }
 
+// DirectWrite factory and the overlay's text formats. Device-independent, so
+// they are built once on a startup thread and survive device-lost recovery.
+struct OverlayTextFormats
+{
+    ComPtr<IDWriteFactory> factory;
+    ComPtr<IDWriteTextFormat> text;       // 24 pt Arial: HUD lines
+    ComPtr<IDWriteTextFormat> small_text; // 12 pt Consolas, trailing: device name, logs
+    ComPtr<IDWriteTextFormat> data_text;  // 24 pt Consolas: loaded data
+    ComPtr<IDWriteTextFormat> stats_text; // 12 pt Consolas, leading: stats table
+    ComPtr<IDWriteTextFormat> arg_row;    // 24 pt Arial, one line, ellipsis: argument rows
+};
+
+// Throws on failure.
+OverlayTextFormats CreateOverlayTextFormats();
+
 class ArgumentDebuggerWindow
 {
   public:
@@ -177,9 +279,14 @@ class ArgumentDebuggerWindow
     }
 
     // Throws on failure.
-    void Initialize(HINSTANCE h_instance, int cmd_show, const std::vector<std::wstring>& args);
+    void Initialize(HINSTANCE h_instance, int cmd_show, const std::vector<std::wstring>& args,
+                    const AppOptions& options);
     int RunMessageLoop();
     void OnCharInput(wchar_t ch);
+    // Scrolling and search navigation for the argument list; keys that do
+    // not produce WM_CHAR.
+    void OnKeyDown(WPARAM key);
+    void OnMouseWheel(int delta);
     void OnDestroy();
     bool is_running() const
     {
@@ -190,41 +297,87 @@ class ArgumentDebuggerWindow
     void InitializeWindow(HINSTANCE h_instance, int cmd_show);
     void InitializeDevice();
     void CreateDeviceAndSwapChain(UINT width, UINT height);
+    void CreateFlipModelSwapChain(UINT width, UINT height, UINT create_flags);
+    void ReleaseSwapChain();
     void CreateRenderTargetView();
     void CreateD2DResources();
     void CreateShadersAndGeometry();
-    void RenderFrame();
+    // --hud=gpu|auto: decides gpu_hud_ for the current device and builds its
+    // pipeline. Called after every device (re)creation.
+    void CreateHudPipeline();
+    bool TryCreateHudPipeline();
+    void PresentStartupFrame();
+    void StartStartupTasks();
+    void PollStartupTasks();
+    unsigned PollRedraw();
+    void RenderFrame(unsigned redraw);
     void Cleanup();
     void UpdateRotation(float delta_time);
 
     // RenderFrame is split into small section methods. RenderFrame itself just
     // orchestrates the sequence; each helper owns one visible region of the UI.
     void UpdateFrameTiming();
+    void PublishFrameMetrics();
+    // --latency-probe: records the Present that just returned (if any) and
+    // feeds DXGI frame statistics to latency_probe_.
+    void TrackInputLatency(bool presented);
+    void PublishInputMetrics();
     void RenderCube(const D3D11_VIEWPORT& vp);
     void RenderTextHud(const D2D1_SIZE_F& size, float& y_pos);
+    void RenderArgList(const D2D1_SIZE_F& size, float& y_pos);
     void RenderLoadedDataPanel(const D2D1_SIZE_F& size);
     void RenderPathsPanel(const D2D1_SIZE_F& size);
     void RenderInputPrompt(const D2D1_SIZE_F& size);
     void RenderQrBitmap(const D2D1_SIZE_F& size);
     void RenderVolumeMeter(const D2D1_SIZE_F& size);
+    void RenderPresentModeLabel(const D2D1_SIZE_F& size);
+    void RenderFrameStatsPanel(const D2D1_SIZE_F& size);
+    // Uploads hud_batch_ and draws it in one DrawInstanced, after EndDraw so
+    // it lands on top of the Direct2D text.
+    void DrawHudQuads(const D3D11_VIEWPORT& vp);
+
+    // Solid HUD shapes. With gpu_hud_ they go into hud_batch_, otherwise
+    // straight to Direct2D with the matching brush.
+    enum class HudInk
+    {
+        White,
+        Green,
+        Yellow,
+    };
+    ID2D1SolidColorBrush* InkBrush(HudInk ink) const;
+    void HudFillRect(const D2D1_RECT_F& rect, HudInk ink);
+    void HudDrawRect(const D2D1_RECT_F& rect, HudInk ink, float width);
+    void HudDrawLine(D2D1_POINT_2F from, D2D1_POINT_2F to, HudInk ink, float width);
+    void DrawCachedText(size_t slot, const std::wstring& text, IDWriteTextFormat* format, const D2D1_RECT_F& rect,
+                        ID2D1Brush* brush);
     // Returns false if the D2D device was lost and has been recreated; in that
     // case the caller should skip Present and move on to the next frame.
     bool EndOverlay();
-    void PresentFrame();
+    // Returns false if the device was lost (and has been recreated) instead
+    // of presenting.
+    bool PresentFrame(unsigned redraw);
+    size_t BuildDirtyRects(unsigned redraw, RECT* rects, size_t max_rects) const;
 
   private:
     // Update QR code – here we add the FPS synchronization logic.
-    void UpdateQrCode(ULONGLONG current_time);
+    void UpdateQrCode(LONGLONG now_qpc);
 
-    // Methods for file operations (saving/loading data)
+    // "save" appends a sample to the session record; "read" summarizes it.
     void SaveData();
     void ReadData();
-
-    // Helper to load entire log file into loaded_data_
+    // %APPDATA%\CloudStreamingArgsDebugger, resolved and created on first
+    // use; empty if that failed.
+    const std::wstring& DataDirectory();
+    SessionRecord BuildSessionRecord(uint32_t flags) const;
+    bool AppendSessionRecord(uint32_t flags);
+    // --record-interval sampling, once per loop iteration.
+    void PollSessionRecord();
+
+    // Loads the last lines of the log into loaded_data_; PollLogFollow()
+    // appends new lines while "logs -f" is active.
     void ShowLogs();
-
-    // Helper to calculate and cache path information once
-    void CalculatePathInfo();
+    void PollLogFollow();
+    void StopLogFollow();
 
     // Play telephone-like beeps for 1 minute
     void PlayTelephoneBeeps();
@@ -232,9 +385,16 @@ class ArgumentDebuggerWindow
     // Show memory usage statistics
     void ShowMemoryStats();
 
+    // "find <text>": search the argument list; bare "find" clears it.
+    void FindArgs(const std::wstring& needle);
+    // Rebuilds arg_list_status_ after the list scrolled or the search changed.
+    void UpdateArgListStatus();
+
     HWND window_handle_ = nullptr;
     bool is_running_ = true;
-    ULONGLONG last_time_ = 0;
+    AppOptions options_;
+    FramePacer frame_pacer_;
+    LONGLONG last_frame_qpc_ = 0; // QPC timestamp of the previous frame
     float rotation_angle_ = 0.0f;
     std::wstring user_input_;
     std::vector<std::wstring> args_;
@@ -246,8 +406,27 @@ class ArgumentDebuggerWindow
     bool show_paths_ = false;        // Flag to control file paths display
     bool show_logs_ = false;         // Flag to control logs display
 
-    // Cached path information to avoid expensive system calls every frame
-    std::vector<std::pair<std::wstring, std::wstring>> cached_path_items_;
+    // "logs" reads only the tail of the log; "logs -f" keeps the file open
+    // and polls it every kLogFollowIntervalMs while the panel is shown.
+    static constexpr double kLogFollowIntervalMs = 250.0;
+    LogTail log_tail_;
+    bool follow_logs_ = false;
+    LONGLONG last_log_poll_ = 0;
+    unsigned log_rotation_seen_ = 0; // GetLogRotationCount() when log_tail_ was opened
+
+    // Path information, collected off the render thread: prefetched at
+    // startup and re-queried in the background by later "path" commands.
+    PathInfoCache path_cache_;
+    bool path_prefetch_shown_ = false; // the first "path" shows the prefetch as is
+
+    // Session record. The writer is opened on the first sample and then kept
+    // open, so each sample is a single append.
+    std::wstring data_dir_;
+    bool data_dir_resolved_ = false;
+    SessionRecordWriter session_writer_;
+    bool session_record_failed_ = false; // stops --record-interval after an error; "save" still retries
+    LONGLONG last_record_qpc_ = 0;
+    uint64_t args_hash_ = 0; // Fnv1a64 of the args text, the QR h= value
 
     // Variables for FPS and QR code
     float current_fps_ = 0.0f;
@@ -255,8 +434,39 @@ class ArgumentDebuggerWindow
     // which will be the same as what is shown in the QR code.
     int synced_fps_ = 0;
 
-    ULONGLONG last_qr_update_time_ = 0;
-    ComPtr<ID2D1Bitmap> qr_bitmap_;
+    // Low-power render gate; drawn_status_ is the status text last rendered.
+    RedrawGate redraw_gate_;
+    std::wstring drawn_status_;
+    // Frames before the allocation guard asserts: text layouts, the QR
+    // bitmap and the first stats table are built while warming up.
+    static constexpr unsigned long long kAllocGuardWarmupFrames = 120;
+    bool QrUpdateDue(LONGLONG now_qpc) const
+    {
+        return last_qr_update_qpc_ == 0 ||
+               FramePacer::TicksToSeconds(now_qpc - last_qr_update_qpc_) * 1000.0 >= options_.qr_interval_ms;
+    }
+
+    // Frame-time telemetry (per-section ring + cached panel text/graph)
+    FrameStats frame_stats_;
+    LONGLONG last_stats_text_qpc_ = 0;
+    std::wstring frame_stats_text_;
+    static constexpr size_t kFrameGraphSamples = 120;
+    std::array<float, kFrameGraphSamples> frame_graph_{};
+
+    // --latency-probe. Completed() stays 0 without it, so the QR and metrics
+    // paths that read it stay idle. latency_in_qr_ / latency_published_ are
+    // the Completed() counts last carried by the QR payload / metrics segment.
+    InputLatencyProbe latency_probe_;
+    uint32_t latency_in_qr_ = 0;
+    uint32_t latency_published_ = 0;
+
+    LONGLONG last_qr_update_qpc_ = 0;
+    unsigned long long frame_counter_ = 0; // RenderFrame calls; carried in the QR payload
+    ComPtr<ID2D1Bitmap> qr_bitmap_;   // persistent; refreshed with CopyFromMemory
+    QrWorker qr_worker_;
+    std::vector<uint32_t> qr_pixels_; // last buffer taken from qr_worker_
+    void RequestQrIfDue(LONGLONG now_qpc);
+    void UploadQrPixels();
 
     // Direct2D and DirectWrite objects
     ComPtr<ID2D1Factory> d2d_factory_;
@@ -265,6 +475,38 @@ class ArgumentDebuggerWindow
     ComPtr<IDWriteTextFormat> text_format_;
     ComPtr<IDWriteTextFormat> small_text_format_; // Smaller font for logs
     ComPtr<IDWriteTextFormat> data_text_format_;  // Medium font for loaded data
+    ComPtr<IDWriteTextFormat> stats_text_format_; // Small, leading-aligned monospace for the stats panel
+    ComPtr<IDWriteTextFormat> arg_row_format_;    // Single-line, ellipsis-trimmed argument rows
+
+    // Overlay text is laid out once and redrawn from the cache until its
+    // content or box changes. Fixed slots first; kDescriptionLines and then
+    // the path lines are indexed from kSlotDynamicBase.
+    enum TextSlot : size_t
+    {
+        kSlotCliHeader,
+        kSlotArgListStatus,
+        kSlotStatus,
+        kSlotLoadedData,
+        kSlotLoadedTitle,
+        kSlotExitPrompt,
+        kSlotUserInput,
+        kSlotFrameStats,
+        kSlotPresentMode,
+        kSlotMicTitle,
+        kSlotDynamicBase,
+    };
+    TextLayoutCache text_layouts_;
+    std::wstring cli_header_text_; // BuildCliHeaderText(args_), args_ never changes after Initialize
+    std::wstring mic_title_;       // "Mic: <device>", refreshed when mic_generation_ changes
+
+    // Only the visible argument rows are laid out, each in its own slot of
+    // arg_layouts_ (slot = row index), so frame cost follows the window
+    // height rather than argc.
+    static constexpr int kWheelRows = 3; // rows per wheel notch
+    ArgListView arg_list_;
+    TextLayoutCache arg_layouts_;
+    std::wstring arg_list_status_; // "Arguments 1-20 of 350 ..."; empty when everything fits
+    int wheel_remainder_ = 0;      // sub-notch wheel delta (touchpads)
 
     // D2D Brushes - created once and reused
     ComPtr<ID2D1SolidColorBrush> white_brush_;
@@ -275,6 +517,12 @@ class ArgumentDebuggerWindow
     ComPtr<ID3D11Device> d3d_device_;
     ComPtr<ID3D11DeviceContext> immediate_context_;
     ComPtr<IDXGISwapChain> swap_chain_;
+    ComPtr<IDXGISwapChain1> swap_chain1_;      // Flip model only (Present1)
+    HANDLE frame_latency_waitable_ = nullptr; // Flip model only; owned
+    bool flip_model_active_ = false;
+    bool tearing_supported_ = false;
+    bool is_wine_ = false;            // Probed once; selects VSync off
+    std::wstring present_mode_label_; // Shown under the QR code and in logs
     ComPtr<ID3D11RenderTargetView> d3d_render_target_view_;
 
     // Shader and geometry objects
@@ -285,8 +533,48 @@ class ArgumentDebuggerWindow
     ComPtr<ID3D11VertexShader> vertex_shader_;
     ComPtr<ID3D11PixelShader> pixel_shader_;
 
+    // GPU HUD (--hud=gpu|auto). hud_batch_ is refilled every frame;
+    // qr_quads_ covers the dark modules of qr_pixels_ in QR pixel
+    // coordinates and is rebuilt only when a new payload arrives.
+    bool gpu_hud_ = false;
+    HudBatch hud_batch_{0}; // sized when the GPU HUD is first enabled
+    std::vector<HudQuad> qr_quads_;
+    size_t qr_quad_count_ = 0;
+    bool qr_quads_valid_ = false;
+    float hud_viewport_width_ = 0.0f; // viewport hud_constants_ was written for
+    float hud_viewport_height_ = 0.0f;
+    ComPtr<ID3D11Buffer> hud_quad_buffer_; // dynamic StructuredBuffer<HudQuad>
+    ComPtr<ID3D11ShaderResourceView> hud_quad_srv_;
+    ComPtr<ID3D11Buffer> hud_constants_;
+    ComPtr<ID3D11VertexShader> hud_vertex_shader_;
+    ComPtr<ID3D11PixelShader> hud_pixel_shader_;
+    ComPtr<ID3D11RasterizerState> hud_rasterizer_; // no culling
+
+    // Live metrics segment. Declared before audio_capture_ so it outlives the
+    // capture thread that publishes into it. metrics_frame_ carries the
+    // slowly refreshed fields (percentiles, memory) between frames.
+    MetricsExport metrics_;
+    MetricsFrameSection metrics_frame_{};
+    LONGLONG last_metrics_summary_qpc_ = 0;
+    LONGLONG last_metrics_memory_qpc_ = 0;
+    MetricsInputSection metrics_input_{}; // ring slots fill in as keystrokes complete
+
     // WASAPI
     AudioCapture audio_capture_; // Owns the WASAPI pipeline and capture thread
+
+    // Startup work running off the render thread (see StartStartupTasks).
+    // Each result is written by its task and read here only once the task
+    // is done; until then the matching UI is left out of the frame.
+    OverlayTextFormats startup_text_formats_; // text_task_
+    bool text_ready_ = false;                 // formats adopted into the members above
+    bool audio_ready_ = false;                // audio_capture_ may be queried
+    uint32_t mic_generation_ = UINT32_MAX;    // DeviceGeneration() mic_title_ was built for
+    LONGLONG startup_qpc_ = 0;                // Initialize() entry, for the startup log
+    // Declared last so it is destroyed (and its threads joined) before the
+    // members the tasks write to.
+    StartupTasks startup_tasks_;
+    StartupTasks::TaskId text_task_ = 0;
+    StartupTasks::TaskId audio_task_ = 0;
 };
 
 #ifndef EXCLUDE_MAIN
@@ -295,6 +583,8 @@ int WINAPI wWinMain(HINSTANCE h_instance, HINSTANCE, PWSTR, int cmd_show)
 #ifdef _DEBUG
     // Enable memory leak detection in debug builds
     _CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF | _CRTDBG_LEAK_CHECK_DF);
+    // Steady-state frames must not allocate (see RenderFrame).
+    alloc_guard::Install();
     // Break on allocation number (uncomment to debug specific leak)
     // _CrtSetBreakAlloc(123);
 #endif
@@ -304,13 +594,8 @@ int WINAPI wWinMain(HINSTANCE h_instance, HINSTANCE, PWSTR, int cmd_show)
         // Initialize COM once at the start - STA is the safest option for UI thread and D2D
         DX_CALL(CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED), "COM initialization failed");
 
-        InitLogger();
-        Log(L"Application start");
-        Log(L"wWinMain: entered");
-
-        // Set unhandled exception filter using a regular function
-        SetUnhandledExceptionFilter(AppUnhandledExceptionFilter);
-
+        // Arguments are parsed before the logger comes up because they pick
+        // its write mode.
         int argc = 0;
         LPWSTR* argv = CommandLineToArgvW(GetCommandLineW(), &argc);
         std::vector<std::wstring> args;
@@ -322,11 +607,38 @@ int WINAPI wWinMain(HINSTANCE h_instance, HINSTANCE, PWSTR, int cmd_show)
             }
             LocalFree(argv);
         }
+        const AppOptions options = ParseAppOptions(args);
+
+        LoggerOptions logger_options;
+        logger_options.mode = options.async_log ? LogWriteMode::Async : LogWriteMode::Sync;
+        logger_options.format = options.log_utf8 ? LogFormat::Utf8 : LogFormat::Utf16;
+        logger_options.rotate_bytes = static_cast<uint64_t>(options.log_rotate_mb) * 1024 * 1024;
+        logger_options.rotate_interval_ms = static_cast<ULONGLONG>(options.log_rotate_minutes) * 60 * 1000;
+        logger_options.keep_files = options.log_keep_files;
+        InitLogger(logger_options);
+        trace_events::Register();
+        Log(L"Application start");
+        Log(L"CPU: " + cpu_dispatch::Describe());
+        Log(L"wWinMain: entered");
+
+        if (options.headless)
+        {
+            // No window, device or audio: report and leave.
+            const int exit_code = headless_report::Run(args, options.headless_output);
+            Log(L"wWinMain: headless report done, exitCode=" + std::to_wstring(exit_code));
+            trace_events::Unregister();
+            CloseLogger();
+            CoUninitialize();
+            return exit_code;
+        }
+
+        // Set unhandled exception filter using a regular function
+        SetUnhandledExceptionFilter(AppUnhandledExceptionFilter);
 
         ArgumentDebuggerWindow debugger_app;
         g_app_instance = &debugger_app;
 
-        debugger_app.Initialize(h_instance, cmd_show, args);
+        debugger_app.Initialize(h_instance, cmd_show, args, options);
 
         int exit_code = debugger_app.RunMessageLoop();
         g_app_instance = nullptr;
@@ -334,6 +646,7 @@ int WINAPI wWinMain(HINSTANCE h_instance, HINSTANCE, PWSTR, int cmd_show)
         Log(L"Application exit, code = " + std::to_wstring(exit_code));
         Log(L"wWinMain: leaving, exitCode=" + std::to_wstring(exit_code));
 
+        trace_events::Unregister();
         CloseLogger();
         CoUninitialize();
         return exit_code;
@@ -344,6 +657,7 @@ int WINAPI wWinMain(HINSTANCE h_instance, HINSTANCE, PWSTR, int cmd_show)
         Log(L"Unhandled C++ exception");
         Log(L"FATAL: " + wstr);
 
+        trace_events::Unregister();
         CloseLogger();
 
         MessageBoxA(nullptr, ex.what(), "Initialization Error", MB_OK | MB_ICONERROR);
@@ -352,18 +666,115 @@ int WINAPI wWinMain(HINSTANCE h_instance, HINSTANCE, PWSTR, int cmd_show)
 }
 #endif // EXCLUDE_MAIN
 
-void ArgumentDebuggerWindow::Initialize(HINSTANCE h_instance, int cmd_show, const std::vector<std::wstring>& args)
+void ArgumentDebuggerWindow::Initialize(HINSTANCE h_instance, int cmd_show, const std::vector<std::wstring>& args,
+                                        const AppOptions& options)
 {
+    startup_qpc_ = FramePacer::Now();
     args_ = args;
+    options_ = options;
+    cli_header_text_ = BuildCliHeaderText(args_);
+    arg_list_.SetArgs(args_);
+    UpdateArgListStatus();
+
+    // The args part of the QR payload never changes; convert it once. The
+    // first payload is queued right away so it encodes while the device is
+    // being created.
+    const std::string args_suffix = qr_worker::detail::BuildArgsSuffix(args_);
+    qr_worker_.Start(args_suffix, options_.latency_probe);
+    if (options_.latency_probe)
+        Log(L"Latency probe: timing keystrokes from WM_CHAR to display");
+    RequestQrIfDue(startup_qpc_);
+    static constexpr size_t kArgsTagLength = sizeof(";args=") - 1;
+    args_hash_ = qr_worker::detail::Fnv1a64(args_suffix.size() > kArgsTagLength ? args_suffix.substr(kArgsTagLength)
+                                                                                 : std::string());
+
+    // Before the audio task starts, so the capture thread sees the segment.
+    if (options_.metrics_shm)
+    {
+        const std::wstring name =
+            options_.metrics_name.empty() ? DefaultMetricsName(GetCurrentProcessId()) : options_.metrics_name;
+        if (metrics_.Create(name))
+            audio_capture_.SetMetricsExport(&metrics_);
+    }
+
+    StartStartupTasks();
     InitializeWindow(h_instance, cmd_show);
     InitializeDevice();
 }
 
+void ArgumentDebuggerWindow::StartStartupTasks()
+{
+    // None of these needs the window or the D3D device, and none depends on
+    // another. WASAPI activation in particular can take seconds on cloud VMs
+    // with virtual audio drivers; the meter simply appears when it is done.
+    text_task_ = startup_tasks_.Start(L"text formats", [this] { startup_text_formats_ = CreateOverlayTextFormats(); });
+    path_cache_.Start();
+
+    AudioCaptureOptions audio_options;
+    audio_options.event_driven = options_.audio_engine != AudioEngine::Legacy;
+    audio_options.low_latency_period = options_.audio_engine == AudioEngine::LowLatency;
+    audio_task_ = startup_tasks_.Start(L"audio", [this, audio_options] { audio_capture_.Initialize(audio_options); });
+}
+
+void ArgumentDebuggerWindow::PollStartupTasks()
+{
+    if (!text_ready_ && startup_tasks_.IsDone(text_task_))
+    {
+        // Fatal, exactly as when the formats were created inline.
+        if (const std::exception_ptr error = startup_tasks_.Error(text_task_))
+            std::rethrow_exception(error);
+        dwrite_factory_ = startup_text_formats_.factory;
+        text_format_ = startup_text_formats_.text;
+        small_text_format_ = startup_text_formats_.small_text;
+        data_text_format_ = startup_text_formats_.data_text;
+        stats_text_format_ = startup_text_formats_.stats_text;
+        arg_row_format_ = startup_text_formats_.arg_row;
+        startup_text_formats_ = OverlayTextFormats{};
+        text_layouts_.Reset(dwrite_factory_.Get());
+        arg_layouts_.Reset(dwrite_factory_.Get());
+        text_ready_ = true;
+        redraw_gate_.Invalidate(kRedrawAll);
+        Log(L"Startup: overlay text ready after " +
+            std::to_wstring(static_cast<int>(FramePacer::TicksToSeconds(FramePacer::Now() - startup_qpc_) * 1000.0)) +
+            L" ms");
+    }
+    if (!audio_ready_ && startup_tasks_.IsDone(audio_task_))
+        audio_ready_ = true;
+    // Once when audio becomes ready, then whenever the capture thread has
+    // moved to another device (or lost it).
+    if (audio_ready_ && audio_capture_.DeviceGeneration() != mic_generation_)
+    {
+        mic_generation_ = audio_capture_.DeviceGeneration();
+        const std::wstring mic_name = audio_capture_.Name();
+        mic_title_ = L"Mic: " + (mic_name.empty() ? L"<unknown>" : mic_name);
+        redraw_gate_.Invalidate(kRedrawMeter);
+    }
+    if (path_cache_.Poll())
+    {
+        const PathSnapshot* paths = path_cache_.Current();
+        Log(L"Paths: snapshot " + std::to_wstring(paths->generation) + L" collected in " +
+            std::to_wstring(static_cast<int>(paths->collect_ms + 0.5)) + L" ms");
+        if (show_paths_)
+        {
+            if (!path_cache_.Busy())
+                command_status_ = L"File paths enabled.";
+            redraw_gate_.Invalidate(kRedrawAll);
+        }
+    }
+}
+
 int ArgumentDebuggerWindow::RunMessageLoop()
 {
     Log(L"RunMessageLoop: started");
     MSG msg = {};
-    last_time_ = GetTickCount64();
+    const bool low_power = options_.render_mode == RenderMode::LowPower;
+    // Low-power skips most ticks, so "unlimited" would just spin on PollRedraw;
+    // fall back to 60 Hz polling there.
+    frame_pacer_.Initialize((low_power && options_.target_fps == 0) ? 60 : options_.target_fps);
+    last_frame_qpc_ = FramePacer::Now();
+    redraw_gate_.Configure(low_power, options_.cube_fps, FramePacer::Frequency(), last_frame_qpc_);
+    if (low_power)
+        Log(L"RunMessageLoop: low-power render mode, cube fps=" + std::to_wstring(options_.cube_fps));
 
     while (is_running_)
     {
@@ -393,25 +804,35 @@ int ArgumentDebuggerWindow::RunMessageLoop()
             }
         }
 
-        // Frame rate limiting - target 60 FPS
-        static ULONGLONG lastFrameTime = 0;
-        ULONGLONG currentFrameTime = GetTickCount64();
-        const ULONGLONG targetFrameTime = 16; // ~60 FPS (1000ms / 60 = 16.67ms)
+        if (!is_running_)
+            break;
 
-        if (currentFrameTime - lastFrameTime < targetFrameTime)
+        // Frame rate limiting: sleeps until the next deadline, but returns
+        // early (false) when input arrives so it is dispatched first.
+        if (!frame_pacer_.WaitForFrame())
+            continue;
+        // Low-power: nothing changed since the last frame, so leave it on
+        // screen. Decided before the latency wait so no waitable count is
+        // consumed without a matching Present.
+        PollStartupTasks();
+        PollLogFollow();
+        PollSessionRecord();
+        const unsigned redraw = PollRedraw();
+        if (redraw == kRedrawNone)
         {
-            // Sleep to maintain target frame rate
-            DWORD sleepTime = static_cast<DWORD>(targetFrameTime - (currentFrameTime - lastFrameTime));
-            if (sleepTime > 0 && sleepTime < targetFrameTime)
-            {
-                Sleep(sleepTime);
-            }
+            frame_pacer_.OnFrameStarted();
+            continue;
         }
-        lastFrameTime = GetTickCount64();
+        // Flip model: block until DXGI can accept another frame so input is
+        // sampled as late as possible. Bounded so a stuck compositor cannot
+        // freeze the loop.
+        if (!frame_pacer_.WaitForHandle(frame_latency_waitable_, 100))
+            continue;
+        frame_pacer_.OnFrameStarted();
 
         try
         {
-            RenderFrame();
+            RenderFrame(redraw);
         }
         catch (const std::exception& ex)
         {
@@ -443,6 +864,14 @@ int ArgumentDebuggerWindow::RunMessageLoop()
 // Keyboard input handling: added support for "save", "read" and "logs" commands
 void ArgumentDebuggerWindow::OnCharInput(wchar_t ch)
 {
+    // GetMessageTime() is on the GetTickCount() clock, so the queue delay is
+    // only as fine as the system tick; everything after this is QPC.
+    if (options_.latency_probe)
+        latency_probe_.OnInput(FramePacer::Now(), GetTickCount() - static_cast<DWORD>(GetMessageTime()));
+
+    // Enter runs a command that may toggle whole panels; other keys only
+    // touch the input line.
+    redraw_gate_.Invalidate(ch == VK_RETURN ? kRedrawAll : kRedrawInput);
     if (ch == VK_RETURN)
     {
         if (_wcsicmp(user_input_.c_str(), L"exit") == 0)
@@ -459,22 +888,42 @@ void ArgumentDebuggerWindow::OnCharInput(wchar_t ch)
         else if (_wcsicmp(user_input_.c_str(), L"read") == 0)
         {
             Log(L"Command: read");
+            StopLogFollow();
             ReadData();
             if (!loaded_data_.empty())
             {
-                loaded_data_title_ = L"Save File Contents:";
+                loaded_data_title_ = L"Session Record:";
                 show_logs_ = true; // Show the data when read succeeds
             }
         }
         else if (_wcsicmp(user_input_.c_str(), L"logs") == 0)
         {
             Log(L"Command: logs");
+            StopLogFollow();
             show_logs_ = !show_logs_;
             if (show_logs_)
             {
                 ShowLogs();
                 loaded_data_title_ = L"Log File Contents:";
-                command_status_ = L"Logs enabled.";
+            }
+            else
+            {
+                loaded_data_.clear();
+                loaded_data_title_.clear();
+                command_status_ = L"Logs disabled.";
+            }
+        }
+        else if (_wcsicmp(user_input_.c_str(), L"logs -f") == 0)
+        {
+            Log(L"Command: logs -f");
+            const bool was_following = follow_logs_;
+            StopLogFollow();
+            show_logs_ = !was_following;
+            if (show_logs_)
+            {
+                follow_logs_ = true;
+                ShowLogs();
+                loaded_data_title_ = L"Log File Contents (following):";
             }
             else
             {
@@ -489,14 +938,16 @@ void ArgumentDebuggerWindow::OnCharInput(wchar_t ch)
             show_paths_ = !show_paths_;
             if (show_paths_)
             {
-                // Calculate path information once when enabling
-                CalculatePathInfo();
-                command_status_ = L"File paths enabled.";
+                // The first request shows the startup prefetch; later ones
+                // re-query (the working directory may have changed) while the
+                // previous snapshot stays on screen.
+                if (path_prefetch_shown_)
+                    path_cache_.Refresh();
+                path_prefetch_shown_ = true;
+                command_status_ = path_cache_.Current() ? L"File paths enabled." : L"Collecting file paths...";
             }
             else
             {
-                // Clear cached data when disabling
-                cached_path_items_.clear();
                 command_status_ = L"File paths disabled.";
             }
         }
@@ -511,6 +962,12 @@ void ArgumentDebuggerWindow::OnCharInput(wchar_t ch)
             Log(L"Command: memory");
             ShowMemoryStats();
         }
+        else if (_wcsnicmp(user_input_.c_str(), L"find", 4) == 0 &&
+                 (user_input_.size() == 4 || user_input_[4] == L' '))
+        {
+            Log(L"Command: find");
+            FindArgs(user_input_.size() > 5 ? user_input_.substr(5) : std::wstring());
+        }
         else
         {
             command_status_ = L"Unknown command.";
@@ -528,12 +985,103 @@ void ArgumentDebuggerWindow::OnCharInput(wchar_t ch)
     }
 }
 
+void ArgumentDebuggerWindow::OnKeyDown(WPARAM key)
+{
+    bool changed = false;
+    switch (key)
+    {
+    case VK_UP:
+        changed = arg_list_.ScrollBy(-1);
+        break;
+    case VK_DOWN:
+        changed = arg_list_.ScrollBy(1);
+        break;
+    case VK_PRIOR:
+        changed = arg_list_.PageUp();
+        break;
+    case VK_NEXT:
+        changed = arg_list_.PageDown();
+        break;
+    case VK_HOME:
+        changed = arg_list_.Home();
+        break;
+    case VK_END:
+        changed = arg_list_.End();
+        break;
+    case VK_F3:
+        // Shift+F3 goes back, as in most editors.
+        changed = arg_list_.FindNext((GetKeyState(VK_SHIFT) & 0x8000) == 0);
+        break;
+    default:
+        return;
+    }
+    if (changed)
+    {
+        UpdateArgListStatus();
+        redraw_gate_.Invalidate(kRedrawAll);
+    }
+}
+
+void ArgumentDebuggerWindow::OnMouseWheel(int delta)
+{
+    // Positive delta is away from the user, i.e. scroll up.
+    wheel_remainder_ += delta;
+    const int notches = wheel_remainder_ / WHEEL_DELTA;
+    wheel_remainder_ %= WHEEL_DELTA;
+    if (notches != 0 && arg_list_.ScrollBy(-static_cast<long long>(notches) * kWheelRows))
+    {
+        UpdateArgListStatus();
+        redraw_gate_.Invalidate(kRedrawAll);
+    }
+}
+
+void ArgumentDebuggerWindow::FindArgs(const std::wstring& needle)
+{
+    if (needle.empty())
+    {
+        arg_list_.ClearSearch();
+        command_status_ = L"Search cleared.";
+    }
+    else
+    {
+        const size_t matches = arg_list_.Find(needle);
+        command_status_ = matches == 0 ? L"No argument contains \"" + needle + L"\"."
+                                       : std::to_wstring(matches) + L" argument(s) contain \"" + needle +
+                                             L"\". F3 / Shift+F3 to step through them.";
+    }
+    UpdateArgListStatus();
+}
+
+void ArgumentDebuggerWindow::UpdateArgListStatus()
+{
+    arg_list_status_.clear();
+    if (!arg_list_.Overflows() && arg_list_.Needle().empty())
+        return;
+
+    arg_list_status_ = L"Arguments " + std::to_wstring(arg_list_.FirstRow() + 1) + L"-" +
+                       std::to_wstring(arg_list_.EndRow()) + L" of " + std::to_wstring(arg_list_.RowCount());
+    if (arg_list_.Overflows())
+        arg_list_status_ += L" (Up/Down, PgUp/PgDn, Home/End, wheel)";
+    if (!arg_list_.Needle().empty())
+    {
+        arg_list_status_ += L"  |  \"" + arg_list_.Needle() + L"\": ";
+        arg_list_status_ += arg_list_.Matches().empty()
+                                ? std::wstring(L"no matches")
+                                : std::to_wstring(arg_list_.CurrentMatch() + 1) + L" of " +
+                                      std::to_wstring(arg_list_.Matches().size()) + L" (F3 / Shift+F3)";
+    }
+}
+
 void ArgumentDebuggerWindow::OnDestroy()
 {
     Log(L"Window destroy event");
 
     is_running_ = false;
+    // Initialize() may still be running on its startup thread.
+    startup_tasks_.Wait(audio_task_);
     audio_capture_.Stop();
+    qr_worker_.Stop();
+    path_cache_.Stop();
     Cleanup();
     PostQuitMessage(0);
 }
@@ -572,15 +1120,67 @@ void ArgumentDebuggerWindow::InitializeDevice()
     UINT width = rc.right - rc.left;
     UINT height = rc.bottom - rc.top;
 
+    // Skip VSync under Wine/Proton — blocking Present on Wine can starve the
+    // whole message loop, producing reported FPS in the single digits.
+    // path_info probes once per process; PresentFrame reads is_wine_.
+    is_wine_ = path_info::IsWine();
+
     CreateDeviceAndSwapChain(width, height);
     CreateRenderTargetView();
+    PresentStartupFrame();
     CreateD2DResources();
     CreateShadersAndGeometry();
-    audio_capture_.Initialize();
+    CreateHudPipeline();
+    // Usually the text formats are ready by now, so the first real frame
+    // already has its overlay.
+    PollStartupTasks();
+}
+
+void ArgumentDebuggerWindow::PresentStartupFrame()
+{
+    // First paint as soon as the swap chain exists: the window shows the
+    // (black) background instead of whatever was behind it while the rest
+    // of the pipeline is built. No VSync wait; this frame is not paced.
+    FLOAT clear_color[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+    immediate_context_->ClearRenderTargetView(d3d_render_target_view_.Get(), clear_color);
+    // Flip model: take the latency waitable's slot like every other frame,
+    // so the loop's waits stay matched to presents.
+    if (frame_latency_waitable_)
+        WaitForSingleObject(frame_latency_waitable_, 100);
+    const HRESULT hr = swap_chain_->Present(0, 0);
+    Log(L"Startup: first frame presented after " +
+        std::to_wstring(static_cast<int>(FramePacer::TicksToSeconds(FramePacer::Now() - startup_qpc_) * 1000.0)) +
+        L" ms" + (FAILED(hr) ? L" (Present failed, hr=" + std::to_wstring(hr) + L")" : L""));
 }
 
 void ArgumentDebuggerWindow::CreateDeviceAndSwapChain(UINT width, UINT height)
 {
+    // Enable debug layer for better diagnostics in debug builds
+#ifdef _DEBUG
+    UINT create_flags = D3D11_CREATE_DEVICE_BGRA_SUPPORT | D3D11_CREATE_DEVICE_DEBUG;
+#else
+    UINT create_flags = D3D11_CREATE_DEVICE_BGRA_SUPPORT;
+#endif
+
+    if (options_.present_model == PresentModel::Flip)
+    {
+        try
+        {
+            CreateFlipModelSwapChain(width, height, create_flags);
+            return;
+        }
+        catch (const std::exception& ex)
+        {
+            // FLIP_DISCARD needs Windows 10; some virtual display drivers
+            // reject it outright. Keep running on the legacy model.
+            Log(L"Flip-model swap chain unavailable (" +
+                std::wstring(ex.what(), ex.what() + strlen(ex.what())) + L"), falling back to blt model");
+            ReleaseSwapChain();
+            immediate_context_.Reset();
+            d3d_device_.Reset();
+        }
+    }
+
     DXGI_SWAP_CHAIN_DESC sd = {};
     sd.BufferCount = 1;
     sd.BufferDesc.Width = width;
@@ -594,17 +1194,96 @@ void ArgumentDebuggerWindow::CreateDeviceAndSwapChain(UINT width, UINT height)
     sd.Windowed = TRUE;
     sd.SwapEffect = DXGI_SWAP_EFFECT_DISCARD;
 
-    // Enable debug layer for better diagnostics in debug builds
-#ifdef _DEBUG
-    UINT create_flags = D3D11_CREATE_DEVICE_BGRA_SUPPORT | D3D11_CREATE_DEVICE_DEBUG;
-#else
-    UINT create_flags = D3D11_CREATE_DEVICE_BGRA_SUPPORT;
-#endif
-
     DX_CALL(D3D11CreateDeviceAndSwapChain(nullptr, D3D_DRIVER_TYPE_HARDWARE, nullptr, create_flags, nullptr, 0,
                                           D3D11_SDK_VERSION, &sd, swap_chain_.GetAddressOf(),
                                           d3d_device_.GetAddressOf(), nullptr, immediate_context_.GetAddressOf()),
             "Failed to create Direct3D device and swap chain.");
+
+    flip_model_active_ = false;
+    tearing_supported_ = false;
+    present_mode_label_ = is_wine_ ? L"Present: blt (discard, no VSync)" : L"Present: blt (discard, VSync)";
+    Log(present_mode_label_);
+}
+
+void ArgumentDebuggerWindow::CreateFlipModelSwapChain(UINT width, UINT height, UINT create_flags)
+{
+    DX_CALL(D3D11CreateDevice(nullptr, D3D_DRIVER_TYPE_HARDWARE, nullptr, create_flags, nullptr, 0, D3D11_SDK_VERSION,
+                              d3d_device_.GetAddressOf(), nullptr, immediate_context_.GetAddressOf()),
+            "Failed to create Direct3D device.");
+
+    // Walk device -> adapter -> factory so the swap chain is created by the
+    // factory that owns the device's adapter.
+    ComPtr<IDXGIDevice> dxgi_device;
+    DX_CALL(d3d_device_.As(&dxgi_device), "Failed to query IDXGIDevice.");
+    ComPtr<IDXGIAdapter> adapter;
+    DX_CALL(dxgi_device->GetAdapter(adapter.GetAddressOf()), "Failed to get DXGI adapter.");
+    ComPtr<IDXGIFactory2> factory;
+    DX_CALL(adapter->GetParent(IID_PPV_ARGS(&factory)), "Failed to get IDXGIFactory2.");
+
+    BOOL allow_tearing = FALSE;
+    ComPtr<IDXGIFactory5> factory5;
+    if (SUCCEEDED(factory.As(&factory5)) &&
+        FAILED(factory5->CheckFeatureSupport(DXGI_FEATURE_PRESENT_ALLOW_TEARING, &allow_tearing,
+                                             sizeof(allow_tearing))))
+    {
+        allow_tearing = FALSE;
+    }
+    tearing_supported_ = allow_tearing == TRUE;
+
+    DXGI_SWAP_CHAIN_DESC1 sd = {};
+    sd.Width = width;
+    sd.Height = height;
+    sd.Format = DXGI_FORMAT_B8G8R8A8_UNORM;
+    sd.SampleDesc.Count = 1;
+    sd.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
+    sd.BufferCount = 2; // flip model minimum
+    sd.Scaling = DXGI_SCALING_STRETCH;
+    sd.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
+    sd.AlphaMode = DXGI_ALPHA_MODE_IGNORE;
+    sd.Flags = DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT;
+    if (tearing_supported_)
+        sd.Flags |= DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING;
+
+    DX_CALL(factory->CreateSwapChainForHwnd(d3d_device_.Get(), window_handle_, &sd, nullptr, nullptr,
+                                            swap_chain1_.GetAddressOf()),
+            "Failed to create flip-model swap chain.");
+    // Alt+Enter fullscreen would change the swap-chain mode behind our back.
+    factory->MakeWindowAssociation(window_handle_, DXGI_MWA_NO_ALT_ENTER);
+    DX_CALL(swap_chain1_.As(&swap_chain_), "Failed to query IDXGISwapChain.");
+
+    ComPtr<IDXGISwapChain2> swap_chain2;
+    DX_CALL(swap_chain1_.As(&swap_chain2), "Failed to query IDXGISwapChain2.");
+    DX_CALL(swap_chain2->SetMaximumFrameLatency(1), "Failed to set maximum frame latency.");
+    frame_latency_waitable_ = swap_chain2->GetFrameLatencyWaitableObject();
+
+    flip_model_active_ = true;
+    present_mode_label_ = L"Present: flip-discard, latency waitable";
+    if (tearing_supported_)
+        present_mode_label_ += L", tearing";
+    else if (!is_wine_)
+        present_mode_label_ += L", VSync";
+    Log(present_mode_label_);
+}
+
+void ArgumentDebuggerWindow::ReleaseSwapChain()
+{
+    // A flip-model swap chain owns its HWND until released, so everything
+    // holding a back-buffer reference has to go before a new one is created.
+    d2d_render_target_.Reset();
+    d3d_render_target_view_.Reset();
+    if (immediate_context_)
+    {
+        immediate_context_->ClearState();
+        immediate_context_->Flush();
+    }
+    if (frame_latency_waitable_)
+    {
+        CloseHandle(frame_latency_waitable_);
+        frame_latency_waitable_ = nullptr;
+    }
+    swap_chain1_.Reset();
+    swap_chain_.Reset();
+    flip_model_active_ = false;
 }
 
 void ArgumentDebuggerWindow::CreateRenderTargetView()
@@ -616,54 +1295,91 @@ void ArgumentDebuggerWindow::CreateRenderTargetView()
             "Failed to create render target view.");
 }
 
-void ArgumentDebuggerWindow::CreateD2DResources()
+OverlayTextFormats CreateOverlayTextFormats()
 {
-    // Create the Direct2D factory.
-    DX_CALL(D2D1CreateFactory(D2D1_FACTORY_TYPE_SINGLE_THREADED, D2D1_FACTORY_OPTIONS{}, d2d_factory_.GetAddressOf()),
-            "Failed to create Direct2D factory.");
-
-    // Get the DXGI surface from the swap chain.
-    ComPtr<IDXGISurface> dxgi_surface;
-    DX_CALL(swap_chain_->GetBuffer(0, IID_PPV_ARGS(&dxgi_surface)), "Failed to get DXGI surface.");
-
-    D2D1_RENDER_TARGET_PROPERTIES props = D2D1::RenderTargetProperties(
-        D2D1_RENDER_TARGET_TYPE_DEFAULT, D2D1::PixelFormat(DXGI_FORMAT_UNKNOWN, D2D1_ALPHA_MODE_PREMULTIPLIED), 0, 0);
-    DX_CALL(d2d_factory_->CreateDxgiSurfaceRenderTarget(dxgi_surface.Get(), &props, d2d_render_target_.GetAddressOf()),
-            "Failed to create Direct2D render target.");
+    OverlayTextFormats formats;
 
     // Create the DirectWrite factory and text format.
     DX_CALL(DWriteCreateFactory(DWRITE_FACTORY_TYPE_SHARED, __uuidof(IDWriteFactory),
-                                reinterpret_cast<IUnknown**>(dwrite_factory_.GetAddressOf())),
+                                reinterpret_cast<IUnknown**>(formats.factory.GetAddressOf())),
             "Failed to create DirectWrite factory.");
-    DX_CALL(dwrite_factory_->CreateTextFormat(L"Arial", nullptr, DWRITE_FONT_WEIGHT_NORMAL, DWRITE_FONT_STYLE_NORMAL,
-                                              DWRITE_FONT_STRETCH_NORMAL, 24.0f, L"en-us", text_format_.GetAddressOf()),
+    DX_CALL(formats.factory->CreateTextFormat(L"Arial", nullptr, DWRITE_FONT_WEIGHT_NORMAL, DWRITE_FONT_STYLE_NORMAL,
+                                              DWRITE_FONT_STRETCH_NORMAL, 24.0f, L"en-us", formats.text.GetAddressOf()),
             "Failed to create text format.");
-    text_format_->SetTextAlignment(DWRITE_TEXT_ALIGNMENT_LEADING);
-    text_format_->SetParagraphAlignment(DWRITE_PARAGRAPH_ALIGNMENT_NEAR);
+    formats.text->SetTextAlignment(DWRITE_TEXT_ALIGNMENT_LEADING);
+    formats.text->SetParagraphAlignment(DWRITE_PARAGRAPH_ALIGNMENT_NEAR);
 
     // Create a smaller text format for logs (half the size of the regular text)
-    DX_CALL(dwrite_factory_->CreateTextFormat(L"Consolas", nullptr, // Using monospaced font for logs
+    DX_CALL(formats.factory->CreateTextFormat(L"Consolas", nullptr, // Using monospaced font for logs
                                               DWRITE_FONT_WEIGHT_NORMAL, DWRITE_FONT_STYLE_NORMAL,
                                               DWRITE_FONT_STRETCH_NORMAL,
                                               12.0f, // Half the size of the regular font
-                                              L"en-us", small_text_format_.GetAddressOf()),
+                                              L"en-us", formats.small_text.GetAddressOf()),
             "Failed to create small text format.");
     // Set text alignment properties
-    small_text_format_->SetParagraphAlignment(DWRITE_PARAGRAPH_ALIGNMENT_NEAR);
-    small_text_format_->SetWordWrapping(DWRITE_WORD_WRAPPING_WRAP);
+    formats.small_text->SetParagraphAlignment(DWRITE_PARAGRAPH_ALIGNMENT_NEAR);
+    formats.small_text->SetWordWrapping(DWRITE_WORD_WRAPPING_WRAP);
     // Use trailing alignment for device name text to align to the right
-    small_text_format_->SetTextAlignment(DWRITE_TEXT_ALIGNMENT_TRAILING);
+    formats.small_text->SetTextAlignment(DWRITE_TEXT_ALIGNMENT_TRAILING);
 
     // Create a medium text format for loaded data (double the size of small font)
-    DX_CALL(dwrite_factory_->CreateTextFormat(L"Consolas", nullptr, // Using monospaced font for data
+    DX_CALL(formats.factory->CreateTextFormat(L"Consolas", nullptr, // Using monospaced font for data
                                               DWRITE_FONT_WEIGHT_NORMAL, DWRITE_FONT_STYLE_NORMAL,
                                               DWRITE_FONT_STRETCH_NORMAL,
-                                              24.0f, // Double the size of small_text_format_
-                                              L"en-us", data_text_format_.GetAddressOf()),
+                                              24.0f, // Double the size of the small format
+                                              L"en-us", formats.data_text.GetAddressOf()),
             "Failed to create data text format.");
-    data_text_format_->SetParagraphAlignment(DWRITE_PARAGRAPH_ALIGNMENT_NEAR);
-    data_text_format_->SetWordWrapping(DWRITE_WORD_WRAPPING_WRAP);
-    data_text_format_->SetTextAlignment(DWRITE_TEXT_ALIGNMENT_LEADING);
+    formats.data_text->SetParagraphAlignment(DWRITE_PARAGRAPH_ALIGNMENT_NEAR);
+    formats.data_text->SetWordWrapping(DWRITE_WORD_WRAPPING_WRAP);
+    formats.data_text->SetTextAlignment(DWRITE_TEXT_ALIGNMENT_LEADING);
+
+    // Same size as the small format but leading-aligned, so the stats table
+    // columns line up.
+    DX_CALL(formats.factory->CreateTextFormat(L"Consolas", nullptr, DWRITE_FONT_WEIGHT_NORMAL, DWRITE_FONT_STYLE_NORMAL,
+                                              DWRITE_FONT_STRETCH_NORMAL, 12.0f, L"en-us",
+                                              formats.stats_text.GetAddressOf()),
+            "Failed to create stats text format.");
+    formats.stats_text->SetParagraphAlignment(DWRITE_PARAGRAPH_ALIGNMENT_NEAR);
+    formats.stats_text->SetWordWrapping(DWRITE_WORD_WRAPPING_NO_WRAP);
+    formats.stats_text->SetTextAlignment(DWRITE_TEXT_ALIGNMENT_LEADING);
+
+    // Argument rows: same face as the HUD, but one line per argument with
+    // anything wider than the window cut with an ellipsis.
+    DX_CALL(formats.factory->CreateTextFormat(L"Arial", nullptr, DWRITE_FONT_WEIGHT_NORMAL, DWRITE_FONT_STYLE_NORMAL,
+                                              DWRITE_FONT_STRETCH_NORMAL, 24.0f, L"en-us",
+                                              formats.arg_row.GetAddressOf()),
+            "Failed to create argument row text format.");
+    formats.arg_row->SetTextAlignment(DWRITE_TEXT_ALIGNMENT_LEADING);
+    formats.arg_row->SetParagraphAlignment(DWRITE_PARAGRAPH_ALIGNMENT_NEAR);
+    formats.arg_row->SetWordWrapping(DWRITE_WORD_WRAPPING_NO_WRAP);
+    ComPtr<IDWriteInlineObject> ellipsis;
+    DX_CALL(formats.factory->CreateEllipsisTrimmingSign(formats.arg_row.Get(), ellipsis.GetAddressOf()),
+            "Failed to create ellipsis trimming sign.");
+    const DWRITE_TRIMMING trimming = {DWRITE_TRIMMING_GRANULARITY_CHARACTER, 0, 0};
+    formats.arg_row->SetTrimming(&trimming, ellipsis.Get());
+    return formats;
+}
+
+void ArgumentDebuggerWindow::CreateD2DResources()
+{
+    // Create the Direct2D factory.
+    DX_CALL(D2D1CreateFactory(D2D1_FACTORY_TYPE_SINGLE_THREADED, D2D1_FACTORY_OPTIONS{}, d2d_factory_.GetAddressOf()),
+            "Failed to create Direct2D factory.");
+
+    // Get the DXGI surface from the swap chain.
+    ComPtr<IDXGISurface> dxgi_surface;
+    DX_CALL(swap_chain_->GetBuffer(0, IID_PPV_ARGS(&dxgi_surface)), "Failed to get DXGI surface.");
+
+    D2D1_RENDER_TARGET_PROPERTIES props = D2D1::RenderTargetProperties(
+        D2D1_RENDER_TARGET_TYPE_DEFAULT, D2D1::PixelFormat(DXGI_FORMAT_UNKNOWN, D2D1_ALPHA_MODE_PREMULTIPLIED), 0, 0);
+    DX_CALL(d2d_factory_->CreateDxgiSurfaceRenderTarget(dxgi_surface.Get(), &props, d2d_render_target_.GetAddressOf()),
+            "Failed to create Direct2D render target.");
+
+    // The QR bitmap belongs to the old render target; rebuild it from the
+    // last pixels instead of waiting for the next payload.
+    qr_bitmap_.Reset();
+    if (!qr_pixels_.empty())
+        UploadQrPixels();
 
     // Create brushes once during initialization
     DX_CALL(d2d_render_target_->CreateSolidColorBrush(D2D1::ColorF(D2D1::ColorF::White), white_brush_.GetAddressOf()),
@@ -674,40 +1390,55 @@ void ArgumentDebuggerWindow::CreateD2DResources()
             "Failed to create yellow brush.");
 }
 
+#ifdef RUNTIME_SHADER_COMPILE
+namespace
+{
+
+// Throws on failure; the compiler's diagnostics go to the log first.
+ComPtr<ID3DBlob> CompileShaderFromFile(const wchar_t* path, const char* entry, const char* target)
+{
+    ComPtr<ID3DBlob> code, errors;
+    const HRESULT hr = D3DCompileFromFile(path, nullptr, D3D_COMPILE_STANDARD_FILE_INCLUDE, entry, target, 0, 0,
+                                          code.GetAddressOf(), errors.GetAddressOf());
+    if (FAILED(hr))
+    {
+        if (errors)
+        {
+            const char* text = static_cast<const char*>(errors->GetBufferPointer());
+            Log(L"Shader compile failed: " + std::wstring(text, text + strnlen(text, errors->GetBufferSize())));
+        }
+        throw std::runtime_error("Failed to compile shader.");
+    }
+    Log(L"Compiled " + std::wstring(entry, entry + strlen(entry)) + L" from " + path + L" at run time");
+    return code;
+}
+
+} // namespace
+#endif
+
 void ArgumentDebuggerWindow::CreateShadersAndGeometry()
 {
-    // Vertex shader source code.
-    constexpr const char vs_src[] = "cbuffer ConstantBuffer : register(b0) {"
-                                    "    matrix WorldViewProjection;"
-                                    "};"
-                                    "struct VS_INPUT { float3 Pos : POSITION; float3 Color : COLOR; };"
-                                    "struct PS_INPUT { float4 Pos : SV_POSITION; float3 Color : COLOR; };"
-                                    "PS_INPUT VSMain(VS_INPUT input) {"
-                                    "    PS_INPUT output;"
-                                    "    output.Pos = mul(float4(input.Pos, 1.0f), WorldViewProjection);"
-                                    "    output.Color = input.Color;"
-                                    "    return output;"
-                                    "}";
-
-    // Pixel shader source code.
-    constexpr const char ps_src[] = "struct PS_INPUT { float4 Pos : SV_POSITION; float3 Color : COLOR; };"
-                                    "float4 PSMain(PS_INPUT input) : SV_Target {"
-                                    "    return float4(input.Color, 1.0f);"
-                                    "}";
-
-    ComPtr<ID3DBlob> vs_blob, ps_blob, error_blob;
-    DX_CALL(D3DCompile(vs_src, sizeof(vs_src) - 1, nullptr, nullptr, nullptr, "VSMain", "vs_4_0", 0, 0,
-                       vs_blob.GetAddressOf(), error_blob.GetAddressOf()),
-            "Failed to compile vertex shader.");
-    DX_CALL(D3DCompile(ps_src, sizeof(ps_src) - 1, nullptr, nullptr, nullptr, "PSMain", "ps_4_0", 0, 0,
-                       ps_blob.GetAddressOf(), error_blob.GetAddressOf()),
-            "Failed to compile pixel shader.");
-
-    DX_CALL(d3d_device_->CreateVertexShader(vs_blob->GetBufferPointer(), vs_blob->GetBufferSize(), nullptr,
-                                            vertex_shader_.GetAddressOf()),
+    const void* vs_code = nullptr;
+    SIZE_T vs_size = 0;
+    const void* ps_code = nullptr;
+    SIZE_T ps_size = 0;
+#ifdef RUNTIME_SHADER_COMPILE
+    ComPtr<ID3DBlob> vs_blob = CompileShaderFromFile(CUBE_SHADER_PATH, "VSMain", "vs_4_0");
+    ComPtr<ID3DBlob> ps_blob = CompileShaderFromFile(CUBE_SHADER_PATH, "PSMain", "ps_4_0");
+    vs_code = vs_blob->GetBufferPointer();
+    vs_size = vs_blob->GetBufferSize();
+    ps_code = ps_blob->GetBufferPointer();
+    ps_size = ps_blob->GetBufferSize();
+#else
+    vs_code = g_cube_vs;
+    vs_size = sizeof(g_cube_vs);
+    ps_code = g_cube_ps;
+    ps_size = sizeof(g_cube_ps);
+#endif
+
+    DX_CALL(d3d_device_->CreateVertexShader(vs_code, vs_size, nullptr, vertex_shader_.GetAddressOf()),
             "Failed to create vertex shader.");
-    DX_CALL(d3d_device_->CreatePixelShader(ps_blob->GetBufferPointer(), ps_blob->GetBufferSize(), nullptr,
-                                           pixel_shader_.GetAddressOf()),
+    DX_CALL(d3d_device_->CreatePixelShader(ps_code, ps_size, nullptr, pixel_shader_.GetAddressOf()),
             "Failed to create pixel shader.");
 
     // Define input layout.
@@ -715,8 +1446,7 @@ void ArgumentDebuggerWindow::CreateShadersAndGeometry()
         {{"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0},
          {"COLOR", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 12, D3D11_INPUT_PER_VERTEX_DATA, 0}}};
     DX_CALL(d3d_device_->CreateInputLayout(layout_desc.data(), static_cast<UINT>(layout_desc.size()),
-                                           vs_blob->GetBufferPointer(), vs_blob->GetBufferSize(),
-                                           vertex_layout_.GetAddressOf()),
+                                           vs_code, vs_size, vertex_layout_.GetAddressOf()),
             "Failed to create input layout.");
     immediate_context_->IASetInputLayout(vertex_layout_.Get());
 
@@ -761,104 +1491,381 @@ void ArgumentDebuggerWindow::CreateShadersAndGeometry()
             "Failed to create constant buffer.");
 }
 
-void ArgumentDebuggerWindow::UpdateQrCode(ULONGLONG current_time)
+namespace
 {
-    // Update the QR code no more than once every 5 seconds.
-    if (current_time - last_qr_update_time_ < 5000)
-        return;
-    last_qr_update_time_ = current_time;
 
-    time_t unix_time = time(nullptr);
-    // Get the integer value of FPS.
-    int fps_for_qr = static_cast<int>(current_fps_);
-
-    // Save this value for synchronized file output.
-    synced_fps_ = fps_for_qr;
-
-    // Create the string for the QR code
-    std::ostringstream oss;
-    oss << "t=" << unix_time << ";f=" << fps_for_qr;
-    if (!args_.empty())
+// Microsoft Basic Render Driver (WARP behind D3D_DRIVER_TYPE_HARDWARE) or
+// any adapter DXGI flags as software.
+bool IsSoftwareAdapter(ID3D11Device* device, std::wstring& description)
+{
+    ComPtr<IDXGIDevice> dxgi_device;
+    ComPtr<IDXGIAdapter> adapter;
+    ComPtr<IDXGIAdapter1> adapter1;
+    DXGI_ADAPTER_DESC1 desc{};
+    if (FAILED(device->QueryInterface(IID_PPV_ARGS(&dxgi_device))) ||
+        FAILED(dxgi_device->GetAdapter(adapter.GetAddressOf())) || FAILED(adapter.As(&adapter1)) ||
+        FAILED(adapter1->GetDesc1(&desc)))
     {
-        oss << ";args=";
-        for (const auto& arg : args_)
-        {
-            oss << wstring_to_string(arg) << " ";
-        }
+        description = L"<unknown adapter>";
+        return false;
     }
-    std::string qr_data = oss.str();
+    description = desc.Description;
+    constexpr UINT kMicrosoftVendorId = 0x1414;
+    constexpr UINT kBasicRenderDeviceId = 0x8c;
+    return (desc.Flags & DXGI_ADAPTER_FLAG_SOFTWARE) != 0 ||
+           (desc.VendorId == kMicrosoftVendorId && desc.DeviceId == kBasicRenderDeviceId);
+}
 
-    // Generate the QR code (error correction level MEDIUM).
-    QrCode qr = QrCode::encodeText(qr_data.c_str(), QrCode::Ecc::MEDIUM);
-    int qr_modules = qr.getSize();
-    constexpr int pixel_size = 375; // final size 375x375
-    float scale = static_cast<float>(pixel_size) / qr_modules;
-    std::vector<uint32_t> pixels(pixel_size * pixel_size, 0xffffffff); // white background
+} // namespace
+
+void ArgumentDebuggerWindow::CreateHudPipeline()
+{
+    if (options_.hud_backend == HudBackend::D2D)
+        return;
 
-    for (int y = 0; y < pixel_size; y++)
+    gpu_hud_ = TryCreateHudPipeline();
+    if (!gpu_hud_)
     {
-        for (int x = 0; x < pixel_size; x++)
-        {
-            int module_x = static_cast<int>(x / scale);
-            int module_y = static_cast<int>(y / scale);
-            if (module_x < qr_modules && module_y < qr_modules)
-            {
-                if (qr.getModule(module_x, module_y))
-                    pixels[y * pixel_size + x] = 0xff000000; // black pixel
-            }
-        }
+        hud_vertex_shader_.Reset();
+        hud_pixel_shader_.Reset();
+        hud_rasterizer_.Reset();
+        hud_quad_srv_.Reset();
+        hud_quad_buffer_.Reset();
+        hud_constants_.Reset();
     }
-
-    D2D1_BITMAP_PROPERTIES bitmapProperties = {};
-    bitmapProperties.pixelFormat.format = DXGI_FORMAT_B8G8R8A8_UNORM;
-    bitmapProperties.pixelFormat.alphaMode = D2D1_ALPHA_MODE_PREMULTIPLIED;
-    bitmapProperties.dpiX = 96.0f;
-    bitmapProperties.dpiY = 96.0f;
-
+    // The QR code lives in qr_bitmap_ or qr_quads_ depending on the backend;
+    // rebuild the one in use from the last pixels.
     qr_bitmap_.Reset();
-    DX_CALL(d2d_render_target_->CreateBitmap(D2D1::SizeU(pixel_size, pixel_size), pixels.data(),
-                                             pixel_size * sizeof(uint32_t), &bitmapProperties,
-                                             qr_bitmap_.GetAddressOf()),
-            "Failed to create QR code bitmap.");
+    qr_quads_valid_ = false;
+    if (!qr_pixels_.empty())
+        UploadQrPixels();
 }
 
-void ArgumentDebuggerWindow::RenderFrame()
+bool ArgumentDebuggerWindow::TryCreateHudPipeline()
 {
-    UpdateFrameTiming();
-
-    RECT rc;
-    GetClientRect(window_handle_, &rc);
-    D3D11_VIEWPORT vp{};
+    std::wstring adapter;
+    const bool software = IsSoftwareAdapter(d3d_device_.Get(), adapter);
+    if (options_.hud_backend == HudBackend::Auto && !software)
+    {
+        Log(L"HUD: Direct2D on hardware adapter " + adapter);
+        return false;
+    }
+    if (d3d_device_->GetFeatureLevel() < D3D_FEATURE_LEVEL_11_0)
+    {
+        Log(L"HUD: GPU backend needs feature level 11_0 for structured buffers, using Direct2D on " + adapter);
+        return false;
+    }
+
+    try
+    {
+        const void* vs_code = nullptr;
+        SIZE_T vs_size = 0;
+        const void* ps_code = nullptr;
+        SIZE_T ps_size = 0;
+#ifdef RUNTIME_SHADER_COMPILE
+        ComPtr<ID3DBlob> vs_blob = CompileShaderFromFile(HUD_SHADER_PATH, "HudVS", "vs_5_0");
+        ComPtr<ID3DBlob> ps_blob = CompileShaderFromFile(HUD_SHADER_PATH, "HudPS", "ps_5_0");
+        vs_code = vs_blob->GetBufferPointer();
+        vs_size = vs_blob->GetBufferSize();
+        ps_code = ps_blob->GetBufferPointer();
+        ps_size = ps_blob->GetBufferSize();
+#else
+        vs_code = g_hud_vs;
+        vs_size = sizeof(g_hud_vs);
+        ps_code = g_hud_ps;
+        ps_size = sizeof(g_hud_ps);
+#endif
+        DX_CALL(d3d_device_->CreateVertexShader(vs_code, vs_size, nullptr, hud_vertex_shader_.ReleaseAndGetAddressOf()),
+                "Failed to create HUD vertex shader.");
+        DX_CALL(d3d_device_->CreatePixelShader(ps_code, ps_size, nullptr, hud_pixel_shader_.ReleaseAndGetAddressOf()),
+                "Failed to create HUD pixel shader.");
+
+        // CPU-side storage is sized once and survives device recreation.
+        if (hud_batch_.Capacity() == 0)
+            hud_batch_ = HudBatch();
+        qr_quads_.resize(kMaxQrQuads);
+
+        // Rewritten with WRITE_DISCARD every frame; the driver renames it.
+        D3D11_BUFFER_DESC bd = {};
+        bd.Usage = D3D11_USAGE_DYNAMIC;
+        bd.ByteWidth = static_cast<UINT>(sizeof(HudQuad) * hud_batch_.Capacity());
+        bd.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+        bd.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+        bd.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+        bd.StructureByteStride = sizeof(HudQuad);
+        DX_CALL(d3d_device_->CreateBuffer(&bd, nullptr, hud_quad_buffer_.ReleaseAndGetAddressOf()),
+                "Failed to create HUD quad buffer.");
+
+        D3D11_SHADER_RESOURCE_VIEW_DESC srv_desc = {};
+        srv_desc.Format = DXGI_FORMAT_UNKNOWN;
+        srv_desc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
+        srv_desc.Buffer.FirstElement = 0;
+        srv_desc.Buffer.NumElements = static_cast<UINT>(hud_batch_.Capacity());
+        DX_CALL(d3d_device_->CreateShaderResourceView(hud_quad_buffer_.Get(), &srv_desc,
+                                                      hud_quad_srv_.ReleaseAndGetAddressOf()),
+                "Failed to create HUD quad view.");
+
+        bd = {};
+        bd.Usage = D3D11_USAGE_DEFAULT;
+        bd.ByteWidth = sizeof(HudConstantsData);
+        bd.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+        DX_CALL(d3d_device_->CreateBuffer(&bd, nullptr, hud_constants_.ReleaseAndGetAddressOf()),
+                "Failed to create HUD constant buffer.");
+
+        D3D11_RASTERIZER_DESC rd = {};
+        rd.FillMode = D3D11_FILL_SOLID;
+        rd.CullMode = D3D11_CULL_NONE;
+        rd.DepthClipEnable = TRUE;
+        DX_CALL(d3d_device_->CreateRasterizerState(&rd, hud_rasterizer_.ReleaseAndGetAddressOf()),
+                "Failed to create HUD rasterizer state.");
+    }
+    catch (const std::exception& ex)
+    {
+        Log(L"HUD: GPU backend unavailable (" + std::wstring(ex.what(), ex.what() + strlen(ex.what())) +
+            L"), using Direct2D");
+        return false;
+    }
+
+    hud_viewport_width_ = 0.0f;
+    hud_viewport_height_ = 0.0f;
+    Log(L"HUD: meter, graph and QR code drawn as one instanced D3D11 draw on " + adapter +
+        (software ? L" (software adapter)" : L""));
+    return true;
+}
+
+void ArgumentDebuggerWindow::RequestQrIfDue(LONGLONG now_qpc)
+{
+    // Refresh no more often than --qr-interval (default every 5 seconds), or
+    // as soon as --latency-probe has measured another keystroke.
+    if (!QrUpdateDue(now_qpc) && latency_probe_.Completed() == latency_in_qr_)
+        return;
+    last_qr_update_qpc_ = now_qpc;
+
+    QrStamp stamp;
+    stamp.unix_time = static_cast<long long>(time(nullptr));
+    // Get the integer value of FPS.
+    stamp.fps = static_cast<int>(current_fps_);
+    stamp.frame = frame_counter_;
+    stamp.qpc = now_qpc;
+    if (latency_probe_.Completed() != 0)
+    {
+        const KeystrokeLatency& key = latency_probe_.Last();
+        stamp.key = key.sequence;
+        stamp.key_latency_us = static_cast<uint32_t>(key.total_ms * 1000.0f + 0.5f);
+        latency_in_qr_ = latency_probe_.Completed();
+    }
+
+    // Save this value for synchronized file output.
+    synced_fps_ = stamp.fps;
+
+    trace_events::QrRequest(stamp.frame, stamp.qpc);
+    qr_worker_.Request(stamp);
+}
+
+void ArgumentDebuggerWindow::UpdateQrCode(LONGLONG now_qpc)
+{
+    // Encoding happens on qr_worker_; this frame only picks up a finished
+    // buffer, usually the one requested a frame or two ago.
+    RequestQrIfDue(now_qpc);
+    if (qr_worker_.TryTake(qr_pixels_))
+    {
+        trace_events::QrTake(frame_counter_);
+        UploadQrPixels();
+    }
+}
+
+void ArgumentDebuggerWindow::UploadQrPixels()
+{
+    constexpr int pixel_size = QrWorker::kPixelSize;
+    if (qr_pixels_.size() != static_cast<size_t>(pixel_size) * pixel_size)
+        return;
+
+    if (gpu_hud_)
+    {
+        // Background plus one quad per run of dark modules, drawn with the
+        // rest of the HUD.
+        qr_quad_count_ = hud_batch::detail::BuildImageQuads(qr_pixels_.data(), pixel_size, pixel_size,
+                                                            kHudBlack, qr_quads_.data(), qr_quads_.size());
+        qr_quads_valid_ = true;
+        return;
+    }
+
+    if (!qr_bitmap_)
+    {
+        D2D1_BITMAP_PROPERTIES bitmapProperties = {};
+        bitmapProperties.pixelFormat.format = DXGI_FORMAT_B8G8R8A8_UNORM;
+        bitmapProperties.pixelFormat.alphaMode = D2D1_ALPHA_MODE_PREMULTIPLIED;
+        bitmapProperties.dpiX = 96.0f;
+        bitmapProperties.dpiY = 96.0f;
+
+        DX_CALL(d2d_render_target_->CreateBitmap(D2D1::SizeU(pixel_size, pixel_size), qr_pixels_.data(),
+                                                 pixel_size * sizeof(uint32_t), &bitmapProperties,
+                                                 qr_bitmap_.GetAddressOf()),
+                "Failed to create QR code bitmap.");
+        return;
+    }
+
+    DX_CALL(qr_bitmap_->CopyFromMemory(nullptr, qr_pixels_.data(), pixel_size * sizeof(uint32_t)),
+            "Failed to update QR code bitmap.");
+}
+
+unsigned ArgumentDebuggerWindow::PollRedraw()
+{
+    if (!redraw_gate_.IsLowPower())
+        return kRedrawAll;
+
+    // A keystroke shown since the last frame completes here, so its QR
+    // payload does not wait for the next cube frame.
+    if (latency_probe_.AwaitingDisplay())
+        TrackInputLatency(false);
+    // Queue the payload now so the worker has it ready by the time a frame
+    // is worth drawing; redraw once the pixels arrive.
+    RequestQrIfDue(FramePacer::Now());
+    if (qr_worker_.HasResult())
+        redraw_gate_.Invalidate(kRedrawQr);
+    if (command_status_ != drawn_status_)
+        redraw_gate_.Invalidate(kRedrawStatus);
+    redraw_gate_.ObserveMeterLevel(audio_ready_ && audio_capture_.IsAvailable() ? audio_capture_.Level() : 0.0f);
+    return redraw_gate_.Poll(FramePacer::Now());
+}
+
+void ArgumentDebuggerWindow::RenderFrame(unsigned redraw)
+{
+    const LONGLONG frame_start = FramePacer::Now();
+    ++frame_counter_;
+    // Anything below that allocates only because its input changed opts
+    // out with alloc_guard::ScopedAllowAlloc.
+    alloc_guard::ScopedNoAlloc no_alloc(text_ready_ && frame_counter_ > kAllocGuardWarmupFrames);
+    trace_events::FrameStart(frame_counter_, redraw);
+    frame_stats_.BeginFrame();
+    UpdateFrameTiming();
+    UpdateRotation(static_cast<float>(redraw_gate_.BeginFrame(frame_start)));
+    if (drawn_status_ != command_status_)
+    {
+        alloc_guard::ScopedAllowAlloc allow;
+        drawn_status_ = command_status_;
+    }
+
+    RECT rc;
+    GetClientRect(window_handle_, &rc);
+    D3D11_VIEWPORT vp{};
     vp.Width = static_cast<float>(rc.right - rc.left);
     vp.Height = static_cast<float>(rc.bottom - rc.top);
     vp.MaxDepth = 1.0f;
-    RenderCube(vp);
+    {
+        ScopedSectionTimer timer(frame_stats_, FrameSection::Cube);
+        RenderCube(vp);
+    }
 
+    if (gpu_hud_)
+        hud_batch_.Clear();
     d2d_render_target_->BeginDraw();
-    UpdateQrCode(GetTickCount64());
+    {
+        ScopedSectionTimer timer(frame_stats_, FrameSection::QrUpdate);
+        UpdateQrCode(frame_start);
+    }
 
+    // Until the startup task delivers the text formats (usually before the
+    // first frame) only the cube and the QR code are drawn.
     const D2D1_SIZE_F size = d2d_render_target_->GetSize();
     float y_pos = kMargin;
-    RenderTextHud(size, y_pos);
-    RenderLoadedDataPanel(size);
-    RenderPathsPanel(size);
-    RenderInputPrompt(size);
+    if (text_ready_)
+    {
+        {
+            ScopedSectionTimer timer(frame_stats_, FrameSection::TextHud);
+            RenderTextHud(size, y_pos);
+        }
+        RenderLoadedDataPanel(size);
+        RenderPathsPanel(size);
+        RenderInputPrompt(size);
+    }
     RenderQrBitmap(size);
-    RenderVolumeMeter(size);
+    if (text_ready_)
+    {
+        RenderVolumeMeter(size);
+        RenderFrameStatsPanel(size);
+        RenderPresentModeLabel(size);
+    }
 
-    if (!EndOverlay()) // device lost → D2D resources already recreated
+    bool overlay_ok = false;
+    {
+        ScopedSectionTimer timer(frame_stats_, FrameSection::EndOverlay);
+        overlay_ok = EndOverlay(); // false: device lost → D2D resources already recreated
+        if (overlay_ok && gpu_hud_)
+            DrawHudQuads(vp);
+    }
+    bool presented = false;
+    if (overlay_ok)
+    {
+        ScopedSectionTimer timer(frame_stats_, FrameSection::Present);
+        presented = PresentFrame(redraw);
+    }
+    else
+    {
+        redraw_gate_.Invalidate(kRedrawAll);
+    }
+    if (!presented)
+        latency_probe_.OnPresentFailed();
+    else if (options_.latency_probe)
+        TrackInputLatency(true); // outside the Present timer, which measures Present alone
+
+    const double cpu_s = FramePacer::TicksToSeconds(FramePacer::Now() - frame_start);
+    frame_stats_.AddSample(FrameSection::Cpu, static_cast<float>(cpu_s * 1000.0));
+    frame_stats_.EndFrame();
+    trace_events::FrameStop(frame_counter_, static_cast<float>(cpu_s * 1000.0));
+    PublishFrameMetrics();
+}
+
+void ArgumentDebuggerWindow::PublishFrameMetrics()
+{
+    if (!metrics_.IsOpen())
         return;
 
-    PresentFrame();
+    const LONGLONG now = FramePacer::Now();
+    MetricsFrameSection& frame = metrics_frame_;
+    frame.frame_counter = frame_counter_;
+    frame.qpc = now;
+    frame.fps = current_fps_;
+    frame.synced_fps = synced_fps_;
+    frame_stats_.CopyHistory(FrameSection::Interval, &frame.interval_ms, 1);
+    frame_stats_.CopyHistory(FrameSection::Cpu, &frame.cpu_ms, 1);
+    MetricsPresentMode present_mode = MetricsPresentMode::Blt;
+    if (flip_model_active_)
+        present_mode = tearing_supported_ ? MetricsPresentMode::FlipTearing : MetricsPresentMode::Flip;
+    frame.present_mode = static_cast<uint32_t>(present_mode);
+    frame.low_power = redraw_gate_.IsLowPower() ? 1u : 0u;
+
+    // Same cadence as the on-screen table: percentiles are O(n log n).
+    if (last_metrics_summary_qpc_ == 0 || FramePacer::TicksToSeconds(now - last_metrics_summary_qpc_) >= 0.25)
+    {
+        last_metrics_summary_qpc_ = now;
+        const SectionSummary interval = frame_stats_.Summarize(FrameSection::Interval);
+        const SectionSummary cpu = frame_stats_.Summarize(FrameSection::Cpu);
+        frame.interval = {interval.p50_ms, interval.p95_ms, interval.p99_ms, interval.max_ms};
+        frame.cpu = {cpu.p50_ms, cpu.p95_ms, cpu.p99_ms, cpu.max_ms};
+    }
+    // GetProcessMemoryInfo is a kernel call; once a second is plenty.
+    if (last_metrics_memory_qpc_ == 0 || FramePacer::TicksToSeconds(now - last_metrics_memory_qpc_) >= 1.0)
+    {
+        last_metrics_memory_qpc_ = now;
+        PROCESS_MEMORY_COUNTERS_EX pmc{};
+        if (GetProcessMemoryInfo(GetCurrentProcess(), reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&pmc), sizeof(pmc)))
+        {
+            frame.working_set_bytes = pmc.WorkingSetSize;
+            frame.peak_working_set_bytes = pmc.PeakWorkingSetSize;
+            frame.private_bytes = pmc.PrivateUsage;
+        }
+    }
+    metrics_.PublishFrame(frame);
 }
 
 void ArgumentDebuggerWindow::UpdateFrameTiming()
 {
-    ULONGLONG current_time = GetTickCount64();
-    float delta_time = (current_time - last_time_) / 1000.0f;
-    last_time_ = current_time;
+    const LONGLONG current_qpc = FramePacer::Now();
+    const float delta_time = static_cast<float>(FramePacer::TicksToSeconds(current_qpc - last_frame_qpc_));
+    last_frame_qpc_ = current_qpc;
     current_fps_ = (delta_time > 0.0f) ? (1.0f / delta_time) : 0.0f;
-    UpdateRotation(delta_time);
+    frame_stats_.AddSample(FrameSection::Interval, delta_time * 1000.0f);
 }
 
 void ArgumentDebuggerWindow::RenderCube(const D3D11_VIEWPORT& vp)
@@ -870,6 +1877,10 @@ void ArgumentDebuggerWindow::RenderCube(const D3D11_VIEWPORT& vp)
 
     UINT stride = sizeof(SimpleVertex);
     UINT offset = 0;
+    // DrawHudQuads leaves its own layout (none) and rasterizer state bound;
+    // the cube relies on back-face culling since it has no depth buffer.
+    immediate_context_->IASetInputLayout(vertex_layout_.Get());
+    immediate_context_->RSSetState(nullptr);
     immediate_context_->IASetVertexBuffers(0, 1, vertex_buffer_.GetAddressOf(), &stride, &offset);
     immediate_context_->IASetIndexBuffer(index_buffer_.Get(), DXGI_FORMAT_R16_UINT, 0);
     immediate_context_->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
@@ -892,36 +1903,76 @@ void ArgumentDebuggerWindow::RenderCube(const D3D11_VIEWPORT& vp)
     immediate_context_->DrawIndexed(36, 0, 0);
 }
 
+void ArgumentDebuggerWindow::DrawCachedText(size_t slot, const std::wstring& text, IDWriteTextFormat* format,
+                                            const D2D1_RECT_F& rect, ID2D1Brush* brush)
+{
+    IDWriteTextLayout* layout = text_layouts_.Get(slot, text, format, rect.right - rect.left, rect.bottom - rect.top);
+    if (layout)
+        d2d_render_target_->DrawTextLayout(D2D1::Point2F(rect.left, rect.top), layout, brush);
+    else
+        d2d_render_target_->DrawText(text.c_str(), static_cast<UINT32>(text.size()), format, rect, brush);
+}
+
 void ArgumentDebuggerWindow::RenderTextHud(const D2D1_SIZE_F& size, float& y_pos)
 {
-    for (const auto& line : kDescriptionLines)
+    for (size_t i = 0; i < kDescriptionLines.size(); ++i)
     {
         D2D1_RECT_F rect = D2D1::RectF(kMargin, y_pos, size.width - kMargin, y_pos + kLineHeight);
-        d2d_render_target_->DrawText(line.c_str(), static_cast<UINT32>(line.size()), text_format_.Get(), rect,
-                                     white_brush_.Get());
+        DrawCachedText(kSlotDynamicBase + i, kDescriptionLines[i], text_format_.Get(), rect, white_brush_.Get());
         y_pos += kLineHeight;
     }
     y_pos += kLineHeight;
 
-    std::wstring cli_text = BuildCliHeaderText(args_);
     D2D1_RECT_F header_rect = D2D1::RectF(kMargin, y_pos, size.width - kMargin, y_pos + kLineHeight);
-    d2d_render_target_->DrawText(cli_text.c_str(), static_cast<UINT32>(cli_text.size()), text_format_.Get(),
-                                 header_rect, green_brush_.Get());
+    DrawCachedText(kSlotCliHeader, cli_header_text_, text_format_.Get(), header_rect, green_brush_.Get());
     y_pos += kLineHeight;
 
     if (!args_.empty())
+        RenderArgList(size, y_pos);
+
+    y_pos += 10.0f;
+    D2D1_RECT_F status_rect = D2D1::RectF(kMargin, size.height - 220.0f, size.width - kMargin, size.height - 190.0f);
+    DrawCachedText(kSlotStatus, command_status_, text_format_.Get(), status_rect, white_brush_.Get());
+}
+
+void ArgumentDebuggerWindow::RenderArgList(const D2D1_SIZE_F& size, float& y_pos)
+{
+    // Rows end one line above the status text; that line holds the scroll
+    // and search indicator.
+    const float list_bottom = size.height - 220.0f - kLineHeight;
+    const size_t page_rows = list_bottom > y_pos ? static_cast<size_t>((list_bottom - y_pos) / kLineHeight) : 1;
+    if (page_rows != arg_list_.PageRows())
     {
-        std::wstring formatted_args = BuildCliArgsText(args_);
-        D2D1_RECT_F args_rect = D2D1::RectF(kMargin, y_pos, size.width - kMargin, size.height - 200.0f);
-        d2d_render_target_->DrawText(formatted_args.c_str(), static_cast<UINT32>(formatted_args.size()),
-                                     text_format_.Get(), args_rect, green_brush_.Get());
+        alloc_guard::ScopedAllowAlloc allow; // window resized
+        arg_list_.SetPageRows(page_rows);
+        UpdateArgListStatus();
+    }
+
+    const float width = size.width - 2.0f * kMargin;
+    const std::vector<size_t>& matches = arg_list_.Matches();
+    for (size_t row = arg_list_.FirstRow(); row < arg_list_.EndRow(); ++row)
+    {
+        ID2D1Brush* brush = green_brush_.Get();
+        if (arg_list_.IsCurrentMatch(row))
+            brush = yellow_brush_.Get();
+        else if (std::binary_search(matches.begin(), matches.end(), row))
+            brush = white_brush_.Get();
+
+        const std::wstring& text = arg_list_.Row(row);
+        if (IDWriteTextLayout* layout = arg_layouts_.Get(row, text, arg_row_format_.Get(), width, kLineHeight))
+            d2d_render_target_->DrawTextLayout(D2D1::Point2F(kMargin, y_pos), layout, brush);
+        else
+            d2d_render_target_->DrawText(text.c_str(), static_cast<UINT32>(text.size()), arg_row_format_.Get(),
+                                         D2D1::RectF(kMargin, y_pos, kMargin + width, y_pos + kLineHeight), brush);
         y_pos += kLineHeight;
     }
 
-    y_pos += 10.0f;
-    D2D1_RECT_F status_rect = D2D1::RectF(kMargin, size.height - 220.0f, size.width - kMargin, size.height - 190.0f);
-    d2d_render_target_->DrawText(command_status_.c_str(), static_cast<UINT32>(command_status_.size()),
-                                 text_format_.Get(), status_rect, white_brush_.Get());
+    if (!arg_list_status_.empty())
+    {
+        D2D1_RECT_F rect = D2D1::RectF(kMargin, y_pos, size.width - kMargin, y_pos + kLineHeight);
+        DrawCachedText(kSlotArgListStatus, arg_list_status_, arg_row_format_.Get(), rect, yellow_brush_.Get());
+        y_pos += kLineHeight;
+    }
 }
 
 void ArgumentDebuggerWindow::RenderLoadedDataPanel(const D2D1_SIZE_F& size)
@@ -930,20 +1981,19 @@ void ArgumentDebuggerWindow::RenderLoadedDataPanel(const D2D1_SIZE_F& size)
         return;
 
     D2D1_RECT_F data_rect = D2D1::RectF(size.width - 750.0f, kMargin, size.width - kMargin, kMargin + 380.0f);
-    d2d_render_target_->DrawText(loaded_data_.c_str(), static_cast<UINT32>(loaded_data_.size()),
-                                 data_text_format_.Get(), data_rect, green_brush_.Get());
+    DrawCachedText(kSlotLoadedData, loaded_data_, data_text_format_.Get(), data_rect, green_brush_.Get());
 
     if (!loaded_data_title_.empty())
     {
         D2D1_RECT_F title_rect = D2D1::RectF(size.width - 750.0f, kMargin - 30.0f, size.width - kMargin, kMargin);
-        d2d_render_target_->DrawText(loaded_data_title_.c_str(), static_cast<UINT32>(loaded_data_title_.size()),
-                                     text_format_.Get(), title_rect, yellow_brush_.Get());
+        DrawCachedText(kSlotLoadedTitle, loaded_data_title_, text_format_.Get(), title_rect, yellow_brush_.Get());
     }
 }
 
 void ArgumentDebuggerWindow::RenderPathsPanel(const D2D1_SIZE_F& size)
 {
-    if (!show_paths_ || cached_path_items_.empty())
+    const PathSnapshot* paths = path_cache_.Current();
+    if (!show_paths_ || !paths || paths->lines.empty())
         return;
 
     constexpr float pathWidth = 400.0f;
@@ -952,65 +2002,73 @@ void ArgumentDebuggerWindow::RenderPathsPanel(const D2D1_SIZE_F& size)
     const float pathStartX = pathEndX - pathWidth;
     float currentY = size.height * 0.3f;
 
-    for (const auto& item : cached_path_items_)
+    const size_t base = kSlotDynamicBase + kDescriptionLines.size();
+    for (size_t i = 0; i < paths->lines.size(); ++i)
     {
-        std::wstring fullLine = item.first + item.second;
         D2D1_RECT_F rect = D2D1::RectF(pathStartX, currentY, pathEndX, currentY + pathLineHeight);
-        d2d_render_target_->DrawText(fullLine.c_str(), static_cast<UINT32>(fullLine.size()), small_text_format_.Get(),
-                                     rect, white_brush_.Get());
+        DrawCachedText(base + i, paths->lines[i], small_text_format_.Get(), rect, white_brush_.Get());
         currentY += pathLineHeight;
     }
 }
 
 void ArgumentDebuggerWindow::RenderInputPrompt(const D2D1_SIZE_F& size)
 {
-    const std::wstring exit_prompt =
-        L"Type 'exit', 'save', 'read', 'logs', 'path', 'sound' or 'memory' and press Enter:";
+    static const std::wstring exit_prompt =
+        L"Type 'exit', 'save', 'read', 'logs', 'path', 'sound', 'memory' or 'find <text>' and press Enter:";
     D2D1_RECT_F exit_prompt_rect =
         D2D1::RectF(kMargin, size.height - 100.0f, size.width - kMargin, size.height - 70.0f);
-    d2d_render_target_->DrawText(exit_prompt.c_str(), static_cast<UINT32>(exit_prompt.size()), text_format_.Get(),
-                                 exit_prompt_rect, yellow_brush_.Get());
+    DrawCachedText(kSlotExitPrompt, exit_prompt, text_format_.Get(), exit_prompt_rect, yellow_brush_.Get());
 
     D2D1_RECT_F user_input_rect = D2D1::RectF(kMargin, size.height - 60.0f, size.width - kMargin, size.height - 30.0f);
-    d2d_render_target_->DrawText(user_input_.c_str(), static_cast<UINT32>(user_input_.size()), text_format_.Get(),
-                                 user_input_rect, green_brush_.Get());
+    DrawCachedText(kSlotUserInput, user_input_, text_format_.Get(), user_input_rect, green_brush_.Get());
+    // This line shows every keystroke handled so far.
+    if (options_.latency_probe)
+        latency_probe_.OnDrawn(frame_counter_);
 }
 
 void ArgumentDebuggerWindow::RenderQrBitmap(const D2D1_SIZE_F& size)
 {
-    if (!qr_bitmap_)
+    if (gpu_hud_ ? !qr_quads_valid_ : !qr_bitmap_)
         return;
     constexpr int qr_size = 375;
     constexpr float qr_margin = 60.0f;
     const float qr_x = qr_margin;
     const float qr_y = size.height - qr_size - qr_margin - 100.0f - (size.height * 0.2f);
+    if (gpu_hud_)
+    {
+        // qr_size == QrWorker::kPixelSize, so image pixels map 1:1.
+        HudFillRect(D2D1::RectF(qr_x, qr_y, qr_x + qr_size, qr_y + qr_size), HudInk::White);
+        hud_batch_.Append(qr_quads_.data(), qr_quad_count_, qr_x, qr_y);
+        return;
+    }
     d2d_render_target_->DrawBitmap(qr_bitmap_.Get(), D2D1::RectF(qr_x, qr_y, qr_x + qr_size, qr_y + qr_size));
 }
 
 void ArgumentDebuggerWindow::RenderVolumeMeter(const D2D1_SIZE_F& size)
 {
-    if (!audio_capture_.IsAvailable())
+    if (!audio_ready_ || !audio_capture_.IsAvailable())
     {
-        std::wstring no_mic = L"No microphone detected";
+        const wchar_t* no_mic = audio_ready_ ? L"No microphone detected" : L"Microphone: starting...";
         D2D1_RECT_F r =
             D2D1::RectF(size.width - 300.f, size.height - 50.f, size.width - kMargin, size.height - kMargin);
-        d2d_render_target_->DrawText(no_mic.c_str(), static_cast<UINT32>(no_mic.size()), text_format_.Get(), r,
+        d2d_render_target_->DrawText(no_mic, static_cast<UINT32>(wcslen(no_mic)), text_format_.Get(), r,
                                      yellow_brush_.Get());
         return;
     }
 
-    const float level = audio_capture_.Level();
+    const MeterSnapshot& meter = audio_capture_.Meter();
+    // Before the first packet, show an idle stereo meter.
+    const UINT32 channels = meter.channels ? (std::min)(meter.channels, kMeterMaxChannels) : 2;
 
-    constexpr float bar_w = 30.0f;
+    // Two 30 px bars for mono/stereo as before; narrower bars for surround
+    // and multichannel virtual cables.
+    const float bar_w = channels <= 2 ? 30.0f : 12.0f;
+    const float spacing = channels <= 2 ? 15.0f : 4.0f;
     constexpr float bar_h = 150.0f;
-    constexpr float spacing = 15.0f;
-    const float total_width = bar_w * 2 + spacing;
+    const float total_width = bar_w * static_cast<float>(channels) + spacing * static_cast<float>(channels - 1);
     const float x0 = size.width - kMargin - total_width;
     const float y0 = size.height - kMargin - bar_h;
 
-    const std::wstring& dev_name = audio_capture_.Name();
-    const std::wstring dev_title = L"Mic: " + (dev_name.empty() ? L"<unknown>" : dev_name);
-
     constexpr float devAreaWidth = 200.0f;
     constexpr float devAreaHeight = 2 * kLineHeight;
     constexpr float marginBottom = 5.0f;
@@ -1019,29 +2077,199 @@ void ArgumentDebuggerWindow::RenderVolumeMeter(const D2D1_SIZE_F& size)
     const float devBottom = y0;
     const float devTop = devBottom - devAreaHeight - marginBottom;
 
-    d2d_render_target_->DrawText(dev_title.c_str(), static_cast<UINT32>(dev_title.size()), small_text_format_.Get(),
-                                 D2D1::RectF(devLeft, devTop, devRight, devBottom), white_brush_.Get());
+    DrawCachedText(kSlotMicTitle, mic_title_, small_text_format_.Get(),
+                   D2D1::RectF(devLeft, devTop, devRight, devBottom), white_brush_.Get());
 
-    // Left channel bar.
-    const float left_filled = bar_h * level;
-    d2d_render_target_->DrawRectangle(D2D1::RectF(x0, y0, x0 + bar_w, y0 + bar_h), white_brush_.Get(), 2.0f);
-    d2d_render_target_->FillRectangle(D2D1::RectF(x0, y0 + (bar_h - left_filled), x0 + bar_w, y0 + bar_h),
-                                      green_brush_.Get());
+    // One bar per channel: RMS filled, peak as a tick above it.
+    static constexpr const wchar_t* kStereoLabels[] = {L"L", L"R"};
+    static constexpr const wchar_t* kChannelLabels[] = {L"1", L"2", L"3", L"4", L"5", L"6", L"7", L"8"};
+    for (UINT32 c = 0; c < channels; ++c)
+    {
+        const float x = x0 + static_cast<float>(c) * (bar_w + spacing);
+        const ChannelLevel& level = meter.levels[c];
+        const float rms_h = bar_h * (std::min)(level.rms, 1.0f);
+        const float peak_y = y0 + bar_h - bar_h * (std::min)(level.peak, 1.0f);
+
+        HudDrawRect(D2D1::RectF(x, y0, x + bar_w, y0 + bar_h), HudInk::White, 2.0f);
+        HudFillRect(D2D1::RectF(x, y0 + (bar_h - rms_h), x + bar_w, y0 + bar_h), HudInk::Green);
+        HudDrawLine(D2D1::Point2F(x, peak_y), D2D1::Point2F(x + bar_w, peak_y), HudInk::Yellow, 2.0f);
+
+        const wchar_t* label = channels == 1 ? L"M" : channels == 2 ? kStereoLabels[c] : kChannelLabels[c];
+        d2d_render_target_->DrawText(label, 1, channels <= 2 ? text_format_.Get() : small_text_format_.Get(),
+                                     D2D1::RectF(x, y0 - 30.0f, x + bar_w, y0), yellow_brush_.Get());
+    }
 
-    // Right channel bar — slight variation for visual distinction from mono.
-    const float right_level = level * 0.9f;
-    const float right_filled = bar_h * right_level;
-    const float right_x = x0 + bar_w + spacing;
-    d2d_render_target_->DrawRectangle(D2D1::RectF(right_x, y0, right_x + bar_w, y0 + bar_h), white_brush_.Get(), 2.0f);
-    d2d_render_target_->FillRectangle(D2D1::RectF(right_x, y0 + (bar_h - right_filled), right_x + bar_w, y0 + bar_h),
-                                      green_brush_.Get());
+    // Min/max envelope of the first two channels above the device name,
+    // newest on the right, one lane per channel.
+    constexpr float wave_h = 40.0f;
+    const float wave_bottom = devTop - marginBottom;
+    const float wave_top = wave_bottom - wave_h;
+    HudDrawRect(D2D1::RectF(devLeft, wave_top, devRight, wave_bottom), HudInk::White, 1.0f);
+
+    const UINT32 lanes = (std::min)(channels, kMeterWaveformChannels);
+    const float lane_h = wave_h / static_cast<float>(lanes);
+    const float step = devAreaWidth / static_cast<float>(kMeterHistoryLength);
+    const UINT32 points = meter.history_length;
+    for (UINT32 c = 0; c < lanes; ++c)
+    {
+        const float mid = wave_top + lane_h * (static_cast<float>(c) + 0.5f);
+        const float half = lane_h * 0.5f;
+        for (UINT32 i = 0; i < points; ++i)
+        {
+            const WaveformPoint& p = meter.history[c][i];
+            const float x = devLeft + step * static_cast<float>(kMeterHistoryLength - points + i) + step * 0.5f;
+            const float top = mid - half * (std::min)(p.max, 1.0f);
+            const float bottom = mid - half * (std::max)(p.min, -1.0f);
+            HudDrawLine(D2D1::Point2F(x, top), D2D1::Point2F(x, (std::max)(bottom, top + 1.0f)), HudInk::Green, step);
+        }
+    }
+}
 
-    const std::wstring left_label = L"L";
-    const std::wstring right_label = L"R";
-    d2d_render_target_->DrawText(left_label.c_str(), static_cast<UINT32>(left_label.size()), text_format_.Get(),
-                                 D2D1::RectF(x0, y0 - 30.0f, x0 + bar_w, y0), yellow_brush_.Get());
-    d2d_render_target_->DrawText(right_label.c_str(), static_cast<UINT32>(right_label.size()), text_format_.Get(),
-                                 D2D1::RectF(right_x, y0 - 30.0f, right_x + bar_w, y0), yellow_brush_.Get());
+void ArgumentDebuggerWindow::RenderFrameStatsPanel(const D2D1_SIZE_F& size)
+{
+    // Percentiles are O(n log n) over the window; refresh the table a few
+    // times per second instead of every frame.
+    const LONGLONG now = FramePacer::Now();
+    if (frame_stats_text_.empty() || FramePacer::TicksToSeconds(now - last_stats_text_qpc_) >= 0.25)
+    {
+        last_stats_text_qpc_ = now;
+
+        static constexpr FrameSection kRows[] = {FrameSection::Interval, FrameSection::Cpu,
+                                                 FrameSection::Cube,     FrameSection::TextHud,
+                                                 FrameSection::QrUpdate, FrameSection::EndOverlay,
+                                                 FrameSection::Present};
+        wchar_t buf[1024];
+        int len = swprintf_s(buf, L"%-8ls %6ls %6ls %6ls %6ls\n", L"ms", L"p50", L"p95", L"p99", L"max");
+        for (FrameSection section : kRows)
+        {
+            if (len < 0)
+                break;
+            const SectionSummary sum = frame_stats_.Summarize(section);
+            const int n = swprintf_s(buf + len, _countof(buf) - len, L"%-8ls %6.2f %6.2f %6.2f %6.2f\n",
+                                     FrameSectionName(section), sum.p50_ms, sum.p95_ms, sum.p99_ms, sum.max_ms);
+            len = n < 0 ? -1 : len + n;
+        }
+        // Reserved once, so later refreshes reuse the buffer.
+        if (frame_stats_text_.capacity() < _countof(buf))
+            frame_stats_text_.reserve(_countof(buf));
+        if (len > 0)
+            frame_stats_text_.assign(buf, static_cast<size_t>(len));
+    }
+
+    // Sits left of the device name / volume meter block.
+    constexpr float panel_w = 330.0f;
+    constexpr float table_h = 120.0f;
+    constexpr float graph_h = 60.0f;
+    const float right = size.width - kMargin - 235.0f;
+    const float left = right - panel_w;
+    const float bottom = size.height - kMargin;
+    const float graph_top = bottom - graph_h;
+    const float table_top = graph_top - table_h;
+
+    DrawCachedText(kSlotFrameStats, frame_stats_text_, stats_text_format_.Get(),
+                   D2D1::RectF(left, table_top, right, graph_top), white_brush_.Get());
+
+    // Frame-interval graph, newest sample on the right. Full scale is 50 ms
+    // (three 60 Hz frames); anything above 25 ms is highlighted.
+    constexpr float full_scale_ms = 50.0f;
+    const size_t n = frame_stats_.CopyHistory(FrameSection::Interval, frame_graph_.data(), frame_graph_.size());
+    const float step = panel_w / static_cast<float>(kFrameGraphSamples);
+    HudDrawRect(D2D1::RectF(left, graph_top, right, bottom), HudInk::White, 1.0f);
+    const float target_y = bottom - graph_h * (16.67f / full_scale_ms);
+    HudDrawLine(D2D1::Point2F(left, target_y), D2D1::Point2F(right, target_y), HudInk::Yellow, 0.5f);
+    for (size_t i = 0; i < n; ++i)
+    {
+        const float ms = frame_graph_[i];
+        const float h = graph_h * (std::min)(ms / full_scale_ms, 1.0f);
+        const float x = left + step * static_cast<float>(kFrameGraphSamples - n + i) + step * 0.5f;
+        HudDrawLine(D2D1::Point2F(x, bottom), D2D1::Point2F(x, bottom - h), ms > 25.0f ? HudInk::Yellow : HudInk::Green,
+                    step * 0.8f);
+    }
+}
+
+void ArgumentDebuggerWindow::RenderPresentModeLabel(const D2D1_SIZE_F& size)
+{
+    // Directly under the QR code (same geometry as RenderQrBitmap).
+    constexpr float qr_size = 375.0f;
+    constexpr float qr_margin = 60.0f;
+    const float qr_y = size.height - qr_size - qr_margin - 100.0f - (size.height * 0.2f);
+    const float label_y = qr_y + qr_size + 5.0f;
+    DrawCachedText(kSlotPresentMode, present_mode_label_, text_format_.Get(),
+                   D2D1::RectF(qr_margin, label_y, size.width - kMargin, label_y + kLineHeight), white_brush_.Get());
+}
+
+ID2D1SolidColorBrush* ArgumentDebuggerWindow::InkBrush(HudInk ink) const
+{
+    switch (ink)
+    {
+    case HudInk::White:
+        return white_brush_.Get();
+    case HudInk::Green:
+        return green_brush_.Get();
+    case HudInk::Yellow:
+    default:
+        return yellow_brush_.Get();
+    }
+}
+
+void ArgumentDebuggerWindow::HudFillRect(const D2D1_RECT_F& rect, HudInk ink)
+{
+    if (gpu_hud_)
+        hud_batch_.Fill(rect.left, rect.top, rect.right, rect.bottom, kHudInkColors[static_cast<size_t>(ink)]);
+    else
+        d2d_render_target_->FillRectangle(rect, InkBrush(ink));
+}
+
+void ArgumentDebuggerWindow::HudDrawRect(const D2D1_RECT_F& rect, HudInk ink, float width)
+{
+    if (gpu_hud_)
+        hud_batch_.Outline(rect.left, rect.top, rect.right, rect.bottom, width,
+                           kHudInkColors[static_cast<size_t>(ink)]);
+    else
+        d2d_render_target_->DrawRectangle(rect, InkBrush(ink), width);
+}
+
+void ArgumentDebuggerWindow::HudDrawLine(D2D1_POINT_2F from, D2D1_POINT_2F to, HudInk ink, float width)
+{
+    if (gpu_hud_)
+        hud_batch_.Line(from.x, from.y, to.x, to.y, width, kHudInkColors[static_cast<size_t>(ink)]);
+    else
+        d2d_render_target_->DrawLine(from, to, InkBrush(ink), width);
+}
+
+void ArgumentDebuggerWindow::DrawHudQuads(const D3D11_VIEWPORT& vp)
+{
+    const size_t count = hud_batch_.Size();
+    if (count == 0 || vp.Width <= 0.0f || vp.Height <= 0.0f)
+        return;
+
+    D3D11_MAPPED_SUBRESOURCE mapped{};
+    if (FAILED(immediate_context_->Map(hud_quad_buffer_.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped)))
+        return; // device removed; PresentFrame recreates the pipeline
+    memcpy(mapped.pData, hud_batch_.Data(), count * sizeof(HudQuad));
+    immediate_context_->Unmap(hud_quad_buffer_.Get(), 0);
+
+    if (vp.Width != hud_viewport_width_ || vp.Height != hud_viewport_height_)
+    {
+        hud_viewport_width_ = vp.Width;
+        hud_viewport_height_ = vp.Height;
+        const HudConstantsData constants = {1.0f / vp.Width, 1.0f / vp.Height, {0.0f, 0.0f}};
+        immediate_context_->UpdateSubresource(hud_constants_.Get(), 0, nullptr, &constants, 0, 0);
+    }
+
+    // Direct2D changes device state during EndDraw; bind everything the
+    // draw needs. Four strip vertices per quad, generated in the shader.
+    immediate_context_->OMSetRenderTargets(1, d3d_render_target_view_.GetAddressOf(), nullptr);
+    immediate_context_->OMSetBlendState(nullptr, nullptr, 0xffffffff);
+    immediate_context_->RSSetViewports(1, &vp);
+    immediate_context_->RSSetState(hud_rasterizer_.Get());
+    immediate_context_->IASetInputLayout(nullptr);
+    immediate_context_->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
+    immediate_context_->VSSetShader(hud_vertex_shader_.Get(), nullptr, 0);
+    immediate_context_->VSSetConstantBuffers(0, 1, hud_constants_.GetAddressOf());
+    immediate_context_->VSSetShaderResources(0, 1, hud_quad_srv_.GetAddressOf());
+    immediate_context_->PSSetShader(hud_pixel_shader_.Get(), nullptr, 0);
+    immediate_context_->DrawInstanced(4, static_cast<UINT>(count), 0, 0);
 }
 
 bool ArgumentDebuggerWindow::EndOverlay()
@@ -1049,11 +2277,13 @@ bool ArgumentDebuggerWindow::EndOverlay()
     HRESULT hr = d2d_render_target_->EndDraw();
     if (hr == D2DERR_RECREATE_TARGET)
     {
+        trace_events::DeviceLost(L"EndOverlay", hr);
+        alloc_guard::ScopedAllowAlloc allow;
         Log(L"Device lost detected, recreating D2D resources");
         white_brush_.Reset();
         green_brush_.Reset();
         yellow_brush_.Reset();
-        data_text_format_.Reset();
+        // Text formats are device-independent and stay as they are.
         CreateD2DResources();
         return false;
     }
@@ -1062,35 +2292,168 @@ bool ArgumentDebuggerWindow::EndOverlay()
     return true;
 }
 
-void ArgumentDebuggerWindow::PresentFrame()
+size_t ArgumentDebuggerWindow::BuildDirtyRects(unsigned redraw, RECT* rects, size_t max_rects) const
+{
+    // Only overlay-only frames qualify; cube frames change the whole window.
+    if (redraw & (kRedrawCube | kRedrawAll))
+        return 0;
+
+    const D2D1_SIZE_F size = d2d_render_target_->GetSize();
+    size_t count = 0;
+    auto add = [&](float left, float top, float right, float bottom)
+    {
+        if (count == max_rects)
+            return;
+        RECT& r = rects[count++];
+        // 96-DPI render target: DIPs are pixels. Pad by a pixel for AA edges.
+        r.left = (std::max)(0L, static_cast<LONG>(left) - 1);
+        r.top = (std::max)(0L, static_cast<LONG>(top) - 1);
+        r.right = (std::min)(static_cast<LONG>(size.width), static_cast<LONG>(right) + 1);
+        r.bottom = (std::min)(static_cast<LONG>(size.height), static_cast<LONG>(bottom) + 1);
+    };
+
+    // Geometry mirrors the Render* functions.
+    if (redraw & kRedrawInput)
+        add(kMargin, size.height - 60.0f, size.width - kMargin, size.height - 30.0f);
+    if (redraw & kRedrawStatus)
+        add(kMargin, size.height - 220.0f, size.width - kMargin, size.height - 190.0f);
+    if (redraw & kRedrawQr)
+    {
+        const float qr_y = size.height - 375.0f - 60.0f - 100.0f - (size.height * 0.2f);
+        add(60.0f, qr_y, 60.0f + 375.0f, qr_y + 375.0f);
+    }
+    if (redraw & kRedrawMeter)
+        add(size.width - 300.0f, size.height - kMargin - 300.0f, size.width - kMargin, size.height - kMargin);
+    // The frame-time panel changes on every rendered frame.
+    const float stats_right = size.width - kMargin - 235.0f;
+    add(stats_right - 330.0f, size.height - kMargin - 180.0f, stats_right, size.height - kMargin);
+    return count;
+}
+
+bool ArgumentDebuggerWindow::PresentFrame(unsigned redraw)
 {
     static ULONGLONG lastFpsLogTime = 0;
     ULONGLONG currentTime = GetTickCount64();
     if (currentTime - lastFpsLogTime > 5000)
     {
-        Log(L"RenderFrame: Present FPS=" + std::to_wstring(static_cast<int>(current_fps_)));
+        alloc_guard::ScopedAllowAlloc allow; // one log line every 5 s
+        const SectionSummary interval = frame_stats_.Summarize(FrameSection::Interval);
+        Log(L"RenderFrame: Present FPS=" + std::to_wstring(static_cast<int>(current_fps_)) + L", frame p50=" +
+            std::to_wstring(interval.p50_ms) + L"ms p99=" + std::to_wstring(interval.p99_ms) + L"ms max=" +
+            std::to_wstring(interval.max_ms) + L"ms");
         lastFpsLogTime = currentTime;
     }
 
-    // Skip VSync under Wine/Proton — blocking Present on Wine can starve the
-    // whole message loop, producing reported FPS in the single digits.
-    HMODULE hNtdll = GetModuleHandleW(L"ntdll.dll");
-    const bool isWine = hNtdll && GetProcAddress(hNtdll, "wine_get_version");
-    const UINT syncInterval = isWine ? 0 : 1;
-
-    HRESULT hr = swap_chain_->Present(syncInterval, 0);
+    // VSync off under Wine/Proton (see InitializeDevice). On the flip model
+    // with tearing support, present immediately and let the frame pacer and
+    // latency waitable set the cadence.
+    const bool tear = flip_model_active_ && tearing_supported_;
+    const UINT syncInterval = (is_wine_ || tear) ? 0 : 1;
+    const UINT presentFlags = tear ? DXGI_PRESENT_ALLOW_TEARING : 0;
+
+    // Low-power overlay-only frames on the flip model tell DWM which regions
+    // changed. The whole back buffer is still redrawn (FLIP_DISCARD does not
+    // preserve it) and the cube is frozen, so everything outside the rects is
+    // identical to the previous frame as Present1 requires.
+    HRESULT hr = S_OK;
+    RECT dirty[6];
+    const size_t dirty_count = (flip_model_active_ && swap_chain1_) ? BuildDirtyRects(redraw, dirty, 6) : 0;
+    trace_events::PresentStart(frame_counter_, syncInterval, presentFlags, static_cast<UINT>(dirty_count));
+    if (dirty_count > 0)
+    {
+        DXGI_PRESENT_PARAMETERS params{};
+        params.DirtyRectsCount = static_cast<UINT>(dirty_count);
+        params.pDirtyRects = dirty;
+        hr = swap_chain1_->Present1(syncInterval, presentFlags, &params);
+    }
+    else
+    {
+        hr = swap_chain_->Present(syncInterval, presentFlags);
+    }
+    trace_events::PresentStop(frame_counter_, hr);
     if (hr == DXGI_ERROR_DEVICE_REMOVED || hr == DXGI_ERROR_DEVICE_RESET)
     {
+        trace_events::DeviceLost(L"PresentFrame", hr);
+        alloc_guard::ScopedAllowAlloc allow;
         Log(L"Device removed/reset detected, recreating all graphics resources");
-        CreateDeviceAndSwapChain(static_cast<UINT>(d2d_render_target_->GetSize().width),
-                                 static_cast<UINT>(d2d_render_target_->GetSize().height));
+        redraw_gate_.Invalidate(kRedrawAll);
+        const D2D1_SIZE_F rt_size = d2d_render_target_->GetSize();
+        ReleaseSwapChain();
+        CreateDeviceAndSwapChain(static_cast<UINT>(rt_size.width), static_cast<UINT>(rt_size.height));
         CreateRenderTargetView();
         CreateD2DResources();
         CreateShadersAndGeometry();
-        return;
+        CreateHudPipeline();
+        return false;
     }
     if (FAILED(hr))
         throw std::runtime_error("Failed to present frame.");
+    return true;
+}
+
+void ArgumentDebuggerWindow::TrackInputLatency(bool presented)
+{
+    const LONGLONG now = FramePacer::Now();
+    if (presented)
+    {
+        UINT present_id = 0;
+        const bool have_id = SUCCEEDED(swap_chain_->GetLastPresentCount(&present_id));
+        latency_probe_.OnPresented(present_id, now);
+        if (!have_id)
+            latency_probe_.OnStatisticsUnavailable(now, false);
+    }
+
+    // Sampled after every present, not only with keystrokes in flight, so
+    // the refresh period is known by the time one is.
+    DXGI_FRAME_STATISTICS stats{};
+    const HRESULT hr = swap_chain_->GetFrameStatistics(&stats);
+    if (SUCCEEDED(hr))
+    {
+        PresentStatistics sample;
+        sample.present_count = stats.PresentCount;
+        sample.present_refresh_count = stats.PresentRefreshCount;
+        sample.sync_refresh_count = stats.SyncRefreshCount;
+        sample.sync_qpc = stats.SyncQPCTime.QuadPart;
+        latency_probe_.OnFrameStatistics(sample, now);
+    }
+    else
+    {
+        // DISJOINT follows mode changes and clears after a later present;
+        // anything else (blt model in a window, Wine) will not recover.
+        latency_probe_.OnStatisticsUnavailable(now, hr == DXGI_ERROR_FRAME_STATISTICS_DISJOINT);
+    }
+
+    if (metrics_.IsOpen() && latency_probe_.Completed() != latency_published_)
+        PublishInputMetrics();
+}
+
+void ArgumentDebuggerWindow::PublishInputMetrics()
+{
+    // Every keystroke completed since the last publish gets its ring slot;
+    // more than the ring holds only keeps the newest.
+    const uint32_t completed = latency_probe_.Completed();
+    std::array<KeystrokeLatency, kMetricsRecentKeystrokes> fresh;
+    const size_t n = latency_probe_.CopyHistory(
+        fresh.data(), (std::min)(static_cast<size_t>(completed - latency_published_), fresh.size()));
+    for (size_t i = 0; i < n; ++i)
+    {
+        const uint32_t nth = completed - static_cast<uint32_t>(n - 1 - i);
+        const KeystrokeLatency& key = fresh[i];
+        MetricsKeystroke& slot = metrics_input_.recent[(nth - 1) % kMetricsRecentKeystrokes];
+        slot.sequence = key.sequence;
+        slot.source = static_cast<uint32_t>(key.source);
+        slot.frame = key.frame;
+        slot.queue_ms = key.queue_ms;
+        slot.render_ms = key.render_ms;
+        slot.display_ms = key.display_ms;
+        slot.total_ms = key.total_ms;
+    }
+    metrics_input_.completed = completed;
+    metrics_input_.dropped = latency_probe_.Dropped();
+    const SectionSummary total = latency_probe_.Summarize();
+    metrics_input_.total = {total.p50_ms, total.p95_ms, total.p99_ms, total.max_ms};
+    metrics_.PublishInput(metrics_input_);
+    latency_published_ = completed;
 }
 
 void ArgumentDebuggerWindow::UpdateRotation(float delta_time)
@@ -1104,23 +2467,42 @@ void ArgumentDebuggerWindow::Cleanup()
 {
     Log(L"Cleanup started");
 
+    // Startup tasks write into this object; let them finish first.
+    startup_tasks_.WaitAll();
+
     // The audio pipeline is owned by `audio_capture_` and released either by
     // its Stop() in OnDestroy or by its destructor.
 
     // Reset all graphics ComPtr objects to automatically release resources.
     vertex_shader_.Reset();
     pixel_shader_.Reset();
+    hud_vertex_shader_.Reset();
+    hud_pixel_shader_.Reset();
+    hud_rasterizer_.Reset();
+    hud_quad_srv_.Reset();
+    hud_quad_buffer_.Reset();
+    hud_constants_.Reset();
     vertex_layout_.Reset();
     constant_buffer_.Reset();
     vertex_buffer_.Reset();
     index_buffer_.Reset();
     d3d_render_target_view_.Reset();
+    if (frame_latency_waitable_)
+    {
+        CloseHandle(frame_latency_waitable_);
+        frame_latency_waitable_ = nullptr;
+    }
+    swap_chain1_.Reset();
     swap_chain_.Reset();
     immediate_context_.Reset();
     d3d_device_.Reset();
     text_format_.Reset();
     small_text_format_.Reset(); // Release the small text format
     data_text_format_.Reset();  // Release the data text format
+    stats_text_format_.Reset();
+    arg_row_format_.Reset();
+    text_layouts_.Reset(nullptr);
+    arg_layouts_.Reset(nullptr);
     dwrite_factory_.Reset();
     d2d_render_target_.Reset();
     d2d_factory_.Reset();
@@ -1132,148 +2514,196 @@ void ArgumentDebuggerWindow::Cleanup()
     Log(L"Cleanup finished");
 }
 
-// Helper to load entire log file into loaded_data_ (showing only the last 100 lines)
+// Loads the last LogTail::kDefaultMaxLines lines of the log into loaded_data_
+// by reading backward from EOF, so the cost does not grow with the log.
 void ArgumentDebuggerWindow::ShowLogs()
 {
     loaded_data_.clear();
 
-    // File is already open for writing, so use _wfsopen with _SH_DENYNO flag
-    // to explicitly allow both reading and writing from different handles
-    FILE* log_file = _wfsopen(g_logPath.c_str(), L"r, ccs=UTF-16LE", _SH_DENYNO);
-    if (!log_file)
+    // Ensure all pending writes (including records still queued for the
+    // async writer) reach the file before reading
+    FlushLogger();
+
+    if (!log_tail_.Open(g_logPath))
     {
+        follow_logs_ = false;
         command_status_ = L"Log file not found.";
         return;
     }
 
-    // Ensure all pending writes are flushed to the file before reading
-    fflush(g_log_file);
-
-    // Skip BOM if present
-    wint_t first_char = fgetwc(log_file);
-    if (first_char != 0xFEFF)
+    loaded_data_ = L"... (showing last " + std::to_wstring(log_tail_.Lines().size()) + L" lines)\n\n" +
+                   log_tail_.Text();
+    if (follow_logs_)
     {
-        // Not a BOM, rewind to start of file
-        fseek(log_file, 0, SEEK_SET);
+        last_log_poll_ = FramePacer::Now();
+        log_rotation_seen_ = GetLogRotationCount();
+        command_status_ = L"Following log file.";
     }
-
-    // Read all lines from the file first into a circular buffer of last 100 lines
-    const size_t maxLines = 100;
-    std::vector<std::wstring> lastLines;
-    lastLines.reserve(maxLines);
-
-    wchar_t buffer[1024];
-    while (fgetws(buffer, 1024, log_file))
+    else
     {
-        if (lastLines.size() >= maxLines)
-        {
-            // Remove oldest line at the beginning
-            lastLines.erase(lastLines.begin());
-        }
-        // Add new line at the end
-        lastLines.push_back(buffer);
+        log_tail_.Close();
+        command_status_ = L"Log file loaded (last 100 lines).";
     }
+}
 
-    // Now build the output string with only the last 100 lines
-    loaded_data_ = L"... (showing last " + std::to_wstring(lastLines.size()) + L" lines)\n\n";
-    for (const auto& line : lastLines)
+void ArgumentDebuggerWindow::PollLogFollow()
+{
+    if (!follow_logs_ || !show_logs_)
+        return;
+
+    const LONGLONG now = FramePacer::Now();
+    if (FramePacer::TicksToSeconds(now - last_log_poll_) * 1000.0 < kLogFollowIntervalMs)
+        return;
+    last_log_poll_ = now;
+
+    // Rotation renamed the file log_tail_ holds; follow the new one.
+    if (GetLogRotationCount() != log_rotation_seen_)
     {
-        loaded_data_ += line;
+        ShowLogs();
+        loaded_data_title_ = L"Log File Contents (following):";
+        redraw_gate_.Invalidate(kRedrawAll);
+        return;
     }
 
-    fclose(log_file);
-    command_status_ = L"Log file loaded (last 100 lines).";
+    if (!log_tail_.Poll())
+        return;
+    loaded_data_ = L"... (following, last " + std::to_wstring(log_tail_.Lines().size()) + L" lines)\n\n" +
+                   log_tail_.Text();
+    redraw_gate_.Invalidate(kRedrawAll);
 }
 
-// Method for saving data (timestamp and FPS) to %APPDATA%\CloudStreamingArgsDebugger\saved_data.txt
-void ArgumentDebuggerWindow::SaveData()
+void ArgumentDebuggerWindow::StopLogFollow()
+{
+    follow_logs_ = false;
+    log_tail_.Close();
+}
+
+const std::wstring& ArgumentDebuggerWindow::DataDirectory()
 {
+    if (data_dir_resolved_)
+        return data_dir_;
+
     PWSTR appdata_path = nullptr;
     HRESULT hr = SHGetKnownFolderPath(FOLDERID_RoamingAppData, 0, nullptr, &appdata_path);
-    if (SUCCEEDED(hr))
+    if (FAILED(hr))
     {
-        std::wstring folder_path = appdata_path;
-        CoTaskMemFree(appdata_path);
-        folder_path += L"\\CloudStreamingArgsDebugger";
-        // Create the directory if it does not exist yet.
-        if (!CreateDirectoryW(folder_path.c_str(), nullptr))
-        {
-            DWORD err = GetLastError();
-            if (err != ERROR_ALREADY_EXISTS)
-            {
-                command_status_ = L"Error creating directory.";
-                Log(L"SaveData: Error creating directory, code = " + std::to_wstring(err));
-                return;
-            }
-        }
-        std::wstring file_path = folder_path + L"\\saved_data.txt";
-        FILE* file = nullptr;
-        // Open the file for writing
-        if (_wfopen_s(&file, file_path.c_str(), L"w, ccs=UTF-8") == 0 && file)
-        {
-            time_t timestamp = time(nullptr);
-            // Write synced_fps_ so it matches the QR code value
-            fwprintf(file, L"Timestamp: %lld\nFPS: %d\n", static_cast<long long>(timestamp), synced_fps_);
-            fclose(file);
-            command_status_ = L"Data saved successfully.";
-            Log(L"SaveData: Data saved successfully to " + file_path);
-        }
-        else
+        Log(L"DataDirectory: Error retrieving AppData path, hr = " + std::to_wstring(hr));
+        return data_dir_;
+    }
+    std::wstring folder_path = appdata_path;
+    CoTaskMemFree(appdata_path);
+    folder_path += L"\\CloudStreamingArgsDebugger";
+    // Create the directory if it does not exist yet.
+    if (!CreateDirectoryW(folder_path.c_str(), nullptr))
+    {
+        DWORD err = GetLastError();
+        if (err != ERROR_ALREADY_EXISTS)
         {
-            command_status_ = L"Error opening file for writing.";
-            Log(L"SaveData: Error opening file for writing: " + file_path);
+            Log(L"DataDirectory: Error creating directory, code = " + std::to_wstring(err));
+            return data_dir_;
         }
     }
-    else
+    data_dir_ = folder_path;
+    data_dir_resolved_ = true;
+    return data_dir_;
+}
+
+SessionRecord ArgumentDebuggerWindow::BuildSessionRecord(uint32_t flags) const
+{
+    SessionRecord record{};
+    record.unix_ms = session_record::UnixMillisNow();
+    record.frame = frame_counter_;
+    record.args_hash = args_hash_;
+    PROCESS_MEMORY_COUNTERS_EX pmc{};
+    if (GetProcessMemoryInfo(GetCurrentProcess(), reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&pmc), sizeof(pmc)))
+        record.working_set_bytes = pmc.WorkingSetSize;
+    // synced_fps_ so it matches the QR code value
+    record.fps = static_cast<float>(synced_fps_);
+    const SectionSummary interval = frame_stats_.Summarize(FrameSection::Interval);
+    record.interval_p50_ms = interval.p50_ms;
+    record.interval_p99_ms = interval.p99_ms;
+    record.interval_max_ms = interval.max_ms;
+    record.cpu_p99_ms = frame_stats_.Summarize(FrameSection::Cpu).p99_ms;
+    record.mic_level = (audio_ready_ && audio_capture_.IsAvailable()) ? audio_capture_.Level() : -1.0f;
+    record.flags = flags | (redraw_gate_.IsLowPower() ? kSessionRecordLowPower : 0u);
+    return record;
+}
+
+bool ArgumentDebuggerWindow::AppendSessionRecord(uint32_t flags)
+{
+    if (!session_writer_.IsOpen())
     {
-        command_status_ = L"Error retrieving AppData path.";
-        Log(L"SaveData: Error retrieving AppData path, hr = " + std::to_wstring(hr));
+        const std::wstring& folder_path = DataDirectory();
+        if (folder_path.empty() || !session_writer_.Open(folder_path + L"\\" + kSessionRecordFileName))
+            return false;
+        Log(L"Session: appending to " + folder_path + L"\\" + kSessionRecordFileName + L" (" +
+            std::to_wstring(session_writer_.RecordCount()) + L" existing records)");
     }
+    if (session_writer_.Append(BuildSessionRecord(flags)))
+        return true;
+    // Reopen on the next sample; Open() drops a partially written record.
+    session_writer_.Close();
+    return false;
 }
 
-// Method for loading data from %APPDATA%\CloudStreamingArgsDebugger\saved_data.txt
-void ArgumentDebuggerWindow::ReadData()
+void ArgumentDebuggerWindow::PollSessionRecord()
 {
-    PWSTR appdata_path = nullptr;
-    HRESULT hr = SHGetKnownFolderPath(FOLDERID_RoamingAppData, 0, nullptr, &appdata_path);
-    if (SUCCEEDED(hr))
+    if (options_.record_interval_ms == 0 || session_record_failed_)
+        return;
+    const LONGLONG now = FramePacer::Now();
+    // The first sample is one interval in, once the frame stats have data.
+    if (last_record_qpc_ == 0)
     {
-        std::wstring folder_path = appdata_path;
-        CoTaskMemFree(appdata_path);
-        folder_path += L"\\CloudStreamingArgsDebugger";
-        std::wstring file_path = folder_path + L"\\saved_data.txt";
-        FILE* file = nullptr;
-        if (_wfopen_s(&file, file_path.c_str(), L"r, ccs=UTF-8") == 0 && file)
-        {
-            wchar_t buffer[256];
-            loaded_data_.clear();
-            // Read file contents line by line.
-            while (fgetws(buffer, 256, file))
-            {
-                loaded_data_ += buffer;
-            }
-            fclose(file);
-            command_status_ = L"Data loaded successfully.";
-            Log(L"ReadData: Data loaded successfully from " + file_path);
-        }
-        else
-        {
-            command_status_ = L"File not found.";
-            loaded_data_.clear();
-            Log(L"ReadData: File not found: " + file_path);
-        }
+        last_record_qpc_ = now;
+        return;
     }
-    else
+    if (FramePacer::TicksToSeconds(now - last_record_qpc_) * 1000.0 < options_.record_interval_ms)
+        return;
+    last_record_qpc_ = now;
+    if (!AppendSessionRecord(0))
     {
-        command_status_ = L"Error retrieving AppData path.";
-        Log(L"ReadData: Error retrieving AppData path, hr = " + std::to_wstring(hr));
+        session_record_failed_ = true;
+        Log(L"Session: periodic recording stopped after an error");
     }
 }
 
-// Helper method to calculate and cache path information once
-void ArgumentDebuggerWindow::CalculatePathInfo()
+// Appends a manual sample to %APPDATA%\CloudStreamingArgsDebugger\session.rec
+void ArgumentDebuggerWindow::SaveData()
 {
-    cached_path_items_ = path_info::Collect();
+    if (!AppendSessionRecord(kSessionRecordManual))
+    {
+        command_status_ =
+            DataDirectory().empty() ? L"Error retrieving AppData path." : L"Error writing session record.";
+        return;
+    }
+    command_status_ = L"Sample " + std::to_wstring(session_writer_.RecordCount()) + L" saved.";
+    Log(L"SaveData: sample " + std::to_wstring(session_writer_.RecordCount()) + L" saved");
+}
+
+// Summarizes %APPDATA%\CloudStreamingArgsDebugger\session.rec into loaded_data_
+void ArgumentDebuggerWindow::ReadData()
+{
+    loaded_data_.clear();
+    const std::wstring& folder_path = DataDirectory();
+    if (folder_path.empty())
+    {
+        command_status_ = L"Error retrieving AppData path.";
+        return;
+    }
+    const std::wstring file_path = folder_path + L"\\" + kSessionRecordFileName;
+    const LONGLONG start = FramePacer::Now();
+    SessionSummary summary;
+    std::wstring error;
+    if (!session_record::ReadSummary(file_path, summary, error))
+    {
+        command_status_ = error;
+        Log(L"ReadData: " + error + L" " + file_path);
+        return;
+    }
+    loaded_data_ = session_record::detail::FormatSummary(summary);
+    command_status_ = L"Data loaded successfully.";
+    Log(L"ReadData: summarized " + std::to_wstring(summary.records) + L" records from " + file_path + L" in " +
+        std::to_wstring(FramePacer::TicksToSeconds(FramePacer::Now() - start) * 1000.0) + L" ms");
 }
 
 void ArgumentDebuggerWindow::PlayTelephoneBeeps() // Name kept for compatibility
@@ -1335,8 +2765,34 @@ void ArgumentDebuggerWindow::ShowMemoryStats()
             ULONGLONG uptime = GetTickCount64();
             stats += L"\n=== RUNTIME ===\n";
             stats += L"Uptime: " + std::to_wstring(uptime / 1000) + L" seconds\n";
+            stats += present_mode_label_ + L"\n";
+
+            stats += L"\n=== CPU ===\n";
+            stats += L"Target: " + cpu_dispatch::Describe() + L"\n";
+            stats += std::wstring(L"Audio peak kernel: ") +
+                     audio_capture::detail::PeakIsaName(audio_capture::detail::DetectPeakIsa()) + L"\n";
+            stats += std::wstring(L"UTF-8 ASCII path: ") + utf8_convert::AsciiPathName() + L"\n";
+
+            if (options_.latency_probe)
+            {
+                const SectionSummary total = latency_probe_.Summarize();
+                const KeystrokeLatency& last = latency_probe_.Last();
+                wchar_t buf[256];
+                stats += L"\n=== INPUT LATENCY ===\n";
+                swprintf_s(buf, L"Keystrokes: %u measured, %u dropped\n", latency_probe_.Completed(),
+                           latency_probe_.Dropped());
+                stats += buf;
+                swprintf_s(buf, L"Input to display: p50 %.2f  p95 %.2f  p99 %.2f  max %.2f ms\n", total.p50_ms,
+                           total.p95_ms, total.p99_ms, total.max_ms);
+                stats += buf;
+                swprintf_s(buf, L"Last: %.2f ms (queue %.0f, to Present %.2f, to display %.2f; %ls)\n",
+                           last.total_ms, last.queue_ms, last.render_ms, last.display_ms,
+                           LatencySourceName(last.source));
+                stats += buf;
+            }
 
             // Store in loaded_data_ to display on screen
+            StopLogFollow();
             loaded_data_ = stats;
             loaded_data_title_ = L"Memory Statistics:";
             show_logs_ = true;
@@ -1369,6 +2825,14 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT message, WPARAM wparam, LPARAM lpara
         if (g_app_instance && g_app_instance->is_running())
             g_app_instance->OnCharInput(static_cast<wchar_t>(wparam));
         break;
+    case WM_KEYDOWN:
+        if (g_app_instance && g_app_instance->is_running())
+            g_app_instance->OnKeyDown(wparam);
+        break;
+    case WM_MOUSEWHEEL:
+        if (g_app_instance && g_app_instance->is_running())
+            g_app_instance->OnMouseWheel(GET_WHEEL_DELTA_WPARAM(wparam));
+        break;
     case WM_DESTROY:
         Log(L"WM_DESTROY");
         if (g_app_instance)
@@ -16,6 +16,23 @@ inline std::wstring BuildCliHeaderText(const std::vector<std::wstring>& args)
     return args.empty() ? L"No arguments were received." : L"Received the following arguments:";
 }
 
+/**
+ * Format one command-line argument the way BuildCliArgsText shows it:
+ * wrapped in double quotes if it is empty or contains whitespace or quotes,
+ * otherwise unchanged.
+ *
+ * @param arg Command-line argument
+ * @return Display form of the argument
+ */
+inline std::wstring FormatCliArg(const std::wstring& arg)
+{
+    // Check if argument is empty, contains whitespace, or quotes and needs quotes
+    bool needsQuotes = arg.empty() ||
+                       std::any_of(arg.begin(), arg.end(), [](wchar_t ch) { return std::iswspace(ch); }) ||
+                       arg.find(L'"') != std::wstring::npos;
+    return needsQuotes ? L"\"" + arg + L"\"" : arg;
+}
+
 /**
  * Format command-line arguments according to Windows conventions:
  * - Arguments without spaces or quotes are not quoted
@@ -31,21 +48,7 @@ inline std::wstring BuildCliArgsText(const std::vector<std::wstring>& args)
     std::wstring result;
     for (size_t i = 0; i < args.size(); ++i)
     {
-        const auto& arg = args[i];
-
-        // Check if argument is empty, contains whitespace, or quotes and needs quotes
-        bool needsQuotes = arg.empty() ||
-                           std::any_of(arg.begin(), arg.end(), [](wchar_t ch) { return std::iswspace(ch); }) ||
-                           arg.find(L'"') != std::wstring::npos;
-
-        if (needsQuotes)
-        {
-            result += L"\"" + arg + L"\"";
-        }
-        else
-        {
-            result += arg;
-        }
+        result += FormatCliArg(args[i]);
 
         // Add space between arguments, but not after the last one
         if (i < args.size() - 1)
@@ -54,4 +57,4 @@ inline std::wstring BuildCliArgsText(const std::vector<std::wstring>& args)
         }
     }
     return result;
-}
\ No newline at end of file
+}
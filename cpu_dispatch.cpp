@@ -0,0 +1,154 @@
+#ifndef UNICODE
+#define UNICODE
+#define _UNICODE
+#endif
+
+#include "cpu_dispatch.hpp"
+
+#include <windows.h>
+
+#if defined(CPU_DISPATCH_X86)
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+namespace
+{
+
+constexpr CpuArch BuildArch()
+{
+#if defined(_M_ARM64EC)
+    return CpuArch::Arm64EC;
+#elif defined(_M_ARM64) || defined(__aarch64__)
+    return CpuArch::Arm64;
+#elif defined(_M_X64) || defined(__x86_64__)
+    return CpuArch::X64;
+#elif defined(_M_IX86) || defined(__i386__)
+    return CpuArch::X86;
+#else
+    return CpuArch::Unknown;
+#endif
+}
+
+CpuArch ArchFromMachine(USHORT machine)
+{
+    switch (machine)
+    {
+    case IMAGE_FILE_MACHINE_I386:
+        return CpuArch::X86;
+    case IMAGE_FILE_MACHINE_AMD64:
+        return CpuArch::X64;
+    case IMAGE_FILE_MACHINE_ARM64:
+        return CpuArch::Arm64;
+    default:
+        return CpuArch::Unknown;
+    }
+}
+
+CpuArch DetectHost(CpuArch build)
+{
+    // IsWow64Process2 reports the real machine even to emulated x64
+    // processes, which GetNativeSystemInfo does not.
+    USHORT process_machine = IMAGE_FILE_MACHINE_UNKNOWN;
+    USHORT native_machine = IMAGE_FILE_MACHINE_UNKNOWN;
+    if (IsWow64Process2(GetCurrentProcess(), &process_machine, &native_machine))
+    {
+        const CpuArch host = ArchFromMachine(native_machine);
+        if (host != CpuArch::Unknown)
+            return host;
+    }
+    return build == CpuArch::Arm64EC ? CpuArch::Arm64 : build;
+}
+
+bool DetectAvx2()
+{
+#if defined(CPU_DISPATCH_X86)
+    int regs[4] = {};
+    __cpuid(regs, 0);
+    if (regs[0] < 7)
+        return false;
+
+    __cpuid(regs, 1);
+    const bool osxsave = (regs[2] & (1 << 27)) != 0;
+    const bool avx = (regs[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx)
+        return false;
+    // The OS must save XMM and YMM state across context switches.
+    if ((_xgetbv(0) & 0x6) != 0x6)
+        return false;
+
+    __cpuidex(regs, 7, 0);
+    return (regs[1] & (1 << 5)) != 0;
+#else
+    return false;
+#endif
+}
+
+CpuInfo DetectOnce()
+{
+    CpuInfo info;
+    info.build = BuildArch();
+    info.host = DetectHost(info.build);
+    info.avx2 = DetectAvx2();
+    return info;
+}
+
+} // namespace
+
+namespace cpu_dispatch
+{
+
+const CpuInfo& Info()
+{
+    static const CpuInfo info = DetectOnce();
+    return info;
+}
+
+bool HasAvx2()
+{
+    return Info().avx2;
+}
+
+std::wstring Describe()
+{
+    return detail::Describe(Info());
+}
+
+} // namespace cpu_dispatch
+
+namespace cpu_dispatch::detail
+{
+
+const wchar_t* ArchName(CpuArch arch)
+{
+    switch (arch)
+    {
+    case CpuArch::X86:
+        return L"x86";
+    case CpuArch::X64:
+        return L"x64";
+    case CpuArch::Arm64:
+        return L"ARM64";
+    case CpuArch::Arm64EC:
+        return L"ARM64EC";
+    default:
+        return L"unknown";
+    }
+}
+
+bool IsEmulated(const CpuInfo& info)
+{
+    return (info.build == CpuArch::X86 || info.build == CpuArch::X64) && info.host == CpuArch::Arm64;
+}
+
+std::wstring Describe(const CpuInfo& info)
+{
+    std::wstring text = ArchName(info.build);
+    if (info.host != info.build && info.host != CpuArch::Unknown)
+        text += std::wstring(L" on ") + ArchName(info.host);
+    if (IsEmulated(info))
+        text += L" (emulated; use the ARM64 or ARM64EC build)";
+    return text;
+}
+
+} // namespace cpu_dispatch::detail
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <string>
+
+// Architecture of the running binary and of the CPU underneath it, shared by
+// the kernels that pick an instruction set at runtime (audio peak detection
+// today). Detection runs once; everything here is cheap to call per frame.
+//
+// ARM64EC defines _M_X64 too, but its x86 intrinsics are translated, so the
+// macros below route it to the NEON kernels like a native ARM64 build.
+#if defined(_M_ARM64EC) || defined(_M_ARM64) || defined(__aarch64__)
+#define CPU_DISPATCH_NEON 1
+#elif defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define CPU_DISPATCH_X86 1
+#endif
+
+// MSVC accepts AVX2 intrinsics in any function; clang-cl and GCC need the
+// target spelled out per function so the rest of the TU stays SSE2-only.
+#if defined(__clang__) || defined(__GNUC__)
+#define CPU_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define CPU_TARGET_AVX2
+#endif
+
+enum class CpuArch
+{
+    Unknown,
+    X86,
+    X64,
+    Arm64,
+    Arm64EC, // only ever the build architecture; the host is then ARM64
+};
+
+struct CpuInfo
+{
+    CpuArch build = CpuArch::Unknown; // what this binary was compiled for
+    CpuArch host = CpuArch::Unknown;  // the machine it runs on
+    bool avx2 = false;                // usable AVX2 (CPU and OS support)
+};
+
+namespace cpu_dispatch
+{
+
+const CpuInfo& Info();
+bool HasAvx2();
+
+// One line for logs and the `memory` panel, e.g. "x64 on ARM64 (emulated)".
+std::wstring Describe();
+
+} // namespace cpu_dispatch
+
+// Pure helpers, exposed for unit tests.
+namespace cpu_dispatch::detail
+{
+
+const wchar_t* ArchName(CpuArch arch);
+// True when x86/x64 code runs translated on an ARM64 host, where every
+// instruction costs several native ones; a native ARM64 or ARM64EC build
+// avoids it.
+bool IsEmulated(const CpuInfo& info);
+std::wstring Describe(const CpuInfo& info);
+
+} // namespace cpu_dispatch::detail
@@ -0,0 +1,162 @@
+#ifndef UNICODE
+#define UNICODE
+#define _UNICODE
+#endif
+
+#include "frame_pacer.hpp"
+
+#include <mmsystem.h> // timeBeginPeriod fallback
+
+#include "log_manager.hpp"
+
+#pragma comment(lib, "winmm")
+
+// Windows 10 1803+. Older SDKs do not define it; older systems reject it and
+// we fall back to a regular waitable timer with a raised timer resolution.
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+namespace
+{
+
+// Wake-ups this close to the deadline count as on time; re-arming the timer
+// for the remainder would cost more than it saves.
+constexpr double kDeadlineSlackSeconds = 0.0002;
+
+} // namespace
+
+namespace frame_pacer::detail
+{
+
+LONGLONG PeriodTicks(LONGLONG qpc_frequency, UINT fps)
+{
+    if (fps == 0 || qpc_frequency <= 0)
+        return 0;
+    return qpc_frequency / fps;
+}
+
+LONGLONG NextDeadline(LONGLONG deadline, LONGLONG now, LONGLONG period)
+{
+    if (period <= 0)
+        return now;
+    LONGLONG next = deadline + period;
+    // More than a whole period late: re-anchor on the current frame.
+    if (next <= now)
+        next = now + period;
+    return next;
+}
+
+} // namespace frame_pacer::detail
+
+FramePacer::~FramePacer()
+{
+    if (timer_)
+    {
+        CloseHandle(timer_);
+        timer_ = nullptr;
+    }
+    if (raised_timer_resolution_)
+    {
+        timeEndPeriod(1);
+        raised_timer_resolution_ = false;
+    }
+}
+
+LONGLONG FramePacer::Now()
+{
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return counter.QuadPart;
+}
+
+LONGLONG FramePacer::Frequency()
+{
+    // Fixed at boot; query once.
+    static const LONGLONG frequency = []
+    {
+        LARGE_INTEGER f;
+        QueryPerformanceFrequency(&f);
+        return f.QuadPart;
+    }();
+    return frequency;
+}
+
+double FramePacer::TicksToSeconds(LONGLONG ticks)
+{
+    return static_cast<double>(ticks) / static_cast<double>(Frequency());
+}
+
+void FramePacer::Initialize(UINT target_fps)
+{
+    target_fps_ = target_fps;
+    period_ticks_ = frame_pacer::detail::PeriodTicks(Frequency(), target_fps);
+    next_deadline_ = Now();
+
+    if (period_ticks_ == 0)
+    {
+        Log(L"FramePacer: unlimited frame rate");
+        return;
+    }
+
+    timer_ = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_MANUAL_RESET |
+                                                          CREATE_WAITABLE_TIMER_HIGH_RESOLUTION,
+                                    TIMER_ALL_ACCESS);
+    high_resolution_ = timer_ != nullptr;
+    if (!timer_)
+    {
+        timer_ = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_MANUAL_RESET, TIMER_ALL_ACCESS);
+        // A classic waitable timer only fires on scheduler ticks; ask for 1 ms.
+        raised_timer_resolution_ = timeBeginPeriod(1) == TIMERR_NOERROR;
+    }
+
+    Log(L"FramePacer: target " + std::to_wstring(target_fps) + L" FPS, " +
+        (high_resolution_ ? L"high-resolution timer" : timer_ ? L"legacy timer" : L"no timer (Sleep fallback)"));
+}
+
+bool FramePacer::WaitForFrame()
+{
+    if (period_ticks_ == 0)
+        return true;
+
+    const LONGLONG remaining = next_deadline_ - Now();
+    if (TicksToSeconds(remaining) <= kDeadlineSlackSeconds)
+        return true;
+
+    if (!timer_)
+    {
+        // No timer object at all: degrade to a coarse sleep rather than spin.
+        Sleep(static_cast<DWORD>(TicksToSeconds(remaining) * 1000.0));
+        return TicksToSeconds(next_deadline_ - Now()) <= kDeadlineSlackSeconds;
+    }
+
+    // Relative due time in 100 ns units (negative = relative).
+    LARGE_INTEGER due;
+    due.QuadPart = -static_cast<LONGLONG>(TicksToSeconds(remaining) * 1e7);
+    if (!SetWaitableTimer(timer_, &due, 0, nullptr, nullptr, FALSE))
+        return true;
+
+    const DWORD wait = MsgWaitForMultipleObjectsEx(1, &timer_, INFINITE, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+    if (wait == WAIT_OBJECT_0 + 1)
+    {
+        // Messages first; the deadline is re-evaluated on the next call.
+        CancelWaitableTimer(timer_);
+        return false;
+    }
+    if (wait == WAIT_OBJECT_0)
+        return TicksToSeconds(next_deadline_ - Now()) <= kDeadlineSlackSeconds;
+    return true;
+}
+
+bool FramePacer::WaitForHandle(HANDLE handle, DWORD timeout_ms)
+{
+    if (!handle)
+        return true;
+    const DWORD wait = MsgWaitForMultipleObjectsEx(1, &handle, timeout_ms, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+    return wait != WAIT_OBJECT_0 + 1;
+}
+
+void FramePacer::OnFrameStarted()
+{
+    next_deadline_ = frame_pacer::detail::NextDeadline(next_deadline_, Now(), period_ticks_);
+}
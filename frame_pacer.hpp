@@ -0,0 +1,75 @@
+#pragma once
+
+#include <windows.h>
+
+// Frame pacing on QueryPerformanceCounter plus a high-resolution waitable
+// timer. The message loop asks WaitForFrame() whether it is time to render;
+// the call sleeps in MsgWaitForMultipleObjectsEx until either the next
+// deadline passes or window messages arrive, so input is never delayed by a
+// sleeping render thread and nothing busy-spins.
+//
+// Deadlines advance by a fixed period from the previous deadline rather than
+// from "now", so small wake-up jitter does not accumulate into drift. If the
+// loop falls more than a period behind (debugger break, long hitch) the
+// schedule is re-anchored instead of rendering a burst of catch-up frames.
+class FramePacer
+{
+  public:
+    FramePacer() = default;
+    ~FramePacer();
+
+    FramePacer(const FramePacer&) = delete;
+    FramePacer& operator=(const FramePacer&) = delete;
+
+    // target_fps == 0 means unlimited: WaitForFrame() never blocks.
+    void Initialize(UINT target_fps);
+
+    // Returns true when the caller should render a frame now, false when it
+    // woke because messages are waiting or slightly ahead of the deadline
+    // (pump messages, then call again).
+    bool WaitForFrame();
+
+    // Block until `handle` is signalled (consuming it, for auto-reset events
+    // and semaphores such as the swap-chain frame-latency waitable) or until
+    // messages arrive. Returns true when the handle was acquired or the wait
+    // gave up after `timeout_ms`; false when messages need pumping first.
+    bool WaitForHandle(HANDLE handle, DWORD timeout_ms);
+
+    // Call once per rendered frame, right before rendering; advances the
+    // deadline by one period.
+    void OnFrameStarted();
+
+    UINT TargetFps() const
+    {
+        return target_fps_;
+    }
+    bool IsHighResolutionTimer() const
+    {
+        return high_resolution_;
+    }
+
+    // QPC helpers shared with frame timing code.
+    static LONGLONG Now();
+    static LONGLONG Frequency();
+    static double TicksToSeconds(LONGLONG ticks);
+
+  private:
+    HANDLE timer_ = nullptr;
+    bool high_resolution_ = false;
+    bool raised_timer_resolution_ = false;
+    UINT target_fps_ = 0;
+    LONGLONG period_ticks_ = 0;
+    LONGLONG next_deadline_ = 0;
+};
+
+// Pure scheduling math, exposed for unit tests.
+namespace frame_pacer::detail
+{
+
+// QPC ticks per frame for `fps` (0 → 0, i.e. unlimited).
+LONGLONG PeriodTicks(LONGLONG qpc_frequency, UINT fps);
+
+// Deadline following `deadline` for a frame that starts at `now`.
+LONGLONG NextDeadline(LONGLONG deadline, LONGLONG now, LONGLONG period);
+
+} // namespace frame_pacer::detail
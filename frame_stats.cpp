@@ -0,0 +1,110 @@
+#ifndef UNICODE
+#define UNICODE
+#define _UNICODE
+#endif
+
+#include "frame_stats.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+
+float NearestRank(const float* sorted, size_t count, double percentile)
+{
+    // Rank ceil(p * n), 1-based.
+    size_t rank = static_cast<size_t>(std::ceil(percentile * static_cast<double>(count)));
+    rank = std::clamp<size_t>(rank, 1, count);
+    return sorted[rank - 1];
+}
+
+} // namespace
+
+namespace frame_stats::detail
+{
+
+SectionSummary SummarizeSamples(float* values, size_t count)
+{
+    SectionSummary summary;
+    if (!values || count == 0)
+        return summary;
+    std::sort(values, values + count);
+    summary.p50_ms = NearestRank(values, count, 0.50);
+    summary.p95_ms = NearestRank(values, count, 0.95);
+    summary.p99_ms = NearestRank(values, count, 0.99);
+    summary.max_ms = values[count - 1];
+    return summary;
+}
+
+} // namespace frame_stats::detail
+
+const wchar_t* FrameSectionName(FrameSection section)
+{
+    switch (section)
+    {
+    case FrameSection::Cube:
+        return L"Cube";
+    case FrameSection::TextHud:
+        return L"Text";
+    case FrameSection::QrUpdate:
+        return L"QR";
+    case FrameSection::EndOverlay:
+        return L"EndDraw";
+    case FrameSection::Present:
+        return L"Present";
+    case FrameSection::Cpu:
+        return L"CPU";
+    case FrameSection::Interval:
+        return L"Frame";
+    default:
+        return L"?";
+    }
+}
+
+void FrameStats::BeginFrame()
+{
+    current_.fill(0.f);
+}
+
+void FrameStats::AddSample(FrameSection section, float ms)
+{
+    const auto index = static_cast<size_t>(section);
+    if (index < kFrameSectionCount)
+        current_[index] += ms;
+}
+
+void FrameStats::EndFrame()
+{
+    for (size_t s = 0; s < kFrameSectionCount; ++s)
+        samples_[s][next_] = current_[s];
+    next_ = (next_ + 1) % kWindow;
+    if (count_ < kWindow)
+        ++count_;
+}
+
+SectionSummary FrameStats::Summarize(FrameSection section) const
+{
+    const auto index = static_cast<size_t>(section);
+    if (index >= kFrameSectionCount || count_ == 0)
+        return {};
+    // Order does not matter for percentiles; copy the filled prefix/ring.
+    std::copy_n(samples_[index].begin(), count_, scratch_.begin());
+    return frame_stats::detail::SummarizeSamples(scratch_.data(), count_);
+}
+
+size_t FrameStats::CopyHistory(FrameSection section, float* out, size_t max) const
+{
+    const auto index = static_cast<size_t>(section);
+    if (index >= kFrameSectionCount || !out)
+        return 0;
+    const size_t n = (std::min)(max, count_);
+    // Oldest of the last n samples sits n slots behind next_.
+    size_t pos = (next_ + kWindow - n) % kWindow;
+    for (size_t i = 0; i < n; ++i)
+    {
+        out[i] = samples_[index][pos];
+        pos = (pos + 1) % kWindow;
+    }
+    return n;
+}
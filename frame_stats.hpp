@@ -0,0 +1,107 @@
+#pragma once
+
+#include <windows.h>
+
+#include <array>
+#include <cstddef>
+
+#include "frame_pacer.hpp"
+#include "trace_events.hpp"
+
+// Per-frame CPU timings for each RenderFrame section, kept in a fixed-size
+// ring so percentiles cover a sliding window of recent frames. Average FPS
+// hides exactly the tail that shows up as stutter; p95/p99/max do not.
+//
+// Single-threaded: written and read from the render thread only.
+
+enum class FrameSection : size_t
+{
+    Cube,       // RenderCube
+    TextHud,    // RenderTextHud
+    QrUpdate,   // UpdateQrCode
+    EndOverlay, // D2D EndDraw (flushes the overlay batch)
+    Present,    // IDXGISwapChain::Present, including any VSync block
+    Cpu,        // whole RenderFrame
+    Interval,   // time since the previous frame started
+    Count,
+};
+
+constexpr size_t kFrameSectionCount = static_cast<size_t>(FrameSection::Count);
+
+const wchar_t* FrameSectionName(FrameSection section);
+
+struct SectionSummary
+{
+    float p50_ms = 0.f;
+    float p95_ms = 0.f;
+    float p99_ms = 0.f;
+    float max_ms = 0.f;
+};
+
+class FrameStats
+{
+  public:
+    static constexpr size_t kWindow = 512; // ~8.5 s at 60 FPS
+
+    // Start a new frame row; sections not sampled this frame record 0.
+    void BeginFrame();
+    // Accumulates, so a section timed in several pieces sums up.
+    void AddSample(FrameSection section, float ms);
+    // Commit the current row into the ring.
+    void EndFrame();
+
+    size_t Count() const
+    {
+        return count_;
+    }
+
+    // Percentiles over the whole window. O(kWindow log kWindow): call at a
+    // reduced rate, not every frame.
+    SectionSummary Summarize(FrameSection section) const;
+
+    // Copies up to `max` most recent samples of `section`, oldest first.
+    size_t CopyHistory(FrameSection section, float* out, size_t max) const;
+
+  private:
+    std::array<std::array<float, kWindow>, kFrameSectionCount> samples_{};
+    std::array<float, kFrameSectionCount> current_{};
+    size_t next_ = 0;
+    size_t count_ = 0;
+    mutable std::array<float, kWindow> scratch_{};
+};
+
+// Adds the QPC time between construction and destruction to one section,
+// and brackets it with Section START/STOP trace events.
+class ScopedSectionTimer
+{
+  public:
+    ScopedSectionTimer(FrameStats& stats, FrameSection section)
+        : stats_(stats), section_(section), start_(FramePacer::Now())
+    {
+        trace_events::SectionStart(FrameSectionName(section_));
+    }
+    ~ScopedSectionTimer()
+    {
+        const double elapsed_s = FramePacer::TicksToSeconds(FramePacer::Now() - start_);
+        const float ms = static_cast<float>(elapsed_s * 1000.0);
+        stats_.AddSample(section_, ms);
+        trace_events::SectionStop(FrameSectionName(section_), ms);
+    }
+
+    ScopedSectionTimer(const ScopedSectionTimer&) = delete;
+    ScopedSectionTimer& operator=(const ScopedSectionTimer&) = delete;
+
+  private:
+    FrameStats& stats_;
+    FrameSection section_;
+    LONGLONG start_;
+};
+
+// Pure helpers, exposed for unit tests.
+namespace frame_stats::detail
+{
+
+// Nearest-rank percentiles. Sorts `values` in place.
+SectionSummary SummarizeSamples(float* values, size_t count);
+
+} // namespace frame_stats::detail
@@ -0,0 +1,187 @@
+#ifndef UNICODE
+#define UNICODE
+#define _UNICODE
+#endif
+
+#include "headless_report.hpp"
+
+#include <windows.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+
+#include "cli_args_display.hpp"
+#include "log_manager.hpp"
+#include "utf8_convert.hpp"
+
+namespace headless_report::detail
+{
+
+void AppendJsonString(std::string& out, const std::string& utf8)
+{
+    static const char kHex[] = "0123456789abcdef";
+    out += '"';
+    for (char ch : utf8)
+    {
+        const unsigned char c = static_cast<unsigned char>(ch);
+        if (c == '"')
+            out += "\\\"";
+        else if (c == '\\')
+            out += "\\\\";
+        else if (c == '\n')
+            out += "\\n";
+        else if (c == '\r')
+            out += "\\r";
+        else if (c == '\t')
+            out += "\\t";
+        else if (c < 0x20)
+        {
+            out += "\\u00";
+            out += kHex[c >> 4];
+            out += kHex[c & 0xF];
+        }
+        else
+            out += ch;
+    }
+    out += '"';
+}
+
+std::wstring TrimLabel(const std::wstring& label)
+{
+    size_t end = label.size();
+    while (end > 0 && (label[end - 1] == L' ' || label[end - 1] == L':'))
+        --end;
+    return label.substr(0, end);
+}
+
+} // namespace headless_report::detail
+
+namespace headless_report
+{
+
+namespace
+{
+
+// `scratch` is reused across calls so each string is converted without a
+// temporary.
+void AppendWide(std::string& out, const std::wstring& text, std::string& scratch)
+{
+    utf8_convert::Assign(text.data(), text.size(), scratch);
+    detail::AppendJsonString(out, scratch);
+}
+
+bool WriteAll(HANDLE handle, const std::string& text)
+{
+    size_t offset = 0;
+    while (offset < text.size())
+    {
+        DWORD written = 0;
+        const DWORD chunk = static_cast<DWORD>((std::min)(text.size() - offset, static_cast<size_t>(1) << 20));
+        if (!WriteFile(handle, text.data() + offset, chunk, &written, nullptr) || written == 0)
+            return false;
+        offset += written;
+    }
+    return true;
+}
+
+bool WriteToStdout(const std::string& text)
+{
+    // A /SUBSYSTEM:WINDOWS process still inherits redirected handles; only
+    // when it was started from a console without redirection is there
+    // nothing to write to until we attach to the parent's console.
+    HANDLE out = GetStdHandle(STD_OUTPUT_HANDLE);
+    if (out == nullptr || out == INVALID_HANDLE_VALUE)
+    {
+        if (!AttachConsole(ATTACH_PARENT_PROCESS))
+            return false;
+        out = GetStdHandle(STD_OUTPUT_HANDLE);
+        if (out == nullptr || out == INVALID_HANDLE_VALUE)
+            return false;
+    }
+    return WriteAll(out, text);
+}
+
+bool WriteToFile(const std::wstring& path, const std::string& text)
+{
+    FILE* file = nullptr;
+    if (_wfopen_s(&file, path.c_str(), L"wb") != 0 || !file)
+        return false;
+    const bool ok = fwrite(text.data(), 1, text.size(), file) == text.size();
+    return fclose(file) == 0 && ok;
+}
+
+} // namespace
+
+Report Collect(const std::vector<std::wstring>& args)
+{
+    Report report;
+    report.args = args;
+    report.paths = path_info::Collect();
+    report.stamp.unix_time = static_cast<long long>(time(nullptr));
+    LARGE_INTEGER now = {};
+    QueryPerformanceCounter(&now);
+    report.stamp.qpc = now.QuadPart;
+    return report;
+}
+
+std::string ToJson(const Report& report)
+{
+    std::string utf8;
+    std::string json = "{\n  \"format\": 1,\n  \"args\": [";
+    for (size_t i = 0; i < report.args.size(); ++i)
+    {
+        json += i ? ", " : "";
+        AppendWide(json, report.args[i], utf8);
+    }
+    json += "],\n  \"args_text\": ";
+    AppendWide(json, BuildCliArgsText(report.args), utf8);
+
+    json += ",\n  \"paths\": [";
+    for (size_t i = 0; i < report.paths.size(); ++i)
+    {
+        json += i ? ",\n    {\"label\": " : "\n    {\"label\": ";
+        AppendWide(json, detail::TrimLabel(report.paths[i].first), utf8);
+        json += ", \"value\": ";
+        AppendWide(json, report.paths[i].second, utf8);
+        json += "}";
+    }
+    json += report.paths.empty() ? "]" : "\n  ]";
+
+    // Same chunking, segments and version pinning as QrWorker, so qr_payload
+    // and qr_version describe the first code the window would show.
+    const std::vector<std::string> chunks = qr_worker::detail::SplitArgsPayload(
+        qr_worker::detail::BuildArgsSuffix(report.args));
+    json += ",\n  \"qr_chunks\": " + std::to_string(chunks.size());
+    json += ",\n  \"qr_payload\": ";
+    detail::AppendJsonString(json, qr_worker::detail::BuildStampPayload(report.stamp) + chunks.front());
+    json += ",\n  \"qr_version\": ";
+    try
+    {
+        const auto segments = qr_worker::detail::MakeByteSegments(chunks.front());
+        const int min_version = qr_worker::detail::StableMinVersion(segments);
+        json += std::to_string(qr_worker::detail::EncodePayload(report.stamp, segments, min_version).getVersion());
+    }
+    catch (const qrcodegen::data_too_long&)
+    {
+        json += "null";
+    }
+    json += "\n}\n";
+    return json;
+}
+
+int Run(const std::vector<std::wstring>& args, const std::wstring& output_path)
+{
+    const std::string json = ToJson(Collect(args));
+    const bool ok = output_path.empty() ? WriteToStdout(json) : WriteToFile(output_path, json);
+    if (!ok)
+    {
+        Log(L"Headless: failed to write report to " + (output_path.empty() ? std::wstring(L"stdout") : output_path) +
+            L", error=" + std::to_wstring(GetLastError()));
+        return 1;
+    }
+    Log(L"Headless: report written (" + std::to_wstring(json.size()) + L" bytes)");
+    return 0;
+}
+
+} // namespace headless_report
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "path_info.hpp"
+#include "qr_worker.hpp"
+
+// --headless: report what the launcher delivered and exit, without creating a
+// window, D3D/D2D device, shaders or audio client. Meant as a pre-flight
+// probe, so it costs a few milliseconds instead of a full startup.
+//
+// The report is one UTF-8 JSON object:
+//
+//   {
+//     "format": 1,
+//     "args": ["<argv[1]>", ...],
+//     "args_text": "<BuildCliArgsText(args)>",
+//     "paths": [{"label": "OS Version", "value": "..."}, ...],
+//     "qr_chunks": <codes in the QR cycle; 1 unless the args are chunked>,
+//     "qr_payload": "t=...;f=0;n=0;q=...;args=...",
+//     "qr_version": <symbol version, or null if the payload does not fit>
+//   }
+//
+// "paths" keeps path_info::Collect() order. The QR payload is built exactly
+// as the running window would build its first one (no frames rendered yet, so
+// f and n are 0); for chunked args that is chunk 0 (see QrStamp).
+namespace headless_report
+{
+
+struct Report
+{
+    std::vector<std::wstring> args;
+    std::vector<PathItem> paths;
+    QrStamp stamp;
+};
+
+// Gathers args, path_info::Collect() and a stamp for the current time.
+Report Collect(const std::vector<std::wstring>& args);
+
+std::string ToJson(const Report& report);
+
+// Collects, serialises and writes the report to `output_path`, or to stdout
+// (attaching to the parent's console if there is no redirected handle) when
+// it is empty. Returns the process exit code: 0 on success, 1 if the report
+// could not be written.
+int Run(const std::vector<std::wstring>& args, const std::wstring& output_path);
+
+} // namespace headless_report
+
+// Pure helpers, exposed for unit tests.
+namespace headless_report::detail
+{
+
+// Appends `utf8` as a quoted JSON string. Quotes, backslashes and control
+// characters are escaped; everything else (including non-ASCII) is copied.
+void AppendJsonString(std::string& out, const std::string& utf8);
+
+// "OS Version: " -> "OS Version": path_info labels carry a trailing ": ".
+std::wstring TrimLabel(const std::wstring& label);
+
+} // namespace headless_report::detail
@@ -0,0 +1,130 @@
+#ifndef UNICODE
+#define UNICODE
+#define _UNICODE
+#endif
+
+#include "hud_batch.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+
+bool IsDark(uint32_t bgra)
+{
+    // The QR image is pure black on white; green alone decides.
+    return ((bgra >> 8) & 0xff) < 0x80;
+}
+
+HudQuad MakeQuad(float left, float top, float right, float bottom, HudColor color)
+{
+    return {left, top, right, bottom, color.r, color.g, color.b, color.a};
+}
+
+} // namespace
+
+HudBatch::HudBatch(size_t capacity) : capacity_(capacity)
+{
+    quads_.reserve(capacity_);
+}
+
+void HudBatch::Clear()
+{
+    quads_.clear();
+    dropped_ = 0;
+}
+
+void HudBatch::Fill(float left, float top, float right, float bottom, HudColor color)
+{
+    if (quads_.size() == capacity_)
+    {
+        ++dropped_;
+        return;
+    }
+    quads_.push_back(MakeQuad(left, top, right, bottom, color));
+}
+
+void HudBatch::Outline(float left, float top, float right, float bottom, float width, HudColor color)
+{
+    const float half = width * 0.5f;
+    Fill(left - half, top - half, right + half, top + half, color);       // top
+    Fill(left - half, bottom - half, right + half, bottom + half, color); // bottom
+    Fill(left - half, top + half, left + half, bottom - half, color);     // left
+    Fill(right - half, top + half, right + half, bottom - half, color);   // right
+}
+
+void HudBatch::Line(float x0, float y0, float x1, float y1, float width, HudColor color)
+{
+    const float half = width * 0.5f;
+    if (x0 == x1)
+        Fill(x0 - half, (std::min)(y0, y1), x0 + half, (std::max)(y0, y1), color);
+    else if (y0 == y1)
+        Fill((std::min)(x0, x1), y0 - half, (std::max)(x0, x1), y0 + half, color);
+    else
+        Fill((std::min)(x0, x1) - half, (std::min)(y0, y1) - half, (std::max)(x0, x1) + half,
+             (std::max)(y0, y1) + half, color);
+}
+
+void HudBatch::Append(const HudQuad* quads, size_t count, float dx, float dy)
+{
+    const size_t room = capacity_ - quads_.size();
+    const size_t taken = (std::min)(count, room);
+    for (size_t i = 0; i < taken; ++i)
+    {
+        HudQuad quad = quads[i];
+        quad.left += dx;
+        quad.right += dx;
+        quad.top += dy;
+        quad.bottom += dy;
+        quads_.push_back(quad);
+    }
+    dropped_ += count - taken;
+}
+
+namespace hud_batch::detail
+{
+
+size_t BuildImageQuads(const uint32_t* pixels, int width, int height, HudColor color, HudQuad* out,
+                       size_t max_quads)
+{
+    if (!pixels || width <= 0 || height <= 0)
+        return 0;
+
+    const size_t row_pixels = static_cast<size_t>(width);
+    size_t count = 0;
+    size_t row_first = 0; // first quad of the rows currently being merged
+    for (int y = 0; y < height; ++y)
+    {
+        const uint32_t* row = pixels + static_cast<size_t>(y) * row_pixels;
+        // Rasterised modules repeat whole rows; stretch the previous row's
+        // quads instead of emitting new ones.
+        if (y > 0 && std::memcmp(row, row - row_pixels, row_pixels * sizeof(uint32_t)) == 0)
+        {
+            for (size_t i = row_first; i < count; ++i)
+                out[i].bottom = static_cast<float>(y + 1);
+            continue;
+        }
+
+        row_first = count;
+        int x = 0;
+        while (x < width)
+        {
+            if (!IsDark(row[x]))
+            {
+                ++x;
+                continue;
+            }
+            const int run_begin = x;
+            while (x < width && IsDark(row[x]))
+                ++x;
+            if (count == max_quads)
+                return count;
+            out[count++] = MakeQuad(static_cast<float>(run_begin), static_cast<float>(y), static_cast<float>(x),
+                                    static_cast<float>(y + 1), color);
+        }
+    }
+    return count;
+}
+
+} // namespace hud_batch::detail
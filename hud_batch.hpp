@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// One solid-colour, axis-aligned rectangle of the GPU HUD in render-target
+// pixels (96 DPI, so the same units as the Direct2D overlay). Layout matches
+// `HudQuad` in shaders/hud.hlsl, one element of its StructuredBuffer.
+struct HudQuad
+{
+    float left, top, right, bottom;
+    float r, g, b, a; // straight alpha; the HUD only uses opaque colours
+};
+
+static_assert(sizeof(HudQuad) == 32, "HudQuad must match the HLSL structure");
+
+struct HudColor
+{
+    float r, g, b, a;
+};
+
+// The rectangles and lines of one frame's HUD (meter bars, waveform,
+// frame-time graph, QR modules), collected so --hud=gpu draws them all with
+// a single instanced draw instead of one Direct2D call each.
+//
+// Storage is reserved once in the constructor; a full batch drops further
+// quads (counted in Dropped()) rather than growing, so adding quads never
+// allocates inside a frame.
+class HudBatch
+{
+  public:
+    // Enough for a version-40 QR code (at most 177 module rows of 89 runs)
+    // plus the meter and graph.
+    static constexpr size_t kDefaultCapacity = 32768;
+
+    explicit HudBatch(size_t capacity = kDefaultCapacity);
+
+    void Clear();
+
+    void Fill(float left, float top, float right, float bottom, HudColor color);
+    // Rectangle outline with the stroke centred on the edge, like
+    // ID2D1RenderTarget::DrawRectangle.
+    void Outline(float left, float top, float right, float bottom, float width, HudColor color);
+    // Horizontal or vertical line with flat caps and the stroke centred on
+    // it, like ID2D1RenderTarget::DrawLine. Any other line becomes the
+    // stroke-wide box around it; the HUD draws none.
+    void Line(float x0, float y0, float x1, float y1, float width, HudColor color);
+    // Appends quads built elsewhere (e.g. by BuildImageQuads), offset by
+    // (dx, dy).
+    void Append(const HudQuad* quads, size_t count, float dx, float dy);
+
+    const HudQuad* Data() const
+    {
+        return quads_.data();
+    }
+
+    size_t Size() const
+    {
+        return quads_.size();
+    }
+
+    size_t Capacity() const
+    {
+        return capacity_;
+    }
+
+    // Quads rejected since the last Clear() because the batch was full.
+    size_t Dropped() const
+    {
+        return dropped_;
+    }
+
+  private:
+    std::vector<HudQuad> quads_;
+    size_t capacity_;
+    size_t dropped_ = 0;
+};
+
+// Pure helpers, exposed for unit tests.
+namespace hud_batch::detail
+{
+
+// Covers the dark pixels of a width x height BGRA image (such as the QR
+// worker's output) with quads in image pixel coordinates: one quad per
+// horizontal run of dark pixels, with runs of identical rows merged into
+// one taller quad. A QR code rasterised at N pixels per module becomes one
+// quad per run of dark modules rather than one per pixel. Writes at most
+// `max_quads` and returns the number written.
+size_t BuildImageQuads(const uint32_t* pixels, int width, int height, HudColor color, HudQuad* out,
+                       size_t max_quads);
+
+} // namespace hud_batch::detail
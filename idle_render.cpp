@@ -0,0 +1,55 @@
+#ifndef UNICODE
+#define UNICODE
+#define _UNICODE
+#endif
+
+#include "idle_render.hpp"
+
+#include <cmath>
+
+#include "frame_pacer.hpp"
+
+void RedrawGate::Configure(bool low_power, unsigned cube_fps, LONGLONG qpc_frequency, LONGLONG now)
+{
+    low_power_ = low_power;
+    frequency_ = qpc_frequency > 0 ? qpc_frequency : 1;
+    cube_period_ = low_power ? frame_pacer::detail::PeriodTicks(frequency_, cube_fps) : 0;
+    next_cube_ = now + cube_period_;
+    last_cube_ = now;
+    pending_ = kRedrawAll;
+    observed_level_ = 0.f;
+    drawn_level_ = 0.f;
+}
+
+void RedrawGate::ObserveMeterLevel(float level)
+{
+    observed_level_ = level;
+    if (std::fabs(level - drawn_level_) > kMeterThreshold)
+        pending_ |= kRedrawMeter;
+}
+
+unsigned RedrawGate::Poll(LONGLONG now)
+{
+    if (!low_power_)
+        return kRedrawAll;
+
+    if (cube_period_ > 0 && now >= next_cube_)
+    {
+        pending_ |= kRedrawCube;
+        next_cube_ = frame_pacer::detail::NextDeadline(next_cube_, now, cube_period_);
+    }
+    return pending_;
+}
+
+double RedrawGate::BeginFrame(LONGLONG now)
+{
+    double cube_seconds = 0.0;
+    if (!low_power_ || (pending_ & kRedrawCube))
+    {
+        cube_seconds = static_cast<double>(now - last_cube_) / static_cast<double>(frequency_);
+        last_cube_ = now;
+    }
+    drawn_level_ = observed_level_;
+    pending_ = kRedrawNone;
+    return cube_seconds;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <windows.h>
+
+// Low-power rendering: decide per paced tick whether anything on screen has
+// changed and, if so, which parts. In full mode every tick renders a frame.
+// In low-power mode a tick with no pending reason renders nothing at all (no
+// D3D/D2D work, no Present), the cube animates at its own reduced rate (or
+// not at all), and overlay-only frames can be presented with dirty rects.
+//
+// Render-thread only.
+
+enum RedrawReason : unsigned
+{
+    kRedrawNone = 0,
+    kRedrawInput = 1u << 0,  // typed character, input line only
+    kRedrawStatus = 1u << 1, // command_status_ text changed
+    kRedrawQr = 1u << 2,     // new QR payload due
+    kRedrawMeter = 1u << 3,  // mic level moved by more than the threshold
+    kRedrawCube = 1u << 4,   // cube animation frame due
+    kRedrawAll = 1u << 5,    // first frame, executed command, device reset
+};
+
+class RedrawGate
+{
+  public:
+    // Mic level changes smaller than this (fraction of full scale, about
+    // three pixels of the 150 px bar) do not trigger a redraw.
+    static constexpr float kMeterThreshold = 0.02f;
+
+    // cube_fps == 0 freezes the cube in low-power mode. The first Poll()
+    // after Configure() always asks for a full frame.
+    void Configure(bool low_power, unsigned cube_fps, LONGLONG qpc_frequency, LONGLONG now);
+
+    bool IsLowPower() const
+    {
+        return low_power_;
+    }
+
+    void Invalidate(unsigned reasons)
+    {
+        pending_ |= reasons;
+    }
+
+    // Latest mic level (0..1); compared against the level last drawn.
+    void ObserveMeterLevel(float level);
+
+    // Reasons to render at `now`, kRedrawNone to skip the tick. Full mode
+    // always returns kRedrawAll.
+    unsigned Poll(LONGLONG now);
+
+    // Call when a frame is actually rendered. Clears the pending reasons and
+    // returns how many seconds the cube animation should advance: the real
+    // elapsed time in full mode and on cube frames, 0 on overlay-only frames
+    // so the pixels outside the dirty rects stay identical.
+    double BeginFrame(LONGLONG now);
+
+  private:
+    bool low_power_ = false;
+    LONGLONG frequency_ = 1;
+    LONGLONG cube_period_ = 0;
+    LONGLONG next_cube_ = 0;
+    LONGLONG last_cube_ = 0;
+    unsigned pending_ = kRedrawAll;
+    float observed_level_ = 0.f;
+    float drawn_level_ = 0.f;
+};
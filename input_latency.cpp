@@ -0,0 +1,189 @@
+#ifndef UNICODE
+#define UNICODE
+#define _UNICODE
+#endif
+
+#include "input_latency.hpp"
+
+#include <algorithm>
+
+#include "frame_pacer.hpp"
+#include "trace_events.hpp"
+
+namespace
+{
+
+float TicksToMs(LONGLONG ticks)
+{
+    return static_cast<float>(FramePacer::TicksToSeconds(ticks) * 1000.0);
+}
+
+} // namespace
+
+namespace input_latency::detail
+{
+
+LONGLONG PresentShownQpc(const PresentStatistics& stats, double refresh_ticks, bool& exact)
+{
+    const UINT refreshes_since = stats.sync_refresh_count - stats.present_refresh_count;
+    if (refreshes_since == 0)
+    {
+        exact = true;
+        return stats.sync_qpc;
+    }
+    // Counters only move forward; anything else is a stale or reset sample.
+    exact = refresh_ticks > 0.0 && refreshes_since < 0x80000000u;
+    if (!exact)
+        return stats.sync_qpc;
+    return stats.sync_qpc - static_cast<LONGLONG>(refreshes_since * refresh_ticks + 0.5);
+}
+
+} // namespace input_latency::detail
+
+const wchar_t* LatencySourceName(LatencySource source)
+{
+    switch (source)
+    {
+    case LatencySource::FrameStatistics:
+        return L"frame statistics";
+    case LatencySource::LaterRefresh:
+        return L"later refresh";
+    case LatencySource::PresentReturn:
+        return L"Present return";
+    default:
+        return L"none";
+    }
+}
+
+void InputLatencyProbe::OnInput(LONGLONG handled_qpc, uint32_t queue_ms)
+{
+    if (count_ == kMaxInFlight)
+    {
+        head_ = (head_ + 1) % kMaxInFlight;
+        --count_;
+        ++dropped_;
+    }
+    InFlight& key = At(count_++);
+    key = InFlight{};
+    key.sequence = ++sequence_;
+    key.queue_ms = queue_ms;
+    key.handled_qpc = handled_qpc;
+}
+
+void InputLatencyProbe::OnDrawn(uint64_t frame)
+{
+    for (size_t i = count_; i > 0 && At(i - 1).stage == Stage::Received; --i)
+    {
+        At(i - 1).stage = Stage::Drawn;
+        At(i - 1).frame = frame;
+    }
+}
+
+void InputLatencyProbe::OnPresented(UINT present_id, LONGLONG present_qpc)
+{
+    for (size_t i = count_; i > 0 && At(i - 1).stage != Stage::Presented; --i)
+    {
+        InFlight& key = At(i - 1);
+        if (key.stage != Stage::Drawn)
+            continue;
+        key.stage = Stage::Presented;
+        key.present_id = present_id;
+        key.present_qpc = present_qpc;
+    }
+}
+
+void InputLatencyProbe::OnPresentFailed()
+{
+    for (size_t i = count_; i > 0 && At(i - 1).stage != Stage::Presented; --i)
+        At(i - 1).stage = Stage::Received;
+}
+
+void InputLatencyProbe::OnFrameStatistics(const PresentStatistics& stats, LONGLONG now_qpc)
+{
+    // The refresh period from two samples at least one refresh apart.
+    if (have_stats_)
+    {
+        const UINT refreshes = stats.sync_refresh_count - last_stats_.sync_refresh_count;
+        const LONGLONG ticks = stats.sync_qpc - last_stats_.sync_qpc;
+        if (refreshes > 0 && refreshes < 0x80000000u && ticks > 0)
+            refresh_ticks_ = static_cast<double>(ticks) / refreshes;
+        if (refreshes != 0)
+            last_stats_ = stats;
+    }
+    else
+    {
+        last_stats_ = stats;
+        have_stats_ = true;
+    }
+
+    bool exact = false;
+    const LONGLONG shown_qpc = input_latency::detail::PresentShownQpc(stats, refresh_ticks_, exact);
+    while (count_ > 0 && At(0).stage == Stage::Presented)
+    {
+        const InFlight& key = At(0);
+        // Present IDs wrap with UINT; compare by difference.
+        const int ahead = static_cast<int>(stats.present_count - key.present_id);
+        if (ahead >= 0)
+            CompleteFront(shown_qpc, ahead == 0 && exact ? LatencySource::FrameStatistics
+                                                         : LatencySource::LaterRefresh);
+        else if (TicksToMs(now_qpc - key.present_qpc) >= kStatisticsTimeoutMs)
+            CompleteFront(key.present_qpc, LatencySource::PresentReturn);
+        else
+            break;
+    }
+}
+
+void InputLatencyProbe::OnStatisticsUnavailable(LONGLONG now_qpc, bool transient)
+{
+    while (count_ > 0 && At(0).stage == Stage::Presented)
+    {
+        const InFlight& key = At(0);
+        if (transient && TicksToMs(now_qpc - key.present_qpc) < kStatisticsTimeoutMs)
+            break;
+        CompleteFront(key.present_qpc, LatencySource::PresentReturn);
+    }
+}
+
+bool InputLatencyProbe::AwaitingDisplay() const
+{
+    return count_ > 0 && At(0).stage == Stage::Presented;
+}
+
+void InputLatencyProbe::CompleteFront(LONGLONG display_qpc, LatencySource source)
+{
+    const InFlight& key = At(0);
+    KeystrokeLatency& done = history_[history_next_];
+    done.sequence = key.sequence;
+    done.source = source;
+    done.frame = key.frame;
+    done.queue_ms = static_cast<float>(key.queue_ms);
+    done.render_ms = TicksToMs(key.present_qpc - key.handled_qpc);
+    // A refresh can precede the return of a Present that blocked on it.
+    done.display_ms = TicksToMs((std::max)(display_qpc, key.handled_qpc) - key.handled_qpc);
+    done.total_ms = done.queue_ms + done.display_ms;
+    last_ = done;
+    trace_events::InputLatency(done.sequence, done.frame, done.total_ms, done.display_ms,
+                               static_cast<uint32_t>(source));
+
+    history_next_ = (history_next_ + 1) % kHistory;
+    history_count_ = (std::min)(history_count_ + 1, kHistory);
+    ++completed_;
+    head_ = (head_ + 1) % kMaxInFlight;
+    --count_;
+}
+
+size_t InputLatencyProbe::CopyHistory(KeystrokeLatency* out, size_t max) const
+{
+    const size_t n = (std::min)(max, history_count_);
+    const size_t start = (history_next_ + kHistory - n) % kHistory;
+    for (size_t i = 0; i < n; ++i)
+        out[i] = history_[(start + i) % kHistory];
+    return n;
+}
+
+SectionSummary InputLatencyProbe::Summarize() const
+{
+    for (size_t i = 0; i < history_count_; ++i)
+        scratch_[i] = history_[i].total_ms;
+    return frame_stats::detail::SummarizeSamples(scratch_.data(), history_count_);
+}
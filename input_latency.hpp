@@ -0,0 +1,176 @@
+#pragma once
+
+#include <windows.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "frame_stats.hpp"
+
+// Input-to-display latency of typed characters (--latency-probe). Each
+// WM_CHAR is stamped when the window procedure handles it and followed
+// through the frame that first draws the input line containing it, the
+// Present that submits that frame, and the DXGI frame statistics that say
+// when that present reached the screen:
+//
+//   OnInput()             - WM_CHAR handled: QPC now and GetMessageTime()'s age.
+//   OnDrawn()             - RenderInputPrompt drew the line that includes it.
+//   OnPresented()         - Present returned: QPC and GetLastPresentCount().
+//   OnFrameStatistics()   - GetFrameStatistics succeeded (once per frame, and
+//                           while idle in low-power mode until it completes).
+//   OnStatisticsUnavailable() - GetFrameStatistics failed.
+//
+// A keystroke completes once statistics report a PresentCount at or past its
+// present ID. Swap chains without statistics (the blt model in a window,
+// most Wine builds) complete at the time Present returned instead, which
+// leaves out the compositor; `source` records which time was used.
+//
+// Render thread only and allocation-free: RenderFrame runs under
+// alloc_guard::ScopedNoAlloc.
+
+enum class LatencySource : uint32_t
+{
+    None = 0,
+    // The refresh at which this keystroke's present was first shown.
+    FrameStatistics = 1,
+    // An upper bound: a later present was already on screen when statistics
+    // were read, or the refresh period was not known yet, so the time is the
+    // refresh of that later present or the statistics sample itself.
+    LaterRefresh = 2,
+    // No statistics: when Present returned, a lower bound.
+    PresentReturn = 3,
+};
+
+const wchar_t* LatencySourceName(LatencySource source);
+
+struct KeystrokeLatency
+{
+    uint32_t sequence = 0; // 1-based count of WM_CHAR messages
+    LatencySource source = LatencySource::None;
+    uint64_t frame = 0;     // RenderFrame counter of the frame that drew it
+    float queue_ms = 0.f;   // GetMessageTime() to handled, at tick resolution
+    float render_ms = 0.f;  // handled to Present returning
+    float display_ms = 0.f; // handled to on screen
+    float total_ms = 0.f;   // queue_ms + display_ms
+};
+
+// The fields of DXGI_FRAME_STATISTICS the probe uses.
+struct PresentStatistics
+{
+    UINT present_count = 0;         // ID of the latest present shown
+    UINT present_refresh_count = 0; // refresh at which it was first shown
+    UINT sync_refresh_count = 0;    // refresh at which sync_qpc was sampled
+    LONGLONG sync_qpc = 0;
+};
+
+class InputLatencyProbe
+{
+  public:
+    // Keystrokes between WM_CHAR and display; beyond this the oldest is
+    // dropped (typing into a hung or minimised window).
+    static constexpr size_t kMaxInFlight = 64;
+    // Completed keystrokes kept for percentiles and the metrics export.
+    static constexpr size_t kHistory = 256;
+    // A presented keystroke that statistics have not reported this long
+    // after Present returned completes as PresentReturn.
+    static constexpr double kStatisticsTimeoutMs = 250.0;
+
+    void OnInput(LONGLONG handled_qpc, uint32_t queue_ms);
+    void OnDrawn(uint64_t frame);
+    void OnPresented(UINT present_id, LONGLONG present_qpc);
+    // The drawn frame never reached Present (device lost); its keystrokes
+    // wait for the next frame.
+    void OnPresentFailed();
+    void OnFrameStatistics(const PresentStatistics& stats, LONGLONG now_qpc);
+    // `transient` for DXGI_ERROR_FRAME_STATISTICS_DISJOINT: keep waiting up
+    // to kStatisticsTimeoutMs. Otherwise presented keystrokes complete now.
+    void OnStatisticsUnavailable(LONGLONG now_qpc, bool transient);
+
+    // True while a keystroke has been presented but not yet completed.
+    bool AwaitingDisplay() const;
+
+    // Keystrokes completed / dropped since startup.
+    uint32_t Completed() const
+    {
+        return completed_;
+    }
+    uint32_t Dropped() const
+    {
+        return dropped_;
+    }
+
+    // Most recently completed keystroke; sequence 0 before the first.
+    const KeystrokeLatency& Last() const
+    {
+        return last_;
+    }
+
+    // Copies up to `max` most recent completed keystrokes, oldest first.
+    size_t CopyHistory(KeystrokeLatency* out, size_t max) const;
+
+    // Percentiles of total_ms over the history. O(kHistory log kHistory).
+    SectionSummary Summarize() const;
+
+  private:
+    enum class Stage
+    {
+        Received,
+        Drawn,
+        Presented,
+    };
+
+    struct InFlight
+    {
+        Stage stage = Stage::Received;
+        uint32_t sequence = 0;
+        uint32_t queue_ms = 0;
+        LONGLONG handled_qpc = 0;
+        uint64_t frame = 0;
+        UINT present_id = 0;
+        LONGLONG present_qpc = 0;
+    };
+
+    // In-flight keystrokes, oldest first. Stages never decrease towards the
+    // back, so keystrokes always complete from the front.
+    InFlight& At(size_t i)
+    {
+        return in_flight_[(head_ + i) % kMaxInFlight];
+    }
+    const InFlight& At(size_t i) const
+    {
+        return in_flight_[(head_ + i) % kMaxInFlight];
+    }
+    // Records the front keystroke as shown at `display_qpc` and removes it.
+    void CompleteFront(LONGLONG display_qpc, LatencySource source);
+
+    std::array<InFlight, kMaxInFlight> in_flight_{};
+    size_t head_ = 0;
+    size_t count_ = 0;
+    uint32_t sequence_ = 0;
+    uint32_t dropped_ = 0;
+
+    std::array<KeystrokeLatency, kHistory> history_{};
+    size_t history_next_ = 0;
+    size_t history_count_ = 0;
+    uint32_t completed_ = 0;
+    KeystrokeLatency last_{};
+    mutable std::array<float, kHistory> scratch_{};
+
+    // Refresh period in QPC ticks, from two statistics samples; 0 until known.
+    double refresh_ticks_ = 0.0;
+    PresentStatistics last_stats_{};
+    bool have_stats_ = false;
+};
+
+// Pure helpers, exposed for unit tests.
+namespace input_latency::detail
+{
+
+// QPC time at which the latest present in `stats` was first shown.
+// SyncQPCTime was sampled sync_refresh_count - present_refresh_count
+// refreshes later; without a known period the sample time itself is
+// returned and `exact` is false.
+LONGLONG PresentShownQpc(const PresentStatistics& stats, double refresh_ticks, bool& exact);
+
+} // namespace input_latency::detail
@@ -5,10 +5,20 @@
 
 #include "log_manager.hpp"
 
+#include <io.h>
 #include <knownfolders.h>
 #include <share.h>
 #include <shlobj.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cwchar>
+#include <memory>
+#include <thread>
+
+#include "utf8_convert.hpp"
+
 #pragma comment(lib, "shell32")
 #pragma comment(lib, "ole32")
 
@@ -17,12 +27,386 @@ std::wstring g_logPath;
 
 namespace
 {
+// Guards g_log_file. In async mode only the consumer side (writer thread,
+// FlushLogger, ring-full fallback) takes it; producers stay lock-free.
 CRITICAL_SECTION g_log_cs;
 bool g_log_cs_initialized = false;
+
+LoggerOptions g_log_options;
+
+// Rotation state. g_log_file_bytes and g_log_opened_tick are only touched
+// with g_log_cs held (or before it exists, in InitLogger).
+uint64_t g_log_file_bytes = 0;
+ULONGLONG g_log_opened_tick = 0;
+std::atomic<unsigned> g_log_rotations{0};
+
+// UTF-8 conversion scratch for LogFormat::Utf8; g_log_cs held.
+std::string g_log_utf8;
+
+// "[YYYY-MM-DD HH:MM:SS] " is 22 characters; leave room for the terminator.
+constexpr size_t kTimestampChars = 32;
+
+// FILETIME of 1970-01-01 (100 ns ticks since 1601).
+constexpr ULONGLONG kUnixEpochFileTime = 116444736000000000ULL;
+
+size_t FormatTimestamp(wchar_t (&out)[kTimestampChars])
+{
+    int n = 0;
+    if (g_log_options.format == LogFormat::Utf8)
+    {
+        FILETIME ft;
+        GetSystemTimeAsFileTime(&ft);
+        const ULONGLONG ticks = (static_cast<ULONGLONG>(ft.dwHighDateTime) << 32) | ft.dwLowDateTime;
+        n = swprintf_s(out, L"%llu ", (ticks - kUnixEpochFileTime) / 10000);
+    }
+    else
+    {
+        SYSTEMTIME st;
+        GetLocalTime(&st);
+        n = swprintf_s(out, L"[%04hu-%02hu-%02hu %02hu:%02hu:%02hu] ", st.wYear, st.wMonth, st.wDay, st.wHour,
+                       st.wMinute, st.wSecond);
+    }
+    return n > 0 ? static_cast<size_t>(n) : 0;
+}
+
+// Opens g_logPath for appending (or truncated) in the configured format.
+FILE* OpenLogFile(bool truncate)
+{
+    const bool utf8 = g_log_options.format == LogFormat::Utf8;
+    const wchar_t* mode = utf8 ? (truncate ? L"wb" : L"ab") : (truncate ? L"w+, ccs=UTF-16LE" : L"a+, ccs=UTF-16LE");
+    FILE* file = _wfsopen(g_logPath.c_str(), mode, _SH_DENYNO);
+    if (!file)
+        return nullptr;
+
+    if (!utf8 && ftell(file) == 0)
+    {
+        fputwc(0xFEFF, file); // UTF-16LE BOM
+    }
+    const __int64 length = _filelengthi64(_fileno(file));
+    g_log_file_bytes = length > 0 ? static_cast<uint64_t>(length) : 0;
+    g_log_opened_tick = GetTickCount64();
+    return file;
+}
+
+// debug.log -> debug.1.log -> ... -> debug.<keep_files>.log, dropping the
+// oldest. The log itself must be closed; the "logs" reader opens it with
+// FILE_SHARE_DELETE, so renaming it underneath the panel is fine.
+void ShiftRotatedFiles()
+{
+    const unsigned keep = g_log_options.keep_files;
+    DeleteFileW(log_manager::detail::RotatedLogPath(g_logPath, keep).c_str());
+    for (unsigned i = keep; i > 1; --i)
+    {
+        MoveFileExW(log_manager::detail::RotatedLogPath(g_logPath, i - 1).c_str(),
+                    log_manager::detail::RotatedLogPath(g_logPath, i).c_str(), MOVEFILE_REPLACE_EXISTING);
+    }
+    MoveFileExW(g_logPath.c_str(), log_manager::detail::RotatedLogPath(g_logPath, 1).c_str(),
+                MOVEFILE_REPLACE_EXISTING);
+}
+
+// Moves the current file aside (or truncates it when keep_files is 0) and
+// opens a fresh one. If the rename fails the old file is simply appended to.
+FILE* RotateLogFile(FILE* current)
+{
+    if (current)
+        fclose(current);
+    if (g_log_options.keep_files == 0)
+        return OpenLogFile(true);
+    ShiftRotatedFiles();
+    return OpenLogFile(false);
+}
+
+// An existing log in the other encoding would be unreadable once records in
+// the new one are appended to it; rotate it out of the way instead.
+bool ExistingLogMatchesFormat()
+{
+    FILE* probe = _wfsopen(g_logPath.c_str(), L"rb", _SH_DENYNO);
+    if (!probe)
+        return true;
+    unsigned char head[2] = {};
+    const size_t got = fread(head, 1, sizeof(head), probe);
+    fclose(probe);
+    if (got == 0)
+        return true;
+    const bool utf16 = got == 2 && head[0] == 0xFF && head[1] == 0xFE;
+    return utf16 == (g_log_options.format == LogFormat::Utf16);
+}
+
+// Log() historically wrote through fputws, which stops at the first embedded
+// NUL. Keep that contract for both write paths.
+size_t VisibleLength(const std::wstring& text)
+{
+    return wcsnlen(text.c_str(), text.size());
+}
+
+// Bounded multi-producer ring (Vyukov-style sequence per cell). Producers
+// claim a cell with one CAS on head_; the single active consumer (serialised
+// by g_log_cs) releases cells by advancing their sequence a lap ahead.
+class LogRing
+{
+  public:
+    static constexpr size_t kSlots = 1024; // power of two
+    static constexpr size_t kRecordChars = 512;
+
+    void Allocate()
+    {
+        cells_ = std::make_unique<Cell[]>(kSlots);
+        for (size_t i = 0; i < kSlots; ++i)
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        head_.store(0, std::memory_order_relaxed);
+        tail_ = 0;
+    }
+
+    void Release()
+    {
+        cells_.reset();
+    }
+
+    bool IsAllocated() const
+    {
+        return cells_ != nullptr;
+    }
+
+    // Returns false when the ring is full or the record does not fit a cell;
+    // the caller then writes the record synchronously.
+    bool TryPush(const wchar_t* stamp, size_t stamp_len, const wchar_t* text, size_t text_len)
+    {
+        if (stamp_len + text_len + 1 > kRecordChars)
+            return false;
+
+        size_t pos = head_.load(std::memory_order_relaxed);
+        Cell* cell = nullptr;
+        for (;;)
+        {
+            cell = &cells_[pos & (kSlots - 1)];
+            const size_t seq = cell->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<ptrdiff_t>(seq) - static_cast<ptrdiff_t>(pos);
+            if (diff == 0)
+            {
+                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+
+        wmemcpy(cell->text, stamp, stamp_len);
+        wmemcpy(cell->text + stamp_len, text, text_len);
+        cell->text[stamp_len + text_len] = L'\n';
+        cell->length = static_cast<UINT32>(stamp_len + text_len + 1);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side; must be called with g_log_cs held. Stops at the first
+    // cell that a producer has claimed but not yet published.
+    template <typename Sink> size_t Drain(Sink&& sink)
+    {
+        size_t drained_chars = 0;
+        for (;;)
+        {
+            Cell& cell = cells_[tail_ & (kSlots - 1)];
+            if (cell.sequence.load(std::memory_order_acquire) != tail_ + 1)
+                break;
+            sink(cell.text, cell.length);
+            drained_chars += cell.length;
+            cell.sequence.store(tail_ + kSlots, std::memory_order_release);
+            ++tail_;
+        }
+        return drained_chars;
+    }
+
+  private:
+    struct Cell
+    {
+        std::atomic<size_t> sequence{0};
+        UINT32 length = 0;
+        wchar_t text[kRecordChars];
+    };
+
+    std::unique_ptr<Cell[]> cells_;
+    std::atomic<size_t> head_{0};
+    size_t tail_ = 0;
+};
+
+LogRing g_log_ring;
+std::atomic<bool> g_log_async{false};
+std::atomic<size_t> g_log_pending_chars{0};
+HANDLE g_log_wake_event = nullptr;
+std::thread g_log_writer;
+std::atomic<bool> g_log_writer_running{false};
+
+// Scratch buffer used to coalesce drained records into a few large fputws
+// calls. Only touched with g_log_cs held.
+std::wstring g_log_batch;
+
+// Writes `length` characters of `text` in the file's encoding. text[length]
+// must be L'\0': the UTF-16 path goes through fputws, which stops there.
+void WriteTextLocked(const wchar_t* text, size_t length)
+{
+    if (length == 0)
+        return;
+    if (g_log_options.format == LogFormat::Utf8)
+    {
+        utf8_convert::Assign(text, length, g_log_utf8);
+        if (g_log_utf8.empty())
+            return;
+        fwrite(g_log_utf8.data(), 1, g_log_utf8.size(), g_log_file);
+        g_log_file_bytes += g_log_utf8.size();
+    }
+    else
+    {
+        fputws(text, g_log_file);
+        // Text mode writes every '\n' as "\r\n".
+        const size_t newlines = static_cast<size_t>(std::count(text, text + length, L'\n'));
+        g_log_file_bytes += (length + newlines) * sizeof(wchar_t);
+    }
+}
+
+// Called after each flushed write. Age-based rotation is therefore checked
+// lazily: a quiet log is not rotated until something is written to it.
+void MaybeRotateLocked()
+{
+    if (!g_log_file)
+        return;
+    const bool by_size = g_log_options.rotate_bytes != 0 && g_log_file_bytes >= g_log_options.rotate_bytes;
+    const ULONGLONG age_ms = GetTickCount64() - g_log_opened_tick;
+    const bool by_age = g_log_options.rotate_interval_ms != 0 && age_ms >= g_log_options.rotate_interval_ms;
+    if (!by_size && !by_age)
+        return;
+
+    // Log() only null-checks g_log_file outside the lock, so it is replaced
+    // in one store rather than cleared while the files are renamed.
+    g_log_file = RotateLogFile(g_log_file);
+    g_log_rotations.fetch_add(1, std::memory_order_release);
+}
+
+void WriteBatchLocked()
+{
+    if (!g_log_batch.empty())
+    {
+        WriteTextLocked(g_log_batch.c_str(), g_log_batch.size());
+        g_log_batch.clear();
+    }
+}
+
+// Write out every published record and flush the CRT buffer once.
+void DrainRingLocked()
+{
+    if (!g_log_file || !g_log_ring.IsAllocated())
+        return;
+
+    const size_t batch_limit = g_log_options.flush_bytes / sizeof(wchar_t);
+    const size_t drained = g_log_ring.Drain(
+        [batch_limit](const wchar_t* text, UINT32 length)
+        {
+            g_log_batch.append(text, length);
+            if (g_log_batch.size() >= batch_limit)
+                WriteBatchLocked();
+        });
+    WriteBatchLocked();
+    if (drained)
+    {
+        g_log_pending_chars.fetch_sub(drained, std::memory_order_relaxed);
+        fflush(g_log_file);
+        MaybeRotateLocked();
+    }
+}
+
+void WriterThreadMain()
+{
+    while (g_log_writer_running.load(std::memory_order_acquire))
+    {
+        WaitForSingleObject(g_log_wake_event, g_log_options.flush_interval_ms);
+        EnterCriticalSection(&g_log_cs);
+        DrainRingLocked();
+        LeaveCriticalSection(&g_log_cs);
+    }
+}
+
+void WriteLineLocked(const wchar_t* stamp, size_t stamp_len, const std::wstring& text, size_t text_len)
+{
+    // A failed rotation leaves no file behind.
+    if (!g_log_file)
+        return;
+    WriteTextLocked(stamp, stamp_len);
+    WriteTextLocked(text.c_str(), text_len);
+    WriteTextLocked(L"\n", 1);
+    fflush(g_log_file);
+    MaybeRotateLocked();
+}
+
+void StartAsyncWriter()
+{
+    g_log_ring.Allocate();
+    g_log_batch.reserve(g_log_options.flush_bytes / sizeof(wchar_t) + LogRing::kRecordChars);
+    g_log_pending_chars.store(0, std::memory_order_relaxed);
+    g_log_wake_event = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+    if (!g_log_wake_event)
+    {
+        g_log_ring.Release();
+        return;
+    }
+
+    g_log_writer_running.store(true, std::memory_order_release);
+    try
+    {
+        g_log_writer = std::thread(WriterThreadMain);
+    }
+    catch (...)
+    {
+        g_log_writer_running.store(false, std::memory_order_release);
+        CloseHandle(g_log_wake_event);
+        g_log_wake_event = nullptr;
+        g_log_ring.Release();
+        return;
+    }
+    g_log_async.store(true, std::memory_order_release);
+}
+
+void StopAsyncWriter()
+{
+    g_log_async.store(false, std::memory_order_release);
+    if (g_log_writer.joinable())
+    {
+        g_log_writer_running.store(false, std::memory_order_release);
+        SetEvent(g_log_wake_event);
+        g_log_writer.join();
+    }
+    if (g_log_wake_event)
+    {
+        CloseHandle(g_log_wake_event);
+        g_log_wake_event = nullptr;
+    }
+}
+
 } // namespace
 
 void InitLogger()
 {
+    InitLogger(LoggerOptions{});
+}
+
+void InitLogger(const LoggerOptions& options)
+{
+    // Re-initialising must not leak the previous FILE* or re-init a live
+    // critical section; tear the old instance down first.
+    if (g_log_cs_initialized)
+        CloseLogger();
+
+    g_log_options = options;
+    if (g_log_options.flush_bytes < LogRing::kRecordChars * sizeof(wchar_t))
+        g_log_options.flush_bytes = LogRing::kRecordChars * sizeof(wchar_t);
+    if (g_log_options.flush_interval_ms == 0)
+        g_log_options.flush_interval_ms = 1;
+
+    g_logPath.clear();
     PWSTR appdata_path = nullptr;
     HRESULT hr = SHGetKnownFolderPath(FOLDERID_RoamingAppData, 0, nullptr, &appdata_path);
     if (SUCCEEDED(hr))
@@ -44,15 +428,17 @@ void InitLogger()
         g_logPath += L"CloudStreamingArgsDebugger.log";
     }
 
-    g_log_file = _wfsopen(g_logPath.c_str(), L"a+, ccs=UTF-16LE", _SH_DENYNO);
-
-    if (g_log_file && ftell(g_log_file) == 0)
-    {
-        fputwc(0xFEFF, g_log_file); // UTF-16LE BOM
-    }
+    g_log_rotations.store(0, std::memory_order_relaxed);
+    if (ExistingLogMatchesFormat())
+        g_log_file = OpenLogFile(false);
+    else
+        g_log_file = RotateLogFile(nullptr);
 
     InitializeCriticalSection(&g_log_cs);
     g_log_cs_initialized = true;
+
+    if (g_log_file && g_log_options.mode == LogWriteMode::Async)
+        StartAsyncWriter();
 }
 
 void Log(const std::wstring& text)
@@ -60,34 +446,33 @@ void Log(const std::wstring& text)
     if (!g_log_file || !g_log_cs_initialized)
         return;
 
-    EnterCriticalSection(&g_log_cs);
+    wchar_t stamp[kTimestampChars];
+    const size_t stamp_len = FormatTimestamp(stamp);
+    const size_t text_len = VisibleLength(text);
 
-    SYSTEMTIME st;
-    GetLocalTime(&st);
-
-    std::wstring entry = L"[";
-    entry += std::to_wstring(st.wYear) + L"-";
-    if (st.wMonth < 10)
-        entry += L"0";
-    entry += std::to_wstring(st.wMonth) + L"-";
-    if (st.wDay < 10)
-        entry += L"0";
-    entry += std::to_wstring(st.wDay) + L" ";
-    if (st.wHour < 10)
-        entry += L"0";
-    entry += std::to_wstring(st.wHour) + L":";
-    if (st.wMinute < 10)
-        entry += L"0";
-    entry += std::to_wstring(st.wMinute) + L":";
-    if (st.wSecond < 10)
-        entry += L"0";
-    entry += std::to_wstring(st.wSecond) + L"] ";
-
-    entry += text + L"\n";
-
-    fputws(entry.c_str(), g_log_file);
-    fflush(g_log_file);
+    if (g_log_async.load(std::memory_order_acquire))
+    {
+        if (g_log_ring.TryPush(stamp, stamp_len, text.c_str(), text_len))
+        {
+            const size_t added = stamp_len + text_len + 1;
+            const size_t before = g_log_pending_chars.fetch_add(added, std::memory_order_relaxed);
+            const size_t threshold = g_log_options.flush_bytes / sizeof(wchar_t);
+            if (before < threshold && before + added >= threshold)
+                SetEvent(g_log_wake_event);
+            return;
+        }
+
+        // Ring full or record larger than a cell: write inline rather than
+        // drop it, draining first so the file keeps producer order.
+        EnterCriticalSection(&g_log_cs);
+        DrainRingLocked();
+        WriteLineLocked(stamp, stamp_len, text, text_len);
+        LeaveCriticalSection(&g_log_cs);
+        return;
+    }
 
+    EnterCriticalSection(&g_log_cs);
+    WriteLineLocked(stamp, stamp_len, text, text_len);
     LeaveCriticalSection(&g_log_cs);
 }
 
@@ -96,12 +481,40 @@ void LogSEH(const wchar_t* message)
     if (!message)
         return;
     Log(std::wstring(message));
+    // The SEH path usually precedes thread (or process) death: do not leave
+    // the record sitting in the ring for the writer to pick up later.
+    FlushLogger();
     OutputDebugStringW(message);
     OutputDebugStringW(L"\n");
 }
 
+void FlushLogger()
+{
+    if (!g_log_file || !g_log_cs_initialized)
+        return;
+
+    EnterCriticalSection(&g_log_cs);
+    DrainRingLocked();
+    fflush(g_log_file);
+    LeaveCriticalSection(&g_log_cs);
+}
+
 void CloseLogger()
 {
+    StopAsyncWriter();
+
+    if (g_log_cs_initialized)
+    {
+        EnterCriticalSection(&g_log_cs);
+        DrainRingLocked();
+        LeaveCriticalSection(&g_log_cs);
+    }
+    g_log_ring.Release();
+    g_log_batch.clear();
+    g_log_batch.shrink_to_fit();
+    g_log_utf8.clear();
+    g_log_utf8.shrink_to_fit();
+
     if (g_log_file)
     {
         fclose(g_log_file);
@@ -113,3 +526,23 @@ void CloseLogger()
         g_log_cs_initialized = false;
     }
 }
+
+unsigned GetLogRotationCount()
+{
+    return g_log_rotations.load(std::memory_order_acquire);
+}
+
+namespace log_manager::detail
+{
+
+std::wstring RotatedLogPath(const std::wstring& path, unsigned index)
+{
+    const size_t name_start = path.find_last_of(L"\\/");
+    const size_t dot = path.find_last_of(L'.');
+    const std::wstring suffix = L"." + std::to_wstring(index);
+    if (dot == std::wstring::npos || (name_start != std::wstring::npos && dot < name_start))
+        return path + suffix;
+    return path.substr(0, dot) + suffix + path.substr(dot);
+}
+
+} // namespace log_manager::detail
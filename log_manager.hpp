@@ -1,16 +1,24 @@
 #pragma once
 
+#include <cstdint>
 #include <cstdio>
 #include <string>
 #include <windows.h>
 
-// UTF-16LE log file written next to the executable (or to %APPDATA%\CloudStreamingArgsDebugger\).
+// Log file written to %APPDATA%\CloudStreamingArgsDebugger\debug.log (or next to
+// the executable). UTF-16LE by default, optionally compact UTF-8, with
+// optional size- and age-based rotation.
 //
 //   InitLogger()     - call once from wWinMain after COM is initialized.
 //   Log(L"...")      - append one line prefixed with local time, thread-safe.
-//   LogSEH(...)      - thin wrapper used from the SEH-guarded audio thread.
+//   LogSEH(...)      - thin wrapper used from the SEH-guarded audio thread;
+//                      drains any queued records before returning.
+//   FlushLogger()    - synchronously write out everything queued so far.
 //   CloseLogger()    - flush, close the file, and release the critical section.
 //   GetLogPath()     - path to the log file (empty before InitLogger()).
+//   GetLogRotationCount() - rotations since InitLogger(); a reader holding
+//                      the old file (the "logs -f" panel) reopens when it
+//                      changes.
 //
 // The raw globals `g_log_file` and `g_logPath` remain visible with extern
 // linkage so that existing unit tests (tests/logging_tests.cpp) keep compiling.
@@ -18,9 +26,50 @@
 extern FILE* g_log_file;
 extern std::wstring g_logPath;
 
+enum class LogWriteMode
+{
+    // Every Log() call writes and fflush()es under the logger lock. Simple and
+    // what the unit tests expect, but the caller pays for the disk I/O.
+    Sync,
+    // Log() formats the record and pushes it into a lock-free ring; a writer
+    // thread batches records to the file. Producers never touch the FILE*.
+    Async,
+};
+
+enum class LogFormat
+{
+    // "[YYYY-MM-DD HH:MM:SS] text" in UTF-16LE with a BOM: two bytes per
+    // ASCII character. What the unit tests and existing tooling read.
+    Utf16,
+    // "<unix ms> text" in UTF-8, no BOM, LF line endings. Roughly half the
+    // bytes for this app's ASCII records, and the integer timestamp skips
+    // the per-record local-time formatting.
+    Utf8,
+};
+
+struct LoggerOptions
+{
+    LogWriteMode mode = LogWriteMode::Sync;
+    LogFormat format = LogFormat::Utf16;
+    // Rotate once the current file reaches this many bytes (0 = never).
+    uint64_t rotate_bytes = 0;
+    // Rotate at the first write after the current file has been open this
+    // long (0 = never).
+    ULONGLONG rotate_interval_ms = 0;
+    // Rotated files kept beside the log: debug.1.log (newest) up to
+    // debug.<keep_files>.log. 0 keeps none; rotation just restarts the file.
+    unsigned keep_files = 3;
+    // Async only: wake the writer early once this many bytes are queued.
+    size_t flush_bytes = 64 * 1024;
+    // Async only: upper bound on how long a record sits in the ring.
+    DWORD flush_interval_ms = 100;
+};
+
 void InitLogger();
+void InitLogger(const LoggerOptions& options);
 void Log(const std::wstring& text);
 void LogSEH(const wchar_t* message);
+void FlushLogger();
 void CloseLogger();
 
 inline const std::wstring& GetLogPath()
@@ -31,3 +80,13 @@ inline FILE* GetLogFile()
 {
     return g_log_file;
 }
+unsigned GetLogRotationCount();
+
+namespace log_manager::detail
+{
+
+// Name of rotated file `index` (1 = newest): debug.log -> debug.<index>.log.
+// A file name without an extension gets ".<index>" appended.
+std::wstring RotatedLogPath(const std::wstring& path, unsigned index);
+
+} // namespace log_manager::detail
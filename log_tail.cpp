@@ -0,0 +1,308 @@
+#ifndef UNICODE
+#define UNICODE
+#define _UNICODE
+#endif
+
+#include "log_tail.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+
+std::wstring DecodeLine(std::wstring line)
+{
+    return line;
+}
+
+std::wstring DecodeLine(const std::string& line)
+{
+    if (line.empty())
+        return {};
+    const int chars = MultiByteToWideChar(CP_UTF8, 0, line.data(), static_cast<int>(line.size()), nullptr, 0);
+    if (chars <= 0)
+        return {};
+    std::wstring wide(static_cast<size_t>(chars), L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, line.data(), static_cast<int>(line.size()), wide.data(), chars);
+    return wide;
+}
+
+template <typename Char>
+size_t AppendTextImpl(const Char* text, size_t count, std::basic_string<Char>& partial,
+                      std::deque<std::wstring>& lines, size_t max_lines)
+{
+    size_t found = 0;
+    size_t begin = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (text[i] != Char('\n'))
+            continue;
+
+        // The '\r' of a "\r\n" split across two reads ends up in `partial`,
+        // so strip it from the assembled line rather than from `text`.
+        std::basic_string<Char> line = std::move(partial);
+        partial.clear();
+        line.append(text + begin, i - begin);
+        if (!line.empty() && line.back() == Char('\r'))
+            line.pop_back();
+
+        lines.push_back(DecodeLine(std::move(line)));
+        if (lines.size() > max_lines)
+            lines.pop_front();
+        ++found;
+        begin = i + 1;
+    }
+    partial.append(text + begin, count - begin);
+    return found;
+}
+
+template <typename Char> size_t TailStartImpl(const Char* text, size_t count, size_t max_lines, bool at_file_start)
+{
+    size_t newlines = 0;
+    size_t first_line = count; // just past the earliest newline seen
+    for (size_t j = count; j > 0; --j)
+    {
+        if (text[j - 1] != Char('\n'))
+            continue;
+        // text[j - 1] ends the line before the last max_lines lines.
+        if (newlines == max_lines)
+            return j;
+        ++newlines;
+        first_line = j;
+    }
+    return at_file_start ? 0 : first_line;
+}
+
+std::wstring BytesToUtf16(const char* bytes, size_t count)
+{
+    std::wstring text(count / sizeof(wchar_t), L'\0');
+    memcpy(text.data(), bytes, text.size() * sizeof(wchar_t));
+    return text;
+}
+
+} // namespace
+
+namespace log_tail::detail
+{
+
+size_t AppendText(const wchar_t* text, size_t count, std::wstring& partial, std::deque<std::wstring>& lines,
+                  size_t max_lines)
+{
+    return AppendTextImpl(text, count, partial, lines, max_lines);
+}
+
+size_t TailStart(const wchar_t* text, size_t count, size_t max_lines, bool at_file_start)
+{
+    return TailStartImpl(text, count, max_lines, at_file_start);
+}
+
+size_t AppendText(const char* text, size_t count, std::string& partial, std::deque<std::wstring>& lines,
+                  size_t max_lines)
+{
+    return AppendTextImpl(text, count, partial, lines, max_lines);
+}
+
+size_t TailStart(const char* text, size_t count, size_t max_lines, bool at_file_start)
+{
+    return TailStartImpl(text, count, max_lines, at_file_start);
+}
+
+} // namespace log_tail::detail
+
+LogTail::LogTail(size_t max_lines) : max_lines_(max_lines)
+{
+}
+
+LogTail::~LogTail()
+{
+    Close();
+}
+
+bool LogTail::Open(const std::wstring& path)
+{
+    Close();
+    // FILE_SHARE_WRITE: the logger keeps its append handle open.
+    // FILE_SHARE_DELETE: rotation may rename the file while it is tailed.
+    file_ = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+                        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file_ == INVALID_HANDLE_VALUE)
+        return false;
+    if (!LoadTail())
+    {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void LogTail::Close()
+{
+    if (file_ != INVALID_HANDLE_VALUE)
+        CloseHandle(file_);
+    file_ = INVALID_HANDLE_VALUE;
+    encoding_ = Encoding::Unknown;
+    offset_ = 0;
+    partial_.clear();
+    partial_bytes_.clear();
+    lines_.clear();
+}
+
+uint64_t LogTail::AlignDown(uint64_t bytes) const
+{
+    // An odd UTF-16 size means a write is in progress.
+    return encoding_ == Encoding::Utf16 ? bytes & ~uint64_t{1} : bytes;
+}
+
+size_t LogTail::CountNewlines(const std::string& bytes) const
+{
+    if (encoding_ == Encoding::Utf8)
+        return static_cast<size_t>(std::count(bytes.begin(), bytes.end(), '\n'));
+    // Chunks start at even offsets, so code units are byte pairs from 0.
+    size_t newlines = 0;
+    for (size_t i = 0; i + 1 < bytes.size(); i += 2)
+    {
+        if (bytes[i] == '\n' && bytes[i + 1] == '\0')
+            ++newlines;
+    }
+    return newlines;
+}
+
+size_t LogTail::AppendBytes(const char* bytes, size_t count)
+{
+    if (encoding_ == Encoding::Utf8)
+        return log_tail::detail::AppendText(bytes, count, partial_bytes_, lines_, max_lines_);
+    const std::wstring text = BytesToUtf16(bytes, count);
+    return log_tail::detail::AppendText(text.data(), text.size(), partial_, lines_, max_lines_);
+}
+
+bool LogTail::LoadTail()
+{
+    lines_.clear();
+    partial_.clear();
+    partial_bytes_.clear();
+    offset_ = 0;
+    encoding_ = Encoding::Unknown;
+
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(file_, &size))
+        return false;
+    const uint64_t file_size = static_cast<uint64_t>(size.QuadPart);
+    if (file_size < 2)
+        return true; // classified by a later Poll()
+
+    std::string head;
+    if (!ReadAt(0, 2, head))
+        return false;
+    const bool utf16_bom = head.size() == 2 && static_cast<unsigned char>(head[0]) == 0xFF &&
+                           static_cast<unsigned char>(head[1]) == 0xFE;
+    encoding_ = utf16_bom ? Encoding::Utf16 : Encoding::Utf8;
+    const uint64_t end = AlignDown(file_size);
+
+    // Chunks are collected back to front and joined once, so the scan is
+    // proportional to the tail, not to the file.
+    std::vector<std::string> chunks;
+    uint64_t pos = end;
+    size_t newlines = 0;
+    while (pos > 0 && end - pos < kMaxTailBytes && newlines <= max_lines_)
+    {
+        const size_t bytes = static_cast<size_t>((std::min)(pos, uint64_t{kChunkBytes}));
+        std::string chunk;
+        if (!ReadAt(pos - bytes, bytes, chunk))
+            return false;
+        pos -= bytes;
+        newlines += CountNewlines(chunk);
+        chunks.push_back(std::move(chunk));
+    }
+
+    std::string tail;
+    for (auto it = chunks.rbegin(); it != chunks.rend(); ++it)
+        tail += *it;
+    const bool at_file_start = pos == 0;
+
+    if (encoding_ == Encoding::Utf16)
+    {
+        std::wstring text = BytesToUtf16(tail.data(), tail.size());
+        if (at_file_start && !text.empty() && text.front() == 0xFEFF)
+            text.erase(0, 1);
+        const size_t start = log_tail::detail::TailStart(text.data(), text.size(), max_lines_, at_file_start);
+        log_tail::detail::AppendText(text.data() + start, text.size() - start, partial_, lines_, max_lines_);
+    }
+    else
+    {
+        if (at_file_start && tail.compare(0, 3, "\xEF\xBB\xBF") == 0)
+            tail.erase(0, 3);
+        const size_t start = log_tail::detail::TailStart(tail.data(), tail.size(), max_lines_, at_file_start);
+        log_tail::detail::AppendText(tail.data() + start, tail.size() - start, partial_bytes_, lines_, max_lines_);
+    }
+    offset_ = end;
+    return true;
+}
+
+bool LogTail::ReadAt(uint64_t offset, size_t bytes, std::string& out)
+{
+    LARGE_INTEGER distance{};
+    distance.QuadPart = static_cast<LONGLONG>(offset);
+    if (!SetFilePointerEx(file_, distance, nullptr, FILE_BEGIN))
+        return false;
+
+    out.resize(bytes);
+    size_t done = 0;
+    while (done < bytes)
+    {
+        DWORD got = 0;
+        const DWORD want = static_cast<DWORD>((std::min)(bytes - done, size_t{kChunkBytes}));
+        if (!ReadFile(file_, out.data() + done, want, &got, nullptr))
+            return false;
+        if (got == 0)
+            break; // truncated underneath us
+        done += got;
+    }
+    out.resize(static_cast<size_t>(AlignDown(done)));
+    return true;
+}
+
+bool LogTail::Poll()
+{
+    if (!IsOpen())
+        return false;
+
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(file_, &size))
+        return false;
+    const uint64_t file_size = static_cast<uint64_t>(size.QuadPart);
+    if (encoding_ == Encoding::Unknown)
+        return file_size >= 2 && LoadTail();
+
+    const uint64_t end = AlignDown(file_size);
+    if (end == offset_)
+        return false;
+
+    // Shrunk (truncated) or a burst larger than the tail window: reading
+    // from offset_ would be wrong or wasteful, so start over from EOF.
+    if (end < offset_ || end - offset_ > kMaxTailBytes)
+        return LoadTail();
+
+    std::string appended;
+    if (!ReadAt(offset_, static_cast<size_t>(end - offset_), appended))
+        return false;
+    offset_ += appended.size();
+    return AppendBytes(appended.data(), appended.size()) > 0;
+}
+
+std::wstring LogTail::Text() const
+{
+    size_t total = 0;
+    for (const auto& line : lines_)
+        total += line.size() + 1;
+
+    std::wstring text;
+    text.reserve(total);
+    for (const auto& line : lines_)
+    {
+        text += line;
+        text += L'\n';
+    }
+    return text;
+}
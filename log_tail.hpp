@@ -0,0 +1,111 @@
+#pragma once
+
+#include <windows.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+
+// Last lines of the log for the "logs" panel, without reading the whole
+// file. The log is append-only and can grow for days, so:
+//
+//   Open(path)  - read backward from EOF in kChunkBytes chunks until
+//                 max_lines lines are found (or kMaxTailBytes were read).
+//   Poll()      - read only what was appended since the last Open()/Poll();
+//                 returns true if Lines() changed. Live-follow calls this
+//                 periodically while the panel is open.
+//
+// The encoding is taken from the file itself: a UTF-16LE BOM selects UTF-16,
+// anything else is read as UTF-8 (LogFormat::Utf8 writes no BOM). An empty
+// file is classified once its first bytes appear.
+//
+// The file is opened with full sharing, so the logger keeps writing while it
+// is tailed. A line is only reported once its terminating newline has been
+// written; a half-written record stays pending until the next Poll(). If the
+// file shrinks (truncated or replaced) Poll() reloads the tail from the new
+// EOF. Render-thread only; nothing here calls Log(), so following the log
+// cannot feed itself.
+class LogTail
+{
+  public:
+    static constexpr size_t kDefaultMaxLines = 100;
+    static constexpr size_t kChunkBytes = 64 * 1024;
+    // Bounds how far back Open() looks for max_lines newlines, and how much
+    // Poll() reads at once before it just reloads the tail instead.
+    static constexpr size_t kMaxTailBytes = 1024 * 1024;
+
+    explicit LogTail(size_t max_lines = kDefaultMaxLines);
+    ~LogTail();
+
+    LogTail(const LogTail&) = delete;
+    LogTail& operator=(const LogTail&) = delete;
+
+    // False if the file cannot be opened; Lines() is then empty.
+    bool Open(const std::wstring& path);
+    void Close();
+    bool IsOpen() const
+    {
+        return file_ != INVALID_HANDLE_VALUE;
+    }
+
+    bool Poll();
+
+    // Oldest first, without line terminators.
+    const std::deque<std::wstring>& Lines() const
+    {
+        return lines_;
+    }
+    // Lines(), each followed by '\n'.
+    std::wstring Text() const;
+
+  private:
+    enum class Encoding
+    {
+        Unknown, // empty file, nothing to decide from yet
+        Utf16,
+        Utf8,
+    };
+
+    bool LoadTail();
+    bool ReadAt(uint64_t offset, size_t bytes, std::string& out);
+    // Whole code units of `bytes`, for the current encoding.
+    uint64_t AlignDown(uint64_t bytes) const;
+    size_t CountNewlines(const std::string& bytes) const;
+    size_t AppendBytes(const char* bytes, size_t count);
+
+    size_t max_lines_;
+    HANDLE file_ = INVALID_HANDLE_VALUE;
+    Encoding encoding_ = Encoding::Unknown;
+    uint64_t offset_ = 0;        // bytes already split into lines_ / partial
+    std::wstring partial_;       // UTF-16: text after the last newline seen
+    std::string partial_bytes_;  // UTF-8: bytes after the last newline seen
+    std::deque<std::wstring> lines_;
+};
+
+namespace log_tail::detail
+{
+
+// Splits `count` UTF-16 units of `text` on '\n' (dropping a '\r' before it)
+// and appends the complete lines to `lines`, keeping at most `max_lines`.
+// `partial` is the unterminated text carried over from the previous call; it
+// is prefixed to the first line and receives the new unterminated rest.
+// Returns the number of complete lines found.
+size_t AppendText(const wchar_t* text, size_t count, std::wstring& partial, std::deque<std::wstring>& lines,
+                  size_t max_lines);
+
+// Offset in `text` where the last `max_lines` complete lines start, scanning
+// backward. A trailing unterminated fragment is not counted as a line.
+// `at_file_start` says whether text[0] is the first character of the file;
+// otherwise the text before the first newline may be a partial line and is
+// never included.
+size_t TailStart(const wchar_t* text, size_t count, size_t max_lines, bool at_file_start);
+
+// UTF-8 versions of the above. Newlines are found on bytes ('\n' never
+// occurs inside a multi-byte sequence), so a sequence split across reads
+// stays in `partial` until its line is complete; lines are decoded to UTF-16.
+size_t AppendText(const char* text, size_t count, std::string& partial, std::deque<std::wstring>& lines,
+                  size_t max_lines);
+size_t TailStart(const char* text, size_t count, size_t max_lines, bool at_file_start);
+
+} // namespace log_tail::detail
@@ -0,0 +1,93 @@
+#ifndef UNICODE
+#define UNICODE
+#define _UNICODE
+#endif
+
+#include "metrics_export.hpp"
+
+#include "log_manager.hpp"
+
+MetricsExport::~MetricsExport()
+{
+    Close();
+}
+
+bool MetricsExport::Create(const std::wstring& name)
+{
+    Close();
+    mapping_ = CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0,
+                                  static_cast<DWORD>(sizeof(MetricsBlock)), name.c_str());
+    if (!mapping_)
+    {
+        Log(L"Metrics: CreateFileMappingW failed for " + name + L", error=" + std::to_wstring(GetLastError()));
+        return false;
+    }
+    // Another live instance using the same (custom) name would be
+    // overwritten; say so rather than silently sharing it.
+    if (GetLastError() == ERROR_ALREADY_EXISTS)
+        Log(L"Metrics: segment " + name + L" already exists, taking it over");
+
+    block_ = static_cast<MetricsBlock*>(MapViewOfFile(mapping_, FILE_MAP_WRITE, 0, 0, sizeof(MetricsBlock)));
+    if (!block_)
+    {
+        Log(L"Metrics: MapViewOfFile failed, error=" + std::to_wstring(GetLastError()));
+        Close();
+        return false;
+    }
+
+    LARGE_INTEGER frequency{};
+    QueryPerformanceFrequency(&frequency);
+    block_->magic.store(0, std::memory_order_relaxed);
+    block_->version = kMetricsVersion;
+    block_->size = static_cast<uint32_t>(sizeof(MetricsBlock));
+    block_->pid = GetCurrentProcessId();
+    block_->qpc_frequency = frequency.QuadPart;
+    block_->frame_sequence.store(0, std::memory_order_relaxed);
+    block_->frame = {};
+    block_->audio_sequence.store(0, std::memory_order_relaxed);
+    block_->audio = {};
+    block_->magic.store(kMetricsMagic, std::memory_order_release);
+
+    name_ = name;
+    Log(L"Metrics: publishing to " + name_);
+    return true;
+}
+
+void MetricsExport::Close()
+{
+    if (block_)
+    {
+        block_->magic.store(0, std::memory_order_release);
+        UnmapViewOfFile(block_);
+        block_ = nullptr;
+    }
+    if (mapping_)
+    {
+        CloseHandle(mapping_);
+        mapping_ = nullptr;
+    }
+    name_.clear();
+}
+
+void MetricsExport::PublishFrame(const MetricsFrameSection& frame)
+{
+    if (block_)
+        metrics_export::detail::SeqlockWrite(block_->frame_sequence, block_->frame, frame);
+}
+
+void MetricsExport::PublishAudio(const MetricsAudioSection& audio)
+{
+    if (block_)
+        metrics_export::detail::SeqlockWrite(block_->audio_sequence, block_->audio, audio);
+}
+
+void MetricsExport::PublishInput(const MetricsInputSection& input)
+{
+    if (block_)
+        metrics_export::detail::SeqlockWrite(block_->input_sequence, block_->input, input);
+}
+
+std::wstring DefaultMetricsName(DWORD pid)
+{
+    return L"Local\\CloudStreamingArgsDebugger.Metrics." + std::to_wstring(pid);
+}
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <windows.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+// Live metrics in a named shared-memory segment, so a host monitoring agent
+// can sample many instances with plain memory reads instead of scraping the
+// log or the screen. The segment holds one MetricsBlock; the agent maps it
+// once (OpenFileMappingW + MapViewOfFile, FILE_MAP_READ) and polls it.
+//
+//   Create(name)   - render thread, before the capture thread starts.
+//   PublishFrame() - render thread, once per rendered frame.
+//   PublishAudio() - capture thread, once per packet.
+//   PublishInput() - render thread, once per keystroke measured by
+//                    --latency-probe (the section stays zero without it).
+//
+// Each section has its own writer and its own seqlock sequence, on its own
+// cache line. Reader protocol (see detail::SeqlockRead):
+//   s0 = sequence; if s0 is odd, a write is in progress: retry.
+//   copy the section; read sequence again; if it changed, retry.
+//
+// The block only ever grows at the end. Readers check magic == kMetricsMagic
+// (written last, once the header is valid), then version and size.
+
+constexpr uint32_t kMetricsMagic = 0x44415343; // "CSAD" in memory order
+constexpr uint32_t kMetricsVersion = 2;
+constexpr uint32_t kMetricsMaxChannels = 8; // matches kMeterMaxChannels
+constexpr uint32_t kMetricsRecentKeystrokes = 16;
+
+enum class MetricsPresentMode : uint32_t
+{
+    Blt = 0,
+    Flip = 1,
+    FlipTearing = 2,
+};
+
+struct MetricsPercentiles
+{
+    float p50_ms;
+    float p95_ms;
+    float p99_ms;
+    float max_ms;
+};
+
+struct MetricsFrameSection
+{
+    uint64_t frame_counter;
+    int64_t qpc;        // QueryPerformanceCounter when published
+    float fps;          // instantaneous, from the last frame interval
+    int32_t synced_fps; // value carried by the QR payload
+    float interval_ms;  // last frame-start to frame-start time
+    float cpu_ms;       // last RenderFrame CPU time
+    // Over FrameStats::kWindow, refreshed four times a second.
+    MetricsPercentiles interval;
+    MetricsPercentiles cpu;
+    uint32_t present_mode; // MetricsPresentMode
+    uint32_t low_power;    // 1 in --render-mode=low-power
+    // From GetProcessMemoryInfo, refreshed about once a second.
+    uint64_t working_set_bytes;
+    uint64_t peak_working_set_bytes;
+    uint64_t private_bytes;
+};
+
+struct MetricsAudioSection
+{
+    uint64_t packets;  // capture packets processed
+    int64_t qpc;       // QueryPerformanceCounter when published
+    uint32_t channels; // stream channels; levels cover the first 8
+    float level;       // smoothed overall peak (the HUD bar)
+    float peak[kMetricsMaxChannels];
+    float rms[kMetricsMaxChannels];
+    // Capture thread user + kernel time (GetThreadTimes), in 100 ns units,
+    // refreshed about once a second.
+    uint64_t thread_cpu_100ns;
+};
+
+// One keystroke measured by --latency-probe (see input_latency.hpp).
+struct MetricsKeystroke
+{
+    uint32_t sequence; // 1-based WM_CHAR count; 0 = slot not written yet
+    uint32_t source;   // LatencySource of the display time
+    uint64_t frame;    // frame that first drew it
+    float queue_ms;    // GetMessageTime() to WM_CHAR handled (tick resolution)
+    float render_ms;   // handled to Present returning
+    float display_ms;  // handled to on screen
+    float total_ms;    // queue_ms + display_ms
+};
+
+struct MetricsInputSection
+{
+    uint32_t completed; // keystrokes measured since startup
+    uint32_t dropped;   // keystrokes that never reached the screen
+    // total_ms over the last 256 measured keystrokes.
+    MetricsPercentiles total;
+    // The n-th measured keystroke goes to recent[(n - 1) % 16], so an agent
+    // polling at least every 16 keystrokes sees each one.
+    MetricsKeystroke recent[kMetricsRecentKeystrokes];
+};
+
+struct MetricsBlock
+{
+    // Header, written once by Create(). std::atomic<uint32_t> has the layout
+    // of a plain uint32_t; readers in other languages treat it as one.
+    std::atomic<uint32_t> magic;
+    uint32_t version;
+    uint32_t size; // sizeof(MetricsBlock)
+    uint32_t pid;
+    int64_t qpc_frequency;
+
+    alignas(64) std::atomic<uint32_t> frame_sequence;
+    MetricsFrameSection frame;
+
+    alignas(64) std::atomic<uint32_t> audio_sequence;
+    MetricsAudioSection audio;
+
+    // Version 2.
+    alignas(64) std::atomic<uint32_t> input_sequence;
+    MetricsInputSection input;
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free && sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+              "seqlock sequences must be plain 32-bit words in shared memory");
+static_assert(std::is_standard_layout_v<MetricsBlock>);
+static_assert(std::is_trivially_copyable_v<MetricsFrameSection> && std::is_trivially_copyable_v<MetricsAudioSection> &&
+              std::is_trivially_copyable_v<MetricsInputSection>);
+
+class MetricsExport
+{
+  public:
+    MetricsExport() = default;
+    ~MetricsExport();
+
+    MetricsExport(const MetricsExport&) = delete;
+    MetricsExport& operator=(const MetricsExport&) = delete;
+
+    // Creates the segment (zero-filled) and writes the header. Logs and
+    // returns false on failure; Publish*() are then no-ops.
+    bool Create(const std::wstring& name);
+    void Close();
+
+    bool IsOpen() const
+    {
+        return block_ != nullptr;
+    }
+    const std::wstring& Name() const
+    {
+        return name_;
+    }
+    // In-process view of the mapping; tests and diagnostics.
+    const MetricsBlock* Block() const
+    {
+        return block_;
+    }
+
+    void PublishFrame(const MetricsFrameSection& frame);
+    void PublishAudio(const MetricsAudioSection& audio);
+    void PublishInput(const MetricsInputSection& input);
+
+  private:
+    HANDLE mapping_ = nullptr;
+    MetricsBlock* block_ = nullptr;
+    std::wstring name_;
+};
+
+// "Local\CloudStreamingArgsDebugger.Metrics.<pid>".
+std::wstring DefaultMetricsName(DWORD pid);
+
+namespace metrics_export::detail
+{
+
+// Single writer per sequence.
+template <typename T> void SeqlockWrite(std::atomic<uint32_t>& sequence, T& dst, const T& src)
+{
+    const uint32_t s = sequence.load(std::memory_order_relaxed);
+    sequence.store(s + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(&dst, &src, sizeof(T));
+    sequence.store(s + 2, std::memory_order_release);
+}
+
+// One read attempt; false if a write overlapped it (the caller retries).
+template <typename T> bool SeqlockRead(const std::atomic<uint32_t>& sequence, const T& src, T& out)
+{
+    const uint32_t s0 = sequence.load(std::memory_order_acquire);
+    if (s0 & 1)
+        return false;
+    memcpy(&out, &src, sizeof(T));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return sequence.load(std::memory_order_relaxed) == s0;
+}
+
+} // namespace metrics_export::detail
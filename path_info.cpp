@@ -13,6 +13,7 @@
 // clang-format on
 
 #include "path_info.hpp"
+#include "session_record.hpp"
 
 #pragma comment(lib, "shell32")
 #pragma comment(lib, "ole32")
@@ -63,6 +64,44 @@ template <typename Query> std::wstring FillWithQueriedSize(Query query)
     return buf;
 }
 
+struct WineProbe
+{
+    bool present = false; // ntdll exports wine_get_version
+    std::wstring version; // what it reported; empty if nothing usable
+};
+
+// The answer cannot change while the process runs, so ntdll is asked once;
+// the function-local static makes the first call thread-safe.
+const WineProbe& ProbeWine()
+{
+    static const WineProbe probe = []
+    {
+        WineProbe result;
+        using wine_get_version_func = const char* (*)(void);
+        HMODULE hNtdll = GetModuleHandleW(L"ntdll.dll");
+        if (!hNtdll)
+            return result;
+
+        auto wineGetVersion = reinterpret_cast<wine_get_version_func>(GetProcAddress(hNtdll, "wine_get_version"));
+        if (!wineGetVersion)
+            return result;
+        result.present = true;
+
+        const char* version = wineGetVersion();
+        if (!version)
+            return result;
+
+        int size_needed = MultiByteToWideChar(CP_UTF8, 0, version, -1, nullptr, 0);
+        if (size_needed <= 1)
+            return result;
+
+        result.version.assign(size_needed - 1, L'\0');
+        MultiByteToWideChar(CP_UTF8, 0, version, -1, &result.version[0], size_needed);
+        return result;
+    }();
+    return probe;
+}
+
 } // namespace
 
 namespace path_info
@@ -117,32 +156,21 @@ std::wstring OsVersionString()
            L" (Build " + std::to_wstring(osvi.dwBuildNumber) + L")";
 }
 
-std::wstring WineOrProtonVersion()
+bool IsWine()
 {
-    using wine_get_version_func = const char* (*)(void);
-    HMODULE hNtdll = GetModuleHandleW(L"ntdll.dll");
-    if (!hNtdll)
-        return L"Not detected";
-
-    auto wineGetVersion = reinterpret_cast<wine_get_version_func>(GetProcAddress(hNtdll, "wine_get_version"));
-    if (!wineGetVersion)
-        return L"Not detected";
-
-    const char* version = wineGetVersion();
-    if (!version)
-        return L"Not detected";
+    return ProbeWine().present;
+}
 
-    int size_needed = MultiByteToWideChar(CP_UTF8, 0, version, -1, nullptr, 0);
-    if (size_needed <= 1)
+std::wstring WineOrProtonVersion()
+{
+    const WineProbe& wine = ProbeWine();
+    if (wine.version.empty())
         return L"Not detected";
 
-    std::wstring wversion(size_needed - 1, L'\0');
-    MultiByteToWideChar(CP_UTF8, 0, version, -1, &wversion[0], size_needed);
-
     wchar_t protonBuf[1024]{};
     if (GetEnvironmentVariableW(L"PROTON_VERSION", protonBuf, 1024) > 0)
-        return L"Proton " + std::wstring(protonBuf) + L" (Wine " + wversion + L")";
-    return L"Wine " + wversion;
+        return L"Proton " + std::wstring(protonBuf) + L" (Wine " + wine.version + L")";
+    return L"Wine " + wine.version;
 }
 
 std::wstring SaveFilePath()
@@ -154,7 +182,8 @@ std::wstring SaveFilePath()
 
     std::wstring path = appdata_path;
     CoTaskMemFree(appdata_path);
-    path += L"\\CloudStreamingArgsDebugger\\saved_data.txt";
+    path += L"\\CloudStreamingArgsDebugger\\";
+    path += kSessionRecordFileName;
     return path;
 }
 
@@ -27,6 +27,10 @@ std::wstring WindowsDirectory();
 std::wstring SystemDirectory();
 std::wstring OsVersionString();
 std::wstring WineOrProtonVersion();
+
+// True under Wine/Proton (ntdll exports wine_get_version). Probed once per
+// process and shared by WineOrProtonVersion() and the presenter.
+bool IsWine();
 std::wstring SaveFilePath();
 
 } // namespace path_info
@@ -0,0 +1,140 @@
+#ifndef UNICODE
+#define UNICODE
+#define _UNICODE
+#endif
+
+#include "path_info_cache.hpp"
+
+#include <objbase.h>
+
+#include <cstring>
+#include <exception>
+#include <utility>
+
+#include "frame_pacer.hpp"
+#include "log_manager.hpp"
+
+PathInfoCache::PathInfoCache(Collector collect) : collect_(std::move(collect))
+{
+}
+
+PathInfoCache::~PathInfoCache()
+{
+    Stop();
+    delete published_.exchange(nullptr, std::memory_order_acquire);
+}
+
+bool PathInfoCache::Start()
+{
+    Stop();
+    // The startup prefetch is generation 1.
+    requested_ = 1;
+    adopted_ = 0;
+    pending_generation_.store(requested_, std::memory_order_release);
+
+    wake_event_ = CreateEventW(nullptr, FALSE, TRUE, nullptr);
+    if (!wake_event_)
+    {
+        Log(L"PathInfoCache: CreateEvent failed, collecting on the calling thread");
+        Collect(requested_);
+        return false;
+    }
+
+    running_.store(true, std::memory_order_release);
+    try
+    {
+        thread_ = std::thread(&PathInfoCache::ThreadMain, this);
+    }
+    catch (...)
+    {
+        running_.store(false, std::memory_order_release);
+        CloseHandle(wake_event_);
+        wake_event_ = nullptr;
+        Log(L"PathInfoCache: thread creation failed, collecting on the calling thread");
+        Collect(requested_);
+        return false;
+    }
+    return true;
+}
+
+void PathInfoCache::Stop()
+{
+    if (thread_.joinable())
+    {
+        running_.store(false, std::memory_order_release);
+        SetEvent(wake_event_);
+        thread_.join();
+    }
+    if (wake_event_)
+    {
+        CloseHandle(wake_event_);
+        wake_event_ = nullptr;
+    }
+}
+
+void PathInfoCache::Refresh()
+{
+    ++requested_;
+    pending_generation_.store(requested_, std::memory_order_release);
+    if (running_.load(std::memory_order_acquire))
+        SetEvent(wake_event_);
+    else
+        Collect(requested_);
+}
+
+bool PathInfoCache::Poll()
+{
+    PathSnapshot* snapshot = published_.exchange(nullptr, std::memory_order_acquire);
+    if (!snapshot)
+        return false;
+    adopted_ = snapshot->generation;
+    current_.reset(snapshot);
+    return true;
+}
+
+void PathInfoCache::Collect(unsigned generation)
+{
+    auto snapshot = std::make_unique<PathSnapshot>();
+    snapshot->generation = generation;
+    const LONGLONG start = FramePacer::Now();
+    try
+    {
+        snapshot->items = collect_();
+    }
+    catch (const std::exception& ex)
+    {
+        // Publish the empty snapshot anyway so Busy() clears.
+        Log(L"PathInfoCache: collection failed: " + std::wstring(ex.what(), ex.what() + strlen(ex.what())));
+        snapshot->items.clear();
+    }
+    snapshot->lines.reserve(snapshot->items.size());
+    for (const PathItem& item : snapshot->items)
+        snapshot->lines.push_back(item.first + item.second);
+    snapshot->collect_ms = FramePacer::TicksToSeconds(FramePacer::Now() - start) * 1000.0;
+
+    // Release publishes the fully built snapshot to Poll()'s acquire. One the
+    // owner has not taken yet is stale now.
+    delete published_.exchange(snapshot.release(), std::memory_order_acq_rel);
+}
+
+void PathInfoCache::ThreadMain()
+{
+    // SHGetKnownFolderPath and friends expect COM on the calling thread.
+    const HRESULT com = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+    unsigned collected = 0;
+    while (running_.load(std::memory_order_acquire))
+    {
+        WaitForSingleObject(wake_event_, INFINITE);
+
+        // Requests made while collecting are served by one more pass.
+        unsigned generation = pending_generation_.load(std::memory_order_acquire);
+        while (generation != collected && running_.load(std::memory_order_acquire))
+        {
+            Collect(generation);
+            collected = generation;
+            generation = pending_generation_.load(std::memory_order_acquire);
+        }
+    }
+    if (SUCCEEDED(com))
+        CoUninitialize();
+}
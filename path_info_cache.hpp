@@ -0,0 +1,88 @@
+#pragma once
+
+#include <windows.h>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "path_info.hpp"
+
+// One path_info::Collect() result. Never modified once published, so the
+// render thread draws straight from it.
+struct PathSnapshot
+{
+    std::vector<PathItem> items;
+    std::vector<std::wstring> lines; // label + value of each item, ready to draw
+    unsigned generation = 0;         // 1 for the startup prefetch, +1 per refresh
+    double collect_ms = 0.0;         // wall time of the Collect() call
+};
+
+// Runs path_info::Collect() on a background thread so the "path" command
+// never blocks a frame. Collect() asks ntdll, the shell and the environment;
+// on Wine/Proton and with network-redirected profiles that can take tens of
+// milliseconds.
+//
+//   Start()   - owner thread: start the worker; it prefetches right away.
+//   Refresh() - owner thread: queue another collection (coalesced with one
+//               already queued).
+//   Poll()    - owner thread, once per loop iteration: adopt the newest
+//               finished snapshot.
+//   Current() - owner thread: the adopted snapshot, or null before the first.
+//
+// Hand-over is a single atomic pointer exchange: the worker publishes a
+// heap snapshot and the owner takes it in Poll(), so Current() is read with
+// no lock at all. A snapshot superseded before Poll() took it is freed by
+// whichever side replaces it. Without a running thread (Start() failed)
+// Refresh() collects inline.
+class PathInfoCache
+{
+  public:
+    using Collector = std::function<std::vector<PathItem>()>;
+
+    // `collect` is swappable for tests.
+    explicit PathInfoCache(Collector collect = path_info::Collect);
+    ~PathInfoCache();
+
+    PathInfoCache(const PathInfoCache&) = delete;
+    PathInfoCache& operator=(const PathInfoCache&) = delete;
+
+    bool Start();
+    // Joins the worker; a collection in flight is finished first. Idempotent.
+    void Stop();
+
+    void Refresh();
+
+    // Returns true if Current() changed. The previous snapshot is freed here.
+    bool Poll();
+
+    const PathSnapshot* Current() const
+    {
+        return current_.get();
+    }
+
+    // A collection has been queued and its result not yet adopted.
+    bool Busy() const
+    {
+        return requested_ != adopted_;
+    }
+
+  private:
+    void ThreadMain();
+    void Collect(unsigned generation);
+
+    Collector collect_;
+    HANDLE wake_event_ = nullptr;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<unsigned> pending_generation_{0}; // newest generation requested
+    std::atomic<PathSnapshot*> published_{nullptr}; // worker -> owner; owned while set
+
+    // Owner thread only.
+    std::unique_ptr<const PathSnapshot> current_;
+    unsigned requested_ = 0;
+    unsigned adopted_ = 0;
+};
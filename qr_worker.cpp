@@ -0,0 +1,368 @@
+#ifndef UNICODE
+#define UNICODE
+#define _UNICODE
+#endif
+
+#include "qr_worker.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <exception>
+
+#include "alloc_guard.hpp"
+#include "log_manager.hpp"
+#include "trace_events.hpp"
+#include "utf8_convert.hpp"
+
+using qrcodegen::QrCode;
+using qrcodegen::QrSegment;
+
+namespace
+{
+
+// Widest stamp in practice: a 10-digit unix time, 5-digit FPS, a frame
+// counter good for years at 60 FPS and 16 QPC digits (decades at 10 MHz).
+// Anything longer still encodes; encodeSegments just picks a larger version.
+// The latency fields, when present, are sized for the full uint32 range.
+QrStamp WidestStamp(bool latency_fields)
+{
+    QrStamp widest;
+    widest.unix_time = 9999999999LL;
+    widest.fps = 99999;
+    widest.frame = 999999999999ULL;
+    widest.qpc = 9999999999999999LL;
+    if (latency_fields)
+    {
+        widest.key = UINT32_MAX;
+        widest.key_latency_us = UINT32_MAX;
+    }
+    return widest;
+}
+
+} // namespace
+
+namespace qr_worker::detail
+{
+
+int ModuleAt(int pixel, float scale)
+{
+    // The original per-pixel mapping; kept bit-exact so the span rasteriser
+    // produces the same image.
+    return static_cast<int>(pixel / scale);
+}
+
+std::string BuildStampPayload(const QrStamp& stamp)
+{
+    std::string payload = "t=" + std::to_string(stamp.unix_time) + ";f=" + std::to_string(stamp.fps) +
+                          ";n=" + std::to_string(stamp.frame) + ";q=" + std::to_string(stamp.qpc);
+    if (stamp.key != 0)
+        payload += ";k=" + std::to_string(stamp.key) + ";l=" + std::to_string(stamp.key_latency_us);
+    return payload;
+}
+
+std::string BuildArgsSuffix(const std::vector<std::wstring>& args)
+{
+    std::string suffix;
+    if (!args.empty())
+    {
+        size_t length = 0;
+        for (const auto& arg : args)
+            length += arg.size() + 1;
+        suffix.reserve(sizeof(";args=") - 1 + length);
+        suffix = ";args=";
+        for (const auto& arg : args)
+        {
+            utf8_convert::Append(arg, suffix);
+            suffix += ' ';
+        }
+    }
+    return suffix;
+}
+
+std::vector<QrSegment> MakeByteSegments(const std::string& text)
+{
+    std::vector<QrSegment> segments;
+    if (!text.empty())
+        segments.push_back(QrSegment::makeBytes(std::vector<std::uint8_t>(text.begin(), text.end())));
+    return segments;
+}
+
+int StableMinVersion(const std::vector<QrSegment>& args_segments, bool latency_fields)
+{
+    try
+    {
+        return EncodePayload(WidestStamp(latency_fields), args_segments, 1).getVersion();
+    }
+    catch (const qrcodegen::data_too_long&)
+    {
+        return 40;
+    }
+}
+
+bool FitsSingleCode(const std::vector<QrSegment>& args_segments, bool latency_fields)
+{
+    try
+    {
+        EncodePayload(WidestStamp(latency_fields), args_segments, 40);
+        return true;
+    }
+    catch (const qrcodegen::data_too_long&)
+    {
+        return false;
+    }
+}
+
+uint64_t Fnv1a64(const std::string& text)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (const char ch : text)
+    {
+        hash ^= static_cast<unsigned char>(ch);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+std::vector<std::string> SplitArgsPayload(const std::string& args_suffix, bool latency_fields)
+{
+    static const std::string kArgsTag = ";args=";
+    if (args_suffix.compare(0, kArgsTag.size(), kArgsTag) != 0 ||
+        FitsSingleCode(MakeByteSegments(args_suffix), latency_fields))
+        return {args_suffix};
+
+    const std::string body = args_suffix.substr(kArgsTag.size());
+    const size_t count = (body.size() + kChunkBytes - 1) / kChunkBytes;
+    const std::string count_text = std::to_string(count);
+
+    char hash_text[17];
+    std::snprintf(hash_text, sizeof(hash_text), "%016llx", static_cast<unsigned long long>(Fnv1a64(body)));
+
+    std::vector<std::string> chunks;
+    chunks.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        // Zero-padded so every header is the same length and chunk 0 is the
+        // widest code in the cycle.
+        std::string index = std::to_string(i);
+        index.insert(0, count_text.size() - index.size(), '0');
+        chunks.push_back(";h=" + std::string(hash_text) + ";c=" + index + "/" + count_text + kArgsTag +
+                         body.substr(i * kChunkBytes, kChunkBytes));
+    }
+    return chunks;
+}
+
+QrCode EncodePayload(const QrStamp& stamp, const std::vector<QrSegment>& args_segments, int min_version)
+{
+    std::vector<QrSegment> segments = MakeByteSegments(BuildStampPayload(stamp));
+    segments.insert(segments.end(), args_segments.begin(), args_segments.end());
+    // Error correction level MEDIUM, as before.
+    return QrCode::encodeSegments(segments, QrCode::Ecc::MEDIUM, min_version);
+}
+
+int ModuleEdge(int module, int pixel_size, float scale)
+{
+    // Smallest x with ModuleAt(x) >= module, found around module * scale and
+    // corrected against the exact expression so rounding cannot shift an edge.
+    int x = static_cast<int>(static_cast<float>(module) * scale);
+    x = std::clamp(x, 0, pixel_size);
+    while (x > 0 && ModuleAt(x - 1, scale) >= module)
+        --x;
+    while (x < pixel_size && ModuleAt(x, scale) < module)
+        ++x;
+    return x;
+}
+
+void RasterizeQr(const QrCode& qr, int pixel_size, std::vector<uint32_t>& pixels)
+{
+    constexpr uint32_t kWhite = 0xffffffff;
+    constexpr uint32_t kBlack = 0xff000000;
+
+    const size_t row_pixels = static_cast<size_t>(pixel_size);
+    pixels.resize(row_pixels * row_pixels);
+
+    const int qr_modules = qr.getSize();
+    if (qr_modules <= 0 || qr_modules > kMaxModules || pixel_size <= 0)
+    {
+        std::fill(pixels.begin(), pixels.end(), kWhite);
+        return;
+    }
+    const float scale = static_cast<float>(pixel_size) / qr_modules;
+
+    // edge[m]..edge[m + 1] is the pixel span of module m, identically for
+    // columns and rows. Past edge[qr_modules] the image is background.
+    std::array<int, kMaxModules + 1> edge{};
+    for (int m = 0; m <= qr_modules; ++m)
+        edge[m] = ModuleEdge(m, pixel_size, scale);
+
+    uint32_t* const base = pixels.data();
+    for (int module_y = 0; module_y < qr_modules; ++module_y)
+    {
+        const int y_begin = edge[module_y];
+        const int y_end = edge[module_y + 1];
+        if (y_begin == y_end)
+            continue;
+
+        // Build the first row of this module row span by span...
+        uint32_t* row = base + static_cast<size_t>(y_begin) * row_pixels;
+        for (int module_x = 0; module_x < qr_modules; ++module_x)
+        {
+            const uint32_t color = qr.getModule(module_x, module_y) ? kBlack : kWhite;
+            std::fill(row + edge[module_x], row + edge[module_x + 1], color);
+        }
+        std::fill(row + edge[qr_modules], row + pixel_size, kWhite);
+
+        // ...and replicate it for the remaining rows of the module.
+        for (int y = y_begin + 1; y < y_end; ++y)
+            std::copy_n(row, row_pixels, base + static_cast<size_t>(y) * row_pixels);
+    }
+    std::fill(base + static_cast<size_t>(edge[qr_modules]) * row_pixels, base + row_pixels * row_pixels, kWhite);
+}
+
+} // namespace qr_worker::detail
+
+QrWorker::QrWorker() : chunk_segments_(1), min_version_(qr_worker::detail::StableMinVersion({}))
+{
+    InitializeCriticalSection(&cs_);
+}
+
+QrWorker::~QrWorker()
+{
+    Stop();
+    DeleteCriticalSection(&cs_);
+}
+
+bool QrWorker::Start(const std::string& args_suffix, bool latency_fields)
+{
+    Stop();
+    const std::vector<std::string> chunks = qr_worker::detail::SplitArgsPayload(args_suffix, latency_fields);
+    chunk_segments_.clear();
+    for (const std::string& chunk : chunks)
+        chunk_segments_.push_back(qr_worker::detail::MakeByteSegments(chunk));
+    next_chunk_ = 0;
+    // Chunk 0 is the widest, so this version fits every code in the cycle.
+    min_version_ = qr_worker::detail::StableMinVersion(chunk_segments_.front(), latency_fields);
+    if (chunks.size() > 1)
+        Log(L"QrWorker: " + std::to_wstring(args_suffix.size()) + L"-byte args payload split into " +
+            std::to_wstring(chunks.size()) + L" QR codes (version " + std::to_wstring(min_version_) + L")");
+
+    wake_event_ = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+    if (!wake_event_)
+    {
+        Log(L"QrWorker: CreateEvent failed, encoding on the render thread");
+        return false;
+    }
+
+    running_.store(true, std::memory_order_release);
+    try
+    {
+        thread_ = std::thread(&QrWorker::ThreadMain, this);
+    }
+    catch (...)
+    {
+        running_.store(false, std::memory_order_release);
+        CloseHandle(wake_event_);
+        wake_event_ = nullptr;
+        Log(L"QrWorker: thread creation failed, encoding on the render thread");
+        return false;
+    }
+    return true;
+}
+
+void QrWorker::Stop()
+{
+    if (thread_.joinable())
+    {
+        running_.store(false, std::memory_order_release);
+        SetEvent(wake_event_);
+        thread_.join();
+    }
+    if (wake_event_)
+    {
+        CloseHandle(wake_event_);
+        wake_event_ = nullptr;
+    }
+}
+
+void QrWorker::Request(const QrStamp& stamp)
+{
+    if (!running_.load(std::memory_order_acquire))
+    {
+        // Encoding inline on the render thread allocates; only reached
+        // when the worker could not be started.
+        alloc_guard::ScopedAllowAlloc allow;
+        Build(stamp, back_);
+        if (!back_.empty())
+            Publish(back_);
+        return;
+    }
+
+    EnterCriticalSection(&cs_);
+    request_pending_ = true;
+    request_ = stamp;
+    LeaveCriticalSection(&cs_);
+    SetEvent(wake_event_);
+}
+
+bool QrWorker::TryTake(std::vector<uint32_t>& pixels)
+{
+    if (!has_result_.load(std::memory_order_acquire))
+        return false;
+
+    EnterCriticalSection(&cs_);
+    pixels.swap(ready_);
+    has_result_.store(false, std::memory_order_release);
+    LeaveCriticalSection(&cs_);
+    return true;
+}
+
+void QrWorker::Publish(std::vector<uint32_t>& built)
+{
+    EnterCriticalSection(&cs_);
+    built.swap(ready_);
+    has_result_.store(true, std::memory_order_release);
+    LeaveCriticalSection(&cs_);
+}
+
+void QrWorker::Build(const QrStamp& stamp, std::vector<uint32_t>& out)
+{
+    trace_events::QrBuildStart(stamp.frame);
+    const std::vector<QrSegment>& args_segments = chunk_segments_[next_chunk_];
+    next_chunk_ = next_chunk_ + 1 < chunk_segments_.size() ? next_chunk_ + 1 : 0;
+    try
+    {
+        const QrCode qr = qr_worker::detail::EncodePayload(stamp, args_segments, min_version_);
+        qr_worker::detail::RasterizeQr(qr, kPixelSize, out);
+    }
+    catch (const std::exception& ex)
+    {
+        // Oversized args are chunked, so this is only an unexpectedly wide
+        // stamp or an allocation failure. Keep the previous QR on screen
+        // rather than taking the UI down.
+        const std::string what = ex.what();
+        Log(L"QrWorker: encoding failed: " + std::wstring(what.begin(), what.end()));
+        out.clear();
+    }
+    trace_events::QrBuildStop(stamp.frame, !out.empty());
+}
+
+void QrWorker::ThreadMain()
+{
+    while (running_.load(std::memory_order_acquire))
+    {
+        WaitForSingleObject(wake_event_, INFINITE);
+
+        EnterCriticalSection(&cs_);
+        const bool pending = request_pending_;
+        const QrStamp stamp = request_;
+        request_pending_ = false;
+        LeaveCriticalSection(&cs_);
+
+        if (!pending)
+            continue;
+
+        Build(stamp, back_);
+        if (!back_.empty())
+            Publish(back_);
+    }
+}
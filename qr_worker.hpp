@@ -0,0 +1,168 @@
+#pragma once
+
+#include <windows.h>
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "qrcodegen.hpp"
+
+// Values that change on every QR update. The payload is
+//   t=<unix time>;f=<fps>;n=<frame>;q=<QPC ticks>[;k=<key>;l=<us>][;args=<arg> <arg> ...]
+// where n is RenderFrame's monotonic frame counter and q the QPC time at which
+// the payload was queued (QueryPerformanceFrequency ticks per second), so a
+// reader of the video stream can measure glass-to-glass latency. With
+// --latency-probe, once a keystroke has been measured, k is its 1-based
+// WM_CHAR count and l its input-to-display latency in microseconds (see
+// input_latency.hpp).
+//
+// When stamp + args do not fit one version-40 symbol, the args are split into
+// kChunkBytes pieces and successive updates cycle through them:
+//   t=...;f=...;n=...;q=...;h=<hash>;c=<i>/<count>;args=<piece>
+// h is the FNV-1a 64 hash of the whole args text (16 hex digits), i is
+// 0-based and zero-padded to the width of count. Concatenating pieces 0..count-1
+// of one h gives the text a single code would have carried after ";args=".
+struct QrStamp
+{
+    long long unix_time = 0;
+    int fps = 0;
+    unsigned long long frame = 0;
+    long long qpc = 0;
+    uint32_t key = 0; // 0: no k/l fields
+    uint32_t key_latency_us = 0;
+};
+
+// Builds the QR code pixels on a background thread so the render thread
+// never encodes or rasterises inside BeginDraw/EndDraw.
+//
+//   Request(stamp)    - render thread: queue a payload (latest request wins).
+//   TryTake(pixels)   - render thread: swap a finished 375x375 BGRA buffer in.
+//
+// The args part never changes, so its QR segments (one set per chunk) are
+// built once in Start() and only the short stamp segment is rebuilt per
+// update. The symbol version is pinned to what the widest expected stamp
+// needs, so the module grid (and therefore the on-screen module size) stays
+// constant as counters grow and as chunks rotate.
+//
+// Buffers are swapped, not copied: the caller's previous buffer becomes the
+// worker's next scratch buffer, so steady state allocates nothing. Without a
+// running thread (Start() failed or was never called) Request() builds the
+// pixels inline, matching the old synchronous behaviour.
+class QrWorker
+{
+  public:
+    static constexpr int kPixelSize = 375;
+
+    QrWorker();
+    ~QrWorker();
+
+    QrWorker(const QrWorker&) = delete;
+    QrWorker& operator=(const QrWorker&) = delete;
+
+    // args_suffix is appended verbatim to every payload ("" or ";args=..."),
+    // or split across a chunk sequence if it is too large for one code.
+    // latency_fields pins the version for stamps that carry k and l.
+    bool Start(const std::string& args_suffix, bool latency_fields = false);
+    // Joins the worker; a request in flight is finished first. Idempotent.
+    void Stop();
+
+    void Request(const QrStamp& stamp);
+
+    bool HasResult() const
+    {
+        return has_result_.load(std::memory_order_acquire);
+    }
+
+    // Returns true and swaps the newest finished buffer into `pixels` if one
+    // arrived since the last call.
+    bool TryTake(std::vector<uint32_t>& pixels);
+
+    // Codes in the payload cycle: 1 unless the args are chunked. Fixed by
+    // Start().
+    size_t ChunkCount() const
+    {
+        return chunk_segments_.size();
+    }
+
+  private:
+    void ThreadMain();
+    void Build(const QrStamp& stamp, std::vector<uint32_t>& out);
+    void Publish(std::vector<uint32_t>& built);
+
+    CRITICAL_SECTION cs_;
+    HANDLE wake_event_ = nullptr;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> has_result_{false};
+    // Immutable while the thread runs. One entry per code in the cycle.
+    std::vector<std::vector<qrcodegen::QrSegment>> chunk_segments_;
+    int min_version_;
+
+    // Guarded by cs_.
+    bool request_pending_ = false;
+    QrStamp request_;
+    std::vector<uint32_t> ready_;
+
+    // Worker-thread only (or the caller's thread in inline mode).
+    std::vector<uint32_t> back_;
+    size_t next_chunk_ = 0;
+};
+
+// Pure helpers, exposed for unit tests.
+namespace qr_worker::detail
+{
+
+// The per-update part of the payload: "t=...;f=...;n=...;q=...", plus
+// ";k=...;l=..." when stamp.key is set.
+std::string BuildStampPayload(const QrStamp& stamp);
+
+// The fixed part of the payload: "" without arguments, otherwise ";args="
+// followed by each argument as UTF-8 and a trailing space.
+std::string BuildArgsSuffix(const std::vector<std::wstring>& args);
+
+// Bytes of args text per chunk. Keeps each chunk symbol well below version 40,
+// so modules stay large enough to survive video compression.
+constexpr size_t kChunkBytes = 1024;
+
+// 64-bit FNV-1a of `text`.
+uint64_t Fnv1a64(const std::string& text);
+
+// True if the widest expected stamp (with k and l if latency_fields)
+// followed by args_segments fits one version-40 symbol at ECC MEDIUM.
+bool FitsSingleCode(const std::vector<qrcodegen::QrSegment>& args_segments, bool latency_fields = false);
+
+// The args suffix of each code in the cycle: {args_suffix} if it fits one
+// code, otherwise ";h=...;c=.../...;args=<piece>" per kChunkBytes-sized piece
+// of the text after ";args=" (see QrStamp).
+std::vector<std::string> SplitArgsPayload(const std::string& args_suffix, bool latency_fields = false);
+
+// Byte-mode segments for `text` (none for an empty string).
+std::vector<qrcodegen::QrSegment> MakeByteSegments(const std::string& text);
+
+// Smallest version that fits the widest expected stamp (with k and l if
+// latency_fields) followed by args_segments at ECC MEDIUM; 40 if even that
+// does not fit.
+int StableMinVersion(const std::vector<qrcodegen::QrSegment>& args_segments, bool latency_fields = false);
+
+// Encodes stamp + args exactly as the worker does.
+qrcodegen::QrCode EncodePayload(const QrStamp& stamp, const std::vector<qrcodegen::QrSegment>& args_segments,
+                                int min_version);
+
+// Largest QR symbol (version 40).
+constexpr int kMaxModules = 177;
+
+// Module index covering `pixel` at `scale` pixels per module.
+int ModuleAt(int pixel, float scale);
+
+// First pixel whose module index is >= `module` (pixel_size if none).
+int ModuleEdge(int module, int pixel_size, float scale);
+
+// Scales `qr` to pixel_size x pixel_size BGRA (black modules on white),
+// reusing `pixels`' storage. Works per module: each module row is built once
+// as horizontal spans and copied down, instead of mapping every pixel.
+void RasterizeQr(const qrcodegen::QrCode& qr, int pixel_size, std::vector<uint32_t>& pixels);
+
+} // namespace qr_worker::detail
@@ -0,0 +1,320 @@
+#ifndef UNICODE
+#define UNICODE
+#define _UNICODE
+#endif
+
+#include "session_record.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#include "log_manager.hpp"
+
+namespace session_record::detail
+{
+
+SessionRecordHeader MakeHeader(int64_t created_unix_ms)
+{
+    SessionRecordHeader header{};
+    std::memcpy(header.magic, kSessionRecordMagic, sizeof(header.magic));
+    header.version = kSessionRecordVersion;
+    header.record_size = sizeof(SessionRecord);
+    header.created_unix_ms = created_unix_ms;
+    return header;
+}
+
+bool IsValidHeader(const SessionRecordHeader& header)
+{
+    return std::memcmp(header.magic, kSessionRecordMagic, sizeof(header.magic)) == 0 &&
+           header.version == kSessionRecordVersion && header.record_size == sizeof(SessionRecord);
+}
+
+bool Summarize(const uint8_t* data, size_t size, SessionSummary& summary)
+{
+    summary = SessionSummary{};
+    SessionRecordHeader header;
+    if (size < sizeof(header))
+        return false;
+    std::memcpy(&header, data, sizeof(header));
+    if (!IsValidHeader(header))
+        return false;
+
+    const size_t body = size - sizeof(header);
+    summary.records = body / sizeof(SessionRecord);
+    summary.ignored_bytes = body % sizeof(SessionRecord);
+    if (summary.records == 0)
+        return true;
+
+    double fps_sum = 0.0;
+    double p99_sum = 0.0;
+    double cpu_sum = 0.0;
+    double mic_sum = 0.0;
+    const uint8_t* cursor = data + sizeof(header);
+    for (uint64_t i = 0; i < summary.records; ++i, cursor += sizeof(SessionRecord))
+    {
+        // The view is only guaranteed byte-aligned as far as the format goes.
+        SessionRecord record;
+        std::memcpy(&record, cursor, sizeof(record));
+
+        if (i == 0)
+        {
+            summary.first_unix_ms = record.unix_ms;
+            summary.fps_min = summary.fps_max = record.fps;
+            summary.working_set_min = summary.working_set_max = record.working_set_bytes;
+        }
+        else if (record.args_hash != summary.last.args_hash)
+        {
+            ++summary.args_hash_changes;
+        }
+
+        summary.fps_min = (std::min)(summary.fps_min, record.fps);
+        summary.fps_max = (std::max)(summary.fps_max, record.fps);
+        fps_sum += record.fps;
+        p99_sum += record.interval_p99_ms;
+        summary.interval_p99_worst_ms = (std::max)(summary.interval_p99_worst_ms, record.interval_p99_ms);
+        summary.interval_max_worst_ms = (std::max)(summary.interval_max_worst_ms, record.interval_max_ms);
+        cpu_sum += record.cpu_p99_ms;
+        if (record.mic_level >= 0.f)
+        {
+            ++summary.mic_records;
+            mic_sum += record.mic_level;
+            summary.mic_level_max = (std::max)(summary.mic_level_max, record.mic_level);
+        }
+        if (record.working_set_bytes)
+        {
+            summary.working_set_min = summary.working_set_min
+                                          ? (std::min)(summary.working_set_min, record.working_set_bytes)
+                                          : record.working_set_bytes;
+            summary.working_set_max = (std::max)(summary.working_set_max, record.working_set_bytes);
+        }
+        if (record.flags & kSessionRecordManual)
+            ++summary.manual_records;
+        summary.last = record;
+    }
+
+    const double count = static_cast<double>(summary.records);
+    summary.last_unix_ms = summary.last.unix_ms;
+    summary.fps_mean = fps_sum / count;
+    summary.interval_p99_mean_ms = p99_sum / count;
+    summary.cpu_p99_mean_ms = cpu_sum / count;
+    if (summary.mic_records)
+        summary.mic_level_mean = mic_sum / static_cast<double>(summary.mic_records);
+    return true;
+}
+
+std::wstring FormatSummary(const SessionSummary& summary)
+{
+    if (summary.records == 0)
+        return L"No samples recorded yet.\n";
+
+    using ull = unsigned long long;
+    constexpr double kMiB = 1024.0 * 1024.0;
+    wchar_t line[160];
+    std::wstring text;
+    swprintf_s(line, L"Samples: %llu (%llu saved manually)\n", static_cast<ull>(summary.records),
+               static_cast<ull>(summary.manual_records));
+    text += line;
+    swprintf_s(line, L"Span: %.1f min, last at %lld\n",
+               static_cast<double>(summary.last_unix_ms - summary.first_unix_ms) / 60000.0,
+               static_cast<long long>(summary.last_unix_ms / 1000));
+    text += line;
+    swprintf_s(line, L"FPS: min %.0f / mean %.1f / max %.0f\n", summary.fps_min, summary.fps_mean, summary.fps_max);
+    text += line;
+    swprintf_s(line, L"Frame p99: mean %.2f ms, worst %.2f ms\n", summary.interval_p99_mean_ms,
+               summary.interval_p99_worst_ms);
+    text += line;
+    swprintf_s(line, L"Frame max: worst %.2f ms\n", summary.interval_max_worst_ms);
+    text += line;
+    swprintf_s(line, L"CPU p99: mean %.2f ms\n", summary.cpu_p99_mean_ms);
+    text += line;
+    if (summary.mic_records)
+        swprintf_s(line, L"Mic level: mean %.2f, max %.2f\n", summary.mic_level_mean, summary.mic_level_max);
+    else
+        swprintf_s(line, L"Mic level: no samples\n");
+    text += line;
+    if (summary.working_set_max)
+    {
+        swprintf_s(line, L"Working set: %.1f - %.1f MB\n", static_cast<double>(summary.working_set_min) / kMiB,
+                   static_cast<double>(summary.working_set_max) / kMiB);
+        text += line;
+    }
+    swprintf_s(line, L"Args hash: %016llx (%llu change(s))\n", static_cast<ull>(summary.last.args_hash),
+               static_cast<ull>(summary.args_hash_changes));
+    text += line;
+    swprintf_s(line, L"Last: frame %llu, FPS %.0f, p99 %.2f ms\n", static_cast<ull>(summary.last.frame),
+               summary.last.fps, summary.last.interval_p99_ms);
+    text += line;
+    if (summary.ignored_bytes)
+    {
+        swprintf_s(line, L"Ignored %llu trailing byte(s)\n", static_cast<ull>(summary.ignored_bytes));
+        text += line;
+    }
+    return text;
+}
+
+} // namespace session_record::detail
+
+namespace session_record
+{
+
+int64_t UnixMillisNow()
+{
+    FILETIME ft;
+    GetSystemTimeAsFileTime(&ft);
+    ULARGE_INTEGER ticks;
+    ticks.LowPart = ft.dwLowDateTime;
+    ticks.HighPart = ft.dwHighDateTime;
+    // 100 ns ticks since 1601-01-01 to milliseconds since 1970-01-01, as in
+    // the compact log format.
+    constexpr ULONGLONG kUnixEpochFileTime = 116444736000000000ULL;
+    return static_cast<int64_t>((ticks.QuadPart - kUnixEpochFileTime) / 10000ULL);
+}
+
+bool ReadSummary(const std::wstring& path, SessionSummary& summary, std::wstring& error)
+{
+    // The writer may hold the file open for appending.
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                              nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        error = L"File not found.";
+        return false;
+    }
+
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(file, &size) || size.QuadPart < static_cast<LONGLONG>(sizeof(SessionRecordHeader)))
+    {
+        CloseHandle(file);
+        error = L"Session file is empty.";
+        return false;
+    }
+    if (static_cast<unsigned long long>(size.QuadPart) > static_cast<unsigned long long>(SIZE_MAX))
+    {
+        CloseHandle(file);
+        error = L"Session file is too large to map.";
+        return false;
+    }
+
+    // The mapping covers the size seen above; records appended meanwhile are
+    // simply not part of this summary.
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mapping)
+    {
+        error = L"Error mapping session file.";
+        Log(L"Session: CreateFileMapping failed for " + path + L", error " + std::to_wstring(GetLastError()));
+        return false;
+    }
+    const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (!view)
+    {
+        error = L"Error mapping session file.";
+        Log(L"Session: MapViewOfFile failed for " + path + L", error " + std::to_wstring(GetLastError()));
+        return false;
+    }
+
+    const bool ok =
+        detail::Summarize(static_cast<const uint8_t*>(view), static_cast<size_t>(size.QuadPart), summary);
+    UnmapViewOfFile(view);
+    if (!ok)
+        error = L"Not a session file of this version.";
+    return ok;
+}
+
+} // namespace session_record
+
+SessionRecordWriter::~SessionRecordWriter()
+{
+    Close();
+}
+
+bool SessionRecordWriter::Open(const std::wstring& path)
+{
+    Close();
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_ALWAYS,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        Log(L"Session: cannot open " + path + L", error " + std::to_wstring(GetLastError()));
+        return false;
+    }
+
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(file, &size))
+    {
+        Log(L"Session: GetFileSizeEx failed for " + path);
+        CloseHandle(file);
+        return false;
+    }
+
+    DWORD io = 0;
+    if (size.QuadPart == 0)
+    {
+        const SessionRecordHeader header = session_record::detail::MakeHeader(session_record::UnixMillisNow());
+        if (!WriteFile(file, &header, sizeof(header), &io, nullptr) || io != sizeof(header))
+        {
+            Log(L"Session: cannot write header to " + path);
+            CloseHandle(file);
+            return false;
+        }
+        records_ = 0;
+    }
+    else
+    {
+        SessionRecordHeader header{};
+        if (!ReadFile(file, &header, sizeof(header), &io, nullptr) || io != sizeof(header) ||
+            !session_record::detail::IsValidHeader(header))
+        {
+            Log(L"Session: " + path + L" is not a version " + std::to_wstring(kSessionRecordVersion) +
+                L" session file; not appending");
+            CloseHandle(file);
+            return false;
+        }
+        records_ = static_cast<uint64_t>(size.QuadPart - sizeof(header)) / sizeof(SessionRecord);
+
+        // Cut a record torn by a crash so appends stay aligned.
+        LARGE_INTEGER whole;
+        whole.QuadPart = static_cast<LONGLONG>(sizeof(header) + records_ * sizeof(SessionRecord));
+        if (whole.QuadPart != size.QuadPart)
+        {
+            Log(L"Session: dropping " + std::to_wstring(size.QuadPart - whole.QuadPart) + L" torn byte(s) from " +
+                path);
+            if (!SetFilePointerEx(file, whole, nullptr, FILE_BEGIN) || !SetEndOfFile(file))
+            {
+                Log(L"Session: cannot truncate " + path);
+                CloseHandle(file);
+                return false;
+            }
+        }
+    }
+
+    LARGE_INTEGER zero{};
+    SetFilePointerEx(file, zero, nullptr, FILE_END);
+    file_ = file;
+    return true;
+}
+
+void SessionRecordWriter::Close()
+{
+    if (file_ != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(file_);
+        file_ = INVALID_HANDLE_VALUE;
+    }
+}
+
+bool SessionRecordWriter::Append(const SessionRecord& record)
+{
+    if (file_ == INVALID_HANDLE_VALUE)
+        return false;
+    DWORD written = 0;
+    if (!WriteFile(file_, &record, sizeof(record), &written, nullptr) || written != sizeof(record))
+    {
+        Log(L"Session: append failed, error " + std::to_wstring(GetLastError()));
+        return false;
+    }
+    ++records_;
+    return true;
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <windows.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+// Append-only binary session log behind "save" / "read" and
+// --record-interval. A session file is one SessionRecordHeader followed by
+// fixed-size SessionRecords, all little-endian:
+//
+//   offset 0   header  (32 bytes)
+//   offset 32  record 0 (64 bytes)
+//   offset 96  record 1 ...
+//
+// Each sample is a single WriteFile at the end of the file, so sampling cost
+// does not grow with the file and nothing already written is rewritten. A
+// record cut short by a crash is dropped the next time a writer opens the
+// file and ignored by readers. Readers map the file and summarize it in one
+// pass; thousands of records take well under a millisecond.
+
+constexpr char kSessionRecordMagic[8] = {'C', 'S', 'A', 'D', 'R', 'E', 'C', '1'};
+constexpr uint32_t kSessionRecordVersion = 1;
+
+enum SessionRecordFlags : uint32_t
+{
+    kSessionRecordManual = 0x1,   // written by the "save" command
+    kSessionRecordLowPower = 0x2, // --render-mode=low-power
+};
+
+struct SessionRecordHeader
+{
+    char magic[8]; // kSessionRecordMagic
+    uint32_t version;
+    uint32_t record_size; // sizeof(SessionRecord)
+    int64_t created_unix_ms;
+    uint64_t reserved;
+};
+
+struct SessionRecord
+{
+    int64_t unix_ms;            // wall clock when sampled
+    uint64_t frame;             // RenderFrame counter (the QR n= value)
+    uint64_t args_hash;         // FNV-1a 64 of the args text (the QR h= value)
+    uint64_t working_set_bytes; // GetProcessMemoryInfo; 0 if unavailable
+    float fps;                  // QR-synced FPS
+    float interval_p50_ms;      // frame interval over FrameStats::kWindow
+    float interval_p99_ms;
+    float interval_max_ms;
+    float cpu_p99_ms;           // RenderFrame CPU time
+    float mic_level;            // smoothed peak in [0, 1]; negative without a microphone
+    uint32_t flags;             // SessionRecordFlags
+    uint32_t reserved;
+};
+
+static_assert(sizeof(SessionRecordHeader) == 32 && std::is_trivially_copyable_v<SessionRecordHeader>);
+static_assert(sizeof(SessionRecord) == 64 && std::is_trivially_copyable_v<SessionRecord>);
+
+// File name inside the data folder (%APPDATA%\CloudStreamingArgsDebugger).
+constexpr const wchar_t* kSessionRecordFileName = L"session.rec";
+
+class SessionRecordWriter
+{
+  public:
+    SessionRecordWriter() = default;
+    ~SessionRecordWriter();
+
+    SessionRecordWriter(const SessionRecordWriter&) = delete;
+    SessionRecordWriter& operator=(const SessionRecordWriter&) = delete;
+
+    // Opens `path` for appending, creating it with a header if it is new or
+    // empty and dropping a torn trailing record. Fails (and logs) if the file
+    // is not a session file of this version.
+    bool Open(const std::wstring& path);
+    void Close();
+
+    bool IsOpen() const
+    {
+        return file_ != INVALID_HANDLE_VALUE;
+    }
+
+    bool Append(const SessionRecord& record);
+
+    // Records in the file, including those written before Open().
+    uint64_t RecordCount() const
+    {
+        return records_;
+    }
+
+  private:
+    HANDLE file_ = INVALID_HANDLE_VALUE;
+    uint64_t records_ = 0;
+};
+
+// One pass over a session file.
+struct SessionSummary
+{
+    uint64_t records = 0;
+    uint64_t manual_records = 0;
+    uint64_t ignored_bytes = 0; // torn trailing record
+    int64_t first_unix_ms = 0;
+    int64_t last_unix_ms = 0;
+    float fps_min = 0.f;
+    float fps_max = 0.f;
+    double fps_mean = 0.0;
+    double interval_p99_mean_ms = 0.0;
+    float interval_p99_worst_ms = 0.f;
+    float interval_max_worst_ms = 0.f;
+    double cpu_p99_mean_ms = 0.0;
+    uint64_t mic_records = 0; // records with a microphone level
+    double mic_level_mean = 0.0;
+    float mic_level_max = 0.f;
+    uint64_t working_set_min = 0;
+    uint64_t working_set_max = 0;
+    uint64_t args_hash_changes = 0; // records whose args_hash differs from the previous one
+    SessionRecord last{};
+};
+
+namespace session_record
+{
+
+// Maps `path` read-only and summarizes it. On failure returns false and sets
+// `error` to a short message for the status line.
+bool ReadSummary(const std::wstring& path, SessionSummary& summary, std::wstring& error);
+
+// Current wall clock in Unix milliseconds.
+int64_t UnixMillisNow();
+
+} // namespace session_record
+
+// Pure helpers, exposed for unit tests.
+namespace session_record::detail
+{
+
+SessionRecordHeader MakeHeader(int64_t created_unix_ms);
+bool IsValidHeader(const SessionRecordHeader& header);
+
+// Summarizes a whole file image (header and records). False if `size` is
+// too small for a header or the header is not valid.
+bool Summarize(const uint8_t* data, size_t size, SessionSummary& summary);
+
+// Multi-line text for the loaded-data panel.
+std::wstring FormatSummary(const SessionSummary& summary);
+
+} // namespace session_record::detail
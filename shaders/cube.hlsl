@@ -0,0 +1,33 @@
+// Spinning cube: per-vertex colour, no lighting. Compiled at build time by
+// fxc into cube_vs.h (VSMain, vs_4_0) and cube_ps.h (PSMain, ps_4_0); see the
+// top-level CMakeLists.txt.
+
+cbuffer ConstantBuffer : register(b0)
+{
+    matrix WorldViewProjection;
+};
+
+struct VS_INPUT
+{
+    float3 Pos : POSITION;
+    float3 Color : COLOR;
+};
+
+struct PS_INPUT
+{
+    float4 Pos : SV_POSITION;
+    float3 Color : COLOR;
+};
+
+PS_INPUT VSMain(VS_INPUT input)
+{
+    PS_INPUT output;
+    output.Pos = mul(float4(input.Pos, 1.0f), WorldViewProjection);
+    output.Color = input.Color;
+    return output;
+}
+
+float4 PSMain(PS_INPUT input) : SV_Target
+{
+    return float4(input.Color, 1.0f);
+}
@@ -0,0 +1,43 @@
+// GPU HUD (--hud=gpu): solid rectangles from a structured buffer, one
+// instance per HudQuad (hud_batch.hpp), four strip vertices each, with no
+// vertex or index buffers. Compiled at build time by fxc into hud_vs.h
+// (HudVS, vs_5_0) and hud_ps.h (HudPS, ps_5_0); see the top-level
+// CMakeLists.txt. Structured buffers need feature level 11_0.
+
+struct HudQuad
+{
+    float4 Rect; // left, top, right, bottom in render-target pixels
+    float4 Color;
+};
+
+StructuredBuffer<HudQuad> Quads : register(t0);
+
+cbuffer HudConstants : register(b0)
+{
+    float2 InvViewportSize;
+    float2 Unused;
+};
+
+struct PS_INPUT
+{
+    float4 Pos : SV_POSITION;
+    float4 Color : COLOR;
+};
+
+PS_INPUT HudVS(uint vertex : SV_VertexID, uint instance : SV_InstanceID)
+{
+    HudQuad quad = Quads[instance];
+    // Strip order: top-left, top-right, bottom-left, bottom-right.
+    float2 pixel = float2((vertex & 1) ? quad.Rect.z : quad.Rect.x, (vertex & 2) ? quad.Rect.w : quad.Rect.y);
+    float2 ndc = pixel * InvViewportSize * float2(2.0f, -2.0f) + float2(-1.0f, 1.0f);
+
+    PS_INPUT output;
+    output.Pos = float4(ndc, 0.0f, 1.0f);
+    output.Color = quad.Color;
+    return output;
+}
+
+float4 HudPS(PS_INPUT input) : SV_Target
+{
+    return input.Color;
+}
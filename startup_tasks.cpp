@@ -0,0 +1,93 @@
+#ifndef UNICODE
+#define UNICODE
+#define _UNICODE
+#endif
+
+#include "startup_tasks.hpp"
+
+#include <objbase.h>
+
+#include <cstring>
+#include <system_error>
+
+#include "frame_pacer.hpp"
+#include "log_manager.hpp"
+
+StartupTasks::~StartupTasks()
+{
+    WaitAll();
+}
+
+void StartupTasks::Execute(Task& task)
+{
+    const HRESULT com = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+    const LONGLONG start = FramePacer::Now();
+    try
+    {
+        task.fn();
+    }
+    catch (const std::exception& ex)
+    {
+        task.error = std::current_exception();
+        Log(L"Startup: " + task.name + L" failed: " + std::wstring(ex.what(), ex.what() + strlen(ex.what())));
+    }
+    catch (...)
+    {
+        task.error = std::current_exception();
+        Log(L"Startup: " + task.name + L" failed with an unknown exception");
+    }
+    task.duration_ms = FramePacer::TicksToSeconds(FramePacer::Now() - start) * 1000.0;
+    if (SUCCEEDED(com))
+        CoUninitialize();
+
+    Log(L"Startup: " + task.name + L" done in " + std::to_wstring(static_cast<int>(task.duration_ms + 0.5)) + L" ms");
+    // Publishes fn's writes, error and duration to IsDone()'s acquire load.
+    task.done.store(true, std::memory_order_release);
+}
+
+StartupTasks::TaskId StartupTasks::Start(const wchar_t* name, std::function<void()> fn)
+{
+    auto task = std::make_unique<Task>();
+    task->name = name;
+    task->fn = std::move(fn);
+    Task& ref = *task;
+    tasks_.push_back(std::move(task));
+
+    try
+    {
+        ref.thread = std::thread([&ref] { Execute(ref); });
+    }
+    catch (const std::system_error&)
+    {
+        Log(L"Startup: no thread for " + ref.name + L", running inline");
+        Execute(ref);
+    }
+    return tasks_.size() - 1;
+}
+
+bool StartupTasks::IsDone(TaskId id) const
+{
+    return id < tasks_.size() && tasks_[id]->done.load(std::memory_order_acquire);
+}
+
+void StartupTasks::Wait(TaskId id)
+{
+    if (id < tasks_.size() && tasks_[id]->thread.joinable())
+        tasks_[id]->thread.join();
+}
+
+void StartupTasks::WaitAll()
+{
+    for (TaskId id = 0; id < tasks_.size(); ++id)
+        Wait(id);
+}
+
+std::exception_ptr StartupTasks::Error(TaskId id) const
+{
+    return IsDone(id) ? tasks_[id]->error : nullptr;
+}
+
+double StartupTasks::DurationMs(TaskId id) const
+{
+    return IsDone(id) ? tasks_[id]->duration_ms : 0.0;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <windows.h>
+
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Runs independent startup work on background threads so the render thread
+// can create the swap chain and present while slow subsystems (WASAPI
+// activation on virtual audio drivers, DirectWrite font setup, path queries)
+// come up in parallel.
+//
+//   Start(name, fn) - owner thread: run fn on a new thread right away.
+//   IsDone(id)      - owner thread: non-blocking; true once fn has returned
+//                     or thrown. Everything fn wrote is visible afterwards.
+//   Wait(id)        - owner thread: block until fn has finished.
+//   Error(id)       - what fn threw, once done (null if it returned).
+//
+// Each task thread runs in the multithreaded COM apartment, so fn may create
+// COM objects directly. Results are handed over through state fn writes and
+// the owner reads only after IsDone()/Wait(); the owner must not touch that
+// state before then. The destructor waits for every task.
+class StartupTasks
+{
+  public:
+    using TaskId = size_t;
+
+    StartupTasks() = default;
+    ~StartupTasks();
+
+    StartupTasks(const StartupTasks&) = delete;
+    StartupTasks& operator=(const StartupTasks&) = delete;
+
+    // Returns an id for the other calls. If the thread cannot be created, fn
+    // runs inline on the calling thread instead.
+    TaskId Start(const wchar_t* name, std::function<void()> fn);
+
+    bool IsDone(TaskId id) const;
+    void Wait(TaskId id);
+    void WaitAll();
+    std::exception_ptr Error(TaskId id) const;
+
+    // Wall time fn took, in milliseconds; 0 until done.
+    double DurationMs(TaskId id) const;
+
+    size_t Count() const
+    {
+        return tasks_.size();
+    }
+
+  private:
+    struct Task
+    {
+        std::wstring name;
+        std::function<void()> fn;
+        std::thread thread;
+        std::exception_ptr error;
+        double duration_ms = 0.0;
+        std::atomic<bool> done{false};
+    };
+
+    static void Execute(Task& task);
+
+    // Stable addresses: task threads hold a Task& while tasks_ grows.
+    std::vector<std::unique_ptr<Task>> tasks_;
+};
@@ -0,0 +1,482 @@
+// Density-scaling stress driver: launches N copies of the debugger side by
+// side, samples every instance's live-metrics segment (metrics_export.hpp)
+// and reports how per-instance throughput and frame-time tails degrade as N
+// grows. Run it once per build to get a curve of sessions per GPU node.
+//
+//   stress_driver [--exe=<path>] [--counts=1,2,4,8] [--warmup=<s>]
+//                 [--duration=<s>] [--args=<n>] [--csv=<path>] [-- <args>]
+//
+// Each step launches its instances, waits --warmup seconds, then measures
+// for --duration seconds and closes them again. Arguments after "--" are
+// passed to every instance (e.g. "-- --render-mode=low-power"). Instances
+// run in a kill-on-close job, so none outlive the driver.
+
+#ifndef UNICODE
+#define UNICODE
+#define _UNICODE
+#endif
+
+#include <windows.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../metrics_export.hpp"
+
+namespace
+{
+
+struct StressOptions
+{
+    std::wstring exe;
+    std::vector<unsigned> counts = {1, 2, 4, 8};
+    unsigned warmup_s = 5;
+    unsigned duration_s = 15;
+    unsigned generated_args = 8;
+    std::wstring csv;
+    std::vector<std::wstring> passthrough;
+};
+
+// One read of everything the report needs from an instance.
+struct Sample
+{
+    bool valid = false;
+    LONGLONG qpc = 0;
+    MetricsFrameSection frame{};
+    MetricsAudioSection audio{};
+    uint64_t process_cpu_100ns = 0;
+};
+
+struct Instance
+{
+    PROCESS_INFORMATION process{};
+    std::wstring metrics_name;
+    HANDLE mapping = nullptr;
+    const MetricsBlock* block = nullptr;
+    Sample begin;
+    Sample end;
+};
+
+// Per-step aggregate; one row of the report.
+struct StepResult
+{
+    unsigned instances = 0;
+    unsigned measured = 0;
+    double mean_fps = 0.0;
+    double min_fps = 0.0;
+    double total_fps = 0.0;
+    double mean_p50_ms = 0.0;
+    double mean_p99_ms = 0.0;
+    double worst_max_ms = 0.0;
+    double mean_cpu_p99_ms = 0.0;
+    double mean_process_cpu_pct = 0.0; // of one core
+    double mean_audio_cpu_pct = 0.0;   // capture thread, of one core
+    unsigned audio_instances = 0;      // instances whose capture ran
+    double mean_working_set_mb = 0.0;
+};
+
+bool ParseUnsignedArg(const std::wstring& text, unsigned& out)
+{
+    if (text.empty() || text.size() > 9 || text.find_first_not_of(L"0123456789") != std::wstring::npos)
+        return false;
+    out = static_cast<unsigned>(std::wcstoul(text.c_str(), nullptr, 10));
+    return true;
+}
+
+bool ParseCounts(const std::wstring& text, std::vector<unsigned>& out)
+{
+    std::vector<unsigned> counts;
+    size_t begin = 0;
+    while (begin <= text.size())
+    {
+        const size_t comma = (std::min)(text.find(L',', begin), text.size());
+        unsigned n = 0;
+        if (!ParseUnsignedArg(text.substr(begin, comma - begin), n) || n == 0)
+            return false;
+        counts.push_back(n);
+        begin = comma + 1;
+    }
+    out = counts;
+    return true;
+}
+
+std::wstring DefaultExePath()
+{
+    wchar_t path[MAX_PATH] = {};
+    GetModuleFileNameW(nullptr, path, MAX_PATH);
+    std::wstring dir = path;
+    dir.resize(dir.find_last_of(L"\\/") + 1);
+    // build/stress/stress_driver.exe next to build/cloud-streaming-args-debugger.exe
+    return dir + L"..\\cloud-streaming-args-debugger.exe";
+}
+
+bool ParseOptions(int argc, wchar_t** argv, StressOptions& options)
+{
+    options.exe = DefaultExePath();
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::wstring arg = argv[i];
+        auto value = [&](const wchar_t* prefix, std::wstring& out)
+        {
+            const size_t len = wcslen(prefix);
+            if (arg.compare(0, len, prefix) != 0)
+                return false;
+            out = arg.substr(len);
+            return true;
+        };
+
+        std::wstring text;
+        if (arg == L"--")
+        {
+            options.passthrough.assign(argv + i + 1, argv + argc);
+            break;
+        }
+        if (value(L"--exe=", options.exe) || value(L"--csv=", options.csv))
+            continue;
+        if (value(L"--counts=", text) && ParseCounts(text, options.counts))
+            continue;
+        if (value(L"--warmup=", text) && ParseUnsignedArg(text, options.warmup_s))
+            continue;
+        if (value(L"--duration=", text) && ParseUnsignedArg(text, options.duration_s) && options.duration_s > 0)
+            continue;
+        if (value(L"--args=", text) && ParseUnsignedArg(text, options.generated_args))
+            continue;
+        fwprintf(stderr, L"stress_driver: unrecognised or malformed option %ls\n", arg.c_str());
+        return false;
+    }
+    return true;
+}
+
+// Argument sets shaped like a streaming launcher's: a few fixed session
+// parameters, then filler flags of growing length so instances do not all
+// format identical HUD text and QR payloads.
+std::vector<std::wstring> GenerateArgs(unsigned instance, unsigned count)
+{
+    static const wchar_t* const kFixed[] = {L"--width=1920", L"--height=1080", L"--fps=60", L"--codec=h264"};
+    std::vector<std::wstring> args;
+    args.push_back(L"--session-id=stress-" + std::to_wstring(instance));
+    for (unsigned i = 0; args.size() < count; ++i)
+    {
+        if (i < _countof(kFixed))
+            args.push_back(kFixed[i]);
+        else
+            args.push_back(L"--opt" + std::to_wstring(i) + L"=" + std::wstring(4 + (instance + i) % 24, L'x'));
+    }
+    return args;
+}
+
+// CommandLineToArgvW quoting: backslashes are literal unless they precede
+// a quote.
+void AppendQuoted(std::wstring& command_line, const std::wstring& arg)
+{
+    if (!command_line.empty())
+        command_line += L' ';
+    if (!arg.empty() && arg.find_first_of(L" \t\"") == std::wstring::npos)
+    {
+        command_line += arg;
+        return;
+    }
+    command_line += L'"';
+    size_t backslashes = 0;
+    for (wchar_t c : arg)
+    {
+        if (c == L'\\')
+        {
+            ++backslashes;
+            continue;
+        }
+        command_line.append(c == L'"' ? backslashes * 2 + 1 : backslashes, L'\\');
+        backslashes = 0;
+        command_line += c;
+    }
+    command_line.append(backslashes * 2, L'\\');
+    command_line += L'"';
+}
+
+bool Launch(const StressOptions& options, HANDLE job, unsigned index, Instance& instance)
+{
+    instance.metrics_name = L"Local\\CloudStreamingArgsDebugger.Stress." + std::to_wstring(GetCurrentProcessId()) +
+                            L"." + std::to_wstring(index);
+
+    std::wstring command_line;
+    AppendQuoted(command_line, options.exe);
+    AppendQuoted(command_line, L"--metrics-name=" + instance.metrics_name);
+    for (const auto& arg : GenerateArgs(index, options.generated_args))
+        AppendQuoted(command_line, arg);
+    for (const auto& arg : options.passthrough)
+        AppendQuoted(command_line, arg);
+
+    STARTUPINFOW startup{};
+    startup.cb = sizeof(startup);
+    // Suspended until it is in the job, so no child escapes it.
+    if (!CreateProcessW(options.exe.c_str(), command_line.data(), nullptr, nullptr, FALSE, CREATE_SUSPENDED, nullptr,
+                        nullptr, &startup, &instance.process))
+    {
+        fwprintf(stderr, L"stress_driver: CreateProcessW failed for %ls, error=%lu\n", options.exe.c_str(),
+                 GetLastError());
+        return false;
+    }
+    AssignProcessToJobObject(job, instance.process.hProcess);
+    ResumeThread(instance.process.hThread);
+    return true;
+}
+
+bool IsRunning(const Instance& instance)
+{
+    return WaitForSingleObject(instance.process.hProcess, 0) == WAIT_TIMEOUT;
+}
+
+// The segment appears once the instance has initialised its window.
+bool OpenMetrics(Instance& instance)
+{
+    if (instance.block)
+        return true;
+    instance.mapping = OpenFileMappingW(FILE_MAP_READ, FALSE, instance.metrics_name.c_str());
+    if (!instance.mapping)
+        return false;
+    instance.block = static_cast<const MetricsBlock*>(MapViewOfFile(instance.mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!instance.block || instance.block->magic.load(std::memory_order_acquire) != kMetricsMagic ||
+        instance.block->version != kMetricsVersion || instance.block->size < sizeof(MetricsBlock))
+    {
+        if (instance.block)
+            UnmapViewOfFile(instance.block);
+        CloseHandle(instance.mapping);
+        instance.block = nullptr;
+        instance.mapping = nullptr;
+        return false;
+    }
+    return true;
+}
+
+template <typename T> T ReadSection(const std::atomic<uint32_t>& sequence, const T& src)
+{
+    T out{};
+    while (!metrics_export::detail::SeqlockRead(sequence, src, out))
+        std::this_thread::yield();
+    return out;
+}
+
+Sample TakeSample(const Instance& instance)
+{
+    Sample sample;
+    if (!instance.block || !IsRunning(instance))
+        return sample;
+    LARGE_INTEGER now{};
+    QueryPerformanceCounter(&now);
+    sample.qpc = now.QuadPart;
+    sample.frame = ReadSection(instance.block->frame_sequence, instance.block->frame);
+    sample.audio = ReadSection(instance.block->audio_sequence, instance.block->audio);
+
+    FILETIME created{}, exited{}, kernel{}, user{};
+    if (GetProcessTimes(instance.process.hProcess, &created, &exited, &kernel, &user))
+    {
+        const auto ticks = [](const FILETIME& t) { return (uint64_t{t.dwHighDateTime} << 32) | t.dwLowDateTime; };
+        sample.process_cpu_100ns = ticks(kernel) + ticks(user);
+    }
+    sample.valid = true;
+    return sample;
+}
+
+BOOL CALLBACK CloseWindowsOfProcess(HWND hwnd, LPARAM param)
+{
+    DWORD pid = 0;
+    GetWindowThreadProcessId(hwnd, &pid);
+    if (pid == static_cast<DWORD>(param))
+        PostMessageW(hwnd, WM_CLOSE, 0, 0);
+    return TRUE;
+}
+
+// WM_CLOSE first so instances shut down (and flush their logs) normally;
+// anything still running after the grace period is terminated.
+void StopInstances(std::vector<Instance>& instances)
+{
+    for (const auto& instance : instances)
+        EnumWindows(CloseWindowsOfProcess, static_cast<LPARAM>(instance.process.dwProcessId));
+
+    const ULONGLONG deadline = GetTickCount64() + 10000;
+    for (auto& instance : instances)
+    {
+        const ULONGLONG now = GetTickCount64();
+        const DWORD wait = now < deadline ? static_cast<DWORD>(deadline - now) : 0;
+        if (WaitForSingleObject(instance.process.hProcess, wait) != WAIT_OBJECT_0)
+            TerminateProcess(instance.process.hProcess, 1);
+        if (instance.block)
+            UnmapViewOfFile(instance.block);
+        if (instance.mapping)
+            CloseHandle(instance.mapping);
+        CloseHandle(instance.process.hThread);
+        CloseHandle(instance.process.hProcess);
+    }
+    instances.clear();
+}
+
+StepResult Summarize(const std::vector<Instance>& instances, LONGLONG qpc_frequency)
+{
+    StepResult result;
+    result.instances = static_cast<unsigned>(instances.size());
+    result.min_fps = 1e9;
+    double audio_cpu_sum = 0.0;
+    for (const auto& instance : instances)
+    {
+        const Sample& a = instance.begin;
+        const Sample& b = instance.end;
+        if (!a.valid || !b.valid || b.qpc <= a.qpc)
+            continue;
+        const double seconds = static_cast<double>(b.qpc - a.qpc) / static_cast<double>(qpc_frequency);
+        const double fps = static_cast<double>(b.frame.frame_counter - a.frame.frame_counter) / seconds;
+        ++result.measured;
+        result.total_fps += fps;
+        result.min_fps = (std::min)(result.min_fps, fps);
+        result.mean_p50_ms += b.frame.interval.p50_ms;
+        result.mean_p99_ms += b.frame.interval.p99_ms;
+        result.worst_max_ms = (std::max)(result.worst_max_ms, static_cast<double>(b.frame.interval.max_ms));
+        result.mean_cpu_p99_ms += b.frame.cpu.p99_ms;
+        result.mean_process_cpu_pct +=
+            static_cast<double>(b.process_cpu_100ns - a.process_cpu_100ns) / (seconds * 1e7) * 100.0;
+        result.mean_working_set_mb += static_cast<double>(b.frame.working_set_bytes) / (1024.0 * 1024.0);
+        // No microphone (or the capture thread failed): nothing to attribute.
+        if (b.audio.packets > a.audio.packets && b.audio.thread_cpu_100ns >= a.audio.thread_cpu_100ns)
+        {
+            ++result.audio_instances;
+            audio_cpu_sum +=
+                static_cast<double>(b.audio.thread_cpu_100ns - a.audio.thread_cpu_100ns) / (seconds * 1e7) * 100.0;
+        }
+    }
+    if (result.measured == 0)
+    {
+        result.min_fps = 0.0;
+        return result;
+    }
+    const double n = result.measured;
+    result.mean_fps = result.total_fps / n;
+    result.mean_p50_ms /= n;
+    result.mean_p99_ms /= n;
+    result.mean_cpu_p99_ms /= n;
+    result.mean_process_cpu_pct /= n;
+    result.mean_working_set_mb /= n;
+    if (result.audio_instances > 0)
+        result.mean_audio_cpu_pct = audio_cpu_sum / result.audio_instances;
+    return result;
+}
+
+StepResult RunStep(const StressOptions& options, HANDLE job, unsigned count, LONGLONG qpc_frequency)
+{
+    std::vector<Instance> instances(count);
+    for (unsigned i = 0; i < count; ++i)
+    {
+        if (!Launch(options, job, i, instances[i]))
+        {
+            instances.resize(i);
+            break;
+        }
+    }
+
+    Sleep(options.warmup_s * 1000);
+    // Slow starts (first launch, cold shader cache) get up to 30 s more.
+    const ULONGLONG deadline = GetTickCount64() + 30000;
+    for (auto& instance : instances)
+    {
+        while (IsRunning(instance) && !OpenMetrics(instance) && GetTickCount64() < deadline)
+            Sleep(100);
+        if (!instance.block)
+            fwprintf(stderr, L"stress_driver: no metrics from pid %lu\n", instance.process.dwProcessId);
+    }
+
+    for (auto& instance : instances)
+        instance.begin = TakeSample(instance);
+    Sleep(options.duration_s * 1000);
+    for (auto& instance : instances)
+        instance.end = TakeSample(instance);
+
+    StepResult result = Summarize(instances, qpc_frequency);
+    result.instances = count;
+    StopInstances(instances);
+    return result;
+}
+
+void PrintHeader()
+{
+    std::printf("%5s %5s %9s %9s %9s %8s %8s %8s %8s %8s %8s %8s %8s\n", "N", "alive", "fps/inst", "min fps",
+                "total", "vs N0", "p50 ms", "p99 ms", "max ms", "cpu p99", "proc %", "audio %", "WS MB");
+}
+
+void PrintRow(const StepResult& r, double baseline_fps)
+{
+    const double relative = baseline_fps > 0.0 ? r.mean_fps / baseline_fps * 100.0 : 0.0;
+    std::printf("%5u %5u %9.1f %9.1f %9.1f %7.1f%% %8.2f %8.2f %8.2f %8.2f %8.1f %8.2f %8.1f\n", r.instances,
+                r.measured, r.mean_fps, r.min_fps, r.total_fps, relative, r.mean_p50_ms, r.mean_p99_ms,
+                r.worst_max_ms, r.mean_cpu_p99_ms, r.mean_process_cpu_pct, r.mean_audio_cpu_pct,
+                r.mean_working_set_mb);
+    std::fflush(stdout);
+}
+
+bool WriteCsv(const std::wstring& path, const std::vector<StepResult>& results)
+{
+    FILE* file = nullptr;
+    if (_wfopen_s(&file, path.c_str(), L"wb") != 0 || !file)
+        return false;
+    std::fprintf(file, "instances,measured,mean_fps,min_fps,total_fps,mean_interval_p50_ms,mean_interval_p99_ms,"
+                       "worst_interval_max_ms,mean_cpu_p99_ms,mean_process_cpu_pct,mean_audio_cpu_pct,"
+                       "audio_instances,mean_working_set_mb\n");
+    for (const auto& r : results)
+    {
+        std::fprintf(file, "%u,%u,%.2f,%.2f,%.2f,%.3f,%.3f,%.3f,%.3f,%.2f,%.3f,%u,%.1f\n", r.instances, r.measured,
+                     r.mean_fps, r.min_fps, r.total_fps, r.mean_p50_ms, r.mean_p99_ms, r.worst_max_ms,
+                     r.mean_cpu_p99_ms, r.mean_process_cpu_pct, r.mean_audio_cpu_pct, r.audio_instances,
+                     r.mean_working_set_mb);
+    }
+    const bool ok = std::ferror(file) == 0;
+    return std::fclose(file) == 0 && ok;
+}
+
+} // namespace
+
+int wmain(int argc, wchar_t** argv)
+{
+    StressOptions options;
+    if (!ParseOptions(argc, argv, options))
+        return 2;
+    if (GetFileAttributesW(options.exe.c_str()) == INVALID_FILE_ATTRIBUTES)
+    {
+        fwprintf(stderr, L"stress_driver: %ls not found (pass --exe=<path>)\n", options.exe.c_str());
+        return 2;
+    }
+
+    HANDLE job = CreateJobObjectW(nullptr, nullptr);
+    if (!job)
+        return 1;
+    JOBOBJECT_EXTENDED_LIMIT_INFORMATION limits{};
+    limits.BasicLimitInformation.LimitFlags = JOB_OBJECT_LIMIT_KILL_ON_JOB_CLOSE;
+    SetInformationJobObject(job, JobObjectExtendedLimitInformation, &limits, sizeof(limits));
+
+    LARGE_INTEGER frequency{};
+    QueryPerformanceFrequency(&frequency);
+
+    std::printf("stress: %zu step(s), warmup %us, measure %us, %u generated args per instance\n",
+                options.counts.size(), options.warmup_s, options.duration_s, options.generated_args);
+    PrintHeader();
+    std::vector<StepResult> results;
+    for (unsigned count : options.counts)
+    {
+        results.push_back(RunStep(options, job, count, frequency.QuadPart));
+        PrintRow(results.back(), results.front().mean_fps);
+    }
+    CloseHandle(job);
+
+    if (!options.csv.empty() && !WriteCsv(options.csv, results))
+    {
+        fwprintf(stderr, L"stress_driver: could not write %ls\n", options.csv.c_str());
+        return 1;
+    }
+    // Non-zero if any step lost an instance, so CI notices crashes under load.
+    for (const auto& r : results)
+    {
+        if (r.measured != r.instances)
+            return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,76 @@
+// Unit tests for alloc_guard: allocations inside a ScopedNoAlloc are counted
+// on the allocating thread only, ScopedAllowAlloc regions are exempt, and
+// nothing is counted outside a scope. The hook exists only in debug builds;
+// release builds skip these tests.
+
+#include <windows.h>
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "../alloc_guard.hpp"
+
+namespace
+{
+
+// Long enough to defeat the small-string buffer.
+std::wstring MakeHeapString()
+{
+    return std::wstring(256, L'x');
+}
+
+class AllocGuardTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        alloc_guard::Install();
+        if (!alloc_guard::Enabled())
+            GTEST_SKIP() << "CRT allocation hook is only available in debug builds";
+    }
+};
+
+} // namespace
+
+TEST_F(AllocGuardTest, CountsAllocationsInsideScope)
+{
+    alloc_guard::ScopedNoAlloc guard(false);
+    const std::wstring text = MakeHeapString();
+    EXPECT_GE(guard.Count(), 1u);
+}
+
+TEST_F(AllocGuardTest, AllowedRegionIsNotCounted)
+{
+    alloc_guard::ScopedNoAlloc guard(false);
+    {
+        alloc_guard::ScopedAllowAlloc allow;
+        const std::wstring text = MakeHeapString();
+    }
+    EXPECT_EQ(guard.Count(), 0u);
+}
+
+TEST_F(AllocGuardTest, OtherThreadsAreNotCounted)
+{
+    alloc_guard::ScopedNoAlloc guard(false);
+    std::unique_ptr<std::thread> worker;
+    {
+        // Creating the thread object allocates on this thread.
+        alloc_guard::ScopedAllowAlloc allow;
+        worker = std::make_unique<std::thread>([] { const std::wstring text = MakeHeapString(); });
+        worker->join();
+    }
+    EXPECT_EQ(guard.Count(), 0u);
+}
+
+TEST_F(AllocGuardTest, NothingCountedAfterScopeEnds)
+{
+    const uint64_t before = alloc_guard::TotalCount();
+    {
+        alloc_guard::ScopedNoAlloc guard(false);
+    }
+    const std::wstring text = MakeHeapString();
+    EXPECT_EQ(alloc_guard::TotalCount(), before);
+}
@@ -0,0 +1,173 @@
+// Unit tests for ParseAppOptions. Pure string handling — no window, device
+// or logger required.
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../app_options.hpp"
+
+TEST(AppOptions, DefaultsWhenNoSwitchesPresent)
+{
+    const AppOptions options = ParseAppOptions({L"game.exe", L"-windowed", L"--port=1234"});
+    EXPECT_FALSE(options.async_log);
+}
+
+TEST(AppOptions, AsyncLogSwitchIsRecognised)
+{
+    EXPECT_TRUE(ParseAppOptions({L"--async-log"}).async_log);
+}
+
+TEST(AppOptions, SwitchesAreCaseInsensitive)
+{
+    EXPECT_TRUE(ParseAppOptions({L"--ASYNC-LOG"}).async_log);
+}
+
+TEST(AppOptions, SwitchMustMatchWholeArgument)
+{
+    EXPECT_FALSE(ParseAppOptions({L"--async-logging"}).async_log);
+    EXPECT_FALSE(ParseAppOptions({L"x--async-log"}).async_log);
+}
+
+TEST(AppOptions, FpsDefaultsToSixty)
+{
+    EXPECT_EQ(ParseAppOptions({}).target_fps, 60u);
+}
+
+TEST(AppOptions, FpsAcceptsNumericTargets)
+{
+    EXPECT_EQ(ParseAppOptions({L"--fps=120"}).target_fps, 120u);
+    EXPECT_EQ(ParseAppOptions({L"--fps=144"}).target_fps, 144u);
+}
+
+TEST(AppOptions, FpsUnlimitedAndZeroDisablePacing)
+{
+    EXPECT_EQ(ParseAppOptions({L"--fps=unlimited"}).target_fps, 0u);
+    EXPECT_EQ(ParseAppOptions({L"--fps=0"}).target_fps, 0u);
+}
+
+TEST(AppOptions, MalformedFpsKeepsDefault)
+{
+    EXPECT_EQ(ParseAppOptions({L"--fps="}).target_fps, 60u);
+    EXPECT_EQ(ParseAppOptions({L"--fps=abc"}).target_fps, 60u);
+    EXPECT_EQ(ParseAppOptions({L"--fps=-5"}).target_fps, 60u);
+    EXPECT_EQ(ParseAppOptions({L"--fps=99999"}).target_fps, 60u);
+}
+
+TEST(AppOptions, PresentModelDefaultsToBlt)
+{
+    EXPECT_EQ(ParseAppOptions({}).present_model, PresentModel::Blt);
+}
+
+TEST(AppOptions, PresentModelSelectable)
+{
+    EXPECT_EQ(ParseAppOptions({L"--present=flip"}).present_model, PresentModel::Flip);
+    EXPECT_EQ(ParseAppOptions({L"--present=FLIP"}).present_model, PresentModel::Flip);
+    EXPECT_EQ(ParseAppOptions({L"--present=flip", L"--present=blt"}).present_model, PresentModel::Blt);
+    EXPECT_EQ(ParseAppOptions({L"--present=mailbox"}).present_model, PresentModel::Blt);
+}
+
+TEST(AppOptions, RenderModeDefaultsToFull)
+{
+    const AppOptions options = ParseAppOptions({});
+    EXPECT_EQ(options.render_mode, RenderMode::Full);
+    EXPECT_EQ(options.cube_fps, 10u);
+}
+
+TEST(AppOptions, LowPowerModeAndCubeRate)
+{
+    const AppOptions options = ParseAppOptions({L"--render-mode=Low-Power", L"--cube-fps=0"});
+    EXPECT_EQ(options.render_mode, RenderMode::LowPower);
+    EXPECT_EQ(options.cube_fps, 0u);
+    EXPECT_EQ(ParseAppOptions({L"--cube-fps=24"}).cube_fps, 24u);
+    EXPECT_EQ(ParseAppOptions({L"--cube-fps=fast"}).cube_fps, 10u);
+    EXPECT_EQ(ParseAppOptions({L"--render-mode=eco"}).render_mode, RenderMode::Full);
+}
+
+TEST(AppOptions, QrIntervalConfigurable)
+{
+    EXPECT_EQ(ParseAppOptions({}).qr_interval_ms, 5000u);
+    EXPECT_EQ(ParseAppOptions({L"--qr-interval=250"}).qr_interval_ms, 250u);
+    EXPECT_EQ(ParseAppOptions({L"--qr-interval=0"}).qr_interval_ms, 0u);
+    EXPECT_EQ(ParseAppOptions({L"--qr-interval=soon"}).qr_interval_ms, 5000u);
+}
+
+TEST(AppOptions, RecordInterval)
+{
+    EXPECT_EQ(ParseAppOptions({}).record_interval_ms, 0u);
+    EXPECT_EQ(ParseAppOptions({L"--record-interval=1000"}).record_interval_ms, 1000u);
+    EXPECT_EQ(ParseAppOptions({L"--record-interval=1000", L"--record-interval=0"}).record_interval_ms, 0u);
+    EXPECT_EQ(ParseAppOptions({L"--record-interval=3600001"}).record_interval_ms, 0u);
+}
+
+TEST(AppOptions, AudioEngineSelectable)
+{
+    EXPECT_EQ(ParseAppOptions({}).audio_engine, AudioEngine::Legacy);
+    EXPECT_EQ(ParseAppOptions({L"--audio-engine=event"}).audio_engine, AudioEngine::Event);
+    EXPECT_EQ(ParseAppOptions({L"--audio-engine=LOW-LATENCY"}).audio_engine, AudioEngine::LowLatency);
+    EXPECT_EQ(ParseAppOptions({L"--audio-engine=event", L"--audio-engine=legacy"}).audio_engine, AudioEngine::Legacy);
+    EXPECT_EQ(ParseAppOptions({L"--audio-engine=asio"}).audio_engine, AudioEngine::Legacy);
+}
+
+TEST(AppOptions, HudBackendSelectable)
+{
+    EXPECT_EQ(ParseAppOptions({}).hud_backend, HudBackend::D2D);
+    EXPECT_EQ(ParseAppOptions({L"--hud=gpu"}).hud_backend, HudBackend::Gpu);
+    EXPECT_EQ(ParseAppOptions({L"--hud=AUTO"}).hud_backend, HudBackend::Auto);
+    EXPECT_EQ(ParseAppOptions({L"--hud=gpu", L"--hud=d2d"}).hud_backend, HudBackend::D2D);
+    EXPECT_EQ(ParseAppOptions({L"--hud=vulkan"}).hud_backend, HudBackend::D2D);
+}
+
+TEST(AppOptions, LatencyProbeIsOptIn)
+{
+    EXPECT_FALSE(ParseAppOptions({}).latency_probe);
+    EXPECT_TRUE(ParseAppOptions({L"--latency-probe"}).latency_probe);
+    EXPECT_TRUE(ParseAppOptions({L"--LATENCY-PROBE"}).latency_probe);
+    EXPECT_FALSE(ParseAppOptions({L"--latency-probe=1"}).latency_probe);
+}
+
+TEST(AppOptions, HeadlessReportSwitches)
+{
+    EXPECT_FALSE(ParseAppOptions({}).headless);
+    EXPECT_TRUE(ParseAppOptions({L"--Headless"}).headless);
+    EXPECT_TRUE(ParseAppOptions({L"--headless"}).headless_output.empty());
+
+    const AppOptions to_file = ParseAppOptions({L"--headless-out=C:\\probe\\report.json"});
+    EXPECT_TRUE(to_file.headless);
+    EXPECT_EQ(to_file.headless_output, L"C:\\probe\\report.json");
+
+    EXPECT_FALSE(ParseAppOptions({L"--headless-out="}).headless);
+    EXPECT_FALSE(ParseAppOptions({L"--headless=yes"}).headless);
+}
+
+TEST(AppOptions, LogFormatAndRotation)
+{
+    const AppOptions defaults = ParseAppOptions({});
+    EXPECT_FALSE(defaults.log_utf8);
+    EXPECT_EQ(defaults.log_rotate_mb, 0u);
+    EXPECT_EQ(defaults.log_rotate_minutes, 0u);
+    EXPECT_EQ(defaults.log_keep_files, 3u);
+
+    EXPECT_TRUE(ParseAppOptions({L"--log-format=UTF8"}).log_utf8);
+    EXPECT_FALSE(ParseAppOptions({L"--log-format=utf8", L"--log-format=utf16"}).log_utf8);
+    EXPECT_FALSE(ParseAppOptions({L"--log-format=binary"}).log_utf8);
+
+    const AppOptions rotating =
+        ParseAppOptions({L"--log-rotate-mb=16", L"--log-rotate-minutes=60", L"--log-keep=0"});
+    EXPECT_EQ(rotating.log_rotate_mb, 16u);
+    EXPECT_EQ(rotating.log_rotate_minutes, 60u);
+    EXPECT_EQ(rotating.log_keep_files, 0u);
+
+    EXPECT_EQ(ParseAppOptions({L"--log-keep=1000"}).log_keep_files, 3u);
+    EXPECT_EQ(ParseAppOptions({L"--log-rotate-mb=-1"}).log_rotate_mb, 0u);
+}
+
+TEST(AppOptions, MetricsSegment)
+{
+    EXPECT_TRUE(ParseAppOptions({}).metrics_shm);
+    EXPECT_TRUE(ParseAppOptions({}).metrics_name.empty());
+    EXPECT_FALSE(ParseAppOptions({L"--no-metrics"}).metrics_shm);
+    EXPECT_EQ(ParseAppOptions({L"--metrics-name=Local\\agent.7"}).metrics_name, L"Local\\agent.7");
+    EXPECT_TRUE(ParseAppOptions({L"--metrics-name="}).metrics_name.empty());
+}
@@ -0,0 +1,140 @@
+// Unit tests for ArgListView: row formatting and truncation, scroll clamping,
+// and case-insensitive search that wraps and keeps the match visible.
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "../arg_list_view.hpp"
+
+namespace
+{
+
+std::vector<std::wstring> MakeArgs(size_t count)
+{
+    std::vector<std::wstring> args;
+    for (size_t i = 0; i < count; ++i)
+        args.push_back(L"--arg" + std::to_wstring(i));
+    return args;
+}
+
+} // namespace
+
+TEST(ArgListViewTest, RowsAreNumberedAndQuoted)
+{
+    ArgListView view;
+    view.SetArgs({L"--plain", L"two words", L""});
+    ASSERT_EQ(view.RowCount(), 3u);
+    EXPECT_EQ(view.Row(0), L"1: --plain");
+    EXPECT_EQ(view.Row(1), L"2: \"two words\"");
+    EXPECT_EQ(view.Row(2), L"3: \"\"");
+}
+
+TEST(ArgListViewTest, LongRowsAreTruncatedWithEllipsis)
+{
+    ArgListView view;
+    view.SetArgs({std::wstring(10000, L'x')});
+    ASSERT_EQ(view.Row(0).size(), ArgListView::kMaxRowChars);
+    EXPECT_EQ(view.Row(0).back(), L'\u2026');
+    EXPECT_EQ(view.Row(0).rfind(L"1: x", 0), 0u);
+}
+
+TEST(ArgListViewTest, ScrollingIsClampedToLastPage)
+{
+    ArgListView view;
+    view.SetArgs(MakeArgs(100));
+    view.SetPageRows(10);
+    EXPECT_TRUE(view.Overflows());
+    EXPECT_EQ(view.FirstRow(), 0u);
+    EXPECT_EQ(view.EndRow(), 10u);
+
+    EXPECT_FALSE(view.ScrollBy(-1));
+    EXPECT_TRUE(view.PageDown());
+    EXPECT_EQ(view.FirstRow(), 10u);
+    EXPECT_TRUE(view.ScrollBy(1000));
+    EXPECT_EQ(view.FirstRow(), 90u);
+    EXPECT_EQ(view.EndRow(), 100u);
+    EXPECT_FALSE(view.End());
+    EXPECT_TRUE(view.Home());
+    EXPECT_EQ(view.FirstRow(), 0u);
+}
+
+TEST(ArgListViewTest, GrowingThePageClampsScrollPosition)
+{
+    ArgListView view;
+    view.SetArgs(MakeArgs(20));
+    view.SetPageRows(5);
+    view.End();
+    EXPECT_EQ(view.FirstRow(), 15u);
+    EXPECT_TRUE(view.SetPageRows(50));
+    EXPECT_EQ(view.FirstRow(), 0u);
+    EXPECT_FALSE(view.Overflows());
+}
+
+TEST(ArgListViewTest, FindIsCaseInsensitiveAndSearchesFullArgument)
+{
+    ArgListView view;
+    std::wstring long_arg(1000, L'x');
+    long_arg += L"NeedleAtTheEnd";
+    view.SetArgs({L"--a", long_arg, L"--NEEDLE"});
+    view.SetPageRows(10);
+
+    EXPECT_EQ(view.Find(L"needle"), 2u);
+    EXPECT_EQ(view.Needle(), L"needle");
+    EXPECT_TRUE(view.IsCurrentMatch(1));
+    EXPECT_EQ(view.Find(L"absent"), 0u);
+    EXPECT_EQ(view.CurrentMatch(), static_cast<size_t>(-1));
+}
+
+TEST(ArgListViewTest, FindNextWrapsAndRevealsMatch)
+{
+    ArgListView view;
+    std::vector<std::wstring> args = MakeArgs(100);
+    args[5] = L"--token=abc";
+    args[80] = L"--TOKEN=def";
+    view.SetArgs(args);
+    view.SetPageRows(10);
+
+    ASSERT_EQ(view.Find(L"token"), 2u);
+    EXPECT_TRUE(view.IsCurrentMatch(5));
+    EXPECT_EQ(view.FirstRow(), 0u);
+
+    EXPECT_TRUE(view.FindNext(true));
+    EXPECT_TRUE(view.IsCurrentMatch(80));
+    EXPECT_GE(80u, view.FirstRow());
+    EXPECT_LT(80u, view.EndRow());
+
+    EXPECT_TRUE(view.FindNext(true));
+    EXPECT_TRUE(view.IsCurrentMatch(5));
+    EXPECT_EQ(view.FirstRow(), 5u);
+
+    EXPECT_TRUE(view.FindNext(false));
+    EXPECT_TRUE(view.IsCurrentMatch(80));
+}
+
+TEST(ArgListViewTest, FindStartsFromVisibleRows)
+{
+    ArgListView view;
+    std::vector<std::wstring> args = MakeArgs(100);
+    args[5] = L"--token";
+    args[60] = L"--token";
+    view.SetArgs(args);
+    view.SetPageRows(10);
+    view.ScrollTo(50);
+
+    ASSERT_EQ(view.Find(L"token"), 2u);
+    EXPECT_TRUE(view.IsCurrentMatch(60));
+    EXPECT_EQ(view.FirstRow(), 51u);
+}
+
+TEST(ArgListViewTest, ClearSearchDropsMatches)
+{
+    ArgListView view;
+    view.SetArgs({L"--a", L"--b"});
+    view.Find(L"--");
+    view.ClearSearch();
+    EXPECT_TRUE(view.Needle().empty());
+    EXPECT_TRUE(view.Matches().empty());
+    EXPECT_FALSE(view.FindNext(true));
+}
@@ -0,0 +1,249 @@
+// Unit tests for AudioMeter and TripleBuffer: per-channel peak/RMS on
+// interleaved buffers, waveform decimation, and tear-free snapshots under a
+// concurrent writer.
+
+// clang-format off
+#include <windows.h>
+#include <mmreg.h>
+// clang-format on
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <thread>
+#include <vector>
+
+#include "../audio_capture.hpp"
+#include "../audio_meter.hpp"
+
+using audio_capture::detail::SampleFormat;
+
+namespace
+{
+
+template <typename T> std::vector<BYTE> ToBytes(const std::vector<T>& values)
+{
+    std::vector<BYTE> bytes(values.size() * sizeof(T));
+    std::memcpy(bytes.data(), values.data(), bytes.size());
+    return bytes;
+}
+
+} // namespace
+
+TEST(AudioMeter, StereoChannelsAreIndependent)
+{
+    AudioMeter meter;
+    meter.Configure(SampleFormat{WAVE_FORMAT_IEEE_FLOAT, 32, 2}, 48000);
+
+    // Left: constant 0.5. Right: alternating +/-0.25 with a single -0.75.
+    std::vector<float> samples;
+    for (int i = 0; i < 480; ++i)
+    {
+        samples.push_back(0.5f);
+        samples.push_back(i == 100 ? -0.75f : (i % 2 ? 0.25f : -0.25f));
+    }
+    const auto bytes = ToBytes(samples);
+    meter.Process(bytes.data(), 480, false);
+
+    const MeterSnapshot& snap = meter.Latest();
+    EXPECT_EQ(snap.channels, 2u);
+    EXPECT_EQ(snap.packets, 1u);
+    // One packet through the 0.5 smoothing.
+    EXPECT_FLOAT_EQ(snap.levels[0].peak, 0.25f);
+    EXPECT_FLOAT_EQ(snap.levels[0].rms, 0.25f);
+    EXPECT_FLOAT_EQ(snap.levels[1].peak, 0.375f);
+    const float right_rms = std::sqrt((479 * 0.0625f + 0.5625f) / 480.f);
+    EXPECT_NEAR(snap.levels[1].rms, right_rms * 0.5f, 1e-6f);
+}
+
+TEST(AudioMeter, Pcm16PeakMatchesScalarKernel)
+{
+    AudioMeter meter;
+    meter.Configure(SampleFormat{WAVE_FORMAT_PCM, 16, 1}, 48000);
+    const std::vector<int16_t> samples = {0, 1000, std::numeric_limits<int16_t>::min(), 12};
+    const auto bytes = ToBytes(samples);
+    // Two identical packets: smoothed peak is 0.75 of the packet peak.
+    meter.Process(bytes.data(), 4, false);
+    meter.Process(bytes.data(), 4, false);
+
+    const float expected = audio_capture::detail::PeakPcm16(bytes.data(), 4);
+    EXPECT_FLOAT_EQ(meter.Latest().levels[0].peak, expected * 0.75f);
+}
+
+TEST(AudioMeter, Pcm24SignExtends)
+{
+    AudioMeter meter;
+    meter.Configure(SampleFormat{WAVE_FORMAT_PCM, 24, 1}, 48000);
+    // -0x400000 (half scale, negative) as 3 little-endian bytes.
+    const std::vector<BYTE> bytes = {0x00, 0x00, 0xC0};
+    meter.Process(bytes.data(), 1, false);
+    EXPECT_NEAR(meter.Latest().levels[0].peak, 0.25f, 1e-6f);
+}
+
+TEST(AudioMeter, ChannelsBeyondLimitAreSkipped)
+{
+    AudioMeter meter;
+    const UINT32 channels = kMeterMaxChannels + 2;
+    meter.Configure(SampleFormat{WAVE_FORMAT_IEEE_FLOAT, 32, channels}, 48000);
+
+    // Each tracked channel c carries (c + 1) / 16; untracked ones are loud.
+    std::vector<float> samples;
+    for (int f = 0; f < 10; ++f)
+    {
+        for (UINT32 c = 0; c < channels; ++c)
+            samples.push_back(c < kMeterMaxChannels ? static_cast<float>(c + 1) / 16.f : 1.0f);
+    }
+    const auto bytes = ToBytes(samples);
+    meter.Process(bytes.data(), 10, false);
+
+    const MeterSnapshot& snap = meter.Latest();
+    EXPECT_EQ(snap.channels, channels);
+    for (UINT32 c = 0; c < kMeterMaxChannels; ++c)
+        EXPECT_FLOAT_EQ(snap.levels[c].peak, static_cast<float>(c + 1) / 32.f) << "channel " << c;
+}
+
+TEST(AudioMeter, SilentPacketDecaysLevels)
+{
+    AudioMeter meter;
+    meter.Configure(SampleFormat{WAVE_FORMAT_IEEE_FLOAT, 32, 1}, 48000);
+    const std::vector<float> loud(480, 1.0f);
+    const auto bytes = ToBytes(loud);
+    meter.Process(bytes.data(), 480, false);
+    // The buffer contents must be ignored when the silent flag is set.
+    meter.Process(bytes.data(), 480, true);
+
+    const MeterSnapshot& snap = meter.Latest();
+    EXPECT_FLOAT_EQ(snap.levels[0].peak, 0.25f);
+    EXPECT_FLOAT_EQ(snap.levels[0].rms, 0.25f);
+    EXPECT_EQ(snap.history_length, 2u);
+    EXPECT_FLOAT_EQ(snap.history[0][1].max, 0.f);
+}
+
+TEST(AudioMeter, NanSamplesDoNotPoisonLevels)
+{
+    AudioMeter meter;
+    meter.Configure(SampleFormat{WAVE_FORMAT_IEEE_FLOAT, 32, 1}, 48000);
+    const std::vector<float> samples = {0.5f, std::numeric_limits<float>::quiet_NaN(),
+                                        std::numeric_limits<float>::infinity(), -0.5f};
+    const auto bytes = ToBytes(samples);
+    meter.Process(bytes.data(), 4, false);
+
+    const ChannelLevel& level = meter.Latest().levels[0];
+    EXPECT_FALSE(std::isnan(level.peak));
+    EXPECT_FALSE(std::isnan(level.rms));
+    EXPECT_LE(level.peak, AudioMeter::kMaxLevel);
+}
+
+TEST(AudioMeter, HistoryDecimatesTenMillisecondBlocks)
+{
+    AudioMeter meter;
+    meter.Configure(SampleFormat{WAVE_FORMAT_IEEE_FLOAT, 32, 2}, 48000);
+
+    // 25 ms of audio split across packets that do not line up with blocks:
+    // two complete 480-frame points, the third still open.
+    std::vector<float> samples;
+    for (int f = 0; f < 1200; ++f)
+    {
+        const float v = static_cast<float>(f) / 1200.f;
+        samples.push_back(v);
+        samples.push_back(-v);
+    }
+    const auto bytes = ToBytes(samples);
+    meter.Process(bytes.data(), 700, false);
+    meter.Process(bytes.data() + 700 * 2 * sizeof(float), 500, false);
+
+    const MeterSnapshot& snap = meter.Latest();
+    ASSERT_EQ(snap.history_length, 2u);
+    EXPECT_FLOAT_EQ(snap.history[0][0].max, 479.f / 1200.f);
+    EXPECT_FLOAT_EQ(snap.history[0][0].min, 0.f);
+    EXPECT_FLOAT_EQ(snap.history[1][0].min, -479.f / 1200.f);
+    EXPECT_FLOAT_EQ(snap.history[0][1].max, 959.f / 1200.f);
+}
+
+TEST(AudioMeter, HistoryKeepsNewestPointsInOrder)
+{
+    AudioMeter meter;
+    // 100 Hz sample rate: one frame per history point.
+    meter.Configure(SampleFormat{WAVE_FORMAT_IEEE_FLOAT, 32, 1}, 100);
+    const UINT32 total = kMeterHistoryLength + 40;
+    std::vector<float> samples(total);
+    for (UINT32 i = 0; i < total; ++i)
+        samples[i] = static_cast<float>(i) / 1000.f;
+    const auto bytes = ToBytes(samples);
+    meter.Process(bytes.data(), total, false);
+
+    const MeterSnapshot& snap = meter.Latest();
+    ASSERT_EQ(snap.history_length, kMeterHistoryLength);
+    EXPECT_FLOAT_EQ(snap.history[0][0].max, 40.f / 1000.f);
+    EXPECT_FLOAT_EQ(snap.history[0][kMeterHistoryLength - 1].max, static_cast<float>(total - 1) / 1000.f);
+}
+
+TEST(AudioMeter, UnsupportedFormatPublishesNothing)
+{
+    AudioMeter meter;
+    meter.Configure(SampleFormat{WAVE_FORMAT_PCM, 8, 1}, 48000);
+    const std::vector<BYTE> bytes = {0xFF, 0x00};
+    meter.Process(bytes.data(), 2, false);
+    EXPECT_EQ(meter.Latest().packets, 0u);
+    EXPECT_EQ(meter.Latest().channels, 0u);
+}
+
+TEST(TripleBuffer, ReaderSeesLatestPublish)
+{
+    TripleBuffer<int> buffer;
+    EXPECT_EQ(buffer.Latest(), 0);
+    buffer.Back() = 1;
+    buffer.Publish();
+    buffer.Back() = 2;
+    buffer.Publish();
+    EXPECT_EQ(buffer.Latest(), 2);
+    // Nothing new: the reader keeps its slot.
+    EXPECT_EQ(buffer.Latest(), 2);
+    buffer.Back() = 3;
+    buffer.Publish();
+    EXPECT_EQ(buffer.Latest(), 3);
+}
+
+TEST(TripleBuffer, ConcurrentSnapshotsNeverTear)
+{
+    struct Payload
+    {
+        UINT64 words[64];
+    };
+    TripleBuffer<Payload> buffer;
+    std::atomic<bool> done{false};
+
+    std::thread writer(
+        [&]
+        {
+            for (UINT64 n = 1; n <= 200000; ++n)
+            {
+                Payload& p = buffer.Back();
+                for (UINT64& w : p.words)
+                    w = n;
+                buffer.Publish();
+            }
+            done.store(true);
+        });
+
+    UINT64 last = 0;
+    bool torn = false;
+    bool backwards = false;
+    while (!done.load())
+    {
+        const Payload& p = buffer.Latest();
+        for (UINT64 w : p.words)
+            torn |= w != p.words[0];
+        backwards |= p.words[0] < last;
+        last = p.words[0];
+    }
+    writer.join();
+
+    EXPECT_FALSE(torn);
+    EXPECT_FALSE(backwards);
+    EXPECT_EQ(buffer.Latest().words[0], 200000u);
+}
@@ -18,19 +18,24 @@
 #include <cstdint>
 #include <cstring>
 #include <limits>
+#include <random>
 #include <vector>
 
 #include <gtest/gtest.h>
 
 #include "../audio_capture.hpp"
 
+using audio_capture::detail::IsPeakIsaAvailable;
 using audio_capture::detail::PeakFloat32;
+using audio_capture::detail::PeakFn;
 using audio_capture::detail::PeakForFormat;
+using audio_capture::detail::PeakIsa;
 using audio_capture::detail::PeakPcm16;
 using audio_capture::detail::PeakPcm24;
 using audio_capture::detail::PeakPcm32;
 using audio_capture::detail::ResolveFormat;
 using audio_capture::detail::SampleFormat;
+using audio_capture::detail::SelectPeakKernel;
 
 namespace
 {
@@ -203,6 +208,176 @@ TEST(PeakForFormat, UnsupportedFormatReturnsZero)
     EXPECT_FLOAT_EQ(PeakForFormat(alaw, buf.data(), 3), 0.f);
 }
 
+// ---------------------------------------------------------------------------
+// SelectPeakKernel — resolved once per stream, not per packet
+// ---------------------------------------------------------------------------
+
+TEST(SelectPeakKernel, ScalarMatchesPeakForFormatDispatch)
+{
+    EXPECT_EQ(SelectPeakKernel({WAVE_FORMAT_IEEE_FLOAT, 32, 2}, PeakIsa::Scalar), &PeakFloat32);
+    EXPECT_EQ(SelectPeakKernel({WAVE_FORMAT_PCM, 16, 2}, PeakIsa::Scalar), &PeakPcm16);
+    EXPECT_EQ(SelectPeakKernel({WAVE_FORMAT_PCM, 24, 2}, PeakIsa::Scalar), &PeakPcm24);
+    EXPECT_EQ(SelectPeakKernel({WAVE_FORMAT_PCM, 32, 2}, PeakIsa::Scalar), &PeakPcm32);
+}
+
+TEST(SelectPeakKernel, DefaultCoversEverySupportedFormat)
+{
+    EXPECT_NE(SelectPeakKernel({WAVE_FORMAT_IEEE_FLOAT, 32, 2}), nullptr);
+    EXPECT_NE(SelectPeakKernel({WAVE_FORMAT_PCM, 16, 2}), nullptr);
+    EXPECT_NE(SelectPeakKernel({WAVE_FORMAT_PCM, 24, 2}), nullptr);
+    EXPECT_NE(SelectPeakKernel({WAVE_FORMAT_PCM, 32, 2}), nullptr);
+}
+
+TEST(SelectPeakKernel, UnsupportedFormatYieldsNull)
+{
+    EXPECT_EQ(SelectPeakKernel({WAVE_FORMAT_PCM, 8, 1}), nullptr);
+    EXPECT_EQ(SelectPeakKernel({WAVE_FORMAT_IEEE_FLOAT, 64, 1}), nullptr);
+    EXPECT_EQ(SelectPeakKernel({WAVE_FORMAT_ALAW, 8, 1}), nullptr);
+}
+
+TEST(SelectPeakKernel, UnavailableIsaYieldsNull)
+{
+    for (PeakIsa isa : {PeakIsa::Sse2, PeakIsa::Avx2, PeakIsa::Neon})
+    {
+        if (!IsPeakIsaAvailable(isa))
+        {
+            EXPECT_EQ(SelectPeakKernel({WAVE_FORMAT_PCM, 16, 2}, isa), nullptr);
+        }
+    }
+    EXPECT_TRUE(IsPeakIsaAvailable(PeakIsa::Scalar));
+    EXPECT_TRUE(IsPeakIsaAvailable(audio_capture::detail::DetectPeakIsa()));
+}
+
+// ---------------------------------------------------------------------------
+// SIMD kernels — bit-identical to the scalar reference
+// ---------------------------------------------------------------------------
+
+namespace
+{
+
+constexpr PeakIsa kVectorIsas[] = {PeakIsa::Sse2, PeakIsa::Avx2, PeakIsa::Neon};
+
+// Runs every available vector kernel for `sf` over every length up to the
+// buffer size and at a few misalignments, comparing bit patterns with the
+// scalar reference (EXPECT_FLOAT_EQ would hide a one-ulp drift).
+void ExpectKernelsMatchScalar(const SampleFormat& sf, const std::vector<BYTE>& bytes, UINT32 bytes_per_sample)
+{
+    const PeakFn reference = SelectPeakKernel(sf, PeakIsa::Scalar);
+    ASSERT_NE(reference, nullptr);
+    const auto total = static_cast<UINT32>(bytes.size() / bytes_per_sample);
+
+    for (PeakIsa isa : kVectorIsas)
+    {
+        const PeakFn kernel = SelectPeakKernel(sf, isa);
+        if (!kernel)
+            continue;
+        for (UINT32 offset = 0; offset < 3 && offset < total; ++offset)
+        {
+            // Copy to a fresh buffer so the start is misaligned by `offset`
+            // samples relative to the allocation, and nothing past the end is
+            // readable by accident.
+            for (UINT32 n = 0; n + offset <= total; ++n)
+            {
+                std::vector<BYTE> window(bytes.begin() + offset * bytes_per_sample,
+                                         bytes.begin() + (offset + n) * bytes_per_sample);
+                const float expected = reference(window.data(), n);
+                const float actual = kernel(window.data(), n);
+                uint32_t expected_bits = 0;
+                uint32_t actual_bits = 0;
+                std::memcpy(&expected_bits, &expected, sizeof(float));
+                std::memcpy(&actual_bits, &actual, sizeof(float));
+                ASSERT_EQ(actual_bits, expected_bits)
+                    << "isa=" << static_cast<int>(isa) << " offset=" << offset << " n=" << n;
+            }
+        }
+    }
+}
+
+} // namespace
+
+TEST(PeakSimd, Float32MatchesScalar)
+{
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> dist(-1.5f, 1.5f);
+    std::vector<float> values(133);
+    for (float& v : values)
+        v = dist(rng);
+    // Specials the kernels must treat like the scalar loop: NaN never wins,
+    // negative zero and infinities survive the abs, and the peak can sit in
+    // the tail after the vector body.
+    values[5] = std::numeric_limits<float>::quiet_NaN();
+    values[17] = -0.0f;
+    values[40] = -std::numeric_limits<float>::infinity();
+    values[41] = std::numeric_limits<float>::denorm_min();
+    values[131] = -1.75f;
+
+    std::vector<BYTE> bytes(values.size() * sizeof(float));
+    std::memcpy(bytes.data(), values.data(), bytes.size());
+    ExpectKernelsMatchScalar({WAVE_FORMAT_IEEE_FLOAT, 32, 1}, bytes, 4);
+}
+
+TEST(PeakSimd, Float32LeadingNaNKeepsZero)
+{
+    std::vector<float> values(64, std::numeric_limits<float>::quiet_NaN());
+    std::vector<BYTE> bytes(values.size() * sizeof(float));
+    std::memcpy(bytes.data(), values.data(), bytes.size());
+    ExpectKernelsMatchScalar({WAVE_FORMAT_IEEE_FLOAT, 32, 1}, bytes, 4);
+}
+
+TEST(PeakSimd, Pcm16MatchesScalar)
+{
+    std::mt19937 rng(16);
+    std::uniform_int_distribution<int> dist(-32768, 32767);
+    std::vector<int16_t> values(133);
+    for (int16_t& v : values)
+        v = static_cast<int16_t>(dist(rng) / 4);
+    values[9] = std::numeric_limits<int16_t>::min();
+    values[130] = std::numeric_limits<int16_t>::max();
+
+    std::vector<BYTE> bytes(values.size() * sizeof(int16_t));
+    std::memcpy(bytes.data(), values.data(), bytes.size());
+    ExpectKernelsMatchScalar({WAVE_FORMAT_PCM, 16, 1}, bytes, 2);
+}
+
+TEST(PeakSimd, Pcm24MatchesScalar)
+{
+    std::mt19937 rng(24);
+    std::uniform_int_distribution<int32_t> dist(-0x800000, 0x7FFFFF);
+    std::vector<BYTE> bytes;
+    for (int i = 0; i < 133; ++i)
+    {
+        int32_t v = dist(rng) / 4;
+        if (i == 12)
+            v = -0x800000;
+        if (i == 129)
+            v = 0x7FFFFF;
+        bytes.push_back(static_cast<BYTE>(v & 0xFF));
+        bytes.push_back(static_cast<BYTE>((v >> 8) & 0xFF));
+        bytes.push_back(static_cast<BYTE>((v >> 16) & 0xFF));
+    }
+    ExpectKernelsMatchScalar({WAVE_FORMAT_PCM, 24, 1}, bytes, 3);
+}
+
+TEST(PeakSimd, Pcm32MatchesScalar)
+{
+    std::mt19937 rng(32);
+    std::uniform_int_distribution<int32_t> dist(std::numeric_limits<int32_t>::min(),
+                                                std::numeric_limits<int32_t>::max());
+    std::vector<int32_t> values(133);
+    for (int32_t& v : values)
+        v = dist(rng) / 4;
+    // Values whose float conversion rounds: the kernels must compare the
+    // rounded float, exactly like the scalar division does.
+    values[3] = 0x7FFFFFC0;
+    values[4] = -0x7FFFFFBF;
+    values[70] = std::numeric_limits<int32_t>::min();
+    values[132] = std::numeric_limits<int32_t>::max();
+
+    std::vector<BYTE> bytes(values.size() * sizeof(int32_t));
+    std::memcpy(bytes.data(), values.data(), bytes.size());
+    ExpectKernelsMatchScalar({WAVE_FORMAT_PCM, 32, 1}, bytes, 4);
+}
+
 // ---------------------------------------------------------------------------
 // ResolveFormat — plain WAVEFORMATEX and WAVEFORMATEXTENSIBLE handling
 // ---------------------------------------------------------------------------
@@ -6,6 +6,8 @@
 #include <thread>
 #include <windows.h>
 
+#include "../audio_capture.hpp"
+
 class AudioTest : public ::testing::Test
 {
   protected:
@@ -305,4 +307,50 @@ TEST_F(AudioTest, TickCountTiming)
     // Allow some tolerance for timing (80-120ms)
     EXPECT_GE(elapsed, 80u);
     EXPECT_LE(elapsed, 120u);
-}
\ No newline at end of file
+}
+
+// Device hot-swap: which endpoint notifications rebuild the capture stream
+TEST(AudioDeviceChangeTest, DefaultConsoleCaptureChangeRebuilds)
+{
+    using audio_capture::detail::DeviceChange;
+    using audio_capture::detail::DeviceNotification;
+    using audio_capture::detail::NeedsRebuild;
+
+    DeviceNotification n;
+    n.change = DeviceChange::DefaultChanged;
+    EXPECT_TRUE(NeedsRebuild(n, true));
+    EXPECT_TRUE(NeedsRebuild(n, false));
+
+    n.role = eCommunications;
+    EXPECT_FALSE(NeedsRebuild(n, true));
+    n.role = eConsole;
+    n.flow = eRender;
+    EXPECT_FALSE(NeedsRebuild(n, true));
+}
+
+TEST(AudioDeviceChangeTest, LosingCurrentDeviceRebuilds)
+{
+    using audio_capture::detail::DeviceChange;
+    using audio_capture::detail::DeviceNotification;
+    using audio_capture::detail::NeedsRebuild;
+
+    DeviceNotification n;
+    n.change = DeviceChange::StateChanged;
+    n.is_current = true;
+    n.state = DEVICE_STATE_UNPLUGGED;
+    EXPECT_TRUE(NeedsRebuild(n, true));
+    n.state = DEVICE_STATE_ACTIVE;
+    EXPECT_FALSE(NeedsRebuild(n, true));
+
+    // Other endpoints only matter while there is no stream.
+    n.is_current = false;
+    EXPECT_FALSE(NeedsRebuild(n, true));
+    EXPECT_TRUE(NeedsRebuild(n, false));
+    n.state = DEVICE_STATE_DISABLED;
+    EXPECT_FALSE(NeedsRebuild(n, false));
+
+    n.change = DeviceChange::Removed;
+    EXPECT_FALSE(NeedsRebuild(n, true));
+    n.is_current = true;
+    EXPECT_TRUE(NeedsRebuild(n, true));
+}
@@ -190,12 +190,13 @@ TEST_F(CliArgsTest, SoundCommandParsing)
 TEST_F(CliArgsTest, CommandDescriptionIncludesAllCommands)
 {
     // The description should mention all commands including sound and memory
-    std::wstring expectedText = L"Type 'exit', 'save', 'read', 'logs', 'path', 'sound' or 'memory' and press Enter to execute commands.";
+    std::wstring expectedText = L"Type 'exit', 'save', 'read', 'logs', 'path', 'sound', 'memory' or 'find <text>' and press Enter to execute commands.";
     
     // This test verifies that the description has been updated
     // In a real test, we would check the actual kDescriptionLines vector
     EXPECT_TRUE(expectedText.find(L"sound") != std::wstring::npos);
     EXPECT_TRUE(expectedText.find(L"memory") != std::wstring::npos);
+    EXPECT_TRUE(expectedText.find(L"find") != std::wstring::npos);
 }
 
 // Test for memory command parsing
@@ -210,3 +211,16 @@ TEST_F(CliArgsTest, MemoryCommandParsing)
     EXPECT_EQ(_wcsicmp(memoryUpper.c_str(), L"memory"), 0);
     EXPECT_EQ(_wcsicmp(memoryMixed.c_str(), L"memory"), 0);
 }
+
+// Test that a single argument is formatted the same way as in the joined line
+TEST_F(CliArgsTest, FormatCliArgMatchesJoinedFormatting)
+{
+    ExpectWideStringEq(L"plain", FormatCliArg(L"plain"));
+    ExpectWideStringEq(L"\"\"", FormatCliArg(L""));
+    ExpectWideStringEq(L"\"two words\"", FormatCliArg(L"two words"));
+    ExpectWideStringEq(L"\"say \"hi\"\"", FormatCliArg(L"say \"hi\""));
+
+    std::vector<std::wstring> args = {L"a", L"b c", L""};
+    ExpectWideStringEq(FormatCliArg(args[0]) + L" " + FormatCliArg(args[1]) + L" " + FormatCliArg(args[2]),
+                       BuildCliArgsText(args));
+}
@@ -0,0 +1,69 @@
+// Unit tests for cpu_dispatch: the build/host description shown by the
+// `memory` command, emulation detection, and agreement between the shared
+// AVX2 probe and the audio peak kernel selection.
+
+#include <gtest/gtest.h>
+
+#include "../audio_capture.hpp"
+#include "../cpu_dispatch.hpp"
+
+namespace
+{
+
+CpuInfo MakeInfo(CpuArch build, CpuArch host)
+{
+    CpuInfo info;
+    info.build = build;
+    info.host = host;
+    return info;
+}
+
+} // namespace
+
+TEST(CpuDispatchTest, DetectsBuildArchitecture)
+{
+    const CpuInfo& info = cpu_dispatch::Info();
+#if defined(_M_ARM64EC)
+    EXPECT_EQ(info.build, CpuArch::Arm64EC);
+    EXPECT_EQ(info.host, CpuArch::Arm64);
+#elif defined(_M_ARM64)
+    EXPECT_EQ(info.build, CpuArch::Arm64);
+#elif defined(_M_X64)
+    EXPECT_EQ(info.build, CpuArch::X64);
+#endif
+    EXPECT_NE(info.host, CpuArch::Unknown);
+    EXPECT_FALSE(cpu_dispatch::Describe().empty());
+}
+
+TEST(CpuDispatchTest, OnlyX86CodeOnArm64IsEmulated)
+{
+    using cpu_dispatch::detail::IsEmulated;
+    EXPECT_TRUE(IsEmulated(MakeInfo(CpuArch::X64, CpuArch::Arm64)));
+    EXPECT_TRUE(IsEmulated(MakeInfo(CpuArch::X86, CpuArch::Arm64)));
+    EXPECT_FALSE(IsEmulated(MakeInfo(CpuArch::Arm64EC, CpuArch::Arm64)));
+    EXPECT_FALSE(IsEmulated(MakeInfo(CpuArch::Arm64, CpuArch::Arm64)));
+    // WOW64 x86 on an x64 host runs natively.
+    EXPECT_FALSE(IsEmulated(MakeInfo(CpuArch::X86, CpuArch::X64)));
+}
+
+TEST(CpuDispatchTest, DescribeNamesBuildAndHost)
+{
+    using cpu_dispatch::detail::Describe;
+    EXPECT_EQ(Describe(MakeInfo(CpuArch::X64, CpuArch::X64)), L"x64");
+    EXPECT_EQ(Describe(MakeInfo(CpuArch::X86, CpuArch::X64)), L"x86 on x64");
+    EXPECT_EQ(Describe(MakeInfo(CpuArch::Arm64EC, CpuArch::Arm64)), L"ARM64EC on ARM64");
+    EXPECT_EQ(Describe(MakeInfo(CpuArch::X64, CpuArch::Arm64)),
+              L"x64 on ARM64 (emulated; use the ARM64 or ARM64EC build)");
+}
+
+TEST(CpuDispatchTest, PeakKernelFollowsSharedProbe)
+{
+    using audio_capture::detail::DetectPeakIsa;
+    using audio_capture::detail::PeakIsa;
+#if defined(CPU_DISPATCH_X86)
+    EXPECT_EQ(DetectPeakIsa(), cpu_dispatch::HasAvx2() ? PeakIsa::Avx2 : PeakIsa::Sse2);
+#elif defined(CPU_DISPATCH_NEON)
+    EXPECT_EQ(DetectPeakIsa(), PeakIsa::Neon);
+    EXPECT_FALSE(cpu_dispatch::HasAvx2());
+#endif
+}
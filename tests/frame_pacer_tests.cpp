@@ -0,0 +1,74 @@
+// Unit tests for the frame_pacer::detail scheduling math plus a coarse live
+// check of FramePacer against QueryPerformanceCounter.
+
+#include <windows.h>
+
+#include <gtest/gtest.h>
+
+#include "../frame_pacer.hpp"
+
+using frame_pacer::detail::NextDeadline;
+using frame_pacer::detail::PeriodTicks;
+
+TEST(FramePacerMath, PeriodTicksForCommonRates)
+{
+    const LONGLONG f = 10000000; // 10 MHz, the usual QPC frequency on Windows 10+
+    EXPECT_EQ(PeriodTicks(f, 60), 166666);
+    EXPECT_EQ(PeriodTicks(f, 120), 83333);
+    EXPECT_EQ(PeriodTicks(f, 144), 69444);
+}
+
+TEST(FramePacerMath, ZeroFpsMeansUnlimited)
+{
+    EXPECT_EQ(PeriodTicks(10000000, 0), 0);
+    EXPECT_EQ(NextDeadline(100, 500, 0), 500);
+}
+
+TEST(FramePacerMath, DeadlineAdvancesFromPreviousDeadlineNotFromNow)
+{
+    // Frame started 30 ticks late: the next deadline stays on the grid.
+    EXPECT_EQ(NextDeadline(1000, 1030, 100), 1100);
+}
+
+TEST(FramePacerMath, FallingBehindReanchorsInsteadOfBursting)
+{
+    // Three periods late: schedule one period from now, not 1100/1200/...
+    EXPECT_EQ(NextDeadline(1000, 1350, 100), 1450);
+}
+
+TEST(FramePacer, UnlimitedNeverBlocks)
+{
+    FramePacer pacer;
+    pacer.Initialize(0);
+    EXPECT_TRUE(pacer.WaitForFrame());
+    pacer.OnFrameStarted();
+    EXPECT_TRUE(pacer.WaitForFrame());
+}
+
+TEST(FramePacer, PacesCloseToTargetRate)
+{
+    FramePacer pacer;
+    pacer.Initialize(100); // 10 ms period
+
+    // Drop anything queued on this thread so MsgWait only wakes on the timer.
+    MSG msg;
+    while (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE))
+    {
+    }
+
+    const int frames = 20;
+    const LONGLONG start = FramePacer::Now();
+    for (int i = 0; i < frames; ++i)
+    {
+        while (!pacer.WaitForFrame())
+        {
+        }
+        pacer.OnFrameStarted();
+    }
+    const double elapsed = FramePacer::TicksToSeconds(FramePacer::Now() - start);
+
+    // The first frame is due immediately, so ~19 periods elapse. Generous
+    // bounds: CI runners are noisy, this only guards against "not pacing".
+    EXPECT_GT(elapsed, 0.15);
+    EXPECT_LT(elapsed, 0.60);
+}
@@ -0,0 +1,108 @@
+// Unit tests for FrameStats: nearest-rank percentiles, ring wrap-around and
+// history ordering.
+
+#include <windows.h>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "../frame_stats.hpp"
+
+using frame_stats::detail::SummarizeSamples;
+
+TEST(FrameStatsMath, EmptyInputYieldsZeros)
+{
+    const SectionSummary s = SummarizeSamples(nullptr, 0);
+    EXPECT_EQ(s.p50_ms, 0.f);
+    EXPECT_EQ(s.max_ms, 0.f);
+}
+
+TEST(FrameStatsMath, NearestRankOnOneToHundred)
+{
+    std::vector<float> v;
+    for (int i = 100; i >= 1; --i)
+        v.push_back(static_cast<float>(i));
+    const SectionSummary s = SummarizeSamples(v.data(), v.size());
+    EXPECT_FLOAT_EQ(s.p50_ms, 50.f);
+    EXPECT_FLOAT_EQ(s.p95_ms, 95.f);
+    EXPECT_FLOAT_EQ(s.p99_ms, 99.f);
+    EXPECT_FLOAT_EQ(s.max_ms, 100.f);
+}
+
+TEST(FrameStatsMath, SingleSpikeShowsInTailOnly)
+{
+    std::vector<float> v(200, 16.7f);
+    v[123] = 80.f;
+    const SectionSummary s = SummarizeSamples(v.data(), v.size());
+    EXPECT_FLOAT_EQ(s.p50_ms, 16.7f);
+    EXPECT_FLOAT_EQ(s.p99_ms, 16.7f);
+    EXPECT_FLOAT_EQ(s.max_ms, 80.f);
+}
+
+TEST(FrameStatsTest, SamplesAccumulateWithinAFrame)
+{
+    FrameStats stats;
+    stats.BeginFrame();
+    stats.AddSample(FrameSection::Cube, 1.5f);
+    stats.AddSample(FrameSection::Cube, 2.0f);
+    stats.EndFrame();
+    EXPECT_EQ(stats.Count(), 1u);
+    EXPECT_FLOAT_EQ(stats.Summarize(FrameSection::Cube).max_ms, 3.5f);
+    // Sections not touched this frame record zero.
+    EXPECT_FLOAT_EQ(stats.Summarize(FrameSection::Present).max_ms, 0.f);
+}
+
+TEST(FrameStatsTest, WindowDropsOldestSamples)
+{
+    FrameStats stats;
+    for (size_t i = 0; i < FrameStats::kWindow + 10; ++i)
+    {
+        stats.BeginFrame();
+        stats.AddSample(FrameSection::Interval, i < 10 ? 1000.f : 10.f);
+        stats.EndFrame();
+    }
+    EXPECT_EQ(stats.Count(), FrameStats::kWindow);
+    EXPECT_FLOAT_EQ(stats.Summarize(FrameSection::Interval).max_ms, 10.f);
+}
+
+TEST(FrameStatsTest, HistoryIsOldestFirstAcrossWrap)
+{
+    FrameStats stats;
+    for (size_t i = 0; i < FrameStats::kWindow + 3; ++i)
+    {
+        stats.BeginFrame();
+        stats.AddSample(FrameSection::Interval, static_cast<float>(i));
+        stats.EndFrame();
+    }
+    float out[5] = {};
+    ASSERT_EQ(stats.CopyHistory(FrameSection::Interval, out, 5), 5u);
+    const float last = static_cast<float>(FrameStats::kWindow + 2);
+    for (size_t i = 0; i < 5; ++i)
+        EXPECT_FLOAT_EQ(out[i], last - 4.f + static_cast<float>(i));
+}
+
+TEST(FrameStatsTest, HistoryClampsToAvailableSamples)
+{
+    FrameStats stats;
+    stats.BeginFrame();
+    stats.AddSample(FrameSection::Cpu, 4.f);
+    stats.EndFrame();
+    float out[8] = {};
+    EXPECT_EQ(stats.CopyHistory(FrameSection::Cpu, out, 8), 1u);
+    EXPECT_FLOAT_EQ(out[0], 4.f);
+}
+
+TEST(ScopedSectionTimerTest, RecordsElapsedTime)
+{
+    FrameStats stats;
+    stats.BeginFrame();
+    {
+        ScopedSectionTimer timer(stats, FrameSection::QrUpdate);
+        Sleep(5);
+    }
+    stats.EndFrame();
+    const float ms = stats.Summarize(FrameSection::QrUpdate).max_ms;
+    EXPECT_GE(ms, 4.0f);
+    EXPECT_LT(ms, 500.0f);
+}
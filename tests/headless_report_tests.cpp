@@ -0,0 +1,104 @@
+// Unit tests for the --headless report: JSON escaping, label trimming and
+// that the embedded QR payload matches what QrWorker would encode.
+
+#include <windows.h>
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "../headless_report.hpp"
+
+using headless_report::Report;
+using headless_report::ToJson;
+using headless_report::detail::AppendJsonString;
+using headless_report::detail::TrimLabel;
+
+namespace
+{
+
+std::string Quoted(const std::string& utf8)
+{
+    std::string out;
+    AppendJsonString(out, utf8);
+    return out;
+}
+
+Report FixedReport(const std::vector<std::wstring>& args)
+{
+    Report report;
+    report.args = args;
+    report.paths = {{L"OS Version: ", L"Windows 10.0 (Build 19045)"}, {L"Current directory: ", L"C:\\Games"}};
+    report.stamp.unix_time = 1700000000;
+    report.stamp.qpc = 123456789;
+    return report;
+}
+
+} // namespace
+
+TEST(HeadlessReport, EscapesJsonSpecials)
+{
+    EXPECT_EQ(Quoted(""), "\"\"");
+    EXPECT_EQ(Quoted("plain"), "\"plain\"");
+    EXPECT_EQ(Quoted("say \"hi\""), "\"say \\\"hi\\\"\"");
+    EXPECT_EQ(Quoted("C:\\Games\\x.exe"), "\"C:\\\\Games\\\\x.exe\"");
+    EXPECT_EQ(Quoted("a\nb\tc\r"), "\"a\\nb\\tc\\r\"");
+    EXPECT_EQ(Quoted(std::string("\x01\x1f", 2)), "\"\\u0001\\u001f\"");
+}
+
+TEST(HeadlessReport, NonAsciiPassesThroughAsUtf8)
+{
+    // U+00E9 and U+4E2D, already UTF-8 encoded.
+    EXPECT_EQ(Quoted("\xC3\xA9\xE4\xB8\xAD"), "\"\xC3\xA9\xE4\xB8\xAD\"");
+}
+
+TEST(HeadlessReport, TrimsPathLabels)
+{
+    EXPECT_EQ(TrimLabel(L"OS Version: "), L"OS Version");
+    EXPECT_EQ(TrimLabel(L"Wine/Proton:"), L"Wine/Proton");
+    EXPECT_EQ(TrimLabel(L"Plain"), L"Plain");
+    EXPECT_EQ(TrimLabel(L": "), L"");
+}
+
+TEST(HeadlessReport, JsonCarriesArgsPathsAndQrPayload)
+{
+    const std::string json = ToJson(FixedReport({L"-windowed", L"--name=Big Game"}));
+
+    EXPECT_NE(json.find("\"format\": 1"), std::string::npos);
+    EXPECT_NE(json.find("\"args\": [\"-windowed\", \"--name=Big Game\"]"), std::string::npos);
+    EXPECT_NE(json.find("\"args_text\": \"-windowed \\\"--name=Big Game\\\"\""), std::string::npos);
+    EXPECT_NE(json.find("{\"label\": \"OS Version\", \"value\": \"Windows 10.0 (Build 19045)\"}"), std::string::npos);
+    EXPECT_NE(json.find("{\"label\": \"Current directory\", \"value\": \"C:\\\\Games\"}"), std::string::npos);
+    EXPECT_NE(json.find("\"qr_payload\": \"t=1700000000;f=0;n=0;q=123456789;args=-windowed --name=Big Game \""),
+              std::string::npos);
+    EXPECT_EQ(json.front(), '{');
+    EXPECT_EQ(json.substr(json.size() - 2), "}\n");
+}
+
+TEST(HeadlessReport, QrVersionMatchesWorkerPinning)
+{
+    const Report report = FixedReport({L"-windowed"});
+    const auto segments = qr_worker::detail::MakeByteSegments(qr_worker::detail::BuildArgsSuffix(report.args));
+    const int expected = qr_worker::detail::StableMinVersion(segments);
+    EXPECT_NE(ToJson(report).find("\"qr_version\": " + std::to_string(expected) + "\n"), std::string::npos);
+}
+
+TEST(HeadlessReport, OversizedPayloadReportsFirstChunk)
+{
+    // Far beyond a version-40 symbol's byte capacity: split into 4 chunks.
+    const std::string json = ToJson(FixedReport({std::wstring(4000, L'x')}));
+    EXPECT_NE(json.find("\"qr_chunks\": 4"), std::string::npos);
+    EXPECT_NE(json.find(";c=0/4;args=xxx"), std::string::npos);
+    EXPECT_EQ(json.find("\"qr_version\": null"), std::string::npos);
+}
+
+TEST(HeadlessReport, EmptyReportIsStillStructured)
+{
+    Report report;
+    const std::string json = ToJson(report);
+    EXPECT_NE(json.find("\"args\": []"), std::string::npos);
+    EXPECT_NE(json.find("\"args_text\": \"\""), std::string::npos);
+    EXPECT_NE(json.find("\"paths\": []"), std::string::npos);
+    EXPECT_NE(json.find("\"qr_payload\": \"t=0;f=0;n=0;q=0\""), std::string::npos);
+}
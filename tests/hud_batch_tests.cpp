@@ -0,0 +1,121 @@
+// Unit tests for HudBatch and BuildImageQuads: Direct2D-equivalent
+// rectangle and line geometry, the fixed capacity, and covering a
+// rasterised QR image with merged runs.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "../hud_batch.hpp"
+
+namespace
+{
+
+constexpr HudColor kRed = {1.0f, 0.0f, 0.0f, 1.0f};
+constexpr uint32_t kWhite = 0xffffffff;
+constexpr uint32_t kBlack = 0xff000000;
+
+void ExpectQuad(const HudQuad& quad, float left, float top, float right, float bottom)
+{
+    EXPECT_FLOAT_EQ(quad.left, left);
+    EXPECT_FLOAT_EQ(quad.top, top);
+    EXPECT_FLOAT_EQ(quad.right, right);
+    EXPECT_FLOAT_EQ(quad.bottom, bottom);
+}
+
+} // namespace
+
+TEST(HudBatchTest, FillAndLinesMatchDirect2DGeometry)
+{
+    HudBatch batch(16);
+    batch.Fill(1.0f, 2.0f, 3.0f, 4.0f, kRed);
+    batch.Line(10.0f, 50.0f, 10.0f, 20.0f, 2.0f, kRed); // vertical, drawn bottom-up
+    batch.Line(0.0f, 5.0f, 8.0f, 5.0f, 0.5f, kRed);     // horizontal
+    ASSERT_EQ(batch.Size(), 3u);
+    ExpectQuad(batch.Data()[0], 1.0f, 2.0f, 3.0f, 4.0f);
+    ExpectQuad(batch.Data()[1], 9.0f, 20.0f, 11.0f, 50.0f);
+    ExpectQuad(batch.Data()[2], 0.0f, 4.75f, 8.0f, 5.25f);
+    EXPECT_FLOAT_EQ(batch.Data()[0].r, 1.0f);
+    EXPECT_FLOAT_EQ(batch.Data()[0].a, 1.0f);
+}
+
+TEST(HudBatchTest, OutlineCentresStrokeOnEdges)
+{
+    HudBatch batch(8);
+    batch.Outline(10.0f, 10.0f, 40.0f, 160.0f, 2.0f, kRed);
+    ASSERT_EQ(batch.Size(), 4u);
+    ExpectQuad(batch.Data()[0], 9.0f, 9.0f, 41.0f, 11.0f);    // top
+    ExpectQuad(batch.Data()[1], 9.0f, 159.0f, 41.0f, 161.0f); // bottom
+    ExpectQuad(batch.Data()[2], 9.0f, 11.0f, 11.0f, 159.0f);  // left
+    ExpectQuad(batch.Data()[3], 39.0f, 11.0f, 41.0f, 159.0f); // right
+}
+
+TEST(HudBatchTest, FullBatchDropsInsteadOfGrowing)
+{
+    HudBatch batch(3);
+    const HudQuad extra[2] = {{0, 0, 1, 1, 0, 0, 0, 1}, {1, 1, 2, 2, 0, 0, 0, 1}};
+    batch.Fill(0.0f, 0.0f, 1.0f, 1.0f, kRed);
+    batch.Append(extra, 2, 100.0f, 200.0f);
+    batch.Fill(0.0f, 0.0f, 1.0f, 1.0f, kRed);
+    EXPECT_EQ(batch.Size(), 3u);
+    EXPECT_EQ(batch.Dropped(), 1u);
+    ExpectQuad(batch.Data()[2], 101.0f, 201.0f, 102.0f, 202.0f);
+
+    batch.Clear();
+    EXPECT_EQ(batch.Size(), 0u);
+    EXPECT_EQ(batch.Dropped(), 0u);
+    EXPECT_EQ(batch.Capacity(), 3u);
+}
+
+TEST(HudBatchTest, ImageQuadsMergeRunsAndRepeatedRows)
+{
+    // 6x4 image: rows 0-1 are identical (two runs), row 2 is white, row 3
+    // has one run reaching the right edge.
+    const std::vector<uint32_t> pixels = {
+        kBlack, kBlack, kWhite, kWhite, kBlack, kWhite, //
+        kBlack, kBlack, kWhite, kWhite, kBlack, kWhite, //
+        kWhite, kWhite, kWhite, kWhite, kWhite, kWhite, //
+        kWhite, kWhite, kWhite, kBlack, kBlack, kBlack, //
+    };
+    HudQuad quads[8];
+    const size_t count = hud_batch::detail::BuildImageQuads(pixels.data(), 6, 4, kRed, quads, 8);
+    ASSERT_EQ(count, 3u);
+    ExpectQuad(quads[0], 0.0f, 0.0f, 2.0f, 2.0f);
+    ExpectQuad(quads[1], 4.0f, 0.0f, 5.0f, 2.0f);
+    ExpectQuad(quads[2], 3.0f, 3.0f, 6.0f, 4.0f);
+}
+
+TEST(HudBatchTest, ImageQuadsCoverEveryDarkPixelOnce)
+{
+    // A checker of 3x3-pixel "modules", as RasterizeQr would produce.
+    constexpr int kModules = 7;
+    constexpr int kScale = 3;
+    constexpr int kSize = kModules * kScale;
+    std::vector<uint32_t> pixels(kSize * kSize);
+    for (int y = 0; y < kSize; ++y)
+        for (int x = 0; x < kSize; ++x)
+            pixels[y * kSize + x] = ((x / kScale + y / kScale) % 2) ? kWhite : kBlack;
+
+    std::vector<HudQuad> quads(256);
+    const size_t count = hud_batch::detail::BuildImageQuads(pixels.data(), kSize, kSize, kRed, quads.data(),
+                                                            quads.size());
+    // One quad per dark module: 25 of the 49.
+    EXPECT_EQ(count, 25u);
+
+    std::vector<int> covered(kSize * kSize, 0);
+    for (size_t i = 0; i < count; ++i)
+        for (int y = static_cast<int>(quads[i].top); y < static_cast<int>(quads[i].bottom); ++y)
+            for (int x = static_cast<int>(quads[i].left); x < static_cast<int>(quads[i].right); ++x)
+                ++covered[y * kSize + x];
+    for (int i = 0; i < kSize * kSize; ++i)
+        EXPECT_EQ(covered[i], pixels[i] == kBlack ? 1 : 0) << "pixel " << i;
+}
+
+TEST(HudBatchTest, ImageQuadsStopAtLimit)
+{
+    const std::vector<uint32_t> pixels = {kBlack, kWhite, kBlack, kWhite, kBlack};
+    HudQuad quads[2];
+    EXPECT_EQ(hud_batch::detail::BuildImageQuads(pixels.data(), 5, 1, kRed, quads, 2), 2u);
+    EXPECT_EQ(hud_batch::detail::BuildImageQuads(nullptr, 5, 1, kRed, quads, 2), 0u);
+}
@@ -0,0 +1,79 @@
+// Unit tests for RedrawGate: full mode always renders, low-power mode only
+// renders for pending reasons and rate-limits the cube. Uses a fake 1000 Hz
+// tick clock so one tick is one millisecond.
+
+#include <windows.h>
+
+#include <gtest/gtest.h>
+
+#include "../idle_render.hpp"
+
+namespace
+{
+constexpr LONGLONG kFreq = 1000;
+}
+
+TEST(RedrawGateTest, FullModeAlwaysRendersAndAnimates)
+{
+    RedrawGate gate;
+    gate.Configure(false, 10, kFreq, 0);
+    EXPECT_EQ(gate.Poll(5), kRedrawAll);
+    EXPECT_DOUBLE_EQ(gate.BeginFrame(16), 0.016);
+    EXPECT_EQ(gate.Poll(17), kRedrawAll);
+    EXPECT_DOUBLE_EQ(gate.BeginFrame(32), 0.016);
+}
+
+TEST(RedrawGateTest, LowPowerFirstFrameThenIdle)
+{
+    RedrawGate gate;
+    gate.Configure(true, 0, kFreq, 0);
+    EXPECT_EQ(gate.Poll(1), kRedrawAll);
+    EXPECT_DOUBLE_EQ(gate.BeginFrame(1), 0.0);
+    for (LONGLONG t = 2; t < 5000; t += 16)
+        EXPECT_EQ(gate.Poll(t), kRedrawNone);
+}
+
+TEST(RedrawGateTest, LowPowerCubeRunsAtItsOwnRate)
+{
+    RedrawGate gate;
+    gate.Configure(true, 10, kFreq, 0); // 100 ms cube period
+    gate.Poll(0);
+    gate.BeginFrame(0);
+    EXPECT_EQ(gate.Poll(50), kRedrawNone);
+    EXPECT_EQ(gate.Poll(100), static_cast<unsigned>(kRedrawCube));
+    EXPECT_DOUBLE_EQ(gate.BeginFrame(100), 0.1);
+    EXPECT_EQ(gate.Poll(150), kRedrawNone);
+}
+
+TEST(RedrawGateTest, OverlayOnlyFramesFreezeTheCube)
+{
+    RedrawGate gate;
+    gate.Configure(true, 10, kFreq, 0);
+    gate.Poll(0);
+    gate.BeginFrame(0);
+    gate.Invalidate(kRedrawInput);
+    EXPECT_EQ(gate.Poll(40), static_cast<unsigned>(kRedrawInput));
+    EXPECT_DOUBLE_EQ(gate.BeginFrame(40), 0.0);
+    // Next cube frame still advances by the full time since the last one.
+    EXPECT_EQ(gate.Poll(100), static_cast<unsigned>(kRedrawCube));
+    EXPECT_DOUBLE_EQ(gate.BeginFrame(100), 0.1);
+}
+
+TEST(RedrawGateTest, MeterThreshold)
+{
+    RedrawGate gate;
+    gate.Configure(true, 0, kFreq, 0);
+    gate.Poll(0);
+    gate.BeginFrame(0);
+
+    gate.ObserveMeterLevel(RedrawGate::kMeterThreshold * 0.5f);
+    EXPECT_EQ(gate.Poll(1), kRedrawNone);
+    gate.ObserveMeterLevel(0.5f);
+    EXPECT_EQ(gate.Poll(2), static_cast<unsigned>(kRedrawMeter));
+    gate.BeginFrame(2);
+    // Compared against the level that was drawn, not the previous sample.
+    gate.ObserveMeterLevel(0.51f);
+    EXPECT_EQ(gate.Poll(3), kRedrawNone);
+    gate.ObserveMeterLevel(0.45f);
+    EXPECT_EQ(gate.Poll(4), static_cast<unsigned>(kRedrawMeter));
+}
@@ -0,0 +1,164 @@
+// Unit tests for InputLatencyProbe: a keystroke completes at the refresh
+// that showed its present, later presents and missing statistics give the
+// documented bounds, and keystrokes stay in order through failed presents
+// and overflow.
+
+#include <gtest/gtest.h>
+
+#include <array>
+
+#include "../frame_pacer.hpp"
+#include "../input_latency.hpp"
+
+namespace
+{
+
+LONGLONG Ms(double ms)
+{
+    return static_cast<LONGLONG>(ms * static_cast<double>(FramePacer::Frequency()) / 1000.0);
+}
+
+PresentStatistics Stats(UINT present_count, UINT present_refresh, UINT sync_refresh, LONGLONG sync_qpc)
+{
+    PresentStatistics stats;
+    stats.present_count = present_count;
+    stats.present_refresh_count = present_refresh;
+    stats.sync_refresh_count = sync_refresh;
+    stats.sync_qpc = sync_qpc;
+    return stats;
+}
+
+// One keystroke handled at `at`, drawn in `frame` and presented 2 ms later.
+void TypeAndPresent(InputLatencyProbe& probe, LONGLONG at, uint64_t frame, UINT present_id)
+{
+    probe.OnInput(at, 5);
+    probe.OnDrawn(frame);
+    probe.OnPresented(present_id, at + Ms(2.0));
+}
+
+} // namespace
+
+TEST(InputLatencyTest, CompletesAtTheRefreshThatShowedItsPresent)
+{
+    InputLatencyProbe probe;
+    const LONGLONG t0 = Ms(1000.0);
+    TypeAndPresent(probe, t0, 10, 100);
+    EXPECT_TRUE(probe.AwaitingDisplay());
+
+    // The previous present is still the latest on screen.
+    probe.OnFrameStatistics(Stats(99, 50, 50, t0 + Ms(1.0)), t0 + Ms(3.0));
+    EXPECT_EQ(probe.Completed(), 0u);
+
+    probe.OnFrameStatistics(Stats(100, 51, 51, t0 + Ms(10.0)), t0 + Ms(20.0));
+    ASSERT_EQ(probe.Completed(), 1u);
+    EXPECT_FALSE(probe.AwaitingDisplay());
+    const KeystrokeLatency& key = probe.Last();
+    EXPECT_EQ(key.sequence, 1u);
+    EXPECT_EQ(key.frame, 10u);
+    EXPECT_EQ(key.source, LatencySource::FrameStatistics);
+    EXPECT_NEAR(key.queue_ms, 5.0f, 1e-3f);
+    EXPECT_NEAR(key.render_ms, 2.0f, 0.01f);
+    EXPECT_NEAR(key.display_ms, 10.0f, 0.01f);
+    EXPECT_NEAR(key.total_ms, 15.0f, 0.01f);
+}
+
+TEST(InputLatencyTest, SyncSampleIsWoundBackToThePresentRefresh)
+{
+    using input_latency::detail::PresentShownQpc;
+    bool exact = false;
+    EXPECT_EQ(PresentShownQpc(Stats(7, 40, 40, 5000), 0.0, exact), 5000);
+    EXPECT_TRUE(exact);
+    // Sampled two refreshes after the present was first shown.
+    EXPECT_EQ(PresentShownQpc(Stats(7, 40, 42, 5000), 1000.0, exact), 3000);
+    EXPECT_TRUE(exact);
+    EXPECT_EQ(PresentShownQpc(Stats(7, 40, 42, 5000), 0.0, exact), 5000);
+    EXPECT_FALSE(exact);
+
+    // The probe learns the period from consecutive samples.
+    InputLatencyProbe probe;
+    const LONGLONG t0 = Ms(1000.0);
+    probe.OnFrameStatistics(Stats(1, 10, 10, t0), t0);
+    probe.OnFrameStatistics(Stats(2, 11, 11, t0 + Ms(16.0)), t0 + Ms(16.0));
+    TypeAndPresent(probe, t0 + Ms(17.0), 3, 3);
+    probe.OnFrameStatistics(Stats(3, 12, 14, t0 + Ms(64.0)), t0 + Ms(64.0));
+    ASSERT_EQ(probe.Completed(), 1u);
+    EXPECT_EQ(probe.Last().source, LatencySource::FrameStatistics);
+    EXPECT_NEAR(probe.Last().display_ms, 15.0f, 0.05f); // shown at t0 + 32 ms
+}
+
+TEST(InputLatencyTest, LaterPresentsAndMissingStatisticsGiveBounds)
+{
+    const LONGLONG t0 = Ms(1000.0);
+    {
+        // Statistics already moved past this present: an upper bound.
+        InputLatencyProbe probe;
+        TypeAndPresent(probe, t0, 1, 5);
+        probe.OnFrameStatistics(Stats(7, 30, 30, t0 + Ms(40.0)), t0 + Ms(41.0));
+        ASSERT_EQ(probe.Completed(), 1u);
+        EXPECT_EQ(probe.Last().source, LatencySource::LaterRefresh);
+        EXPECT_NEAR(probe.Last().display_ms, 40.0f, 0.01f);
+    }
+    {
+        // DISJOINT: wait out the timeout, then fall back to Present return.
+        InputLatencyProbe probe;
+        TypeAndPresent(probe, t0, 1, 5);
+        probe.OnStatisticsUnavailable(t0 + Ms(100.0), true);
+        EXPECT_EQ(probe.Completed(), 0u);
+        probe.OnStatisticsUnavailable(t0 + Ms(3.0 + InputLatencyProbe::kStatisticsTimeoutMs), true);
+        ASSERT_EQ(probe.Completed(), 1u);
+        EXPECT_EQ(probe.Last().source, LatencySource::PresentReturn);
+        EXPECT_NEAR(probe.Last().display_ms, 2.0f, 0.01f);
+    }
+    {
+        // No statistics at all (blt model in a window): complete right away.
+        InputLatencyProbe probe;
+        TypeAndPresent(probe, t0, 1, 5);
+        probe.OnStatisticsUnavailable(t0 + Ms(3.0), false);
+        ASSERT_EQ(probe.Completed(), 1u);
+        EXPECT_EQ(probe.Last().source, LatencySource::PresentReturn);
+    }
+    {
+        // Statistics that never reach the present (occluded window) time out too.
+        InputLatencyProbe probe;
+        TypeAndPresent(probe, t0, 1, 5);
+        probe.OnFrameStatistics(Stats(4, 30, 30, t0), t0 + Ms(3.0 + InputLatencyProbe::kStatisticsTimeoutMs));
+        ASSERT_EQ(probe.Completed(), 1u);
+        EXPECT_EQ(probe.Last().source, LatencySource::PresentReturn);
+    }
+}
+
+TEST(InputLatencyTest, KeystrokesStayInOrderThroughFailuresAndOverflow)
+{
+    InputLatencyProbe probe;
+    const LONGLONG t0 = Ms(1000.0);
+    probe.OnInput(t0, 0);
+    probe.OnInput(t0 + Ms(1.0), 0);
+    probe.OnDrawn(1);
+    // Device lost before Present: redrawn by the next frame instead.
+    probe.OnPresentFailed();
+    probe.OnDrawn(2);
+    probe.OnPresented(9, t0 + Ms(5.0));
+    probe.OnInput(t0 + Ms(6.0), 0); // not drawn yet
+    probe.OnFrameStatistics(Stats(9, 3, 3, t0 + Ms(8.0)), t0 + Ms(9.0));
+    ASSERT_EQ(probe.Completed(), 2u);
+    EXPECT_FALSE(probe.AwaitingDisplay());
+
+    std::array<KeystrokeLatency, 4> history{};
+    ASSERT_EQ(probe.CopyHistory(history.data(), history.size()), 2u);
+    EXPECT_EQ(history[0].sequence, 1u);
+    EXPECT_EQ(history[0].frame, 2u);
+    EXPECT_NEAR(history[0].display_ms, 8.0f, 0.01f);
+    EXPECT_EQ(history[1].sequence, 2u);
+    EXPECT_NEAR(history[1].display_ms, 7.0f, 0.01f);
+    EXPECT_NEAR(probe.Summarize().max_ms, 8.0f, 0.01f);
+
+    // The third keystroke is still waiting, so overflow drops it first.
+    for (size_t i = 0; i < InputLatencyProbe::kMaxInFlight; ++i)
+        probe.OnInput(t0 + Ms(10.0), 0);
+    EXPECT_EQ(probe.Dropped(), 1u);
+    probe.OnDrawn(3);
+    probe.OnPresented(10, t0 + Ms(11.0));
+    probe.OnStatisticsUnavailable(t0 + Ms(12.0), false);
+    EXPECT_EQ(probe.Completed(), 2u + InputLatencyProbe::kMaxInFlight);
+    EXPECT_EQ(probe.Last().sequence, 3u + InputLatencyProbe::kMaxInFlight);
+}
@@ -0,0 +1,218 @@
+// Unit tests for LogTail: the backward tail scan returns exactly the last N
+// lines of a UTF-16LE or UTF-8 file, and Poll() picks up appended (and
+// half-written) records without rereading the file.
+
+#include <windows.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "../log_tail.hpp"
+
+namespace
+{
+
+// Appends UTF-16LE text exactly as given (no newline translation).
+void AppendUtf16(const std::filesystem::path& path, const std::wstring& text)
+{
+    std::ofstream out(path, std::ios::binary | std::ios::app);
+    for (wchar_t ch : text)
+    {
+        out.put(static_cast<char>(ch & 0xFF));
+        out.put(static_cast<char>((ch >> 8) & 0xFF));
+    }
+}
+
+void AppendBytes(const std::filesystem::path& path, const std::string& bytes)
+{
+    std::ofstream out(path, std::ios::binary | std::ios::app);
+    out << bytes;
+}
+
+std::wstring NumberedLines(int first, int last)
+{
+    std::wstring text;
+    for (int i = first; i <= last; ++i)
+        text += L"line " + std::to_wstring(i) + L"\r\n";
+    return text;
+}
+
+class LogTailFileTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        path_ = std::filesystem::temp_directory_path() /
+                ("log_tail_test_" + std::string(::testing::UnitTest::GetInstance()->current_test_info()->name()) +
+                 ".log");
+        std::filesystem::remove(path_);
+    }
+    void TearDown() override
+    {
+        std::error_code ec;
+        std::filesystem::remove(path_, ec);
+    }
+
+    std::filesystem::path path_;
+};
+
+} // namespace
+
+TEST(LogTailDetail, AppendTextSplitsAndKeepsPartial)
+{
+    std::wstring partial;
+    std::deque<std::wstring> lines;
+    EXPECT_EQ(log_tail::detail::AppendText(L"a\r\nb\nc", 6, partial, lines, 10), 2u);
+    ASSERT_EQ(lines.size(), 2u);
+    EXPECT_EQ(lines[0], L"a");
+    EXPECT_EQ(lines[1], L"b");
+    EXPECT_EQ(partial, L"c");
+
+    // "\r" and "\n" arriving in separate reads.
+    EXPECT_EQ(log_tail::detail::AppendText(L"d\r", 2, partial, lines, 10), 0u);
+    EXPECT_EQ(log_tail::detail::AppendText(L"\n", 1, partial, lines, 10), 1u);
+    EXPECT_EQ(lines.back(), L"cd");
+    EXPECT_TRUE(partial.empty());
+}
+
+TEST(LogTailDetail, AppendTextKeepsOnlyMaxLines)
+{
+    std::wstring partial;
+    std::deque<std::wstring> lines;
+    const std::wstring text = NumberedLines(1, 50);
+    log_tail::detail::AppendText(text.data(), text.size(), partial, lines, 3);
+    ASSERT_EQ(lines.size(), 3u);
+    EXPECT_EQ(lines.front(), L"line 48");
+    EXPECT_EQ(lines.back(), L"line 50");
+}
+
+TEST(LogTailDetail, TailStartFindsLastLines)
+{
+    const std::wstring text = L"one\ntwo\nthree\n";
+    EXPECT_EQ(text.substr(log_tail::detail::TailStart(text.data(), text.size(), 2, true)), L"two\nthree\n");
+    EXPECT_EQ(log_tail::detail::TailStart(text.data(), text.size(), 5, true), 0u);
+    EXPECT_EQ(log_tail::detail::TailStart(text.data(), text.size(), 0, true), text.size());
+
+    // Unterminated fragment is not a line but is kept after the tail.
+    const std::wstring partial = L"one\ntwo\nthr";
+    EXPECT_EQ(partial.substr(log_tail::detail::TailStart(partial.data(), partial.size(), 1, true)), L"two\nthr");
+}
+
+TEST(LogTailDetail, TailStartDropsLeadingFragmentMidFile)
+{
+    const std::wstring text = L"ial line\nfull\n";
+    EXPECT_EQ(text.substr(log_tail::detail::TailStart(text.data(), text.size(), 5, false)), L"full\n");
+    EXPECT_EQ(text.substr(log_tail::detail::TailStart(text.data(), text.size(), 5, true)), text);
+}
+
+TEST_F(LogTailFileTest, MissingFileFailsToOpen)
+{
+    LogTail tail;
+    EXPECT_FALSE(tail.Open(path_.wstring()));
+    EXPECT_FALSE(tail.IsOpen());
+    EXPECT_TRUE(tail.Lines().empty());
+}
+
+TEST_F(LogTailFileTest, ReadsLastLinesAndSkipsBom)
+{
+    AppendUtf16(path_, std::wstring(1, wchar_t{0xFEFF}) + NumberedLines(1, 5));
+    LogTail tail(10);
+    ASSERT_TRUE(tail.Open(path_.wstring()));
+    ASSERT_EQ(tail.Lines().size(), 5u);
+    EXPECT_EQ(tail.Lines().front(), L"line 1");
+    EXPECT_EQ(tail.Text(), L"line 1\nline 2\nline 3\nline 4\nline 5\n");
+}
+
+TEST_F(LogTailFileTest, LargeFileReturnsExactTailAcrossChunks)
+{
+    // ~2.4 MB, spanning many kChunkBytes chunks and beyond kMaxTailBytes.
+    AppendUtf16(path_, std::wstring(1, wchar_t{0xFEFF}) + NumberedLines(1, 100000));
+    LogTail tail;
+    ASSERT_TRUE(tail.Open(path_.wstring()));
+    ASSERT_EQ(tail.Lines().size(), LogTail::kDefaultMaxLines);
+    EXPECT_EQ(tail.Lines().front(), L"line 99901");
+    EXPECT_EQ(tail.Lines().back(), L"line 100000");
+}
+
+TEST_F(LogTailFileTest, PollReadsOnlyAppendedLines)
+{
+    AppendUtf16(path_, NumberedLines(1, 3));
+    LogTail tail(3);
+    ASSERT_TRUE(tail.Open(path_.wstring()));
+    EXPECT_FALSE(tail.Poll());
+
+    AppendUtf16(path_, L"line 4\r\nline ");
+    EXPECT_TRUE(tail.Poll());
+    EXPECT_EQ(tail.Lines().front(), L"line 2");
+    EXPECT_EQ(tail.Lines().back(), L"line 4");
+
+    // The half-written record appears once its newline is written.
+    EXPECT_FALSE(tail.Poll());
+    AppendUtf16(path_, L"5\r\n");
+    EXPECT_TRUE(tail.Poll());
+    EXPECT_EQ(tail.Lines().back(), L"line 5");
+    EXPECT_EQ(tail.Lines().size(), 3u);
+}
+
+TEST_F(LogTailFileTest, PollReloadsAfterTruncation)
+{
+    AppendUtf16(path_, NumberedLines(1, 20));
+    LogTail tail(5);
+    ASSERT_TRUE(tail.Open(path_.wstring()));
+    EXPECT_EQ(tail.Lines().back(), L"line 20");
+
+    std::filesystem::resize_file(path_, 0);
+    AppendUtf16(path_, L"fresh\r\n");
+    EXPECT_TRUE(tail.Poll());
+    ASSERT_EQ(tail.Lines().size(), 1u);
+    EXPECT_EQ(tail.Lines().front(), L"fresh");
+}
+
+TEST(LogTailDetail, Utf8LinesAreDecoded)
+{
+    std::string partial;
+    std::deque<std::wstring> lines;
+    // "caf\u00e9" with the two-byte sequence split across reads.
+    EXPECT_EQ(log_tail::detail::AppendText("1 caf\xC3", 6, partial, lines, 10), 0u);
+    EXPECT_EQ(log_tail::detail::AppendText("\xA9\n2 x\n", 6, partial, lines, 10), 2u);
+    ASSERT_EQ(lines.size(), 2u);
+    EXPECT_EQ(lines[0], L"1 caf\u00e9");
+    EXPECT_EQ(lines[1], L"2 x");
+    EXPECT_TRUE(partial.empty());
+}
+
+TEST_F(LogTailFileTest, ReadsUtf8Log)
+{
+    std::string text;
+    for (int i = 1; i <= 300; ++i)
+        text += "1760000000000 record " + std::to_string(i) + "\n";
+    AppendBytes(path_, text);
+
+    LogTail tail(10);
+    ASSERT_TRUE(tail.Open(path_.wstring()));
+    ASSERT_EQ(tail.Lines().size(), 10u);
+    EXPECT_EQ(tail.Lines().front(), L"1760000000000 record 291");
+    EXPECT_EQ(tail.Lines().back(), L"1760000000000 record 300");
+
+    AppendBytes(path_, "1760000000001 record \xE2\x9C\x93\n");
+    EXPECT_TRUE(tail.Poll());
+    EXPECT_EQ(tail.Lines().back(), L"1760000000001 record \u2713");
+}
+
+TEST_F(LogTailFileTest, EmptyFileIsClassifiedWhenDataArrives)
+{
+    AppendBytes(path_, "");
+    LogTail tail;
+    ASSERT_TRUE(tail.Open(path_.wstring()));
+    EXPECT_TRUE(tail.Lines().empty());
+
+    AppendUtf16(path_, std::wstring(1, wchar_t{0xFEFF}) + L"first\r\n");
+    EXPECT_TRUE(tail.Poll());
+    ASSERT_EQ(tail.Lines().size(), 1u);
+    EXPECT_EQ(tail.Lines().front(), L"first");
+}
@@ -4,6 +4,7 @@
 #include <filesystem>
 #include <fstream>
 #include <gtest/gtest.h>
+#include <iterator>
 #include <string>
 #include <thread>
 #include <vector>
@@ -17,6 +18,9 @@ extern void LogSEH(const wchar_t* message);
 extern std::wstring g_logPath;
 extern FILE* g_log_file;
 
+// LoggerOptions / FlushLogger / CloseLogger for the async-mode suite below.
+#include "../log_manager.hpp"
+
 // Helper function to get the log file path
 std::wstring GetLogFilePath()
 {
@@ -385,4 +389,238 @@ TEST_F(LoggingTest, MultipleInitLoggerCallsAreSafe)
         }
     }
     EXPECT_TRUE(found);
-}
\ No newline at end of file
+}
+// ---------------------------------------------------------------------------
+// Async write mode — records go through the lock-free ring and the writer
+// thread; FlushLogger() / CloseLogger() must drain them synchronously.
+// ---------------------------------------------------------------------------
+
+class AsyncLoggingTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        ClearLogFile();
+        LoggerOptions options;
+        options.mode = LogWriteMode::Async;
+        // Long interval so the tests observe the explicit drains, not the timer.
+        options.flush_interval_ms = 60000;
+        InitLogger(options);
+    }
+
+    void TearDown() override
+    {
+        // Leave the logger in the default synchronous mode for other suites.
+        InitLogger();
+    }
+
+    static bool Contains(const std::vector<std::wstring>& lines, const std::wstring& needle)
+    {
+        for (const auto& line : lines)
+        {
+            if (line.find(needle) != std::wstring::npos)
+                return true;
+        }
+        return false;
+    }
+};
+
+TEST_F(AsyncLoggingTest, FlushLoggerDrainsQueuedRecords)
+{
+    Log(L"async record one");
+    Log(L"async record two");
+    FlushLogger();
+
+    auto lines = ReadLastLogLines(10);
+    EXPECT_TRUE(Contains(lines, L"async record one"));
+    EXPECT_TRUE(Contains(lines, L"async record two"));
+}
+
+TEST_F(AsyncLoggingTest, LogSEHIsWrittenBeforeReturning)
+{
+    LogSEH(L"SEH: async drain check");
+
+    auto lines = ReadLastLogLines(10);
+    EXPECT_TRUE(Contains(lines, L"SEH: async drain check"));
+}
+
+TEST_F(AsyncLoggingTest, OversizedRecordFallsBackInOrder)
+{
+    Log(L"before oversized");
+    Log(L"oversized: " + std::wstring(4000, L'B'));
+    Log(L"after oversized");
+    FlushLogger();
+
+    auto lines = ReadLastLogLines(10);
+    ASSERT_GE(lines.size(), 3u);
+    const size_t n = lines.size();
+    EXPECT_NE(lines[n - 3].find(L"before oversized"), std::wstring::npos);
+    EXPECT_NE(lines[n - 2].find(L"oversized: BBBB"), std::wstring::npos);
+    EXPECT_NE(lines[n - 1].find(L"after oversized"), std::wstring::npos);
+}
+
+TEST_F(AsyncLoggingTest, ConcurrentProducersLoseNothing)
+{
+    const int num_threads = 8;
+    const int messages_per_thread = 500; // 4000 records: more than one lap of the ring
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_threads; ++i)
+    {
+        threads.emplace_back(
+            [i, messages_per_thread]()
+            {
+                for (int j = 0; j < messages_per_thread; ++j)
+                    Log(L"producer " + std::to_wstring(i) + L" seq " + std::to_wstring(j));
+            });
+    }
+    for (auto& t : threads)
+        t.join();
+    FlushLogger();
+
+    auto lines = ReadLastLogLines(num_threads * messages_per_thread + 10);
+    int count = 0;
+    for (const auto& line : lines)
+    {
+        if (line.find(L"producer ") != std::wstring::npos)
+            ++count;
+    }
+    EXPECT_EQ(count, num_threads * messages_per_thread);
+}
+
+TEST_F(AsyncLoggingTest, CloseLoggerDrainsPendingRecords)
+{
+    Log(L"written at close");
+    CloseLogger();
+
+    auto lines = ReadLastLogLines(10);
+    EXPECT_TRUE(Contains(lines, L"written at close"));
+}
+
+// ---------------------------------------------------------------------------
+// Compact UTF-8 format and rotation. The logger is closed around each test so
+// the files can be deleted and renamed, then restored to the default.
+// ---------------------------------------------------------------------------
+
+TEST(LogManagerDetail, RotatedLogPathInsertsIndexBeforeExtension)
+{
+    using log_manager::detail::RotatedLogPath;
+    EXPECT_EQ(RotatedLogPath(L"C:\\logs\\debug.log", 1), L"C:\\logs\\debug.1.log");
+    EXPECT_EQ(RotatedLogPath(L"C:\\logs\\debug.log", 12), L"C:\\logs\\debug.12.log");
+    EXPECT_EQ(RotatedLogPath(L"C:\\my.logs\\debug", 2), L"C:\\my.logs\\debug.2");
+}
+
+class LogRotationTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        CloseLogger();
+        ClearLogFile();
+        RemoveRotatedFiles();
+    }
+
+    void TearDown() override
+    {
+        CloseLogger();
+        RemoveRotatedFiles();
+        ClearLogFile();
+        InitLogger();
+    }
+
+    static void RemoveRotatedFiles()
+    {
+        for (unsigned i = 1; i <= 5; ++i)
+            DeleteFileW(log_manager::detail::RotatedLogPath(GetLogFilePath(), i).c_str());
+    }
+
+    static bool Exists(unsigned index)
+    {
+        return std::filesystem::exists(log_manager::detail::RotatedLogPath(GetLogFilePath(), index));
+    }
+
+    static std::string ReadBytes(const std::wstring& path)
+    {
+        std::ifstream in(std::filesystem::path(path), std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+};
+
+TEST_F(LogRotationTest, Utf8RecordsUseIntegerTimestamps)
+{
+    LoggerOptions options;
+    options.format = LogFormat::Utf8;
+    InitLogger(options);
+    Log(L"compact record \u00e9");
+    FlushLogger();
+
+    const std::string bytes = ReadBytes(GetLogFilePath());
+    ASSERT_FALSE(bytes.empty());
+    EXPECT_NE(static_cast<unsigned char>(bytes[0]), 0xFF) << "no UTF-16 BOM in UTF-8 mode";
+
+    const size_t record = bytes.find("compact record \xC3\xA9\n");
+    ASSERT_NE(record, std::string::npos);
+    const size_t line_start = bytes.rfind('\n', record) == std::string::npos ? 0 : bytes.rfind('\n', record) + 1;
+    const std::string stamp = bytes.substr(line_start, record - line_start);
+    ASSERT_GE(stamp.size(), 14u); // 13-digit Unix milliseconds + space
+    EXPECT_EQ(stamp.back(), ' ');
+    for (size_t i = 0; i + 1 < stamp.size(); ++i)
+        EXPECT_TRUE(stamp[i] >= '0' && stamp[i] <= '9') << stamp;
+}
+
+TEST_F(LogRotationTest, SwitchingFormatRotatesExistingLog)
+{
+    InitLogger();
+    Log(L"utf16 record");
+    CloseLogger();
+
+    LoggerOptions options;
+    options.format = LogFormat::Utf8;
+    InitLogger(options);
+    Log(L"utf8 record");
+    FlushLogger();
+
+    ASSERT_TRUE(Exists(1));
+    const std::string old_bytes = ReadBytes(log_manager::detail::RotatedLogPath(GetLogFilePath(), 1));
+    ASSERT_GE(old_bytes.size(), 2u);
+    EXPECT_EQ(static_cast<unsigned char>(old_bytes[0]), 0xFF);
+    EXPECT_EQ(static_cast<unsigned char>(old_bytes[1]), 0xFE);
+    EXPECT_NE(ReadBytes(GetLogFilePath()).find("utf8 record"), std::string::npos);
+}
+
+TEST_F(LogRotationTest, SizeRotationKeepsBoundedFiles)
+{
+    LoggerOptions options;
+    options.rotate_bytes = 4096;
+    options.keep_files = 2;
+    InitLogger(options);
+    for (int i = 0; i < 500; ++i)
+        Log(L"rotation filler record " + std::to_wstring(i));
+    FlushLogger();
+
+    EXPECT_GE(GetLogRotationCount(), 3u);
+    EXPECT_TRUE(Exists(1));
+    EXPECT_TRUE(Exists(2));
+    EXPECT_FALSE(Exists(3));
+    EXPECT_LT(std::filesystem::file_size(GetLogFilePath()), 4096u + 256u);
+
+    // The newest records are in the live file, in UTF-16 with a BOM.
+    auto lines = ReadLastLogLines(1);
+    ASSERT_EQ(lines.size(), 1u);
+    EXPECT_NE(lines[0].find(L"rotation filler record 499"), std::wstring::npos);
+}
+
+TEST_F(LogRotationTest, KeepZeroRestartsTheFile)
+{
+    LoggerOptions options;
+    options.format = LogFormat::Utf8;
+    options.rotate_bytes = 2048;
+    options.keep_files = 0;
+    InitLogger(options);
+    for (int i = 0; i < 500; ++i)
+        Log(L"restart filler record " + std::to_wstring(i));
+    FlushLogger();
+
+    EXPECT_GE(GetLogRotationCount(), 1u);
+    EXPECT_FALSE(Exists(1));
+    EXPECT_LT(std::filesystem::file_size(GetLogFilePath()), 2048u + 128u);
+}
@@ -0,0 +1,154 @@
+// Unit tests for MetricsExport: the segment is reachable by name from
+// another mapping (as a monitoring agent would open it), the header is
+// valid, and seqlock readers never observe a torn section.
+
+#include <windows.h>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <thread>
+
+#include "../metrics_export.hpp"
+
+namespace
+{
+
+std::wstring TestSegmentName()
+{
+    return L"Local\\CloudStreamingArgsDebugger.MetricsTest." + std::to_wstring(GetCurrentProcessId());
+}
+
+template <typename T> T ReadSection(const std::atomic<uint32_t>& sequence, const T& src)
+{
+    T out{};
+    while (!metrics_export::detail::SeqlockRead(sequence, src, out))
+        std::this_thread::yield();
+    return out;
+}
+
+} // namespace
+
+TEST(MetricsExport, LayoutKeepsWritersOnSeparateCacheLines)
+{
+    EXPECT_EQ(offsetof(MetricsBlock, frame_sequence) % 64, 0u);
+    EXPECT_EQ(offsetof(MetricsBlock, audio_sequence) % 64, 0u);
+    EXPECT_EQ(offsetof(MetricsBlock, input_sequence) % 64, 0u);
+    EXPECT_GE(offsetof(MetricsBlock, audio_sequence) - offsetof(MetricsBlock, frame_sequence), 64u);
+    EXPECT_GE(offsetof(MetricsBlock, input_sequence) - offsetof(MetricsBlock, audio_sequence), 64u);
+}
+
+TEST(MetricsExport, DefaultNameIsPerProcess)
+{
+    EXPECT_EQ(DefaultMetricsName(1234), L"Local\\CloudStreamingArgsDebugger.Metrics.1234");
+}
+
+TEST(MetricsExport, AgentSeesHeaderAndPublishedSections)
+{
+    MetricsExport metrics;
+    ASSERT_TRUE(metrics.Create(TestSegmentName()));
+    ASSERT_TRUE(metrics.IsOpen());
+
+    // Open a second, read-only view the way an external agent would.
+    HANDLE mapping = OpenFileMappingW(FILE_MAP_READ, FALSE, TestSegmentName().c_str());
+    ASSERT_NE(mapping, nullptr);
+    const auto* view = static_cast<const MetricsBlock*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    ASSERT_NE(view, nullptr);
+
+    EXPECT_EQ(view->magic.load(), kMetricsMagic);
+    EXPECT_EQ(view->version, kMetricsVersion);
+    EXPECT_EQ(view->size, sizeof(MetricsBlock));
+    EXPECT_EQ(view->pid, GetCurrentProcessId());
+    EXPECT_GT(view->qpc_frequency, 0);
+
+    MetricsFrameSection frame{};
+    frame.frame_counter = 42;
+    frame.fps = 59.9f;
+    frame.interval = {16.6f, 17.0f, 18.0f, 25.0f};
+    frame.present_mode = static_cast<uint32_t>(MetricsPresentMode::Flip);
+    frame.working_set_bytes = 64ull << 20;
+    metrics.PublishFrame(frame);
+
+    MetricsAudioSection audio{};
+    audio.packets = 7;
+    audio.channels = 2;
+    audio.peak[1] = 0.5f;
+    metrics.PublishAudio(audio);
+
+    const MetricsFrameSection seen_frame = ReadSection(view->frame_sequence, view->frame);
+    EXPECT_EQ(seen_frame.frame_counter, 42u);
+    EXPECT_FLOAT_EQ(seen_frame.interval.p99_ms, 18.0f);
+    EXPECT_EQ(seen_frame.present_mode, static_cast<uint32_t>(MetricsPresentMode::Flip));
+    EXPECT_EQ(seen_frame.working_set_bytes, 64ull << 20);
+    EXPECT_EQ(view->frame_sequence.load() % 2, 0u);
+
+    const MetricsAudioSection seen_audio = ReadSection(view->audio_sequence, view->audio);
+    EXPECT_EQ(seen_audio.packets, 7u);
+    EXPECT_FLOAT_EQ(seen_audio.peak[1], 0.5f);
+
+    MetricsInputSection input{};
+    input.completed = 18;
+    input.recent[1].sequence = 20;
+    input.recent[1].total_ms = 33.5f;
+    metrics.PublishInput(input);
+    const MetricsInputSection seen_input = ReadSection(view->input_sequence, view->input);
+    EXPECT_EQ(seen_input.completed, 18u);
+    EXPECT_EQ(seen_input.recent[1].sequence, 20u);
+    EXPECT_FLOAT_EQ(seen_input.recent[1].total_ms, 33.5f);
+
+    // Close() invalidates the header for readers still mapping it.
+    metrics.Close();
+    EXPECT_EQ(view->magic.load(), 0u);
+
+    UnmapViewOfFile(view);
+    CloseHandle(mapping);
+}
+
+TEST(MetricsExport, PublishWithoutSegmentIsNoOp)
+{
+    MetricsExport metrics;
+    EXPECT_FALSE(metrics.IsOpen());
+    metrics.PublishFrame(MetricsFrameSection{});
+    metrics.PublishAudio(MetricsAudioSection{});
+    metrics.PublishInput(MetricsInputSection{});
+    EXPECT_EQ(metrics.Block(), nullptr);
+}
+
+TEST(MetricsExportSeqlock, ReaderNeverSeesTornSection)
+{
+    // Every field of the section carries the same counter; a torn read
+    // would mix two values.
+    struct Section
+    {
+        uint64_t values[16];
+    };
+    std::atomic<uint32_t> sequence{0};
+    Section shared{};
+    std::atomic<bool> stop{false};
+
+    std::thread writer(
+        [&]
+        {
+            Section next{};
+            for (uint64_t i = 1; !stop.load(std::memory_order_relaxed); ++i)
+            {
+                for (auto& v : next.values)
+                    v = i;
+                metrics_export::detail::SeqlockWrite(sequence, shared, next);
+            }
+        });
+
+    uint64_t last = 0;
+    for (int i = 0; i < 20000; ++i)
+    {
+        const Section seen = ReadSection(sequence, shared);
+        for (uint64_t v : seen.values)
+            ASSERT_EQ(v, seen.values[0]);
+        ASSERT_GE(seen.values[0], last);
+        last = seen.values[0];
+    }
+    stop.store(true);
+    writer.join();
+}
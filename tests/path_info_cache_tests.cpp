@@ -0,0 +1,118 @@
+// Unit tests for PathInfoCache: the startup prefetch, refreshes that are
+// coalesced and published as new snapshots, and inline collection without a
+// worker thread. A fake collector stands in for path_info::Collect().
+
+#include <windows.h>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../path_info_cache.hpp"
+
+namespace
+{
+
+// Polls until a snapshot is adopted that is not busy any more.
+bool WaitForIdle(PathInfoCache& cache)
+{
+    for (int i = 0; i < 500; ++i)
+    {
+        cache.Poll();
+        if (!cache.Busy() && cache.Current())
+            return true;
+        Sleep(10);
+    }
+    return false;
+}
+
+} // namespace
+
+TEST(PathInfoCacheTest, StartPrefetchesFirstSnapshot)
+{
+    std::atomic<int> calls{0};
+    PathInfoCache cache(
+        [&calls]
+        {
+            ++calls;
+            return std::vector<PathItem>{{L"Label: ", L"value"}};
+        });
+    EXPECT_EQ(cache.Current(), nullptr);
+    ASSERT_TRUE(cache.Start());
+    ASSERT_TRUE(WaitForIdle(cache));
+
+    const PathSnapshot* snapshot = cache.Current();
+    EXPECT_EQ(snapshot->generation, 1u);
+    ASSERT_EQ(snapshot->items.size(), 1u);
+    ASSERT_EQ(snapshot->lines.size(), 1u);
+    EXPECT_EQ(snapshot->lines[0], L"Label: value");
+    EXPECT_EQ(calls.load(), 1);
+}
+
+TEST(PathInfoCacheTest, RefreshPublishesNewSnapshot)
+{
+    std::atomic<int> calls{0};
+    PathInfoCache cache(
+        [&calls]
+        {
+            const int n = ++calls;
+            return std::vector<PathItem>{{L"Call: ", std::to_wstring(n)}};
+        });
+    ASSERT_TRUE(cache.Start());
+    ASSERT_TRUE(WaitForIdle(cache));
+
+    cache.Refresh();
+    EXPECT_TRUE(cache.Busy());
+    // The previous snapshot stays readable until the new one is adopted.
+    EXPECT_EQ(cache.Current()->generation, 1u);
+    ASSERT_TRUE(WaitForIdle(cache));
+    EXPECT_EQ(cache.Current()->generation, 2u);
+    EXPECT_EQ(cache.Current()->lines[0], L"Call: 2");
+}
+
+TEST(PathInfoCacheTest, RefreshesAreCoalesced)
+{
+    std::atomic<int> calls{0};
+    PathInfoCache cache(
+        [&calls]
+        {
+            ++calls;
+            Sleep(20);
+            return std::vector<PathItem>{};
+        });
+    ASSERT_TRUE(cache.Start());
+    for (int i = 0; i < 10; ++i)
+        cache.Refresh();
+    ASSERT_TRUE(WaitForIdle(cache));
+    EXPECT_EQ(cache.Current()->generation, 11u);
+    EXPECT_LT(calls.load(), 11);
+}
+
+TEST(PathInfoCacheTest, InlineWithoutThread)
+{
+    int calls = 0;
+    PathInfoCache cache(
+        [&calls]
+        {
+            ++calls;
+            return std::vector<PathItem>{{L"A: ", L"b"}};
+        });
+    // Never started: Refresh() collects on this thread and Poll() adopts it.
+    cache.Refresh();
+    EXPECT_EQ(calls, 1);
+    EXPECT_TRUE(cache.Poll());
+    EXPECT_FALSE(cache.Busy());
+    EXPECT_EQ(cache.Current()->lines[0], L"A: b");
+    EXPECT_FALSE(cache.Poll());
+}
+
+TEST(PathInfoCacheTest, FailedCollectionStillClearsBusy)
+{
+    PathInfoCache cache([]() -> std::vector<PathItem> { throw std::runtime_error("boom"); });
+    ASSERT_TRUE(cache.Start());
+    ASSERT_TRUE(WaitForIdle(cache));
+    EXPECT_TRUE(cache.Current()->items.empty());
+}
@@ -100,13 +100,13 @@ TEST(PathInfo, WineOrProtonReturnsSomething)
     EXPECT_FALSE(v.empty());
 }
 
-TEST(PathInfo, SaveFilePathEndsInSavedDataTxt)
+TEST(PathInfo, SaveFilePathEndsInSessionRecord)
 {
     const std::wstring p = path_info::SaveFilePath();
     ASSERT_FALSE(p.empty());
     if (p == L"Not available")
         return; // SHGetKnownFolderPath was unavailable; acceptable outcome.
-    const std::wstring suffix = L"saved_data.txt";
+    const std::wstring suffix = L"\\CloudStreamingArgsDebugger\\session.rec";
     ASSERT_GE(p.size(), suffix.size());
     EXPECT_EQ(p.substr(p.size() - suffix.size()), suffix);
 }
@@ -0,0 +1,262 @@
+// Unit tests for QrWorker: payload format and version pinning, rasterisation
+// against the original per-pixel loop, and the background handoff.
+
+#include <windows.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "../qr_worker.hpp"
+#include "qrcodegen.hpp"
+
+using qrcodegen::QrCode;
+using qrcodegen::QrSegment;
+using qr_worker::detail::BuildStampPayload;
+using qr_worker::detail::EncodePayload;
+using qr_worker::detail::kChunkBytes;
+using qr_worker::detail::MakeByteSegments;
+using qr_worker::detail::ModuleAt;
+using qr_worker::detail::ModuleEdge;
+using qr_worker::detail::RasterizeQr;
+using qr_worker::detail::SplitArgsPayload;
+using qr_worker::detail::StableMinVersion;
+
+namespace
+{
+
+// The per-pixel loop UpdateQrCode used before the span rasteriser.
+std::vector<uint32_t> ReferencePixels(const QrCode& qr, int pixel_size)
+{
+    int qr_modules = qr.getSize();
+    float scale = static_cast<float>(pixel_size) / qr_modules;
+    std::vector<uint32_t> pixels(pixel_size * pixel_size, 0xffffffff);
+    for (int y = 0; y < pixel_size; y++)
+    {
+        for (int x = 0; x < pixel_size; x++)
+        {
+            int module_x = static_cast<int>(x / scale);
+            int module_y = static_cast<int>(y / scale);
+            if (module_x < qr_modules && module_y < qr_modules && qr.getModule(module_x, module_y))
+                pixels[y * pixel_size + x] = 0xff000000;
+        }
+    }
+    return pixels;
+}
+
+// What the worker should produce for `stamp` with the given args suffix.
+std::vector<uint32_t> ExpectedPixels(const QrStamp& stamp, const std::string& args_suffix)
+{
+    const std::vector<QrSegment> args = MakeByteSegments(args_suffix);
+    return ReferencePixels(EncodePayload(stamp, args, StableMinVersion(args)), QrWorker::kPixelSize);
+}
+
+// An args suffix far beyond one version-40 symbol: 300 arguments of ~40 bytes.
+std::string OversizedArgsSuffix()
+{
+    std::string suffix = ";args=";
+    for (int i = 0; i < 300; ++i)
+        suffix += "--option-" + std::to_string(i) + "=https://example.com/path?q=1 ";
+    return suffix;
+}
+
+QrStamp MakeStamp(long long unix_time, int fps, unsigned long long frame = 1)
+{
+    QrStamp stamp;
+    stamp.unix_time = unix_time;
+    stamp.fps = fps;
+    stamp.frame = frame;
+    stamp.qpc = 1000 * static_cast<long long>(frame);
+    return stamp;
+}
+
+bool WaitForResult(const QrWorker& worker)
+{
+    for (int i = 0; i < 500 && !worker.HasResult(); ++i)
+        Sleep(10);
+    return worker.HasResult();
+}
+
+} // namespace
+
+TEST(QrWorkerPayload, StampFormat)
+{
+    QrStamp stamp;
+    stamp.unix_time = 1700000000;
+    stamp.fps = 60;
+    stamp.frame = 1234;
+    stamp.qpc = 98765432109;
+    EXPECT_EQ(BuildStampPayload(stamp), "t=1700000000;f=60;n=1234;q=98765432109");
+
+    // --latency-probe: the last measured keystroke and its latency in us.
+    stamp.key = 17;
+    stamp.key_latency_us = 24350;
+    EXPECT_EQ(BuildStampPayload(stamp), "t=1700000000;f=60;n=1234;q=98765432109;k=17;l=24350");
+}
+
+TEST(QrWorkerPayload, NoArgsMeansNoArgsSegment)
+{
+    EXPECT_TRUE(MakeByteSegments("").empty());
+    EXPECT_EQ(MakeByteSegments(";args=a ").size(), 1u);
+}
+
+TEST(QrWorkerPayload, VersionStaysFixedAsCountersGrow)
+{
+    const std::vector<QrSegment> args = MakeByteSegments(";args=--width=1920 --height=1080 ");
+    const int min_version = StableMinVersion(args);
+    QrStamp small;
+    QrStamp large;
+    large.unix_time = 1700000000;
+    large.fps = 144;
+    large.frame = 50000000;
+    large.qpc = 123456789012345;
+    EXPECT_EQ(EncodePayload(small, args, min_version).getSize(), EncodePayload(large, args, min_version).getSize());
+
+    // Pinned for the latency fields, the first measured keystroke does not
+    // resize the modules either.
+    const int probe_version = StableMinVersion(args, true);
+    EXPECT_GE(probe_version, min_version);
+    large.key = 4000000000u;
+    large.key_latency_us = 4000000000u;
+    EXPECT_EQ(EncodePayload(small, args, probe_version).getSize(), EncodePayload(large, args, probe_version).getSize());
+}
+
+TEST(QrWorkerRaster, SpanRasterMatchesReferenceAcrossVersionsAndSizes)
+{
+    // Short payloads give small versions (non-integer scale), long ones push
+    // the version up towards one pixel per module.
+    for (size_t args_len : {0u, 40u, 300u, 1200u})
+    {
+        const QrCode qr =
+            EncodePayload(MakeStamp(1700000000, 60), MakeByteSegments(";args=" + std::string(args_len, 'x')), 1);
+        for (int pixel_size : {375, 200, 97, 1000})
+        {
+            std::vector<uint32_t> pixels(7, 0x12345678); // stale contents must be overwritten
+            RasterizeQr(qr, pixel_size, pixels);
+            EXPECT_EQ(pixels, ReferencePixels(qr, pixel_size)) << "args=" << args_len << " size=" << pixel_size;
+        }
+    }
+}
+
+TEST(QrWorkerRaster, ModuleEdgesMatchPerPixelMapping)
+{
+    const int pixel_size = 375;
+    for (int modules : {21, 25, 57, 177})
+    {
+        const float scale = static_cast<float>(pixel_size) / modules;
+        for (int m = 0; m <= modules; ++m)
+        {
+            const int edge = ModuleEdge(m, pixel_size, scale);
+            if (edge < pixel_size)
+            {
+                EXPECT_GE(ModuleAt(edge, scale), m);
+            }
+            if (edge > 0)
+            {
+                EXPECT_LT(ModuleAt(edge - 1, scale), m);
+            }
+        }
+    }
+}
+
+TEST(QrWorkerTest, InlineModeWithoutThread)
+{
+    QrWorker worker;
+    worker.Request(MakeStamp(1700000000, 60));
+    ASSERT_TRUE(worker.HasResult());
+    std::vector<uint32_t> pixels;
+    ASSERT_TRUE(worker.TryTake(pixels));
+    EXPECT_EQ(pixels, ExpectedPixels(MakeStamp(1700000000, 60), ""));
+    EXPECT_FALSE(worker.TryTake(pixels));
+}
+
+TEST(QrWorkerTest, BackgroundRequestProducesSamePixels)
+{
+    QrWorker worker;
+    ASSERT_TRUE(worker.Start(";args=a b "));
+    worker.Request(MakeStamp(1700000123, 30, 7));
+    ASSERT_TRUE(WaitForResult(worker));
+    std::vector<uint32_t> pixels;
+    ASSERT_TRUE(worker.TryTake(pixels));
+    EXPECT_EQ(pixels, ExpectedPixels(MakeStamp(1700000123, 30, 7), ";args=a b "));
+    worker.Stop();
+    worker.Stop(); // idempotent
+}
+
+TEST(QrWorkerTest, BuffersAreRecycled)
+{
+    QrWorker worker;
+    ASSERT_TRUE(worker.Start(""));
+    std::vector<uint32_t> pixels;
+    for (int i = 0; i < 3; ++i)
+    {
+        worker.Request(MakeStamp(1700000000, 60, i));
+        ASSERT_TRUE(WaitForResult(worker));
+        ASSERT_TRUE(worker.TryTake(pixels));
+        EXPECT_EQ(pixels, ExpectedPixels(MakeStamp(1700000000, 60, i), ""));
+    }
+}
+
+TEST(QrWorkerChunks, FittingArgsAreNotChunked)
+{
+    EXPECT_EQ(SplitArgsPayload(""), std::vector<std::string>{""});
+    EXPECT_EQ(SplitArgsPayload(";args=a b "), std::vector<std::string>{";args=a b "});
+}
+
+TEST(QrWorkerChunks, OversizedArgsReassembleFromChunks)
+{
+    const std::string suffix = OversizedArgsSuffix();
+    const std::string body = suffix.substr(6);
+    const std::vector<std::string> chunks = SplitArgsPayload(suffix);
+    const size_t count = (body.size() + kChunkBytes - 1) / kChunkBytes;
+    ASSERT_EQ(chunks.size(), count);
+    ASSERT_GE(count, 10u);
+    ASSERT_LT(count, 100u); // two-digit indices below
+
+    char hash[17];
+    snprintf(hash, sizeof(hash), "%016llx", static_cast<unsigned long long>(qr_worker::detail::Fnv1a64(body)));
+    std::string reassembled;
+    for (size_t i = 0; i < chunks.size(); ++i)
+    {
+        const std::string index = (i < 10 ? "0" : "") + std::to_string(i);
+        const std::string header = ";h=" + std::string(hash) + ";c=" + index + "/" + std::to_string(count) + ";args=";
+        ASSERT_EQ(chunks[i].compare(0, header.size(), header), 0) << chunks[i].substr(0, header.size());
+        reassembled += chunks[i].substr(header.size());
+    }
+    EXPECT_EQ(reassembled, body);
+}
+
+TEST(QrWorkerChunks, EveryChunkFitsThePinnedVersion)
+{
+    const std::vector<std::string> chunks = SplitArgsPayload(OversizedArgsSuffix());
+    const int min_version = StableMinVersion(MakeByteSegments(chunks.front()));
+    EXPECT_LT(min_version, 40);
+    for (const std::string& chunk : chunks)
+        EXPECT_EQ(EncodePayload(MakeStamp(1700000000, 60), MakeByteSegments(chunk), min_version).getVersion(),
+                  min_version);
+}
+
+TEST(QrWorkerTest, ChunkedPayloadCyclesThroughCodes)
+{
+    const std::string suffix = OversizedArgsSuffix();
+    const std::vector<std::string> chunks = SplitArgsPayload(suffix);
+    const int min_version = StableMinVersion(MakeByteSegments(chunks.front()));
+
+    QrWorker worker;
+    ASSERT_TRUE(worker.Start(suffix));
+    EXPECT_EQ(worker.ChunkCount(), chunks.size());
+    std::vector<uint32_t> pixels;
+    for (size_t i = 0; i <= chunks.size(); ++i)
+    {
+        const QrStamp stamp = MakeStamp(1700000000, 60, i);
+        worker.Request(stamp);
+        ASSERT_TRUE(WaitForResult(worker));
+        ASSERT_TRUE(worker.TryTake(pixels));
+        const std::string& chunk = chunks[i % chunks.size()];
+        EXPECT_EQ(pixels, ReferencePixels(EncodePayload(stamp, MakeByteSegments(chunk), min_version),
+                                          QrWorker::kPixelSize));
+    }
+}
@@ -0,0 +1,185 @@
+// Unit tests for the session record: header validation, the one-pass
+// summary over a file image (including a torn trailing record), the panel
+// text, and a writer/reader round trip through a temporary file.
+
+#include <windows.h>
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "../session_record.hpp"
+
+namespace
+{
+
+SessionRecord MakeRecord(int64_t unix_ms, float fps, float p99_ms, float mic_level, uint64_t args_hash)
+{
+    SessionRecord record{};
+    record.unix_ms = unix_ms;
+    record.frame = static_cast<uint64_t>(unix_ms / 16);
+    record.args_hash = args_hash;
+    record.working_set_bytes = 64ull << 20;
+    record.fps = fps;
+    record.interval_p50_ms = 16.6f;
+    record.interval_p99_ms = p99_ms;
+    record.interval_max_ms = p99_ms * 2.f;
+    record.cpu_p99_ms = 2.f;
+    record.mic_level = mic_level;
+    return record;
+}
+
+std::vector<uint8_t> MakeImage(const std::vector<SessionRecord>& records)
+{
+    const SessionRecordHeader header = session_record::detail::MakeHeader(1000);
+    std::vector<uint8_t> image(sizeof(header) + records.size() * sizeof(SessionRecord));
+    std::memcpy(image.data(), &header, sizeof(header));
+    if (!records.empty())
+        std::memcpy(image.data() + sizeof(header), records.data(), records.size() * sizeof(SessionRecord));
+    return image;
+}
+
+std::wstring TempRecordPath()
+{
+    wchar_t dir[MAX_PATH];
+    GetTempPathW(MAX_PATH, dir);
+    return std::wstring(dir) + L"csad_session_test_" + std::to_wstring(GetCurrentProcessId()) + L".rec";
+}
+
+} // namespace
+
+TEST(SessionRecordTest, HeaderRoundTripsAndRejectsOtherFiles)
+{
+    SessionRecordHeader header = session_record::detail::MakeHeader(42);
+    EXPECT_TRUE(session_record::detail::IsValidHeader(header));
+    EXPECT_EQ(header.created_unix_ms, 42);
+
+    SessionRecordHeader other = header;
+    other.version = kSessionRecordVersion + 1;
+    EXPECT_FALSE(session_record::detail::IsValidHeader(other));
+    other = header;
+    other.record_size = 48;
+    EXPECT_FALSE(session_record::detail::IsValidHeader(other));
+    other = header;
+    other.magic[7] = '2';
+    EXPECT_FALSE(session_record::detail::IsValidHeader(other));
+}
+
+TEST(SessionRecordTest, SummarizeRejectsShortOrForeignImages)
+{
+    SessionSummary summary;
+    std::vector<uint8_t> image = MakeImage({});
+    EXPECT_FALSE(session_record::detail::Summarize(image.data(), sizeof(SessionRecordHeader) - 1, summary));
+    image[0] = 'X';
+    EXPECT_FALSE(session_record::detail::Summarize(image.data(), image.size(), summary));
+}
+
+TEST(SessionRecordTest, SummarizeAggregatesRecords)
+{
+    std::vector<SessionRecord> records = {
+        MakeRecord(1000, 60.f, 18.f, 0.2f, 7),
+        MakeRecord(61000, 30.f, 40.f, -1.f, 7),
+        MakeRecord(121000, 59.f, 20.f, 0.6f, 9),
+    };
+    records[1].flags = kSessionRecordManual;
+    records[2].working_set_bytes = 80ull << 20;
+    const std::vector<uint8_t> image = MakeImage(records);
+
+    SessionSummary summary;
+    ASSERT_TRUE(session_record::detail::Summarize(image.data(), image.size(), summary));
+    EXPECT_EQ(summary.records, 3u);
+    EXPECT_EQ(summary.manual_records, 1u);
+    EXPECT_EQ(summary.ignored_bytes, 0u);
+    EXPECT_EQ(summary.first_unix_ms, 1000);
+    EXPECT_EQ(summary.last_unix_ms, 121000);
+    EXPECT_FLOAT_EQ(summary.fps_min, 30.f);
+    EXPECT_FLOAT_EQ(summary.fps_max, 60.f);
+    EXPECT_DOUBLE_EQ(summary.fps_mean, (60.0 + 30.0 + 59.0) / 3.0);
+    EXPECT_DOUBLE_EQ(summary.interval_p99_mean_ms, (18.0 + 40.0 + 20.0) / 3.0);
+    EXPECT_FLOAT_EQ(summary.interval_p99_worst_ms, 40.f);
+    EXPECT_FLOAT_EQ(summary.interval_max_worst_ms, 80.f);
+    // The record without a microphone is left out of the level statistics.
+    EXPECT_EQ(summary.mic_records, 2u);
+    EXPECT_NEAR(summary.mic_level_mean, 0.4, 1e-6);
+    EXPECT_FLOAT_EQ(summary.mic_level_max, 0.6f);
+    EXPECT_EQ(summary.working_set_min, 64ull << 20);
+    EXPECT_EQ(summary.working_set_max, 80ull << 20);
+    EXPECT_EQ(summary.args_hash_changes, 1u);
+    EXPECT_EQ(summary.last.args_hash, 9u);
+}
+
+TEST(SessionRecordTest, SummarizeIgnoresTornTrailingRecord)
+{
+    std::vector<uint8_t> image = MakeImage({MakeRecord(1000, 60.f, 17.f, 0.1f, 1)});
+    image.resize(image.size() + sizeof(SessionRecord) / 2, 0xCD);
+
+    SessionSummary summary;
+    ASSERT_TRUE(session_record::detail::Summarize(image.data(), image.size(), summary));
+    EXPECT_EQ(summary.records, 1u);
+    EXPECT_EQ(summary.ignored_bytes, sizeof(SessionRecord) / 2);
+    EXPECT_FLOAT_EQ(summary.fps_max, 60.f);
+}
+
+TEST(SessionRecordTest, FormatSummaryDescribesRecords)
+{
+    SessionSummary empty;
+    const std::vector<uint8_t> header_only = MakeImage({});
+    ASSERT_TRUE(session_record::detail::Summarize(header_only.data(), header_only.size(), empty));
+    EXPECT_EQ(session_record::detail::FormatSummary(empty), L"No samples recorded yet.\n");
+
+    const std::vector<uint8_t> image = MakeImage({MakeRecord(1000, 60.f, 17.f, -1.f, 0xabcdef)});
+    SessionSummary summary;
+    ASSERT_TRUE(session_record::detail::Summarize(image.data(), image.size(), summary));
+    const std::wstring text = session_record::detail::FormatSummary(summary);
+    EXPECT_NE(text.find(L"Samples: 1 (0 saved manually)"), std::wstring::npos);
+    EXPECT_NE(text.find(L"FPS: min 60 / mean 60.0 / max 60"), std::wstring::npos);
+    EXPECT_NE(text.find(L"Mic level: no samples"), std::wstring::npos);
+    EXPECT_NE(text.find(L"Args hash: 0000000000abcdef"), std::wstring::npos);
+    EXPECT_EQ(text.find(L"Ignored"), std::wstring::npos);
+}
+
+TEST(SessionRecordTest, WriterAppendsAndReaderSummarizes)
+{
+    const std::wstring path = TempRecordPath();
+    DeleteFileW(path.c_str());
+    {
+        SessionRecordWriter writer;
+        ASSERT_TRUE(writer.Open(path));
+        EXPECT_EQ(writer.RecordCount(), 0u);
+        EXPECT_TRUE(writer.Append(MakeRecord(1000, 60.f, 17.f, 0.5f, 3)));
+        EXPECT_TRUE(writer.Append(MakeRecord(2000, 58.f, 19.f, 0.5f, 3)));
+
+        // Readers map the file while the writer still holds it open.
+        SessionSummary summary;
+        std::wstring error;
+        ASSERT_TRUE(session_record::ReadSummary(path, summary, error)) << error.c_str();
+        EXPECT_EQ(summary.records, 2u);
+    }
+    {
+        // Reopening appends after the existing records instead of rewriting.
+        SessionRecordWriter writer;
+        ASSERT_TRUE(writer.Open(path));
+        EXPECT_EQ(writer.RecordCount(), 2u);
+        EXPECT_TRUE(writer.Append(MakeRecord(3000, 57.f, 21.f, 0.5f, 3)));
+        EXPECT_EQ(writer.RecordCount(), 3u);
+    }
+
+    SessionSummary summary;
+    std::wstring error;
+    ASSERT_TRUE(session_record::ReadSummary(path, summary, error)) << error.c_str();
+    EXPECT_EQ(summary.records, 3u);
+    EXPECT_EQ(summary.first_unix_ms, 1000);
+    EXPECT_EQ(summary.last_unix_ms, 3000);
+    EXPECT_FLOAT_EQ(summary.fps_min, 57.f);
+    DeleteFileW(path.c_str());
+}
+
+TEST(SessionRecordTest, ReaderReportsMissingFile)
+{
+    SessionSummary summary;
+    std::wstring error;
+    EXPECT_FALSE(session_record::ReadSummary(TempRecordPath() + L".missing", summary, error));
+    EXPECT_FALSE(error.empty());
+}
@@ -0,0 +1,114 @@
+// Unit tests for StartupTasks: tasks run concurrently, results are visible
+// once IsDone()/Wait() report completion, and exceptions are captured
+// instead of escaping the task thread.
+
+#include <windows.h>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../startup_tasks.hpp"
+
+TEST(StartupTasks, RunsTasksConcurrently)
+{
+    // Each task waits for the other to have started; run one after another
+    // they would both time out.
+    std::atomic<int> started{0};
+    std::atomic<int> met{0};
+    auto rendezvous = [&]
+    {
+        started.fetch_add(1);
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (started.load() < 2 && std::chrono::steady_clock::now() < deadline)
+            std::this_thread::yield();
+        if (started.load() == 2)
+            met.fetch_add(1);
+    };
+
+    StartupTasks tasks;
+    const auto a = tasks.Start(L"a", rendezvous);
+    const auto b = tasks.Start(L"b", rendezvous);
+    tasks.WaitAll();
+
+    EXPECT_TRUE(tasks.IsDone(a));
+    EXPECT_TRUE(tasks.IsDone(b));
+    EXPECT_EQ(met.load(), 2);
+    EXPECT_EQ(tasks.Count(), 2u);
+}
+
+TEST(StartupTasks, ResultsVisibleAfterWait)
+{
+    std::vector<std::wstring> result;
+    StartupTasks tasks;
+    const auto id = tasks.Start(L"fill", [&] { result.assign(1000, L"path"); });
+    tasks.Wait(id);
+    EXPECT_TRUE(tasks.IsDone(id));
+    EXPECT_EQ(result.size(), 1000u);
+    EXPECT_EQ(tasks.Error(id), nullptr);
+    EXPECT_GE(tasks.DurationMs(id), 0.0);
+}
+
+TEST(StartupTasks, IsDoneDoesNotBlock)
+{
+    std::atomic<bool> release{false};
+    StartupTasks tasks;
+    const auto id = tasks.Start(L"slow",
+                                [&]
+                                {
+                                    while (!release.load())
+                                        std::this_thread::yield();
+                                });
+    EXPECT_FALSE(tasks.IsDone(id));
+    EXPECT_EQ(tasks.Error(id), nullptr);
+    EXPECT_EQ(tasks.DurationMs(id), 0.0);
+    release.store(true);
+    tasks.Wait(id);
+    EXPECT_TRUE(tasks.IsDone(id));
+}
+
+TEST(StartupTasks, ExceptionIsCapturedForTheOwner)
+{
+    StartupTasks tasks;
+    const auto id = tasks.Start(L"throws", [] { throw std::runtime_error("no text formats"); });
+    tasks.Wait(id);
+    ASSERT_TRUE(tasks.IsDone(id));
+    const std::exception_ptr error = tasks.Error(id);
+    ASSERT_NE(error, nullptr);
+    try
+    {
+        std::rethrow_exception(error);
+    }
+    catch (const std::runtime_error& ex)
+    {
+        EXPECT_STREQ(ex.what(), "no text formats");
+    }
+}
+
+TEST(StartupTasks, DestructorWaitsForRunningTasks)
+{
+    std::atomic<bool> finished{false};
+    {
+        StartupTasks tasks;
+        tasks.Start(L"sleepy",
+                    [&]
+                    {
+                        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                        finished.store(true);
+                    });
+    }
+    EXPECT_TRUE(finished.load());
+}
+
+TEST(StartupTasks, UnknownIdIsNeverDone)
+{
+    StartupTasks tasks;
+    EXPECT_FALSE(tasks.IsDone(3));
+    EXPECT_EQ(tasks.Error(3), nullptr);
+    tasks.Wait(3); // no-op
+}
@@ -0,0 +1,88 @@
+// Unit tests for TextLayoutCache: layouts are reused until the text, format or
+// box changes. Uses a real shared DirectWrite factory (no window needed).
+
+#include <windows.h>
+
+#include <dwrite.h>
+#include <gtest/gtest.h>
+#include <wrl/client.h>
+
+#include "../text_layout_cache.hpp"
+
+using Microsoft::WRL::ComPtr;
+
+class TextLayoutCacheTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        HRESULT hr = DWriteCreateFactory(DWRITE_FACTORY_TYPE_SHARED, __uuidof(IDWriteFactory),
+                                         reinterpret_cast<IUnknown**>(factory_.GetAddressOf()));
+        if (FAILED(hr))
+            GTEST_SKIP() << "DirectWrite unavailable";
+        ASSERT_HRESULT_SUCCEEDED(factory_->CreateTextFormat(L"Arial", nullptr, DWRITE_FONT_WEIGHT_NORMAL,
+                                                            DWRITE_FONT_STYLE_NORMAL, DWRITE_FONT_STRETCH_NORMAL,
+                                                            24.0f, L"en-us", format_.GetAddressOf()));
+        cache_.Reset(factory_.Get());
+    }
+
+    ComPtr<IDWriteFactory> factory_;
+    ComPtr<IDWriteTextFormat> format_;
+    TextLayoutCache cache_;
+};
+
+TEST_F(TextLayoutCacheTest, SameInputReusesLayout)
+{
+    IDWriteTextLayout* first = cache_.Get(0, L"hello", format_.Get(), 200.f, 30.f);
+    ASSERT_NE(first, nullptr);
+    for (int i = 0; i < 10; ++i)
+        EXPECT_EQ(cache_.Get(0, L"hello", format_.Get(), 200.f, 30.f), first);
+    EXPECT_EQ(cache_.RebuildCount(), 1u);
+}
+
+TEST_F(TextLayoutCacheTest, ChangedTextOrBoxRebuilds)
+{
+    cache_.Get(0, L"hello", format_.Get(), 200.f, 30.f);
+    cache_.Get(0, L"hello!", format_.Get(), 200.f, 30.f);
+    EXPECT_EQ(cache_.RebuildCount(), 2u);
+    cache_.Get(0, L"hello!", format_.Get(), 300.f, 30.f);
+    EXPECT_EQ(cache_.RebuildCount(), 3u);
+
+    const FLOAT max_width = cache_.Get(0, L"hello!", format_.Get(), 300.f, 30.f)->GetMaxWidth();
+    EXPECT_FLOAT_EQ(max_width, 300.f);
+    EXPECT_EQ(cache_.RebuildCount(), 3u);
+}
+
+TEST_F(TextLayoutCacheTest, ChangedFormatRebuilds)
+{
+    ComPtr<IDWriteTextFormat> other;
+    ASSERT_HRESULT_SUCCEEDED(factory_->CreateTextFormat(L"Consolas", nullptr, DWRITE_FONT_WEIGHT_NORMAL,
+                                                        DWRITE_FONT_STYLE_NORMAL, DWRITE_FONT_STRETCH_NORMAL, 12.0f,
+                                                        L"en-us", other.GetAddressOf()));
+    cache_.Get(0, L"text", format_.Get(), 100.f, 20.f);
+    cache_.Get(0, L"text", other.Get(), 100.f, 20.f);
+    EXPECT_EQ(cache_.RebuildCount(), 2u);
+}
+
+TEST_F(TextLayoutCacheTest, SlotsAreIndependent)
+{
+    IDWriteTextLayout* a = cache_.Get(0, L"a", format_.Get(), 100.f, 20.f);
+    IDWriteTextLayout* b = cache_.Get(5, L"b", format_.Get(), 100.f, 20.f);
+    EXPECT_NE(a, b);
+    EXPECT_EQ(cache_.Get(0, L"a", format_.Get(), 100.f, 20.f), a);
+    EXPECT_EQ(cache_.Get(5, L"b", format_.Get(), 100.f, 20.f), b);
+    EXPECT_EQ(cache_.RebuildCount(), 2u);
+}
+
+TEST_F(TextLayoutCacheTest, ResetDropsLayoutsAndNullInputsFail)
+{
+    cache_.Get(0, L"a", format_.Get(), 100.f, 20.f);
+    cache_.Reset(factory_.Get());
+    EXPECT_EQ(cache_.RebuildCount(), 0u);
+    cache_.Get(0, L"a", format_.Get(), 100.f, 20.f);
+    EXPECT_EQ(cache_.RebuildCount(), 1u);
+
+    EXPECT_EQ(cache_.Get(1, L"a", nullptr, 100.f, 20.f), nullptr);
+    cache_.Reset(nullptr);
+    EXPECT_EQ(cache_.Get(0, L"a", format_.Get(), 100.f, 20.f), nullptr);
+}
@@ -0,0 +1,97 @@
+// Unit tests for utf8_convert: the ASCII fast path around vector block
+// boundaries, equivalence with one WideCharToMultiByte call over the whole
+// text, and appending into a reused buffer.
+
+#include <windows.h>
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "../utf8_convert.hpp"
+
+namespace
+{
+
+// What wstring_to_string produced before the fast path: one conversion of
+// the whole text.
+std::string Reference(const std::wstring& text)
+{
+    if (text.empty())
+        return std::string();
+    const int bytes =
+        WideCharToMultiByte(CP_UTF8, 0, text.data(), static_cast<int>(text.size()), nullptr, 0, nullptr, nullptr);
+    std::string out(static_cast<size_t>(bytes), '\0');
+    WideCharToMultiByte(CP_UTF8, 0, text.data(), static_cast<int>(text.size()), out.data(), bytes, nullptr, nullptr);
+    return out;
+}
+
+std::string Convert(const std::wstring& text)
+{
+    std::string out;
+    utf8_convert::Append(text, out);
+    return out;
+}
+
+} // namespace
+
+TEST(Utf8ConvertTest, NarrowAsciiPrefixStopsAtFirstNonAscii)
+{
+    // Every position across two vector blocks and the scalar tail.
+    for (size_t at = 0; at < 40; ++at)
+    {
+        std::wstring text(40, L'a');
+        text[at] = L'\x00e9';
+        char out[40] = {};
+        EXPECT_EQ(utf8_convert::detail::NarrowAsciiPrefix(text.data(), text.size(), out), at) << "at " << at;
+        EXPECT_EQ(std::string(out, at), std::string(at, 'a'));
+    }
+
+    const std::wstring ascii(37, L'~');
+    char out[37] = {};
+    EXPECT_EQ(utf8_convert::detail::NarrowAsciiPrefix(ascii.data(), ascii.size(), out), ascii.size());
+    // DEL is still ASCII; U+0080 is the first code unit that is not.
+    const std::wstring edge = L"\x7f\x7f\x0080";
+    EXPECT_EQ(utf8_convert::detail::NarrowAsciiPrefix(edge.data(), edge.size(), out), 2u);
+}
+
+TEST(Utf8ConvertTest, MatchesWholeTextConversion)
+{
+    const std::wstring cases[] = {
+        L"",
+        L"--resolution=1920x1080",
+        L"C:\\Users\\\x0416\x0435\x043d\x044f\\AppData\\Local\\Game\\bin\\game.exe",
+        L"\x4e2d\x6587\x8def\x5f84 with ascii tail that is longer than sixteen units",
+        L"0123456789abcdef\x00e9" L"0123456789abcdef",
+        std::wstring(L"null\0inside", 11),
+        L"emoji \xD83D\xDE00 and \xD83C\xDFAE across a block edge \xD83D\xDE80",
+        L"lone \xD800 high and \xDC00 low surrogates",
+    };
+    for (const std::wstring& text : cases)
+        EXPECT_EQ(Convert(text), Reference(text));
+
+    // Surrogate pairs straddling each possible 16-unit block boundary.
+    for (size_t at = 0; at < 20; ++at)
+    {
+        std::wstring text(34, L'x');
+        text.insert(at, L"\xD83D\xDE00");
+        EXPECT_EQ(Convert(text), Reference(text)) << "at " << at;
+    }
+}
+
+TEST(Utf8ConvertTest, AppendKeepsExistingContentAndAssignReusesCapacity)
+{
+    std::string out = ";args=";
+    utf8_convert::Append(std::wstring(L"--name=\x00c5sa"), out);
+    EXPECT_EQ(out, ";args=--name=\xc3\x85sa");
+
+    out.reserve(256);
+    const size_t capacity = out.capacity();
+    const std::wstring line = L"[12:00:00] frame 42 presented";
+    utf8_convert::Assign(line.data(), line.size(), out);
+    EXPECT_EQ(out, "[12:00:00] frame 42 presented");
+    EXPECT_EQ(out.capacity(), capacity);
+
+    utf8_convert::Assign(nullptr, 0, out);
+    EXPECT_TRUE(out.empty());
+}
@@ -0,0 +1,54 @@
+#ifndef UNICODE
+#define UNICODE
+#define _UNICODE
+#endif
+
+#include "text_layout_cache.hpp"
+
+#include "alloc_guard.hpp"
+
+#pragma comment(lib, "dwrite")
+
+void TextLayoutCache::Reset(IDWriteFactory* factory)
+{
+    factory_ = factory;
+    entries_.clear();
+    rebuilds_ = 0;
+}
+
+IDWriteTextLayout* TextLayoutCache::Get(size_t slot, const std::wstring& text, IDWriteTextFormat* format,
+                                        float width, float height)
+{
+    if (!factory_ || !format)
+        return nullptr;
+
+    if (slot >= entries_.size())
+    {
+        alloc_guard::ScopedAllowAlloc allow; // first use of a slot
+        entries_.resize(slot + 1);
+    }
+
+    Entry& entry = entries_[slot];
+    if (entry.layout && entry.format.Get() == format && entry.width == width && entry.height == height &&
+        entry.text == text)
+        return entry.layout.Get();
+
+    // Content or box changed: rebuilding is expected to allocate.
+    alloc_guard::ScopedAllowAlloc allow;
+    entry.layout.Reset();
+    HRESULT hr = factory_->CreateTextLayout(text.c_str(), static_cast<UINT32>(text.size()), format, width, height,
+                                            entry.layout.GetAddressOf());
+    if (FAILED(hr))
+    {
+        entry.format.Reset();
+        entry.text.clear();
+        return nullptr;
+    }
+
+    entry.text = text;
+    entry.format = format;
+    entry.width = width;
+    entry.height = height;
+    ++rebuilds_;
+    return entry.layout.Get();
+}
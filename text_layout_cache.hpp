@@ -0,0 +1,51 @@
+#pragma once
+
+#include <windows.h>
+
+#include <dwrite.h>
+#include <wrl/client.h>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Retained IDWriteTextLayout objects for overlay text that rarely changes.
+// DrawText re-runs DirectWrite layout and shaping on every call; drawing a
+// cached layout with DrawTextLayout only rasterises the glyph runs.
+//
+// Each slot remembers the text, format and layout box it was built for and is
+// rebuilt only when one of them changes, so callers can simply pass the
+// current content every frame. Render-thread only.
+class TextLayoutCache
+{
+  public:
+    // Drops every cached layout. Call whenever the DirectWrite factory or the
+    // text formats are recreated.
+    void Reset(IDWriteFactory* factory);
+
+    // Layout for `slot` sized to width x height. Returns nullptr if DirectWrite
+    // refuses to build one; the caller may fall back to DrawText.
+    IDWriteTextLayout* Get(size_t slot, const std::wstring& text, IDWriteTextFormat* format, float width,
+                           float height);
+
+    // Number of layouts built since the last Reset(); diagnostics and tests.
+    size_t RebuildCount() const
+    {
+        return rebuilds_;
+    }
+
+  private:
+    struct Entry
+    {
+        std::wstring text;
+        // Held by reference so a recreated format can never alias a stale key.
+        Microsoft::WRL::ComPtr<IDWriteTextFormat> format;
+        float width = 0.f;
+        float height = 0.f;
+        Microsoft::WRL::ComPtr<IDWriteTextLayout> layout;
+    };
+
+    Microsoft::WRL::ComPtr<IDWriteFactory> factory_;
+    std::vector<Entry> entries_;
+    size_t rebuilds_ = 0;
+};
@@ -0,0 +1,130 @@
+#ifndef UNICODE
+#define UNICODE
+#define _UNICODE
+#endif
+
+#include "trace_events.hpp"
+
+#include <TraceLoggingProvider.h>
+#include <winmeta.h> // WINEVENT_LEVEL_*, WINEVENT_OPCODE_*
+
+#pragma comment(lib, "advapi32") // EventRegister / EventWriteTransfer
+
+// Name hash of "CloudStreamingArgsDebugger" (EventSource convention).
+TRACELOGGING_DEFINE_PROVIDER(g_trace_provider, "CloudStreamingArgsDebugger",
+                             (0x644de0b5, 0x57c2, 0x529a, 0xf4, 0x57, 0x01, 0xe9, 0x48, 0xe2, 0x1d, 0x29));
+
+namespace trace_events
+{
+
+void Register()
+{
+    // Failure only means no session will ever see the events.
+    TraceLoggingRegister(g_trace_provider);
+}
+
+void Unregister()
+{
+    TraceLoggingUnregister(g_trace_provider);
+}
+
+void FrameStart(uint64_t frame, unsigned redraw)
+{
+    TraceLoggingWrite(g_trace_provider, "Frame", TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
+                      TraceLoggingKeyword(kKeywordFrame), TraceLoggingOpcode(WINEVENT_OPCODE_START),
+                      TraceLoggingUInt64(frame, "Frame"), TraceLoggingHexUInt32(redraw, "Redraw"));
+}
+
+void FrameStop(uint64_t frame, float cpu_ms)
+{
+    TraceLoggingWrite(g_trace_provider, "Frame", TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
+                      TraceLoggingKeyword(kKeywordFrame), TraceLoggingOpcode(WINEVENT_OPCODE_STOP),
+                      TraceLoggingUInt64(frame, "Frame"), TraceLoggingFloat32(cpu_ms, "CpuMs"));
+}
+
+void SectionStart(const wchar_t* section)
+{
+    TraceLoggingWrite(g_trace_provider, "Section", TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
+                      TraceLoggingKeyword(kKeywordFrame), TraceLoggingOpcode(WINEVENT_OPCODE_START),
+                      TraceLoggingWideString(section, "Section"));
+}
+
+void SectionStop(const wchar_t* section, float ms)
+{
+    TraceLoggingWrite(g_trace_provider, "Section", TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
+                      TraceLoggingKeyword(kKeywordFrame), TraceLoggingOpcode(WINEVENT_OPCODE_STOP),
+                      TraceLoggingWideString(section, "Section"), TraceLoggingFloat32(ms, "Ms"));
+}
+
+void PresentStart(uint64_t frame, UINT sync_interval, UINT flags, UINT dirty_rects)
+{
+    TraceLoggingWrite(g_trace_provider, "Present", TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
+                      TraceLoggingKeyword(kKeywordPresent), TraceLoggingOpcode(WINEVENT_OPCODE_START),
+                      TraceLoggingUInt64(frame, "Frame"), TraceLoggingUInt32(sync_interval, "SyncInterval"),
+                      TraceLoggingHexUInt32(flags, "Flags"), TraceLoggingUInt32(dirty_rects, "DirtyRects"));
+}
+
+void PresentStop(uint64_t frame, HRESULT hr)
+{
+    TraceLoggingWrite(g_trace_provider, "Present", TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
+                      TraceLoggingKeyword(kKeywordPresent), TraceLoggingOpcode(WINEVENT_OPCODE_STOP),
+                      TraceLoggingUInt64(frame, "Frame"), TraceLoggingHResult(hr, "HResult"));
+}
+
+void DeviceLost(const wchar_t* where, HRESULT hr)
+{
+    TraceLoggingWrite(g_trace_provider, "DeviceLost", TraceLoggingLevel(WINEVENT_LEVEL_WARNING),
+                      TraceLoggingKeyword(kKeywordPresent), TraceLoggingWideString(where, "Where"),
+                      TraceLoggingHResult(hr, "HResult"));
+}
+
+void QrRequest(uint64_t frame, int64_t qpc)
+{
+    TraceLoggingWrite(g_trace_provider, "QrRequest", TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
+                      TraceLoggingKeyword(kKeywordQr), TraceLoggingUInt64(frame, "Frame"),
+                      TraceLoggingInt64(qpc, "Qpc"));
+}
+
+void QrTake(uint64_t frame)
+{
+    TraceLoggingWrite(g_trace_provider, "QrTake", TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
+                      TraceLoggingKeyword(kKeywordQr), TraceLoggingUInt64(frame, "Frame"));
+}
+
+void QrBuildStart(uint64_t frame)
+{
+    TraceLoggingWrite(g_trace_provider, "QrBuild", TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
+                      TraceLoggingKeyword(kKeywordQr), TraceLoggingOpcode(WINEVENT_OPCODE_START),
+                      TraceLoggingUInt64(frame, "Frame"));
+}
+
+void QrBuildStop(uint64_t frame, bool ok)
+{
+    TraceLoggingWrite(g_trace_provider, "QrBuild", TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
+                      TraceLoggingKeyword(kKeywordQr), TraceLoggingOpcode(WINEVENT_OPCODE_STOP),
+                      TraceLoggingUInt64(frame, "Frame"), TraceLoggingBoolean(ok, "Ok"));
+}
+
+void AudioGetBuffer(uint32_t frames, uint32_t flags, HRESULT hr)
+{
+    TraceLoggingWrite(g_trace_provider, "AudioGetBuffer", TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
+                      TraceLoggingKeyword(kKeywordAudio), TraceLoggingUInt32(frames, "Frames"),
+                      TraceLoggingHexUInt32(flags, "Flags"), TraceLoggingHResult(hr, "HResult"));
+}
+
+void AudioReleaseBuffer(uint32_t frames, HRESULT hr)
+{
+    TraceLoggingWrite(g_trace_provider, "AudioReleaseBuffer", TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
+                      TraceLoggingKeyword(kKeywordAudio), TraceLoggingUInt32(frames, "Frames"),
+                      TraceLoggingHResult(hr, "HResult"));
+}
+
+void InputLatency(uint32_t sequence, uint64_t frame, float total_ms, float display_ms, uint32_t source)
+{
+    TraceLoggingWrite(g_trace_provider, "InputLatency", TraceLoggingLevel(WINEVENT_LEVEL_INFO),
+                      TraceLoggingKeyword(kKeywordInput), TraceLoggingUInt32(sequence, "Sequence"),
+                      TraceLoggingUInt64(frame, "Frame"), TraceLoggingFloat32(total_ms, "TotalMs"),
+                      TraceLoggingFloat32(display_ms, "DisplayMs"), TraceLoggingUInt32(source, "Source"));
+}
+
+} // namespace trace_events
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <windows.h>
+
+#include <cstdint>
+
+// TraceLogging (ETW) events for the render, present, QR and audio paths, so
+// a capture lines up with GPUView/WPA, PresentMon and encoder traces at QPC
+// resolution instead of Log()'s millisecond text lines.
+//
+// Provider "CloudStreamingArgsDebugger",
+//   {644de0b5-57c2-529a-f457-01e948e21d29}
+// (the name-hashed GUID, so "*CloudStreamingArgsDebugger" also works in
+// tools that accept provider names). Keywords select event groups; with no
+// session listening each call is a single enabled-check and returns.
+//
+// Paired events use the START/STOP opcodes with the same name, which WPA
+// shows as regions. Register() is called once from wWinMain; before that,
+// and in tests, every function is a no-op.
+namespace trace_events
+{
+
+constexpr ULONGLONG kKeywordFrame = 0x1;   // Frame, Section
+constexpr ULONGLONG kKeywordPresent = 0x2; // Present, DeviceLost
+constexpr ULONGLONG kKeywordQr = 0x4;      // QrRequest, QrBuild, QrTake
+constexpr ULONGLONG kKeywordAudio = 0x8;   // AudioGetBuffer, AudioReleaseBuffer
+constexpr ULONGLONG kKeywordInput = 0x10;  // InputLatency
+
+void Register();
+void Unregister();
+
+// Around RenderFrame; `redraw` is the kRedraw* mask that caused the frame.
+void FrameStart(uint64_t frame, unsigned redraw);
+void FrameStop(uint64_t frame, float cpu_ms);
+// Around each timed RenderFrame phase (see ScopedSectionTimer);
+// `section` is FrameSectionName().
+void SectionStart(const wchar_t* section);
+void SectionStop(const wchar_t* section, float ms);
+
+// Around the Present/Present1 call itself.
+void PresentStart(uint64_t frame, UINT sync_interval, UINT flags, UINT dirty_rects);
+void PresentStop(uint64_t frame, HRESULT hr);
+// `where` is "EndOverlay" (D2DERR_RECREATE_TARGET) or "PresentFrame"
+// (DXGI_ERROR_DEVICE_REMOVED/RESET), emitted before resources are recreated.
+void DeviceLost(const wchar_t* where, HRESULT hr);
+
+// Render thread queued a payload / picked up finished pixels.
+void QrRequest(uint64_t frame, int64_t qpc);
+void QrTake(uint64_t frame);
+// Worker thread encoding + rasterising the payload for `frame`.
+void QrBuildStart(uint64_t frame);
+void QrBuildStop(uint64_t frame, bool ok);
+
+// Capture thread, per packet. `flags` are the AUDCLNT_BUFFERFLAGS_* bits.
+void AudioGetBuffer(uint32_t frames, uint32_t flags, HRESULT hr);
+void AudioReleaseBuffer(uint32_t frames, HRESULT hr);
+
+// Render thread, once per keystroke measured by --latency-probe; `source` is
+// the LatencySource of the display time (see input_latency.hpp).
+void InputLatency(uint32_t sequence, uint64_t frame, float total_ms, float display_ms, uint32_t source);
+
+} // namespace trace_events
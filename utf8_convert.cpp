@@ -0,0 +1,125 @@
+#ifndef UNICODE
+#define UNICODE
+#define _UNICODE
+#endif
+
+#include "utf8_convert.hpp"
+
+#include <windows.h>
+
+#include <cstdint>
+#include <cwchar>
+
+#include "cpu_dispatch.hpp"
+
+// The vector paths treat wchar_t as a UTF-16 code unit, as on Windows.
+#if WCHAR_MAX == 0xFFFF && defined(CPU_DISPATCH_X86)
+#define UTF8_SSE2 1
+#include <emmintrin.h>
+#elif WCHAR_MAX == 0xFFFF && defined(CPU_DISPATCH_NEON)
+#define UTF8_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace
+{
+
+// Most UTF-8 bytes one wchar_t can become: 3 for a UTF-16 unit (a surrogate
+// pair is 4 bytes for two units, and a lone surrogate becomes U+FFFD), 4
+// where wchar_t holds whole code points.
+constexpr size_t kMaxBytesPerUnit = sizeof(wchar_t) == 2 ? 3 : 4;
+
+bool IsAscii(wchar_t ch)
+{
+    return static_cast<uint32_t>(ch) < 0x80;
+}
+
+} // namespace
+
+namespace utf8_convert::detail
+{
+
+size_t NarrowAsciiPrefix(const wchar_t* text, size_t length, char* out)
+{
+    size_t i = 0;
+#if defined(UTF8_SSE2)
+    const __m128i high_bits = _mm_set1_epi16(static_cast<short>(0xff80));
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= length; i += 16)
+    {
+        const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i));
+        const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i + 8));
+        const __m128i any_high = _mm_and_si128(_mm_or_si128(lo, hi), high_bits);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi16(any_high, zero)) != 0xffff)
+            break;
+        // Every unit is below 0x80, so the saturating pack is a plain narrow.
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(lo, hi));
+    }
+#elif defined(UTF8_NEON)
+    for (; i + 16 <= length; i += 16)
+    {
+        const uint16x8_t lo = vld1q_u16(reinterpret_cast<const uint16_t*>(text + i));
+        const uint16x8_t hi = vld1q_u16(reinterpret_cast<const uint16_t*>(text + i + 8));
+        if (vmaxvq_u16(vorrq_u16(lo, hi)) >= 0x80)
+            break;
+        vst1q_u8(reinterpret_cast<uint8_t*>(out + i), vcombine_u8(vmovn_u16(lo), vmovn_u16(hi)));
+    }
+#endif
+    // The tail, and the block that stopped the vector loop, one at a time.
+    for (; i < length && IsAscii(text[i]); ++i)
+        out[i] = static_cast<char>(text[i]);
+    return i;
+}
+
+} // namespace utf8_convert::detail
+
+namespace utf8_convert
+{
+
+void Append(const wchar_t* text, size_t length, std::string& out)
+{
+    if (length == 0)
+        return;
+
+    // All-ASCII text, the common case, is exactly one byte per character.
+    const size_t start = out.size();
+    out.resize(start + length);
+    size_t pos = detail::NarrowAsciiPrefix(text, length, out.data() + start);
+    if (pos == length)
+        return;
+
+    // Otherwise size the rest for the worst case once and trim at the end.
+    out.resize(start + pos + (length - pos) * kMaxBytesPerUnit);
+    char* const dst = out.data() + start;
+    size_t written = pos;
+    while (pos < length)
+    {
+        size_t end = pos + 1;
+        while (end < length && !IsAscii(text[end]))
+            ++end;
+        const int units = static_cast<int>(end - pos);
+        const int bytes = WideCharToMultiByte(CP_UTF8, 0, text + pos, units, dst + written,
+                                              units * static_cast<int>(kMaxBytesPerUnit), nullptr, nullptr);
+        if (bytes > 0)
+            written += static_cast<size_t>(bytes);
+        pos = end;
+
+        const size_t ascii = detail::NarrowAsciiPrefix(text + pos, length - pos, dst + written);
+        written += ascii;
+        pos += ascii;
+    }
+    out.resize(start + written);
+}
+
+const wchar_t* AsciiPathName()
+{
+#if defined(UTF8_SSE2)
+    return L"SSE2";
+#elif defined(UTF8_NEON)
+    return L"NEON";
+#else
+    return L"scalar";
+#endif
+}
+
+} // namespace utf8_convert
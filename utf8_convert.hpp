@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// UTF-16 -> UTF-8 for the QR payload, the UTF-8 log writer and the headless
+// JSON report. Arguments, paths and log lines are overwhelmingly ASCII, so
+// ASCII runs are narrowed with SSE2/NEON (16 characters per step) and only
+// the non-ASCII runs between them go through WideCharToMultiByte, in one call
+// each with no size query. The output is byte-for-byte what a single
+// WideCharToMultiByte(CP_UTF8) call over the whole text produces: runs only
+// split at ASCII characters, so surrogate pairs are never cut apart.
+//
+// Results are appended to a caller-owned std::string; reusing one buffer
+// keeps repeated conversions allocation-free once it has grown.
+namespace utf8_convert
+{
+
+void Append(const wchar_t* text, size_t length, std::string& out);
+
+inline void Append(const std::wstring& text, std::string& out)
+{
+    Append(text.data(), text.size(), out);
+}
+
+// Replaces the contents of `out`, keeping its capacity.
+inline void Assign(const wchar_t* text, size_t length, std::string& out)
+{
+    out.clear();
+    Append(text, length, out);
+}
+
+// Instruction set of the ASCII path ("SSE2", "NEON" or "scalar"), for the
+// `memory` panel. SSE2 and NEON are the baselines of their architectures, so
+// nothing is detected at runtime.
+const wchar_t* AsciiPathName();
+
+} // namespace utf8_convert
+
+// Pure helpers, exposed for unit tests.
+namespace utf8_convert::detail
+{
+
+// Copies the leading ASCII characters (< 0x80) of text[0, length) to `out`
+// as bytes and returns how many there were. `out` needs room for `length`.
+size_t NarrowAsciiPrefix(const wchar_t* text, size_t length, char* out);
+
+} // namespace utf8_convert::detail
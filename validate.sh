@@ -19,7 +19,11 @@ echo "🔍 Checking for common C++ syntax issues..."
 # Check for missing semicolons, unmatched braces, etc.
 syntax_errors=0
 
-for file in cli_args_debugger.cpp seh_wrapper.cpp log_manager.cpp path_info.cpp audio_capture.cpp; do
+for file in cli_args_debugger.cpp seh_wrapper.cpp log_manager.cpp path_info.cpp audio_capture.cpp app_options.cpp \
+    frame_pacer.cpp frame_stats.cpp text_layout_cache.cpp idle_render.cpp qr_worker.cpp audio_peak_kernels.cpp \
+    audio_meter.cpp headless_report.cpp startup_tasks.cpp log_tail.cpp metrics_export.cpp \
+    trace_events.cpp alloc_guard.cpp arg_list_view.cpp path_info_cache.cpp \
+    session_record.cpp hud_batch.cpp cpu_dispatch.cpp utf8_convert.cpp input_latency.cpp; do
     if [ -f "$file" ]; then
         echo "Checking $file..."
         